@@ -15,6 +15,20 @@
 #include "stdafx.h"
 #include "jsrt-wrappers.h"
 
+#include <climits>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <stdlib.h>
+#include <thread>
+#include <windows.h>
+
+#if defined(_M_IX86) || defined(_M_X64)
+#include <emmintrin.h>
+#define JSRT_SSE2
+#endif
+
 namespace jsrt
 {
     const std::wstring typed_array_type<char, false>::type_name = L"Int8";
@@ -26,6 +40,3189 @@ namespace jsrt
     const std::wstring typed_array_type<float, false>::type_name = L"Float32";
     const std::wstring typed_array_type<double, false>::type_name = L"Float64";
 
+    void endian_copy::copy(unsigned char *destination, const unsigned char *source, unsigned int count, int element_size, bool reverse)
+    {
+        if (!reverse || element_size == 1)
+        {
+            memcpy(destination, source, static_cast<size_t>(count) * element_size);
+            return;
+        }
+
+        size_t length = static_cast<size_t>(count) * element_size;
+        size_t index = 0;
+
+#ifdef JSRT_SSE2
+        // Reverse 16 bytes at a time: first reorder the 16-bit words within each element, then
+        // swap the bytes within each word.
+        for (; index + 16 <= length; index += 16)
+        {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + index));
+
+            if (element_size == 4)
+            {
+                block = _mm_shufflehi_epi16(_mm_shufflelo_epi16(block, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+            }
+            else if (element_size == 8)
+            {
+                block = _mm_shufflehi_epi16(_mm_shufflelo_epi16(block, _MM_SHUFFLE(0, 1, 2, 3)), _MM_SHUFFLE(0, 1, 2, 3));
+            }
+
+            block = _mm_or_si128(_mm_slli_epi16(block, 8), _mm_srli_epi16(block, 8));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(destination + index), block);
+        }
+#endif
+
+        for (; index < length; index += element_size)
+        {
+            switch (element_size)
+            {
+            case 2:
+                {
+                    unsigned short element;
+                    memcpy(&element, source + index, sizeof(element));
+                    element = _byteswap_ushort(element);
+                    memcpy(destination + index, &element, sizeof(element));
+                    break;
+                }
+            case 4:
+                {
+                    unsigned long element;
+                    memcpy(&element, source + index, sizeof(element));
+                    element = _byteswap_ulong(element);
+                    memcpy(destination + index, &element, sizeof(element));
+                    break;
+                }
+            case 8:
+                {
+                    unsigned long long element;
+                    memcpy(&element, source + index, sizeof(element));
+                    element = _byteswap_uint64(element);
+                    memcpy(destination + index, &element, sizeof(element));
+                    break;
+                }
+            default:
+                throw invalid_argument_exception();
+            }
+        }
+    }
+
+    double numeric::dot(const double *left, const double *right, size_t count)
+    {
+        size_t index = 0;
+        double sum = 0;
+
+#ifdef JSRT_SSE2
+        __m128d sum0 = _mm_setzero_pd();
+        __m128d sum1 = _mm_setzero_pd();
+        for (; index + 4 <= count; index += 4)
+        {
+            sum0 = _mm_add_pd(sum0, _mm_mul_pd(_mm_loadu_pd(left + index), _mm_loadu_pd(right + index)));
+            sum1 = _mm_add_pd(sum1, _mm_mul_pd(_mm_loadu_pd(left + index + 2), _mm_loadu_pd(right + index + 2)));
+        }
+        sum0 = _mm_add_pd(sum0, sum1);
+        sum = _mm_cvtsd_f64(_mm_add_sd(sum0, _mm_unpackhi_pd(sum0, sum0)));
+#endif
+
+        for (; index < count; index++)
+        {
+            sum += left[index] * right[index];
+        }
+
+        return sum;
+    }
+
+    double numeric::dot(const int *left, const int *right, size_t count)
+    {
+        size_t index = 0;
+        double sum = 0;
+
+#ifdef JSRT_SSE2
+        __m128d sum0 = _mm_setzero_pd();
+        __m128d sum1 = _mm_setzero_pd();
+        for (; index + 4 <= count; index += 4)
+        {
+            __m128i leftBlock = _mm_loadu_si128(reinterpret_cast<const __m128i *>(left + index));
+            __m128i rightBlock = _mm_loadu_si128(reinterpret_cast<const __m128i *>(right + index));
+            sum0 = _mm_add_pd(sum0, _mm_mul_pd(_mm_cvtepi32_pd(leftBlock), _mm_cvtepi32_pd(rightBlock)));
+            sum1 = _mm_add_pd(sum1, _mm_mul_pd(_mm_cvtepi32_pd(_mm_srli_si128(leftBlock, 8)), _mm_cvtepi32_pd(_mm_srli_si128(rightBlock, 8))));
+        }
+        sum0 = _mm_add_pd(sum0, sum1);
+        sum = _mm_cvtsd_f64(_mm_add_sd(sum0, _mm_unpackhi_pd(sum0, sum0)));
+#endif
+
+        for (; index < count; index++)
+        {
+            sum += static_cast<double>(left[index]) * right[index];
+        }
+
+        return sum;
+    }
+
+    void numeric::prefix_sum(const double *input, double *output, size_t count)
+    {
+        size_t index = 0;
+        double sum = 0;
+
+#ifdef JSRT_SSE2
+        // Scan each pair in register, then add the running total carried from the previous pair.
+        __m128d carry = _mm_setzero_pd();
+        for (; index + 2 <= count; index += 2)
+        {
+            __m128d block = _mm_loadu_pd(input + index);
+            block = _mm_add_pd(block, _mm_castsi128_pd(_mm_slli_si128(_mm_castpd_si128(block), 8)));
+            block = _mm_add_pd(block, carry);
+            _mm_storeu_pd(output + index, block);
+            carry = _mm_unpackhi_pd(block, block);
+        }
+        sum = _mm_cvtsd_f64(carry);
+#endif
+
+        for (; index < count; index++)
+        {
+            sum += input[index];
+            output[index] = sum;
+        }
+    }
+
+    void numeric::prefix_sum(const int *input, int *output, size_t count)
+    {
+        size_t index = 0;
+        unsigned int sum = 0;
+
+#ifdef JSRT_SSE2
+        __m128i carry = _mm_setzero_si128();
+        for (; index + 4 <= count; index += 4)
+        {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input + index));
+            block = _mm_add_epi32(block, _mm_slli_si128(block, 4));
+            block = _mm_add_epi32(block, _mm_slli_si128(block, 8));
+            block = _mm_add_epi32(block, carry);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(output + index), block);
+            carry = _mm_shuffle_epi32(block, _MM_SHUFFLE(3, 3, 3, 3));
+        }
+        sum = static_cast<unsigned int>(_mm_cvtsi128_si32(carry));
+#endif
+
+        for (; index < count; index++)
+        {
+            sum += static_cast<unsigned int>(input[index]);
+            output[index] = static_cast<int>(sum);
+        }
+    }
+
+    double numeric::min(const double *input, size_t count)
+    {
+        size_t index = 0;
+        double result = std::numeric_limits<double>::infinity();
+        bool unordered = false;
+
+#ifdef JSRT_SSE2
+        __m128d minimum = _mm_set1_pd(result);
+        __m128d nan = _mm_setzero_pd();
+        for (; index + 2 <= count; index += 2)
+        {
+            __m128d block = _mm_loadu_pd(input + index);
+            nan = _mm_or_pd(nan, _mm_cmpunord_pd(block, block));
+            minimum = _mm_min_pd(minimum, block);
+        }
+        unordered = _mm_movemask_pd(nan) != 0;
+        result = _mm_cvtsd_f64(_mm_min_sd(minimum, _mm_unpackhi_pd(minimum, minimum)));
+#endif
+
+        for (; index < count; index++)
+        {
+            unordered = unordered || input[index] != input[index];
+            result = input[index] < result ? input[index] : result;
+        }
+
+        return unordered ? std::numeric_limits<double>::quiet_NaN() : result;
+    }
+
+    double numeric::max(const double *input, size_t count)
+    {
+        size_t index = 0;
+        double result = -std::numeric_limits<double>::infinity();
+        bool unordered = false;
+
+#ifdef JSRT_SSE2
+        __m128d maximum = _mm_set1_pd(result);
+        __m128d nan = _mm_setzero_pd();
+        for (; index + 2 <= count; index += 2)
+        {
+            __m128d block = _mm_loadu_pd(input + index);
+            nan = _mm_or_pd(nan, _mm_cmpunord_pd(block, block));
+            maximum = _mm_max_pd(maximum, block);
+        }
+        unordered = _mm_movemask_pd(nan) != 0;
+        result = _mm_cvtsd_f64(_mm_max_sd(maximum, _mm_unpackhi_pd(maximum, maximum)));
+#endif
+
+        for (; index < count; index++)
+        {
+            unordered = unordered || input[index] != input[index];
+            result = input[index] > result ? input[index] : result;
+        }
+
+        return unordered ? std::numeric_limits<double>::quiet_NaN() : result;
+    }
+
+    double numeric::min(const int *input, size_t count)
+    {
+        if (count == 0)
+        {
+            return std::numeric_limits<double>::infinity();
+        }
+
+        size_t index = 0;
+        int result = INT_MAX;
+
+#ifdef JSRT_SSE2
+        // SSE2 has no 32-bit integer minimum, so select with a compare mask.
+        __m128i minimum = _mm_set1_epi32(INT_MAX);
+        for (; index + 4 <= count; index += 4)
+        {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input + index));
+            __m128i less = _mm_cmplt_epi32(block, minimum);
+            minimum = _mm_or_si128(_mm_and_si128(less, block), _mm_andnot_si128(less, minimum));
+        }
+
+        int lanes[4];
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), minimum);
+        for (int lane = 0; lane < 4; lane++)
+        {
+            result = lanes[lane] < result ? lanes[lane] : result;
+        }
+#endif
+
+        for (; index < count; index++)
+        {
+            result = input[index] < result ? input[index] : result;
+        }
+
+        return result;
+    }
+
+    double numeric::max(const int *input, size_t count)
+    {
+        if (count == 0)
+        {
+            return -std::numeric_limits<double>::infinity();
+        }
+
+        size_t index = 0;
+        int result = INT_MIN;
+
+#ifdef JSRT_SSE2
+        __m128i maximum = _mm_set1_epi32(INT_MIN);
+        for (; index + 4 <= count; index += 4)
+        {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input + index));
+            __m128i greater = _mm_cmpgt_epi32(block, maximum);
+            maximum = _mm_or_si128(_mm_and_si128(greater, block), _mm_andnot_si128(greater, maximum));
+        }
+
+        int lanes[4];
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), maximum);
+        for (int lane = 0; lane < 4; lane++)
+        {
+            result = lanes[lane] > result ? lanes[lane] : result;
+        }
+#endif
+
+        for (; index < count; index++)
+        {
+            result = input[index] > result ? input[index] : result;
+        }
+
+        return result;
+    }
+
+    void numeric::histogram(const double *input, size_t count, double low, double high, unsigned int *bins, size_t bin_count)
+    {
+        memset(bins, 0, bin_count * sizeof(unsigned int));
+
+        if (bin_count == 0 || !(low < high))
+        {
+            return;
+        }
+
+        // The increments scatter across the bins, so this loop is left scalar.
+        double scale = bin_count / (high - low);
+        for (size_t index = 0; index < count; index++)
+        {
+            double element = input[index];
+            if (element >= low && element < high)
+            {
+                size_t bin = static_cast<size_t>((element - low) * scale);
+                bins[bin < bin_count ? bin : bin_count - 1]++;
+            }
+        }
+    }
+
+    void numeric::histogram(const int *input, size_t count, double low, double high, unsigned int *bins, size_t bin_count)
+    {
+        memset(bins, 0, bin_count * sizeof(unsigned int));
+
+        if (bin_count == 0 || !(low < high))
+        {
+            return;
+        }
+
+        double scale = bin_count / (high - low);
+        for (size_t index = 0; index < count; index++)
+        {
+            double element = input[index];
+            if (element >= low && element < high)
+            {
+                size_t bin = static_cast<size_t>((element - low) * scale);
+                bins[bin < bin_count ? bin : bin_count - 1]++;
+            }
+        }
+    }
+
+    // Retrieves the storage of a Float64Array, Int32Array or Uint32Array argument, raising a 
+    // TypeError in the script if the argument is anything else.
+    static bool numeric_storage(object argument, unsigned char **data, unsigned int *count, JsTypedArrayType *type)
+    {
+        unsigned int size;
+        int element_size;
+
+        if (JsGetTypedArrayStorage(argument.handle(), data, &size, type, &element_size) != JsNoError ||
+            (*type != JsArrayTypeFloat64 && *type != JsArrayTypeInt32 && *type != JsArrayTypeUint32))
+        {
+            context::set_exception(error::create_type_error(L"Argument must be a Float64Array, Int32Array or Uint32Array."));
+            return false;
+        }
+
+        *count = size / element_size;
+        return true;
+    }
+
+    static bool numeric_mismatch()
+    {
+        context::set_exception(error::create_type_error(L"Arguments must be arrays of the same type and length."));
+        return false;
+    }
+
+    double numeric::dot_callback(const call_info &info, object left, object right)
+    {
+        unsigned char *leftData, *rightData;
+        unsigned int leftCount, rightCount;
+        JsTypedArrayType leftType, rightType;
+
+        if (!numeric_storage(left, &leftData, &leftCount, &leftType) ||
+            !numeric_storage(right, &rightData, &rightCount, &rightType))
+        {
+            return 0;
+        }
+
+        if (leftType != rightType || leftCount != rightCount || leftType == JsArrayTypeUint32)
+        {
+            numeric_mismatch();
+            return 0;
+        }
+
+        return leftType == JsArrayTypeFloat64 ?
+            dot(reinterpret_cast<double *>(leftData), reinterpret_cast<double *>(rightData), leftCount) :
+            dot(reinterpret_cast<int *>(leftData), reinterpret_cast<int *>(rightData), leftCount);
+    }
+
+    void numeric::prefix_sum_callback(const call_info &info, object input, object output)
+    {
+        unsigned char *inputData, *outputData;
+        unsigned int inputCount, outputCount;
+        JsTypedArrayType inputType, outputType;
+
+        if (!numeric_storage(input, &inputData, &inputCount, &inputType) ||
+            !numeric_storage(output, &outputData, &outputCount, &outputType))
+        {
+            return;
+        }
+
+        if (inputType != outputType || inputCount != outputCount || inputType == JsArrayTypeUint32)
+        {
+            numeric_mismatch();
+            return;
+        }
+
+        if (inputType == JsArrayTypeFloat64)
+        {
+            prefix_sum(reinterpret_cast<double *>(inputData), reinterpret_cast<double *>(outputData), inputCount);
+        }
+        else
+        {
+            prefix_sum(reinterpret_cast<int *>(inputData), reinterpret_cast<int *>(outputData), inputCount);
+        }
+    }
+
+    double numeric::min_callback(const call_info &info, object input)
+    {
+        unsigned char *data;
+        unsigned int count;
+        JsTypedArrayType type;
+
+        if (!numeric_storage(input, &data, &count, &type))
+        {
+            return 0;
+        }
+
+        if (type == JsArrayTypeUint32)
+        {
+            numeric_mismatch();
+            return 0;
+        }
+
+        return type == JsArrayTypeFloat64 ?
+            min(reinterpret_cast<double *>(data), count) :
+            min(reinterpret_cast<int *>(data), count);
+    }
+
+    double numeric::max_callback(const call_info &info, object input)
+    {
+        unsigned char *data;
+        unsigned int count;
+        JsTypedArrayType type;
+
+        if (!numeric_storage(input, &data, &count, &type))
+        {
+            return 0;
+        }
+
+        if (type == JsArrayTypeUint32)
+        {
+            numeric_mismatch();
+            return 0;
+        }
+
+        return type == JsArrayTypeFloat64 ?
+            max(reinterpret_cast<double *>(data), count) :
+            max(reinterpret_cast<int *>(data), count);
+    }
+
+    void numeric::histogram_callback(const call_info &info, object input, object bins, double low, double high)
+    {
+        unsigned char *inputData, *binData;
+        unsigned int inputCount, binCount;
+        JsTypedArrayType inputType, binType;
+
+        if (!numeric_storage(input, &inputData, &inputCount, &inputType) ||
+            !numeric_storage(bins, &binData, &binCount, &binType))
+        {
+            return;
+        }
+
+        if (inputType == JsArrayTypeUint32 || binType != JsArrayTypeUint32)
+        {
+            numeric_mismatch();
+            return;
+        }
+
+        if (inputType == JsArrayTypeFloat64)
+        {
+            histogram(reinterpret_cast<double *>(inputData), inputCount, low, high, reinterpret_cast<unsigned int *>(binData), binCount);
+        }
+        else
+        {
+            histogram(reinterpret_cast<int *>(inputData), inputCount, low, high, reinterpret_cast<unsigned int *>(binData), binCount);
+        }
+    }
+
+    void numeric::install(object target)
+    {
+        target.set_property(property_id::create(L"dot"), function<double, object, object>::create(L"dot", dot_callback));
+        target.set_property(property_id::create(L"prefixSum"), function<void, object, object>::create(L"prefixSum", prefix_sum_callback));
+        target.set_property(property_id::create(L"min"), function<double, object>::create(L"min", min_callback));
+        target.set_property(property_id::create(L"max"), function<double, object>::create(L"max", max_callback));
+        target.set_property(property_id::create(L"histogram"), function<void, object, object, double, double>::create(L"histogram", histogram_callback));
+    }
+
+    // Runs cleanup with a context current, then makes the previous context current again. Errors
+    // are ignored, because it is called by destructors.
+    template<class Cleanup>
+    static void cleanup_in_context(JsContextRef context, Cleanup cleanup)
+    {
+        JsContextRef current = JS_INVALID_REFERENCE;
+        JsGetCurrentContext(&current);
+
+        if (current == context)
+        {
+            cleanup();
+        }
+        else if (JsSetCurrentContext(context) == JsNoError)
+        {
+            cleanup();
+            JsSetCurrentContext(current);
+        }
+    }
+
+    microtask_queue::microtask_queue(size_t capacity) :
+        _context(JS_INVALID_REFERENCE),
+        _error(JsNoError),
+        _tasks(),
+        _head(0),
+        _count(0),
+        _task_budget(0),
+        _time_budget(0),
+        _max_depth(0),
+        _tasks_run(0),
+        _drains(0),
+        _last_drain_time(0),
+        _max_drain_time(0)
+    {
+        // Keep the capacity a power of two so positions can wrap with a mask.
+        size_t size = 1;
+        while (size < capacity)
+        {
+            size *= 2;
+        }
+
+        _tasks.resize(size);
+    }
+
+    microtask_queue::~microtask_queue()
+    {
+        // Stop the context from queuing into the queue once it is gone.
+        if (_context != JS_INVALID_REFERENCE)
+        {
+            cleanup_in_context(_context, []() { JsSetPromiseContinuationCallback(nullptr, nullptr); });
+        }
+
+        for (; _count > 0; _count--)
+        {
+            JsRelease(_tasks[_head], nullptr);
+            _head = (_head + 1) & (_tasks.size() - 1);
+        }
+    }
+
+    void CALLBACK microtask_queue::enqueue_thunk(JsValueRef task, void *callbackState)
+    {
+        microtask_queue *queue = static_cast<microtask_queue *>(callbackState);
+
+        // Exceptions can't be thrown back into the engine, so the error is kept for the next drain.
+        try
+        {
+            queue->enqueue(task);
+        }
+        catch (const std::bad_alloc &)
+        {
+            if (queue->_error == JsNoError)
+            {
+                queue->_error = JsErrorOutOfMemory;
+            }
+        }
+    }
+
+    void microtask_queue::enqueue(JsValueRef task)
+    {
+        if (_count == _tasks.size())
+        {
+            // Unwrap the ring into a buffer twice the size.
+            std::vector<JsValueRef> tasks(_tasks.size() * 2);
+            for (size_t index = 0; index < _count; index++)
+            {
+                tasks[index] = _tasks[(_head + index) & (_tasks.size() - 1)];
+            }
+
+            _tasks.swap(tasks);
+            _head = 0;
+        }
+
+        // Tasks are stored outside of the engine, so they have to be pinned until they run.
+        JsErrorCode error = JsAddRef(task, nullptr);
+        if (error != JsNoError)
+        {
+            if (_error == JsNoError)
+            {
+                _error = error;
+            }
+            return;
+        }
+
+        _tasks[(_head + _count) & (_tasks.size() - 1)] = task;
+        _count++;
+        _max_depth = (std::max)(_max_depth, _count);
+    }
+
+    void microtask_queue::install()
+    {
+        JsContextRef context;
+        runtime::translate_error_code(JsGetCurrentContext(&context));
+        runtime::translate_error_code(JsSetPromiseContinuationCallback(enqueue_thunk, this));
+        _context = context;
+    }
+
+    microtask_queue::statistics microtask_queue::stats() const
+    {
+        statistics result;
+        result.depth = _count;
+        result.max_depth = _max_depth;
+        result.tasks_run = _tasks_run;
+        result.drains = _drains;
+        result.last_drain_time = _last_drain_time;
+        result.max_drain_time = _max_drain_time;
+        return result;
+    }
+
+    size_t microtask_queue::drain()
+    {
+        if (_error != JsNoError)
+        {
+            JsErrorCode error = _error;
+            _error = JsNoError;
+            runtime::translate_error_code(error);
+        }
+
+        if (_count == 0)
+        {
+            return 0;
+        }
+
+        JsValueRef undefinedValue;
+        runtime::translate_error_code(JsGetUndefinedValue(&undefinedValue));
+
+        auto start = std::chrono::steady_clock::now();
+        size_t run = 0;
+        JsErrorCode error = JsNoError;
+
+        while (_count > 0 && error == JsNoError)
+        {
+            if ((_task_budget != 0 && run >= _task_budget) ||
+                (_time_budget.count() != 0 && run > 0 && std::chrono::steady_clock::now() - start >= _time_budget))
+            {
+                break;
+            }
+
+            JsValueRef task = _tasks[_head];
+            _head = (_head + 1) & (_tasks.size() - 1);
+            _count--;
+
+            JsValueRef result;
+            error = JsCallFunction(task, &undefinedValue, 1, &result);
+            JsRelease(task, nullptr);
+            run++;
+        }
+
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+        _tasks_run += run;
+        _drains++;
+        _last_drain_time = elapsed;
+        _max_drain_time = (std::max)(_max_drain_time, elapsed);
+
+        runtime::translate_error_code(error);
+        return run;
+    }
+
+    void microtask_queue::run(const std::wstring &script)
+    {
+        context::run(script);
+        drain();
+    }
+
+    value microtask_queue::evaluate(const std::wstring &script)
+    {
+        value result = context::evaluate(script);
+        drain();
+        return result;
+    }
+
+    static std::vector<unsigned char> processor_information(LOGICAL_PROCESSOR_RELATIONSHIP relationship)
+    {
+        std::vector<unsigned char> buffer;
+        DWORD length = 0;
+
+        if (!GetLogicalProcessorInformationEx(relationship, nullptr, &length) && GetLastError() == ERROR_INSUFFICIENT_BUFFER)
+        {
+            buffer.resize(length);
+            if (!GetLogicalProcessorInformationEx(relationship, reinterpret_cast<PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX>(buffer.data()), &length))
+            {
+                buffer.clear();
+            }
+        }
+
+        return buffer;
+    }
+
+    thread_placement::thread_placement(placement_policy policy) :
+        _policy(policy),
+        _slots(),
+        _node_count(1)
+    {
+        if (policy == placement_policy::none)
+        {
+            return;
+        }
+
+        struct node_processors
+        {
+            slot node;
+            std::vector<unsigned long long> cores;
+        };
+
+        std::vector<node_processors> nodes;
+        std::vector<unsigned char> buffer = processor_information(RelationNumaNode);
+        for (size_t offset = 0; offset < buffer.size(); offset += reinterpret_cast<PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX>(&buffer[offset])->Size)
+        {
+            PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX entry = reinterpret_cast<PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX>(&buffer[offset]);
+            node_processors found;
+            found.node.group = entry->NumaNode.GroupMask.Group;
+            found.node.mask = entry->NumaNode.GroupMask.Mask;
+            found.node.node = entry->NumaNode.NodeNumber;
+            nodes.push_back(found);
+        }
+
+        std::sort(nodes.begin(), nodes.end(), [](const node_processors &left, const node_processors &right) { return left.node.node < right.node.node; });
+
+        buffer = processor_information(RelationProcessorCore);
+        for (size_t offset = 0; offset < buffer.size(); offset += reinterpret_cast<PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX>(&buffer[offset])->Size)
+        {
+            const GROUP_AFFINITY &core = reinterpret_cast<PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX>(&buffer[offset])->Processor.GroupMask[0];
+            for (node_processors &node : nodes)
+            {
+                if (core.Mask != 0 && node.node.group == core.Group && (core.Mask & node.node.mask) == core.Mask)
+                {
+                    node.cores.push_back(core.Mask);
+                    break;
+                }
+            }
+        }
+
+        // Nodes with only memory have no processors to place threads on.
+        nodes.erase(std::remove_if(nodes.begin(), nodes.end(), [](const node_processors &node) { return node.cores.empty(); }), nodes.end());
+        if (nodes.empty())
+        {
+            return;
+        }
+
+        _node_count = nodes.size();
+
+        if (policy == placement_policy::nodes)
+        {
+            for (const node_processors &node : nodes)
+            {
+                _slots.push_back(node.node);
+            }
+            return;
+        }
+
+        // Take one core from each node in turn, so that consecutive slots are on different nodes.
+        for (size_t round = 0; ; round++)
+        {
+            size_t added = 0;
+            for (const node_processors &node : nodes)
+            {
+                if (round < node.cores.size())
+                {
+                    slot core = node.node;
+                    core.mask = node.cores[round];
+                    _slots.push_back(core);
+                    added++;
+                }
+            }
+
+            if (added == 0)
+            {
+                break;
+            }
+        }
+    }
+
+    bool thread_placement::apply(size_t worker) const
+    {
+        if (_slots.empty())
+        {
+            return false;
+        }
+
+        const slot &target = _slots[worker % _slots.size()];
+        GROUP_AFFINITY affinity;
+        std::memset(&affinity, 0, sizeof(affinity));
+        affinity.Mask = static_cast<KAFFINITY>(target.mask);
+        affinity.Group = target.group;
+        return SetThreadGroupAffinity(GetCurrentThread(), &affinity, nullptr) != FALSE;
+    }
+
+    thread_pool::thread_pool(unsigned int thread_count, const thread_placement &placement) :
+        _work(),
+        _threads(),
+        _placement(placement),
+        _stopping(false)
+    {
+        if (thread_count == 0)
+        {
+            thread_count = (std::max)(std::thread::hardware_concurrency(), 1u);
+        }
+
+        try
+        {
+            _threads.reserve(thread_count);
+            for (unsigned int index = 0; index < thread_count; index++)
+            {
+                _threads.emplace_back(&thread_pool::work, this, static_cast<size_t>(index));
+            }
+        }
+        catch (...)
+        {
+            {
+                std::lock_guard<std::mutex> guard(_lock);
+                _stopping = true;
+            }
+            _available.notify_all();
+
+            for (std::thread &thread : _threads)
+            {
+                thread.join();
+            }
+            throw;
+        }
+    }
+
+    thread_pool::~thread_pool()
+    {
+        {
+            std::lock_guard<std::mutex> guard(_lock);
+            _stopping = true;
+        }
+        _available.notify_all();
+
+        for (std::thread &thread : _threads)
+        {
+            thread.join();
+        }
+    }
+
+    void thread_pool::submit(std::function<void()> work)
+    {
+        if (!work)
+        {
+            runtime::translate_error_code(JsErrorInvalidArgument);
+        }
+
+        {
+            std::lock_guard<std::mutex> guard(_lock);
+            _work.push_back(std::move(work));
+        }
+        _available.notify_one();
+    }
+
+    void thread_pool::work(size_t index)
+    {
+        _placement.apply(index);
+
+        for (;;)
+        {
+            std::function<void()> item;
+            {
+                std::unique_lock<std::mutex> guard(_lock);
+                _available.wait(guard, [this] { return _stopping || !_work.empty(); });
+
+                // Work that was submitted before the pool stopped is still run.
+                if (_work.empty())
+                {
+                    return;
+                }
+
+                item = std::move(_work.front());
+                _work.pop_front();
+            }
+
+            try
+            {
+                item();
+            }
+            catch (...)
+            {
+            }
+        }
+    }
+
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+    completion_queue::completion_queue() :
+        _posted(nullptr),
+        _timer(nullptr),
+        _completions(),
+        _outstanding(0)
+    {
+        _posted = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+
+        // High-resolution timers are only available on newer versions of Windows.
+        _timer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+        if (_timer == nullptr)
+        {
+            _timer = CreateWaitableTimerExW(nullptr, nullptr, 0, TIMER_ALL_ACCESS);
+        }
+
+        if (_posted == nullptr || _timer == nullptr)
+        {
+            close_handles();
+            runtime::translate_error_code(JsErrorOutOfMemory);
+        }
+    }
+
+    completion_queue::~completion_queue()
+    {
+        close_handles();
+    }
+
+    void completion_queue::close_handles()
+    {
+        if (_posted != nullptr)
+        {
+            CloseHandle(_posted);
+            _posted = nullptr;
+        }
+
+        if (_timer != nullptr)
+        {
+            CloseHandle(_timer);
+            _timer = nullptr;
+        }
+    }
+
+    bool completion_queue::ready() const
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        return !_completions.empty();
+    }
+
+    void completion_queue::post(std::function<void()> completion)
+    {
+        if (!completion)
+        {
+            runtime::translate_error_code(JsErrorInvalidArgument);
+        }
+
+        {
+            std::lock_guard<std::mutex> guard(_lock);
+            _completions.push_back(std::move(completion));
+        }
+        SetEvent(_posted);
+    }
+
+    bool completion_queue::wait_until(std::chrono::steady_clock::time_point deadline)
+    {
+        // The event stays set if a completion is posted after this check, so it isn't missed.
+        if (ready())
+        {
+            return true;
+        }
+
+        if (deadline == std::chrono::steady_clock::time_point::max())
+        {
+            WaitForSingleObject(_posted, INFINITE);
+            return ready();
+        }
+
+        auto remaining = deadline - std::chrono::steady_clock::now();
+        if (remaining <= std::chrono::steady_clock::duration::zero())
+        {
+            return false;
+        }
+
+        // A negative due time is relative, in units of 100 nanoseconds.
+        LARGE_INTEGER due;
+        due.QuadPart = -((std::chrono::duration_cast<std::chrono::nanoseconds>(remaining).count() + 99) / 100);
+
+        HANDLE handles[] = { _posted, _timer };
+        if (SetWaitableTimer(_timer, &due, 0, nullptr, nullptr, FALSE))
+        {
+            WaitForMultipleObjects(2, handles, FALSE, INFINITE);
+        }
+
+        return ready();
+    }
+
+    size_t completion_queue::drain()
+    {
+        std::vector<std::function<void()>> running;
+        {
+            std::lock_guard<std::mutex> guard(_lock);
+            running.swap(_completions);
+        }
+
+        size_t index = 0;
+        try
+        {
+            for (; index < running.size(); index++)
+            {
+                std::function<void()> completion = std::move(running[index]);
+                if (_outstanding > 0)
+                {
+                    _outstanding--;
+                }
+                completion();
+            }
+        }
+        catch (...)
+        {
+            // Put the completions that have not run back ahead of any posted since.
+            std::lock_guard<std::mutex> guard(_lock);
+            _completions.insert(_completions.begin(), std::make_move_iterator(running.begin() + index + 1), std::make_move_iterator(running.end()));
+            throw;
+        }
+
+        return index;
+    }
+
+    event_loop::event_loop() :
+        _microtasks(),
+        _completions(),
+        _start(std::chrono::steady_clock::now()),
+        _now(0),
+        _timers(),
+        _free(),
+        _due(),
+        _next_due(0),
+        _next_id(1),
+        _stopped(false),
+        _context(JS_INVALID_REFERENCE)
+    {
+        memset(_heads, 0, sizeof(_heads));
+        memset(_tails, 0, sizeof(_tails));
+        memset(_occupied, 0, sizeof(_occupied));
+    }
+
+    event_loop::~event_loop()
+    {
+        // The timer functions hold a pointer to the loop, so script must not reach them once it 
+        // is gone.
+        if (_context != JS_INVALID_REFERENCE)
+        {
+            cleanup_in_context(_context, []()
+            {
+                static const wchar_t *const names[] = { L"setTimeout", L"setInterval", L"clearTimeout", L"clearInterval" };
+                JsValueRef globalObject;
+                if (JsGetGlobalObject(&globalObject) == JsNoError)
+                {
+                    for (const wchar_t *name : names)
+                    {
+                        JsPropertyIdRef id;
+                        JsValueRef result;
+                        if (JsGetPropertyIdFromName(name, &id) == JsNoError)
+                        {
+                            JsDeleteProperty(globalObject, id, false, &result);
+                        }
+                    }
+                }
+            });
+        }
+
+        for (auto &entry : _timers)
+        {
+            if (entry.second->level >= 0)
+            {
+                unlink(entry.second);
+            }
+            release(entry.second);
+        }
+
+        for (timer *entry : _free)
+        {
+            delete entry;
+        }
+    }
+
+    static void event_loop_define(JsValueRef target, const wchar_t *name, JsNativeFunction function, void *state)
+    {
+        JsValueRef nameValue;
+        JsValueRef functionValue;
+        JsPropertyIdRef id;
+        runtime::translate_error_code(JsPointerToString(name, wcslen(name), &nameValue));
+        runtime::translate_error_code(JsCreateNamedFunction(nameValue, function, state, &functionValue));
+        runtime::translate_error_code(JsGetPropertyIdFromName(name, &id));
+        runtime::translate_error_code(JsSetProperty(target, id, functionValue, true));
+    }
+
+    void event_loop::install()
+    {
+        JsValueRef globalObject;
+        runtime::translate_error_code(JsGetCurrentContext(&_context));
+        runtime::translate_error_code(JsGetGlobalObject(&globalObject));
+        event_loop_define(globalObject, L"setTimeout", set_timeout_thunk, this);
+        event_loop_define(globalObject, L"setInterval", set_interval_thunk, this);
+        event_loop_define(globalObject, L"clearTimeout", clear_thunk, this);
+        event_loop_define(globalObject, L"clearInterval", clear_thunk, this);
+        _microtasks.install();
+    }
+
+    JsValueRef event_loop::add_from_script(event_loop *loop, bool repeat, JsValueRef *arguments, unsigned short argument_count)
+    {
+        try
+        {
+            JsValueType type = JsUndefined;
+            if (argument_count < 2 || JsGetValueType(arguments[1], &type) != JsNoError || type != JsFunction)
+            {
+                context::set_exception(error::create_type_error(L"Callback is not a function."));
+                return JS_INVALID_REFERENCE;
+            }
+
+            double delay = 0;
+            if (argument_count > 2)
+            {
+                JsValueRef delayValue;
+                runtime::translate_error_code(JsConvertValueToNumber(arguments[2], &delayValue));
+                runtime::translate_error_code(JsNumberToDouble(delayValue, &delay));
+            }
+
+            unsigned int id = loop->add(arguments[1], delay, repeat, arguments + (std::min)(argument_count, static_cast<unsigned short>(3)), argument_count > 3 ? argument_count - 3 : 0);
+
+            JsValueRef result;
+            runtime::translate_error_code(JsDoubleToNumber(static_cast<double>(id), &result));
+            return result;
+        }
+        catch (...)
+        {
+            context::set_exception(error::create(L"Fatal error."));
+            return JS_INVALID_REFERENCE;
+        }
+    }
+
+    JsValueRef CALLBACK event_loop::set_timeout_thunk(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, void *callback_state)
+    {
+        return add_from_script(static_cast<event_loop *>(callback_state), false, arguments, argument_count);
+    }
+
+    JsValueRef CALLBACK event_loop::set_interval_thunk(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, void *callback_state)
+    {
+        return add_from_script(static_cast<event_loop *>(callback_state), true, arguments, argument_count);
+    }
+
+    JsValueRef CALLBACK event_loop::clear_thunk(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, void *callback_state)
+    {
+        JsValueRef result;
+        JsValueRef idValue;
+        double id;
+
+        // Like the browser functions, anything that isn't a timer ID is ignored.
+        if (argument_count > 1 &&
+            JsConvertValueToNumber(arguments[1], &idValue) == JsNoError &&
+            JsNumberToDouble(idValue, &id) == JsNoError &&
+            id >= 1 && id <= UINT_MAX)
+        {
+            static_cast<event_loop *>(callback_state)->clear(static_cast<unsigned int>(id));
+        }
+
+        return JsGetUndefinedValue(&result) == JsNoError ? result : JS_INVALID_REFERENCE;
+    }
+
+    unsigned int event_loop::add(JsValueRef callback, double delay, bool repeat, const JsValueRef *arguments, size_t argument_count)
+    {
+        // Timers always wait at least until the next tick, and NaN counts as no delay.
+        unsigned int ticks = 1;
+        if (delay > 1)
+        {
+            ticks = delay >= INT_MAX ? INT_MAX : static_cast<unsigned int>(delay);
+        }
+
+        timer *entry;
+        if (_free.empty())
+        {
+            entry = new timer();
+        }
+        else
+        {
+            entry = _free.back();
+            _free.pop_back();
+        }
+
+        // Skip IDs that are still in use after the counter wraps around.
+        do
+        {
+            entry->id = _next_id++;
+            if (_next_id == 0)
+            {
+                _next_id = 1;
+            }
+        }
+        while (_timers.count(entry->id) != 0);
+
+        entry->callback = callback;
+        entry->arguments.assign(arguments, arguments + argument_count);
+        entry->repeat = repeat;
+        entry->interval = ticks;
+
+        JsAddRef(entry->callback, nullptr);
+        for (JsValueRef argument : entry->arguments)
+        {
+            JsAddRef(argument, nullptr);
+        }
+
+        // The wheel may not have caught up with the clock, so measure the delay from the clock.
+        entry->deadline = (std::max)(_now, elapsed()) + ticks;
+        link(entry);
+        _timers[entry->id] = entry;
+        return entry->id;
+    }
+
+    unsigned int event_loop::set_timeout(function_base callback, std::chrono::milliseconds delay)
+    {
+        return add(callback.handle(), static_cast<double>(delay.count()), false, nullptr, 0);
+    }
+
+    unsigned int event_loop::set_interval(function_base callback, std::chrono::milliseconds interval)
+    {
+        return add(callback.handle(), static_cast<double>(interval.count()), true, nullptr, 0);
+    }
+
+    void event_loop::link(timer *entry)
+    {
+        unsigned long long delta = entry->deadline > _now ? entry->deadline - _now : 0;
+
+        // Each level holds the deadlines that are less than slot_count of its slots away.
+        int level = 0;
+        while (level < level_count - 1 && delta >= (1ULL << (slot_bits * (level + 1))))
+        {
+            level++;
+        }
+
+        int slot = static_cast<int>((entry->deadline >> (slot_bits * level)) & (slot_count - 1));
+
+        entry->level = level;
+        entry->slot = slot;
+        entry->next = nullptr;
+        entry->previous = _tails[level][slot];
+
+        if (entry->previous == nullptr)
+        {
+            _heads[level][slot] = entry;
+        }
+        else
+        {
+            entry->previous->next = entry;
+        }
+
+        _tails[level][slot] = entry;
+        _occupied[level] |= 1ULL << slot;
+    }
+
+    void event_loop::unlink(timer *entry)
+    {
+        int level = entry->level;
+        int slot = entry->slot;
+
+        if (entry->previous == nullptr)
+        {
+            _heads[level][slot] = entry->next;
+        }
+        else
+        {
+            entry->previous->next = entry->next;
+        }
+
+        if (entry->next == nullptr)
+        {
+            _tails[level][slot] = entry->previous;
+        }
+        else
+        {
+            entry->next->previous = entry->previous;
+        }
+
+        if (_heads[level][slot] == nullptr)
+        {
+            _occupied[level] &= ~(1ULL << slot);
+        }
+
+        entry->level = -1;
+    }
+
+    void event_loop::release(timer *entry)
+    {
+        JsRelease(entry->callback, nullptr);
+        for (JsValueRef argument : entry->arguments)
+        {
+            JsRelease(argument, nullptr);
+        }
+
+        entry->arguments.clear();
+        _free.push_back(entry);
+    }
+
+    void event_loop::clear(unsigned int id)
+    {
+        auto position = _timers.find(id);
+        if (position == _timers.end())
+        {
+            return;
+        }
+
+        timer *entry = position->second;
+        _timers.erase(position);
+
+        // Timers that are due have already been taken out of the wheel.
+        if (entry->level >= 0)
+        {
+            unlink(entry);
+        }
+
+        release(entry);
+    }
+
+    void event_loop::cascade(int level)
+    {
+        int slot = static_cast<int>((_now >> (slot_bits * level)) & (slot_count - 1));
+        timer *entry = _heads[level][slot];
+
+        _heads[level][slot] = nullptr;
+        _tails[level][slot] = nullptr;
+        _occupied[level] &= ~(1ULL << slot);
+
+        while (entry != nullptr)
+        {
+            timer *next = entry->next;
+            link(entry);
+            entry = next;
+        }
+    }
+
+    void event_loop::collect(int slot)
+    {
+        size_t first = _due.size();
+
+        for (timer *entry = _heads[0][slot]; entry != nullptr; entry = entry->next)
+        {
+            entry->level = -1;
+            _due.push_back(entry->id);
+        }
+
+        _heads[0][slot] = nullptr;
+        _tails[0][slot] = nullptr;
+        _occupied[0] &= ~(1ULL << slot);
+
+        // Every timer in a slot has the same deadline, but cascading can mix up the order they
+        // were added in.
+        std::sort(_due.begin() + first, _due.end());
+    }
+
+    void event_loop::advance(unsigned long long target)
+    {
+        while (_now < target && !_stopped)
+        {
+            fire_due();
+
+            bool empty = true;
+            for (int level = 0; level < level_count; level++)
+            {
+                empty = empty && _occupied[level] == 0;
+            }
+
+            if (empty)
+            {
+                _now = target;
+                break;
+            }
+
+            // Nothing can happen before the next cascade if the first level is empty.
+            if (_occupied[0] == 0)
+            {
+                unsigned long long boundary = ((_now >> slot_bits) + 1) << slot_bits;
+                if (boundary > target)
+                {
+                    _now = target;
+                    break;
+                }
+
+                _now = boundary - 1;
+            }
+
+            _now++;
+
+            for (int level = level_count - 1; level > 0; level--)
+            {
+                if ((_now & ((1ULL << (slot_bits * level)) - 1)) == 0)
+                {
+                    cascade(level);
+                }
+            }
+
+            collect(static_cast<int>(_now & (slot_count - 1)));
+        }
+
+        fire_due();
+    }
+
+    void event_loop::fire_due()
+    {
+        JsValueRef undefinedValue;
+        runtime::translate_error_code(JsGetUndefinedValue(&undefinedValue));
+
+        while (_next_due < _due.size() && !_stopped)
+        {
+            auto position = _timers.find(_due[_next_due++]);
+            if (position == _timers.end())
+            {
+                // Cleared by an earlier callback.
+                continue;
+            }
+
+            timer *entry = position->second;
+            if (entry->level >= 0)
+            {
+                // Cleared, and the ID reused by a new timer.
+                continue;
+            }
+
+            std::vector<JsValueRef> arguments(1, undefinedValue);
+            arguments.insert(arguments.end(), entry->arguments.begin(), entry->arguments.end());
+            JsValueRef callback = entry->callback;
+            bool repeat = entry->repeat;
+
+            if (repeat)
+            {
+                entry->deadline = _now + entry->interval;
+                link(entry);
+                JsAddRef(callback, nullptr);
+            }
+            else
+            {
+                // Keep the callback and arguments alive until the call is done.
+                _timers.erase(position);
+                entry->arguments.clear();
+                _free.push_back(entry);
+            }
+
+            JsValueRef result;
+            JsErrorCode error = JsCallFunction(callback, arguments.data(), static_cast<unsigned short>(arguments.size()), &result);
+
+            JsRelease(callback, nullptr);
+            if (!repeat)
+            {
+                for (size_t index = 1; index < arguments.size(); index++)
+                {
+                    JsRelease(arguments[index], nullptr);
+                }
+            }
+
+            runtime::translate_error_code(error);
+            _microtasks.drain();
+        }
+
+        if (_next_due == _due.size())
+        {
+            _due.clear();
+            _next_due = 0;
+        }
+    }
+
+    unsigned long long event_loop::elapsed() const
+    {
+        return static_cast<unsigned long long>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - _start).count());
+    }
+
+    unsigned long long event_loop::next_deadline() const
+    {
+        unsigned long long deadline = ULLONG_MAX;
+
+        // In the first level, every timer in a slot is due at the slot's time.
+        for (unsigned long long tick = _now + 1; tick < _now + slot_count && _occupied[0] != 0; tick++)
+        {
+            if (_heads[0][tick & (slot_count - 1)] != nullptr)
+            {
+                deadline = tick;
+                break;
+            }
+        }
+
+        // In higher levels, only the first slot that will be cascaded has to be searched, but a 
+        // higher level can still have an earlier deadline than a lower one.
+        for (int level = 1; level < level_count; level++)
+        {
+            if (_occupied[level] == 0)
+            {
+                continue;
+            }
+
+            unsigned long long current = _now >> (slot_bits * level);
+            for (unsigned long long index = current + 1; index <= current + slot_count; index++)
+            {
+                const timer *entry = _heads[level][index & (slot_count - 1)];
+                if (entry == nullptr)
+                {
+                    continue;
+                }
+
+                for (; entry != nullptr; entry = entry->next)
+                {
+                    deadline = (std::min)(deadline, entry->deadline);
+                }
+                break;
+            }
+        }
+
+        return deadline;
+    }
+
+    bool event_loop::run_once()
+    {
+        _stopped = false;
+        _completions.drain();
+        _microtasks.drain();
+        advance((std::max)(_now, elapsed()));
+        return !_timers.empty() || _completions.outstanding() != 0;
+    }
+
+    void event_loop::run()
+    {
+        _stopped = false;
+        _completions.drain();
+        _microtasks.drain();
+
+        while ((!_timers.empty() || _completions.outstanding() != 0) && !_stopped)
+        {
+            unsigned long long next = next_deadline();
+            if (_microtasks.depth() == 0 && _next_due == _due.size() && !_completions.ready())
+            {
+                if (next == ULLONG_MAX)
+                {
+                    if (_timers.empty())
+                    {
+                        _completions.wait_until(std::chrono::steady_clock::time_point::max());
+                    }
+                }
+                else
+                {
+                    // A posted completion ends the wait early.
+                    _completions.wait_until(_start + std::chrono::milliseconds(next));
+                }
+            }
+
+            _completions.drain();
+            _microtasks.drain();
+            advance((std::max)(_now, elapsed()));
+        }
+    }
+
+    runtime_dispatcher::runtime_dispatcher(JsRuntimeAttributes attributes) :
+        _head(&_stub),
+        _tail(&_stub),
+        _scheduled(false),
+        _calls(0),
+        _batches(0),
+        _largest_batch(0),
+        _stopping(false),
+        _loop(nullptr)
+    {
+        _stub.next.store(nullptr);
+        _stub.complete = nullptr;
+
+        std::promise<void> started;
+        std::future<void> ready = started.get_future();
+        _thread = std::thread(&runtime_dispatcher::main, this, attributes, &started);
+
+        try
+        {
+            ready.get();
+        }
+        catch (...)
+        {
+            _thread.join();
+            throw;
+        }
+    }
+
+    runtime_dispatcher::~runtime_dispatcher()
+    {
+        _loop->completions().post([this]()
+        {
+            _stopping = true;
+            _loop->stop();
+        });
+        _thread.join();
+    }
+
+    void runtime_dispatcher::main(JsRuntimeAttributes attributes, std::promise<void> *started)
+    {
+        runtime runtime;
+
+        try
+        {
+            runtime = runtime::create(attributes);
+            context context = runtime.create_context();
+            context::scope scope(context);
+            event_loop loop;
+            loop.install();
+
+            // The loop always expects one completion, either the next drain or the stop, so 
+            // that it waits for calls when no timers are pending.
+            loop.completions().expect();
+            _loop = &loop;
+            started->set_value();
+
+            // Calls report their own exceptions to their callers, so anything else that escapes 
+            // the loop is ignored. Leaving early would leave _loop pointing at a dead loop.
+            while (!_stopping)
+            {
+                try
+                {
+                    loop.run();
+                }
+                catch (...)
+                {
+                }
+            }
+
+            // Run the calls that were queued before the dispatcher stopped.
+            while (call_node *call = unlink())
+            {
+                call->complete(call, true);
+            }
+
+            _loop = nullptr;
+        }
+        catch (...)
+        {
+            if (_loop == nullptr)
+            {
+                started->set_exception(std::current_exception());
+            }
+        }
+
+        if (runtime.is_valid())
+        {
+            runtime.dispose();
+        }
+    }
+
+    void runtime_dispatcher::link(call_node *call)
+    {
+        call->next.store(nullptr, std::memory_order_relaxed);
+        call_node *previous = _head.exchange(call, std::memory_order_acq_rel);
+        previous->next.store(call, std::memory_order_release);
+    }
+
+    runtime_dispatcher::call_node *runtime_dispatcher::unlink()
+    {
+        call_node *tail = _tail;
+        call_node *next = tail->next.load(std::memory_order_acquire);
+
+        if (tail == &_stub)
+        {
+            if (next == nullptr)
+            {
+                return nullptr;
+            }
+
+            _tail = next;
+            tail = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+
+        if (next != nullptr)
+        {
+            _tail = next;
+            return tail;
+        }
+
+        // The last call can only be taken once another node follows it. If a call is still 
+        // being linked, it is taken by the drain that its enqueue schedules.
+        if (tail != _head.load(std::memory_order_acquire))
+        {
+            return nullptr;
+        }
+
+        link(&_stub);
+        next = tail->next.load(std::memory_order_acquire);
+        if (next != nullptr)
+        {
+            _tail = next;
+            return tail;
+        }
+
+        return nullptr;
+    }
+
+    void runtime_dispatcher::enqueue(call_node *call)
+    {
+        link(call);
+
+        // Only the first call since the last drain wakes the dispatcher's thread.
+        if (!_scheduled.exchange(true))
+        {
+            _loop->completions().post([this]() { drain(); });
+        }
+    }
+
+    void runtime_dispatcher::drain()
+    {
+        _loop->completions().expect();
+
+        // Calls linked after this are either taken by this drain or schedule another one.
+        _scheduled.exchange(false, std::memory_order_acq_rel);
+
+        size_t count = 0;
+        while (call_node *call = unlink())
+        {
+            // Count the call first, so that its caller sees it in the statistics.
+            _calls++;
+            count++;
+            call->complete(call, true);
+        }
+
+        if (count > 0)
+        {
+            _batches++;
+            if (count > _largest_batch.load())
+            {
+                _largest_batch.store(count);
+            }
+        }
+    }
+
+    runtime_dispatcher::statistics runtime_dispatcher::stats() const
+    {
+        statistics result;
+        result.calls = _calls.load();
+        result.batches = _batches.load();
+        result.largest_batch = _largest_batch.load();
+        return result;
+    }
+
+    thread_local script_executor::worker *script_executor::current_worker = nullptr;
+
+    script_executor::script_executor(unsigned int worker_count, JsRuntimeAttributes attributes, const thread_placement &placement) :
+        _workers(),
+        _scripts(),
+        _pending(0),
+        _sleeping(0),
+        _next_worker(0),
+        _tasks(0),
+        _steals(0),
+        _placement(placement),
+        _stopping(false)
+    {
+        if (worker_count == 0)
+        {
+            worker_count = (std::max)(std::thread::hardware_concurrency(), 1u);
+        }
+
+        // The workers report whether they created their runtimes, so that failures are thrown 
+        // to the caller.
+        std::vector<std::promise<void>> started(worker_count);
+
+        try
+        {
+            for (unsigned int index = 0; index < worker_count; index++)
+            {
+                _workers.push_back(std::unique_ptr<worker>(new worker()));
+                _workers.back()->executor = this;
+            }
+
+            for (size_t index = 0; index < _workers.size(); index++)
+            {
+                _workers[index]->thread = std::thread(&script_executor::work, this, index, attributes, &started[index]);
+            }
+
+            for (std::promise<void> &worker_started : started)
+            {
+                worker_started.get_future().get();
+            }
+        }
+        catch (...)
+        {
+            stop();
+            throw;
+        }
+    }
+
+    script_executor::~script_executor()
+    {
+        stop();
+    }
+
+    void script_executor::stop()
+    {
+        {
+            std::lock_guard<std::mutex> guard(_lock);
+            _stopping = true;
+        }
+        _available.notify_all();
+
+        for (auto &entry : _workers)
+        {
+            if (entry->thread.joinable())
+            {
+                entry->thread.join();
+            }
+        }
+
+        for (auto &entry : _workers)
+        {
+            if (entry->script_runtime.is_valid())
+            {
+                entry->script_runtime.dispose();
+            }
+        }
+    }
+
+    void script_executor::work(size_t index, JsRuntimeAttributes attributes, std::promise<void> *started)
+    {
+        worker &self = *_workers[index];
+
+        // The runtime is created after the thread is placed, so that its memory is first touched
+        // on the thread's node.
+        try
+        {
+            _placement.apply(index);
+            self.script_runtime = runtime::create(attributes);
+            self.script_context = self.script_runtime.create_context();
+            started->set_value();
+        }
+        catch (...)
+        {
+            started->set_exception(std::current_exception());
+            return;
+        }
+
+        current_worker = &self;
+
+        {
+            context::scope scope(self.script_context);
+            microtask_queue microtasks;
+            microtasks.install();
+
+            for (;;)
+            {
+                task_node *task = take(index);
+                if (task != nullptr)
+                {
+                    // Count the task first, so that its caller sees it in the statistics.
+                    _tasks++;
+                    task->finish(task, &self);
+
+                    try
+                    {
+                        microtasks.drain();
+                    }
+                    catch (const exception &)
+                    {
+                    }
+                    continue;
+                }
+
+                std::unique_lock<std::mutex> guard(_lock);
+                _sleeping++;
+                _available.wait(guard, [this] { return _stopping || _pending.load() > 0; });
+                _sleeping--;
+
+                if (_stopping && _pending.load() == 0)
+                {
+                    break;
+                }
+            }
+
+            self.scripts.clear();
+        }
+
+        current_worker = nullptr;
+    }
+
+    void script_executor::enqueue(task_node *task)
+    {
+        worker *target = current_worker != nullptr && current_worker->executor == this ?
+            current_worker :
+            _workers[_next_worker++ % _workers.size()].get();
+
+        try
+        {
+            std::lock_guard<std::mutex> guard(target->lock);
+            target->tasks.push_back(task);
+        }
+        catch (...)
+        {
+            task->finish(task, nullptr);
+            throw;
+        }
+
+        // A worker counts itself as sleeping before it checks for pending tasks, so either it 
+        // sees this task or it is notified.
+        _pending++;
+        if (_sleeping.load() > 0)
+        {
+            std::lock_guard<std::mutex> guard(_lock);
+            _available.notify_one();
+        }
+    }
+
+    script_executor::task_node *script_executor::take(size_t index)
+    {
+        task_node *task = nullptr;
+        worker &self = *_workers[index];
+
+        {
+            std::lock_guard<std::mutex> guard(self.lock);
+            if (!self.tasks.empty())
+            {
+                task = self.tasks.front();
+                self.tasks.pop_front();
+            }
+        }
+
+        // Steal from the other end of the other queues, so that a thief rarely contends with 
+        // the owner for the same task.
+        for (size_t offset = 1; task == nullptr && offset < _workers.size(); offset++)
+        {
+            worker &victim = *_workers[(index + offset) % _workers.size()];
+            std::lock_guard<std::mutex> guard(victim.lock);
+            if (!victim.tasks.empty())
+            {
+                task = victim.tasks.back();
+                victim.tasks.pop_back();
+                _steals++;
+            }
+        }
+
+        if (task != nullptr)
+        {
+            _pending--;
+        }
+
+        return task;
+    }
+
+    value script_executor::load(worker &owner, unsigned int script)
+    {
+        if (script < owner.scripts.size() && owner.scripts[script]->is_valid())
+        {
+            return *owner.scripts[script];
+        }
+
+        script_entry *entry;
+        {
+            std::lock_guard<std::mutex> guard(_scripts_lock);
+            if (script >= _scripts.size())
+            {
+                runtime::translate_error_code(JsErrorInvalidArgument);
+            }
+            entry = &_scripts[script];
+        }
+
+        // The serialized script is shared by all of the runtimes, so it has to outlive them.
+        std::call_once(entry->serialize_once, [entry]()
+        {
+            unsigned long size = context::serialize(entry->source, nullptr, 0);
+            entry->serialized.resize(size);
+            context::serialize(entry->source, entry->serialized.data(), size);
+        });
+
+        value function = context::evaluate_serialized(entry->source, entry->serialized.data());
+        if (function.type() != JsFunction)
+        {
+            runtime::translate_error_code(JsErrorInvalidArgument);
+        }
+
+        if (owner.scripts.size() <= script)
+        {
+            owner.scripts.resize(script + 1);
+        }
+        owner.scripts[script] = pinned<value>(function);
+        return function;
+    }
+
+    unsigned int script_executor::add_script(const std::wstring &source)
+    {
+        std::lock_guard<std::mutex> guard(_scripts_lock);
+        _scripts.emplace_back();
+        _scripts.back().source = source;
+        return static_cast<unsigned int>(_scripts.size() - 1);
+    }
+
+    script_executor::statistics script_executor::stats() const
+    {
+        statistics result;
+        result.tasks = _tasks.load();
+        result.steals = _steals.load();
+        return result;
+    }
+
+    thread_local fiber_scheduler::fiber *fiber_scheduler::current_fiber = nullptr;
+
+    fiber_scheduler::fiber_scheduler(JsRuntimeAttributes attributes, size_t stack_size) :
+        _fibers(),
+        _next_id(0),
+        _stack_size(stack_size),
+        _attributes(attributes),
+        _main_fiber(nullptr),
+        _running(false)
+    {
+    }
+
+    fiber_scheduler::~fiber_scheduler()
+    {
+        for (auto &entry : _fibers)
+        {
+            DeleteFiber(entry.second->handle);
+        }
+    }
+
+    void CALLBACK fiber_scheduler::start(void *parameter)
+    {
+        fiber &self = *static_cast<fiber *>(parameter);
+        runtime fiber_runtime;
+
+        try
+        {
+            // The runtime is created and disposed on the fiber, so it only ever runs on the 
+            // fiber's stack.
+            fiber_runtime = runtime::create(self.scheduler->_attributes);
+            context fiber_context = fiber_runtime.create_context();
+            context::scope scope(fiber_context);
+            microtask_queue microtasks;
+            microtasks.install();
+            self.microtasks = &microtasks;
+
+            try
+            {
+                self.scheduler->run_inbox(self);
+                self.body();
+                microtasks.drain();
+            }
+            catch (...)
+            {
+                self.microtasks = nullptr;
+                throw;
+            }
+
+            self.microtasks = nullptr;
+        }
+        catch (...)
+        {
+            self.failure = std::current_exception();
+        }
+
+        try
+        {
+            if (fiber_runtime.is_valid())
+            {
+                fiber_runtime.dispose();
+            }
+        }
+        catch (...)
+        {
+            if (!self.failure)
+            {
+                self.failure = std::current_exception();
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> guard(self.scheduler->_lock);
+            self.finished = true;
+        }
+
+        // Returning from a fiber's start routine would end the thread, so switch back instead.
+        SwitchToFiber(self.scheduler->_main_fiber);
+    }
+
+    fiber_scheduler::fiber &fiber_scheduler::running()
+    {
+        if (current_fiber == nullptr)
+        {
+            runtime::translate_error_code(JsErrorWrongThread);
+        }
+
+        return *current_fiber;
+    }
+
+    void fiber_scheduler::schedule(fiber &target)
+    {
+        if (!target.queued && !target.finished)
+        {
+            target.queued = true;
+            _ready.push_back(&target);
+        }
+    }
+
+    void fiber_scheduler::leave(fiber &self)
+    {
+        // A thread has one current context, so the fiber's context is made current again when 
+        // the fiber resumes. This fails if script is running on the fiber.
+        context previous = context::current();
+        runtime::translate_error_code(JsSetCurrentContext(JS_INVALID_REFERENCE));
+        SwitchToFiber(_main_fiber);
+        runtime::translate_error_code(JsSetCurrentContext(previous.handle()));
+        run_inbox(self);
+    }
+
+    void fiber_scheduler::run_inbox(fiber &self)
+    {
+        std::vector<std::function<void()>> work;
+
+        {
+            std::lock_guard<std::mutex> guard(_lock);
+            work.swap(self.inbox);
+        }
+
+        for (size_t index = 0; index < work.size(); index++)
+        {
+            try
+            {
+                work[index]();
+            }
+            catch (...)
+            {
+                // Keep the work that hasn't run for the next time the fiber resumes.
+                std::lock_guard<std::mutex> guard(_lock);
+                self.inbox.insert(self.inbox.begin(), std::make_move_iterator(work.begin() + index + 1), std::make_move_iterator(work.end()));
+                if (!self.inbox.empty())
+                {
+                    schedule(self);
+                }
+                throw;
+            }
+        }
+
+        self.microtasks->drain();
+    }
+
+    size_t fiber_scheduler::size()
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        return _fibers.size();
+    }
+
+    unsigned int fiber_scheduler::spawn(std::function<void()> body)
+    {
+        if (!body)
+        {
+            runtime::translate_error_code(JsErrorNullArgument);
+        }
+
+        std::unique_ptr<fiber> created(new fiber());
+        created->scheduler = this;
+        created->handle = nullptr;
+        created->body = std::move(body);
+        created->microtasks = nullptr;
+        created->queued = false;
+        created->finished = false;
+
+        std::lock_guard<std::mutex> guard(_lock);
+        if (_running && std::this_thread::get_id() != _thread)
+        {
+            runtime::translate_error_code(JsErrorWrongThread);
+        }
+
+        created->handle = CreateFiberEx(0, _stack_size, FIBER_FLAG_FLOAT_SWITCH, &fiber_scheduler::start, created.get());
+        if (created->handle == nullptr)
+        {
+            runtime::translate_error_code(JsErrorOutOfMemory);
+        }
+
+        unsigned int id = _next_id++;
+        created->id = id;
+        fiber &target = *created;
+        _fibers[id] = std::move(created);
+        schedule(target);
+        return id;
+    }
+
+    void fiber_scheduler::post(unsigned int id, std::function<void()> work)
+    {
+        if (!work)
+        {
+            runtime::translate_error_code(JsErrorNullArgument);
+        }
+
+        {
+            std::lock_guard<std::mutex> guard(_lock);
+            auto found = _fibers.find(id);
+            if (found == _fibers.end() || found->second->finished)
+            {
+                runtime::translate_error_code(JsErrorInvalidArgument);
+            }
+
+            found->second->inbox.push_back(std::move(work));
+            schedule(*found->second);
+        }
+
+        _ready_changed.notify_one();
+    }
+
+    void fiber_scheduler::run()
+    {
+        {
+            std::lock_guard<std::mutex> guard(_lock);
+            if (_running || current_fiber != nullptr)
+            {
+                runtime::translate_error_code(JsErrorInvalidArgument);
+            }
+
+            _running = true;
+            _thread = std::this_thread::get_id();
+        }
+
+        bool converted = true;
+        _main_fiber = ConvertThreadToFiber(nullptr);
+        if (_main_fiber == nullptr)
+        {
+            if (GetLastError() != ERROR_ALREADY_FIBER)
+            {
+                std::lock_guard<std::mutex> guard(_lock);
+                _running = false;
+                runtime::translate_error_code(JsErrorOutOfMemory);
+            }
+
+            converted = false;
+            _main_fiber = GetCurrentFiber();
+        }
+
+        std::exception_ptr failure;
+
+        for (;;)
+        {
+            fiber *next;
+
+            {
+                std::unique_lock<std::mutex> guard(_lock);
+                _ready_changed.wait(guard, [this]() { return !_ready.empty() || _fibers.empty(); });
+                if (_ready.empty())
+                {
+                    break;
+                }
+
+                next = _ready.front();
+                _ready.pop_front();
+                next->queued = false;
+            }
+
+            current_fiber = next;
+            SwitchToFiber(next->handle);
+            current_fiber = nullptr;
+
+            if (next->finished)
+            {
+                if (next->failure && !failure)
+                {
+                    failure = next->failure;
+                }
+
+                DeleteFiber(next->handle);
+
+                std::lock_guard<std::mutex> guard(_lock);
+                if (next->queued)
+                {
+                    _ready.erase(std::find(_ready.begin(), _ready.end(), next));
+                }
+                _fibers.erase(next->id);
+            }
+        }
+
+        if (converted)
+        {
+            ConvertFiberToThread();
+        }
+
+        _main_fiber = nullptr;
+
+        {
+            std::lock_guard<std::mutex> guard(_lock);
+            _running = false;
+        }
+
+        if (failure)
+        {
+            std::rethrow_exception(failure);
+        }
+    }
+
+    unsigned int fiber_scheduler::current()
+    {
+        return running().id;
+    }
+
+    fiber_scheduler &fiber_scheduler::current_scheduler()
+    {
+        return *running().scheduler;
+    }
+
+    void fiber_scheduler::yield()
+    {
+        fiber &self = running();
+
+        {
+            std::lock_guard<std::mutex> guard(self.scheduler->_lock);
+            self.scheduler->schedule(self);
+        }
+
+        self.scheduler->leave(self);
+    }
+
+    void fiber_scheduler::suspend()
+    {
+        fiber &self = running();
+        self.scheduler->leave(self);
+    }
+
+    thread_local unsigned int context::scope::depth = 0;
+
+    unsigned int runtime_handle::scope_depth()
+    {
+        return context::scope::depth;
+    }
+
+    runtime_handle runtime_handle::create(JsRuntimeAttributes attributes)
+    {
+        runtime_handle result;
+        result._state = std::make_shared<state>();
+        result._state->attached = false;
+        result._state->migrations = 0;
+        result._state->script_runtime = runtime::create(attributes);
+
+        try
+        {
+            result._state->script_context = result._state->script_runtime.create_context();
+        }
+        catch (...)
+        {
+            result._state->script_runtime.dispose();
+            throw;
+        }
+
+        return result;
+    }
+
+    bool runtime_handle::is_valid() const
+    {
+        if (!_state)
+        {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> guard(_state->lock);
+        return _state->script_runtime.is_valid();
+    }
+
+    bool runtime_handle::is_attached() const
+    {
+        if (!_state)
+        {
+            runtime::translate_error_code(JsErrorInvalidArgument);
+        }
+
+        std::lock_guard<std::mutex> guard(_state->lock);
+        return _state->attached;
+    }
+
+    std::thread::id runtime_handle::thread_id() const
+    {
+        if (!_state)
+        {
+            runtime::translate_error_code(JsErrorInvalidArgument);
+        }
+
+        std::lock_guard<std::mutex> guard(_state->lock);
+        return _state->thread;
+    }
+
+    unsigned long long runtime_handle::migrations() const
+    {
+        if (!_state)
+        {
+            runtime::translate_error_code(JsErrorInvalidArgument);
+        }
+
+        std::lock_guard<std::mutex> guard(_state->lock);
+        return _state->migrations;
+    }
+
+    runtime runtime_handle::script_runtime() const
+    {
+        if (!_state)
+        {
+            runtime::translate_error_code(JsErrorInvalidArgument);
+        }
+
+        std::lock_guard<std::mutex> guard(_state->lock);
+        return _state->script_runtime;
+    }
+
+    context runtime_handle::script_context() const
+    {
+        if (!_state)
+        {
+            runtime::translate_error_code(JsErrorInvalidArgument);
+        }
+
+        std::lock_guard<std::mutex> guard(_state->lock);
+        return _state->script_context;
+    }
+
+    runtime_handle::lease runtime_handle::attach() const
+    {
+        if (!_state)
+        {
+            runtime::translate_error_code(JsErrorInvalidArgument);
+        }
+
+        JsContextRef previous;
+        runtime::translate_error_code(JsGetCurrentContext(&previous));
+
+        {
+            std::lock_guard<std::mutex> guard(_state->lock);
+            if (!_state->script_runtime.is_valid())
+            {
+                runtime::translate_error_code(JsErrorInvalidArgument);
+            }
+
+            if (_state->attached)
+            {
+                runtime::translate_error_code(JsErrorRuntimeInUse);
+            }
+
+            _state->attached = true;
+        }
+
+        JsErrorCode error = JsSetCurrentContext(_state->script_context.handle());
+
+        std::lock_guard<std::mutex> guard(_state->lock);
+        if (error != JsNoError)
+        {
+            _state->attached = false;
+            runtime::translate_error_code(error);
+        }
+
+        if (_state->thread != std::this_thread::get_id())
+        {
+            if (_state->thread != std::thread::id())
+            {
+                _state->migrations++;
+            }
+            _state->thread = std::this_thread::get_id();
+        }
+
+        return lease(_state, previous);
+    }
+
+    void runtime_handle::dispose()
+    {
+        if (!_state)
+        {
+            runtime::translate_error_code(JsErrorInvalidArgument);
+        }
+
+        std::lock_guard<std::mutex> guard(_state->lock);
+        if (_state->attached)
+        {
+            runtime::translate_error_code(JsErrorRuntimeInUse);
+        }
+
+        if (_state->script_runtime.is_valid())
+        {
+            _state->script_runtime.dispose();
+            _state->script_runtime = runtime();
+            _state->script_context = context();
+        }
+    }
+
+    runtime_handle::lease::lease(std::shared_ptr<state> attached, JsContextRef previous) :
+        _state(std::move(attached)),
+        _previous(previous),
+        _depth(scope_depth())
+    {
+    }
+
+    runtime_handle::lease::~lease()
+    {
+        if (_state)
+        {
+            JsSetCurrentContext(_previous);
+
+            std::lock_guard<std::mutex> guard(_state->lock);
+            _state->attached = false;
+        }
+    }
+
+    void runtime_handle::lease::detach()
+    {
+        if (!_state)
+        {
+            runtime::translate_error_code(JsErrorInvalidArgument);
+        }
+
+        if (std::this_thread::get_id() != _state->thread)
+        {
+            runtime::translate_error_code(JsErrorWrongThread);
+        }
+
+        // A scope created under the lease would use the runtime from this thread after the 
+        // runtime moves to another one.
+        JsContextRef current;
+        runtime::translate_error_code(JsGetCurrentContext(&current));
+        if (scope_depth() != _depth || current != _state->script_context.handle())
+        {
+            runtime::translate_error_code(JsErrorRuntimeInUse);
+        }
+
+        runtime::translate_error_code(JsSetCurrentContext(_previous));
+
+        {
+            std::lock_guard<std::mutex> guard(_state->lock);
+            _state->attached = false;
+        }
+
+        _state.reset();
+    }
+
+    runtime_balancer::runtime_balancer(unsigned int thread_count, JsRuntimeAttributes attributes, const thread_placement &placement) :
+        _workers(),
+        _tenants(),
+        _attributes(attributes),
+        _placement(placement),
+        _tasks(0),
+        _migrations(0),
+        _stopping(false)
+    {
+        if (thread_count == 0)
+        {
+            thread_count = (std::max)(std::thread::hardware_concurrency(), 1u);
+        }
+
+        for (unsigned int index = 0; index < thread_count; index++)
+        {
+            _workers.push_back(std::unique_ptr<worker>(new worker()));
+            _workers.back()->tenants = 0;
+            _workers.back()->busy = std::chrono::nanoseconds::zero();
+        }
+
+        try
+        {
+            for (size_t index = 0; index < _workers.size(); index++)
+            {
+                _workers[index]->thread = std::thread(&runtime_balancer::work, this, index);
+            }
+        }
+        catch (...)
+        {
+            stop();
+            throw;
+        }
+    }
+
+    runtime_balancer::~runtime_balancer()
+    {
+        stop();
+    }
+
+    void runtime_balancer::stop()
+    {
+        {
+            std::lock_guard<std::mutex> guard(_lock);
+            _stopping = true;
+            for (auto &entry : _workers)
+            {
+                entry->available.notify_all();
+            }
+        }
+
+        for (auto &entry : _workers)
+        {
+            if (entry->thread.joinable())
+            {
+                entry->thread.join();
+            }
+        }
+
+        for (auto &entry : _tenants)
+        {
+            if (entry->handle.is_valid())
+            {
+                {
+                    runtime_handle::lease lease = entry->handle.attach();
+                    entry->microtasks.reset();
+                }
+                entry->handle.dispose();
+            }
+        }
+    }
+
+    void runtime_balancer::schedule(tenant &target)
+    {
+        if (!target.queued && !target.running && !target.work.empty())
+        {
+            worker &owner = *_workers[target.worker];
+            target.queued = true;
+            owner.ready.push_back(&target);
+            owner.available.notify_one();
+        }
+    }
+
+    void runtime_balancer::enqueue(unsigned int id, std::function<void()> work)
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        if (id >= _tenants.size())
+        {
+            runtime::translate_error_code(JsErrorInvalidArgument);
+        }
+
+        tenant &target = *_tenants[id];
+        target.work.push_back(std::move(work));
+        schedule(target);
+    }
+
+    void runtime_balancer::work(size_t index)
+    {
+        worker &self = *_workers[index];
+        _placement.apply(index);
+        std::unique_lock<std::mutex> guard(_lock);
+
+        for (;;)
+        {
+            self.available.wait(guard, [this, &self]() { return _stopping || !self.ready.empty(); });
+            if (self.ready.empty())
+            {
+                break;
+            }
+
+            tenant &target = *self.ready.front();
+            self.ready.pop_front();
+            target.queued = false;
+            target.running = true;
+
+            std::deque<std::function<void()>> batch;
+            batch.swap(target.work);
+            _tasks += batch.size();
+            guard.unlock();
+
+            bool detached = false;
+            std::exception_ptr failure;
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+            try
+            {
+                if (!target.handle.is_valid())
+                {
+                    // The runtime is created by its thread, so that its memory is first touched 
+                    // on the thread's node.
+                    target.handle = runtime_handle::create(_attributes);
+                }
+
+                runtime_handle::lease lease = target.handle.attach();
+                if (!target.microtasks)
+                {
+                    target.microtasks.reset(new microtask_queue());
+                    target.microtasks->install();
+                }
+
+                // The work is packaged, so its exceptions are stored in its future.
+                for (std::function<void()> &item : batch)
+                {
+                    item();
+                }
+                batch.clear();
+
+                for (;;)
+                {
+                    try
+                    {
+                        target.microtasks->drain();
+                        break;
+                    }
+                    catch (const exception &)
+                    {
+                    }
+                }
+
+                lease.detach();
+                detached = true;
+            }
+            catch (...)
+            {
+                if (target.starting)
+                {
+                    failure = std::current_exception();
+                }
+
+                // A queue that failed to install, or whose runtime didn't detach cleanly, is 
+                // installed again by the next batch. Its destructor makes its own context 
+                // current, as the lease is already gone.
+                target.microtasks.reset();
+            }
+
+            std::chrono::nanoseconds elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+
+            guard.lock();
+            target.busy += elapsed;
+            self.busy += elapsed;
+            target.running = false;
+            if (!detached)
+            {
+                target.movable = false;
+            }
+            schedule(target);
+
+            // add_tenant waits for the first batch, which creates the runtime. It takes the lock
+            // before it touches the tenant again, so this is the last use of a tenant that failed.
+            if (target.starting)
+            {
+                target.starting = false;
+                if (failure)
+                {
+                    target.started.set_exception(failure);
+                }
+                else
+                {
+                    target.started.set_value();
+                }
+            }
+        }
+    }
+
+    unsigned int runtime_balancer::add_tenant()
+    {
+        std::unique_ptr<tenant> created(new tenant());
+        created->queued = false;
+        created->running = false;
+        created->movable = true;
+        created->starting = true;
+        created->busy = std::chrono::nanoseconds::zero();
+        std::future<void> ready = created->started.get_future();
+
+        {
+            // Consecutive workers are on different nodes, so filling the lowest worker with the 
+            // fewest tenants spreads tenants across nodes.
+            std::lock_guard<std::mutex> guard(_lock);
+            size_t coldest = 0;
+            for (size_t index = 1; index < _workers.size(); index++)
+            {
+                if (_workers[index]->tenants < _workers[coldest]->tenants)
+                {
+                    coldest = index;
+                }
+            }
+
+            // The first batch is empty, so it creates the runtime without counting as a task.
+            // The tenant isn't registered until then, so nothing else can reach it.
+            created->worker = coldest;
+            created->queued = true;
+            _workers[coldest]->tenants++;
+            _workers[coldest]->ready.push_back(created.get());
+            _workers[coldest]->available.notify_one();
+        }
+
+        try
+        {
+            ready.get();
+        }
+        catch (...)
+        {
+            {
+                std::lock_guard<std::mutex> guard(_lock);
+                _workers[created->worker]->tenants--;
+            }
+
+            if (created->handle.is_valid())
+            {
+                created->handle.dispose();
+            }
+            throw;
+        }
+
+        std::lock_guard<std::mutex> guard(_lock);
+        _tenants.push_back(std::move(created));
+        return static_cast<unsigned int>(_tenants.size() - 1);
+    }
+
+    size_t runtime_balancer::worker_of(unsigned int id)
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        if (id >= _tenants.size())
+        {
+            runtime::translate_error_code(JsErrorInvalidArgument);
+        }
+
+        return _tenants[id]->worker;
+    }
+
+    size_t runtime_balancer::rebalance()
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        size_t hottest = 0;
+        for (size_t index = 1; index < _workers.size(); index++)
+        {
+            if (_workers[index]->busy > _workers[hottest]->busy)
+            {
+                hottest = index;
+            }
+        }
+
+        // Pinned runtimes only move within a node, so their memory stays local.
+        bool same_node = _placement.size() > 0;
+        size_t coldest = hottest;
+        for (size_t index = 0; index < _workers.size(); index++)
+        {
+            if ((!same_node || _placement.node_of(index) == _placement.node_of(hottest)) && _workers[index]->busy < _workers[coldest]->busy)
+            {
+                coldest = index;
+            }
+        }
+
+        std::vector<tenant *> candidates;
+        for (auto &entry : _tenants)
+        {
+            if (entry->worker == hottest && entry->movable && !entry->running)
+            {
+                candidates.push_back(entry.get());
+            }
+        }
+
+        // Try the busiest tenants first, so the fewest tenants are moved.
+        std::sort(candidates.begin(), candidates.end(), [](const tenant *left, const tenant *right) { return left->busy > right->busy; });
+
+        worker &hot = *_workers[hottest];
+        worker &cold = *_workers[coldest];
+        std::chrono::nanoseconds hot_busy = hot.busy;
+        std::chrono::nanoseconds cold_busy = cold.busy;
+        size_t moved = 0;
+
+        for (tenant *candidate : candidates)
+        {
+            if (hottest == coldest || cold_busy + candidate->busy >= hot_busy)
+            {
+                continue;
+            }
+
+            if (candidate->queued)
+            {
+                hot.ready.erase(std::find(hot.ready.begin(), hot.ready.end(), candidate));
+                cold.ready.push_back(candidate);
+                cold.available.notify_one();
+            }
+
+            candidate->worker = coldest;
+            hot.tenants--;
+            cold.tenants++;
+            hot_busy -= candidate->busy;
+            cold_busy += candidate->busy;
+            moved++;
+        }
+
+        _migrations += moved;
+
+        for (auto &entry : _workers)
+        {
+            entry->busy = std::chrono::nanoseconds::zero();
+        }
+
+        for (auto &entry : _tenants)
+        {
+            entry->busy = std::chrono::nanoseconds::zero();
+        }
+
+        return moved;
+    }
+
+    runtime_balancer::statistics runtime_balancer::stats()
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        statistics result;
+        result.tasks = _tasks;
+        result.migrations = _migrations;
+        return result;
+    }
+
+    typedef std::pair<JsRuntimeHandle, const void *> property_id_cache_key;
+
+    static std::mutex property_id_cache_lock;
+    static std::map<property_id_cache_key, std::vector<JsPropertyIdRef>> property_id_cache_entries;
+
+    // Bumped when a runtime's entries are cleared, so threads drop their copies.
+    static std::atomic<unsigned long long> property_id_cache_generation(0);
+
+    // Each thread keeps the entries it has used, so that only the first lookup of an entry on a 
+    // thread takes the lock.
+    struct property_id_thread_cache
+    {
+        unsigned long long generation;
+        JsContextRef context;
+        JsRuntimeHandle runtime;
+        std::map<property_id_cache_key, const JsPropertyIdRef *> entries;
+    };
+
+    static thread_local property_id_thread_cache property_id_local_cache;
+
+    static JsErrorCode property_id_cache_runtime(JsRuntimeHandle *runtime)
+    {
+        JsContextRef context;
+
+        JsErrorCode error = JsGetCurrentContext(&context);
+        if (error != JsNoError)
+        {
+            return error;
+        }
+
+        if (context == JS_INVALID_REFERENCE)
+        {
+            return JsErrorNoCurrentContext;
+        }
+
+        property_id_thread_cache &local = property_id_local_cache;
+        unsigned long long generation = property_id_cache_generation.load(std::memory_order_acquire);
+        if (local.generation != generation)
+        {
+            local.entries.clear();
+            local.context = JS_INVALID_REFERENCE;
+            local.generation = generation;
+        }
+
+        if (local.context != context)
+        {
+            error = JsGetRuntime(context, &local.runtime);
+            if (error != JsNoError)
+            {
+                local.context = JS_INVALID_REFERENCE;
+                return error;
+            }
+
+            local.context = context;
+        }
+
+        *runtime = local.runtime;
+        return JsNoError;
+    }
+
+    JsErrorCode property_id_cache::get(const void *key, const std::vector<const wchar_t *> &names, const JsPropertyIdRef **result)
+    {
+        JsRuntimeHandle runtime;
+
+        JsErrorCode error = property_id_cache_runtime(&runtime);
+        if (error != JsNoError)
+        {
+            return error;
+        }
+
+        property_id_cache_key cacheKey(runtime, key);
+        auto local = property_id_local_cache.entries.find(cacheKey);
+        if (local != property_id_local_cache.entries.end())
+        {
+            *result = local->second;
+            return JsNoError;
+        }
+
+        std::lock_guard<std::mutex> guard(property_id_cache_lock);
+        auto entry = property_id_cache_entries.find(cacheKey);
+
+        if (entry == property_id_cache_entries.end())
+        {
+            std::vector<JsPropertyIdRef> ids(names.size());
+
+            for (size_t index = 0; index < names.size(); index++)
+            {
+                error = JsGetPropertyIdFromName(names[index], &ids[index]);
+
+                // Property IDs can be collected, so hold on to them for the life of the runtime.
+                if (error == JsNoError)
+                {
+                    error = JsAddRef(ids[index], nullptr);
+                }
+
+                if (error != JsNoError)
+                {
+                    for (size_t added = 0; added < index; added++)
+                    {
+                        JsRelease(ids[added], nullptr);
+                    }
+                    return error;
+                }
+            }
+
+            entry = property_id_cache_entries.insert(std::make_pair(cacheKey, std::move(ids))).first;
+        }
+
+        *result = entry->second.data();
+        property_id_local_cache.entries[cacheKey] = *result;
+        return JsNoError;
+    }
+
+    JsErrorCode property_id_cache::get_symbol(const wchar_t *name, JsPropertyIdRef *result)
+    {
+        JsRuntimeHandle runtime;
+
+        JsErrorCode error = property_id_cache_runtime(&runtime);
+        if (error != JsNoError)
+        {
+            return error;
+        }
+
+        property_id_cache_key cacheKey(runtime, name);
+        auto local = property_id_local_cache.entries.find(cacheKey);
+        if (local != property_id_local_cache.entries.end())
+        {
+            *result = *local->second;
+            return JsNoError;
+        }
+
+        std::lock_guard<std::mutex> guard(property_id_cache_lock);
+        auto entry = property_id_cache_entries.find(cacheKey);
+
+        if (entry == property_id_cache_entries.end())
+        {
+            JsValueRef globalObject;
+            JsPropertyIdRef symbolName;
+            JsValueRef symbolConstructor;
+            JsPropertyIdRef wellKnownName;
+            JsValueRef symbol;
+            JsPropertyIdRef id;
+
+            error = JsGetGlobalObject(&globalObject);
+            if (error != JsNoError)
+            {
+                return error;
+            }
+
+            error = JsGetPropertyIdFromName(L"Symbol", &symbolName);
+            if (error != JsNoError)
+            {
+                return error;
+            }
+
+            error = JsGetProperty(globalObject, symbolName, &symbolConstructor);
+            if (error != JsNoError)
+            {
+                return error;
+            }
+
+            error = JsGetPropertyIdFromName(name, &wellKnownName);
+            if (error != JsNoError)
+            {
+                return error;
+            }
+
+            error = JsGetProperty(symbolConstructor, wellKnownName, &symbol);
+            if (error != JsNoError)
+            {
+                return error;
+            }
+
+            error = JsGetPropertyIdFromSymbol(symbol, &id);
+            if (error != JsNoError)
+            {
+                return error;
+            }
+
+            // Property IDs can be collected, so hold on to them for the life of the runtime.
+            error = JsAddRef(id, nullptr);
+            if (error != JsNoError)
+            {
+                return error;
+            }
+
+            entry = property_id_cache_entries.insert(std::make_pair(cacheKey, std::vector<JsPropertyIdRef>(1, id))).first;
+        }
+
+        *result = entry->second[0];
+        property_id_local_cache.entries[cacheKey] = entry->second.data();
+        return JsNoError;
+    }
+
+    JsErrorCode property_id_cache::get_script(const void *key, const wchar_t *script, JsValueRef *result)
+    {
+        JsRuntimeHandle runtime;
+
+        JsErrorCode error = property_id_cache_runtime(&runtime);
+        if (error != JsNoError)
+        {
+            return error;
+        }
+
+        // The value is stored on the global object under a symbol that only the cache holds, 
+        // so it is freed with the context. The symbol is created once per runtime.
+        JsPropertyIdRef id;
+        property_id_cache_key cacheKey(runtime, key);
+        auto local = property_id_local_cache.entries.find(cacheKey);
+        if (local != property_id_local_cache.entries.end())
+        {
+            id = *local->second;
+        }
+        else
+        {
+            std::lock_guard<std::mutex> guard(property_id_cache_lock);
+            auto entry = property_id_cache_entries.find(cacheKey);
+
+            if (entry == property_id_cache_entries.end())
+            {
+                JsValueRef symbol;
+
+                error = JsCreateSymbol(JS_INVALID_REFERENCE, &symbol);
+                if (error != JsNoError)
+                {
+                    return error;
+                }
+
+                error = JsGetPropertyIdFromSymbol(symbol, &id);
+                if (error != JsNoError)
+                {
+                    return error;
+                }
+
+                // Property IDs can be collected, so hold on to them for the life of the runtime.
+                error = JsAddRef(id, nullptr);
+                if (error != JsNoError)
+                {
+                    return error;
+                }
+
+                entry = property_id_cache_entries.insert(std::make_pair(cacheKey, std::vector<JsPropertyIdRef>(1, id))).first;
+            }
+
+            id = entry->second[0];
+            property_id_local_cache.entries[cacheKey] = entry->second.data();
+        }
+
+        JsValueRef globalObject;
+        JsValueRef value;
+        JsValueType type;
+
+        error = JsGetGlobalObject(&globalObject);
+        if (error != JsNoError)
+        {
+            return error;
+        }
+
+        error = JsGetProperty(globalObject, id, &value);
+        if (error != JsNoError)
+        {
+            return error;
+        }
+
+        error = JsGetValueType(value, &type);
+        if (error != JsNoError)
+        {
+            return error;
+        }
+
+        if (type == JsUndefined)
+        {
+            error = JsRunScript(script, JS_SOURCE_CONTEXT_NONE, L"", &value);
+            if (error != JsNoError)
+            {
+                return error;
+            }
+
+            error = JsSetProperty(globalObject, id, value, true);
+            if (error != JsNoError)
+            {
+                return error;
+            }
+        }
+
+        *result = value;
+        return JsNoError;
+    }
+
+    void property_id_cache::clear(JsRuntimeHandle runtime)
+    {
+        std::lock_guard<std::mutex> guard(property_id_cache_lock);
+        auto entry = property_id_cache_entries.lower_bound(std::make_pair(runtime, static_cast<const void *>(nullptr)));
+
+        while (entry != property_id_cache_entries.end() && entry->first.first == runtime)
+        {
+            entry = property_id_cache_entries.erase(entry);
+        }
+
+        property_id_cache_generation.fetch_add(1, std::memory_order_release);
+    }
+
     void runtime::dispose()
     {
         // TODO: Throws an access violation in this case, which shouldn't happen
@@ -34,6 +3231,7 @@ namespace jsrt
             throw invalid_argument_exception();
         }
         runtime::translate_error_code(JsDisposeRuntime(_handle));
+        property_id_cache::clear(_handle);
         _handle = JS_INVALID_RUNTIME_HANDLE;
     }
 
@@ -23,6 +23,26 @@
 #include <initializer_list>
 #include <functional>
 #include <memory>
+#include <cstring>
+#include <iterator>
+#include <type_traits>
+#include <array>
+#include <cstdint>
+#include <climits>
+#include <cmath>
+#include <limits>
+#include <tuple>
+#include <map>
+#include <unordered_map>
+#include <new>
+#include <utility>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <future>
 
 #pragma once
 
@@ -46,6 +66,14 @@ namespace jsrt
     class array;
     template<class T, bool clamped = false>
     class typed_array;
+    template<class T, unsigned int Rank, bool clamped = false>
+    class ndarray;
+    template<class T>
+    class buffer_view;
+    template<class T, bool clamped = false>
+    class typed_result;
+    template<class T>
+    class task;
 
     /// <summary>
     ///     Specified the endedness of an operation.
@@ -527,6 +555,11 @@ namespace jsrt
         /// </remarks>
         class scope
         {
+            friend class runtime_handle;
+
+            // The number of scopes that are alive on this thread.
+            static thread_local unsigned int depth;
+
             JsContextRef previousContext;
 
             // Disallow some operators to keep the scope on the stack, where it belongs.
@@ -544,10 +577,12 @@ namespace jsrt
             {
                 runtime::translate_error_code(JsGetCurrentContext(&(this->previousContext)));
                 runtime::translate_error_code(JsSetCurrentContext(context._ref));
+                depth++;
             }
 
             ~scope()
             {
+                depth--;
                 runtime::translate_error_code(JsSetCurrentContext(this->previousContext));
             }
         };
@@ -1131,4451 +1166,5012 @@ namespace jsrt
         }
     };
 
-	/// <summary>
-	///		A class to marshal values to/from native.
-	/// </summary>
-	class marshal
-	{
-	public:
-		template<class T>
-		static JsErrorCode to_native(JsValueRef value, T *result);
+    /// <summary>
+    ///     A field of a native structure that is marshalled as a property of a JavaScript object.
+    /// </summary>
+    template<class Struct, class T>
+    struct struct_field
+    {
+        /// <summary>
+        ///     The name of the property.
+        /// </summary>
+        const wchar_t *name;
 
-		template<class T>
-		static JsErrorCode to_native(JsValueRef value, optional<T> *result);
+        /// <summary>
+        ///     The field.
+        /// </summary>
+        T Struct::*member;
+    };
 
-		template<class T>
-		static JsErrorCode from_native(T value, JsValueRef *result);
+    /// <summary>
+    ///     Creates a <c>struct_field</c>.
+    /// </summary>
+    /// <param name="name">The name of the property.</param>
+    /// <param name="member">The field.</param>
+    /// <returns>The field description.</returns>
+    template<class Struct, class T>
+    struct_field<Struct, T> field(const wchar_t *name, T Struct::*member)
+    {
+        struct_field<Struct, T> result = { name, member };
+        return result;
+    }
 
-		template<class T>
-		static JsErrorCode from_native(optional<T> value, JsValueRef *result);
-	};
+    /// <summary>
+    ///     The base of <c>struct_type</c> specializations.
+    /// </summary>
+    struct struct_mapping
+    {
+    };
 
-	template<>
-	JsErrorCode marshal::to_native(JsValueRef value, symbol *result);
+    /// <summary>
+    ///     The fields of a native structure that is marshalled to and from JavaScript objects.
+    /// </summary>
+    /// <remarks>
+    ///     <para>
+    ///     To make a structure marshallable, specialize this template for the structure, derive
+    ///     the specialization from <c>struct_mapping</c> and give it a static <c>fields</c>
+    ///     function that returns a tuple of <c>struct_field</c>. For example:
+    ///     </para>
+    ///     <code>
+    ///     template&lt;&gt;
+    ///     struct struct_type&lt;point&gt; : struct_mapping
+    ///     {
+    ///         static auto fields()
+    ///         {
+    ///             return std::make_tuple(field(L"x", &amp;point::x), field(L"y", &amp;point::y));
+    ///         }
+    ///     };
+    ///     </code>
+    ///     <para>
+    ///     The structure must be default constructible. Fields can be of any marshallable type, 
+    ///     including other mapped structures and <c>std::vector</c>. An <c>optional</c> field that
+    ///     is missing is not set on the object, and an undefined property becomes a missing 
+    ///     <c>optional</c> field.
+    ///     </para>
+    /// </remarks>
+    template<class Struct>
+    struct struct_type
+    {
+    };
 
-	template<>
-	JsErrorCode marshal::to_native<int>(JsValueRef value, int *result);
+    /// <summary>
+    ///     Whether a native structure has a <c>struct_type</c> specialization.
+    /// </summary>
+    template<class T>
+    struct is_mapped_struct : std::is_base_of<struct_mapping, struct_type<T>>
+    {
+    };
 
-	template<>
-	JsErrorCode marshal::to_native<double>(JsValueRef value, double *result);
+    /// <summary>
+    ///     Property IDs resolved once per runtime, and helper scripts evaluated once per context.
+    /// </summary>
+    class property_id_cache
+    {
+    public:
+        /// <summary>
+        ///     Retrieves the property IDs for a list of names in the current runtime, creating 
+        ///     them the first time they are requested.
+        /// </summary>
+        /// <remarks>
+        ///     Requires an active script context. The property IDs are kept alive until the 
+        ///     runtime is disposed.
+        /// </remarks>
+        /// <param name="key">A key that uniquely identifies the list of names.</param>
+        /// <param name="names">The names.</param>
+        /// <param name="result">The property IDs, in the same order as the names.</param>
+        /// <returns>
+        ///     The code <c>JsNoError</c> if the operation succeeded, a failure code otherwise.
+        /// </returns>
+        static JsErrorCode get(const void *key, const std::vector<const wchar_t *> &names, const JsPropertyIdRef **result);
 
-	template<>
-	JsErrorCode marshal::to_native<bool>(JsValueRef value, bool *result);
+        /// <summary>
+        ///     Retrieves the property ID of a well-known symbol, such as <c>Symbol.iterator</c>, 
+        ///     in the current runtime.
+        /// </summary>
+        /// <remarks>
+        ///     Requires an active script context. The property ID is kept alive until the runtime
+        ///     is disposed.
+        /// </remarks>
+        /// <param name="name">The name of the symbol, such as <c>L"iterator"</c>.</param>
+        /// <param name="result">The property ID.</param>
+        /// <returns>
+        ///     The code <c>JsNoError</c> if the operation succeeded, a failure code otherwise.
+        /// </returns>
+        static JsErrorCode get_symbol(const wchar_t *name, JsPropertyIdRef *result);
 
-	template<>
-	JsErrorCode marshal::to_native<std::wstring>(JsValueRef value, std::wstring *result);
+        /// <summary>
+        ///     Retrieves the value of a helper script in the current context, running the script
+        ///     the first time it is requested.
+        /// </summary>
+        /// <remarks>
+        ///     Requires an active script context. The value is stored on the context's global 
+        ///     object under a symbol created for the key, so it lives as long as the context. The
+        ///     symbol's property ID is kept alive until the runtime is disposed, so this is meant 
+        ///     for a fixed set of helpers rather than for scripts built at run time.
+        /// </remarks>
+        /// <param name="key">A key that uniquely identifies the script.</param>
+        /// <param name="script">The script, which is usually a function expression.</param>
+        /// <param name="result">The value of the script.</param>
+        /// <returns>
+        ///     The code <c>JsNoError</c> if the operation succeeded, a failure code otherwise.
+        /// </returns>
+        static JsErrorCode get_script(const void *key, const wchar_t *script, JsValueRef *result);
 
-	template<>
-	JsErrorCode marshal::from_native(double value, JsValueRef *result);
+        /// <summary>
+        ///     Forgets the property IDs of a runtime.
+        /// </summary>
+        /// <param name="runtime">The runtime being disposed.</param>
+        static void clear(JsRuntimeHandle runtime);
+    };
 
-	template<>
-	JsErrorCode marshal::from_native(int value, JsValueRef *result);
+    /// <summary>
+    ///     A value that holds one of a fixed set of types.
+    /// </summary>
+    /// <remarks>
+    ///     <para>
+    ///     A default constructed variant holds a default constructed value of the first type.
+    ///     If copying a value into a variant by assignment throws, the variant holds no value: 
+    ///     <c>index</c> is -1, <c>get</c> throws and it can't be marshalled to JavaScript.
+    ///     </para>
+    ///     <para>
+    ///     When a variant is marshalled from JavaScript, the type of the value is retrieved once
+    ///     and the first alternative that can represent a value of that type is used. Wrapper 
+    ///     types such as <c>value</c> and <c>object</c> accept any value, so should come last.
+    ///     </para>
+    /// </remarks>
+    template<class... Types>
+    class variant
+    {
+        static_assert(sizeof...(Types) > 0, "A variant must have at least one alternative.");
 
-	template<>
-	JsErrorCode marshal::from_native(bool value, JsValueRef *result);
+        template<class T, class... Alternatives>
+        struct index_of;
 
-	template<>
-	JsErrorCode marshal::from_native(std::wstring value, JsValueRef *result);
+        template<class T>
+        struct index_of<T> : std::integral_constant<int, -1>
+        {
+        };
 
-	template<>
-	JsErrorCode marshal::from_native(const wchar_t *value, JsValueRef *result);
+        template<class T, class First, class... Rest>
+        struct index_of<T, First, Rest...> :
+            std::integral_constant<int, std::is_same<T, First>::value ? 0 : (index_of<T, Rest...>::value < 0 ? -1 : index_of<T, Rest...>::value + 1)>
+        {
+        };
 
-	/// <summary>
-    ///     A reference to a JavaScript value.
-    /// </summary>
-    class value : public reference
-    {
-        friend class function_base;
-        friend class runtime;
-        friend class context;
-        friend class object;
-        template<endedness byte_order>
-        friend class data_view;
-        template<class T>
-        friend class array_element;
+        typedef typename std::tuple_element<0, std::tuple<Types...>>::type first_type;
 
-    protected:
-        explicit value(JsValueRef ref) :
-            reference(ref)
+        typename std::aligned_union<0, Types...>::type _storage;
+        int _index;
+
+        template<class T>
+        static void destroy_as(void *value)
         {
+            static_cast<T *>(value)->~T();
         }
 
-    public:
-        /// <summary>
-        ///     Creates an invalid value handle.
-        /// </summary>
-        value() :
-            reference()
+        template<class T>
+        static void copy_as(void *destination, const void *source)
         {
+            new (destination) T(*static_cast<const T *>(source));
         }
 
-        /// <summary>
-        ///     Gets the JavaScript type of a value.
-        /// </summary>
-        /// <remarks>
-        ///     Requires an active script context.
-        /// </remarks>
-        /// <returns>The type of the value.</returns>
-        JsValueType type() const
+        void destroy()
         {
-            JsValueType type;
-            runtime::translate_error_code(JsGetValueType(_ref, &type));
-            return type;
+            static void (*const destroyers[])(void *) = { &destroy_as<Types>... };
+            if (_index >= 0)
+            {
+                destroyers[_index](&_storage);
+            }
         }
 
-        /// <summary>
-        ///     Converts the value to a <c>VARIANT</c> as a projection of a JavaScript value.
-        /// </summary>
-        /// <remarks>
-        ///     <para>
-        ///     The projection <c>VARIANT</c> can be used by COM automation clients to call into the
-        ///     projected JavaScript object.
-        ///     </para>
-        ///     <para>
-        ///     Requires an active script context.
-        ///     </para>
-        /// </remarks>
-        /// <param name="variant">
-        ///     A pointer to a <c>VARIANT</c> struct that will be initialized as a projection.
-        /// </param>
-        void to_variant(VARIANT *variant) const
+        void copy(const variant &other)
         {
-            runtime::translate_error_code(JsValueToVariant(_ref, variant));
+            static void (*const copiers[])(void *, const void *) = { &copy_as<Types>... };
+            if (other._index >= 0)
+            {
+                copiers[other._index](&_storage, &other._storage);
+            }
+            _index = other._index;
         }
 
+    public:
         /// <summary>
-        ///     Compare two JavaScript values for equality.
+        ///     Creates a variant holding a default value of the first type.
         /// </summary>
-        /// <remarks>
-        ///     <para>
-        ///     This function is equivalent to the <c>==</c> operator in JavaScript.
-        ///     </para>
-        ///     <para>
-        ///     Requires an active script context.
-        ///     </para>
-        /// </remarks>
-        /// <param name="other>The object to compare.</param>
-        /// <returns>Whether the values are equal.</returns>
-        bool equals(value other) const
+        variant() :
+            _index(0)
         {
-            bool isEqual;
-            runtime::translate_error_code(JsEquals(handle(), other.handle(), &isEqual));
-            return isEqual;
+            new (&_storage) first_type();
         }
 
         /// <summary>
-        ///     Compare two JavaScript values for strict equality.
+        ///     Creates a variant holding a value.
         /// </summary>
-        /// <remarks>
-        ///     <para>
-        ///     This function is equivalent to the <c>===</c> operator in JavaScript.
-        ///     </para>
-        ///     <para>
-        ///     Requires an active script context.
-        ///     </para>
-        /// </remarks>
-        /// <param name="other>The object to compare.</param>
-        /// <returns>Whether the values are equal.</returns>
-        bool strict_equals(value other) const
+        /// <param name="value">The value.</param>
+        template<class T, class = typename std::enable_if<(index_of<typename std::decay<T>::type, Types...>::value >= 0)>::type>
+        variant(T &&value) :
+            _index(index_of<typename std::decay<T>::type, Types...>::value)
         {
-            bool isEqual;
-            runtime::translate_error_code(JsStrictEquals(handle(), other.handle(), &isEqual));
-            return isEqual;
+            new (&_storage) typename std::decay<T>::type(std::forward<T>(value));
         }
 
-        /// <summary>
-        ///     Creates a JavaScript value that is a projection of the passed in <c>VARIANT</c>.
-        /// </summary>
-        /// <remarks>
-        ///     <para>
-        ///     The projected value can be used by script to call a COM automation object from script. 
-        ///     Hosts are responsible for enforcing COM threading rules.
-        ///     </para>
-        ///     <para>
-        ///     Requires an active script context.
-        ///     </para>
-        /// </remarks>
-        /// <param name="variant_value">A <c>VARIANT</c> to be projected.</param>
-        /// <returns>A JavaScript value that is a projection of the <c>VARIANT</c>.</returns>
-        static value from_variant(VARIANT *variant_value)
+        variant(const variant &other)
         {
-            JsValueRef result;
-            runtime::translate_error_code(JsVariantToValue(variant_value, &result));
-            return value(result);
+            copy(other);
         }
-    };
 
-	/// <summary>
-    ///     A reference to a JavaScript Boolean value.
-    /// </summary>
-    class boolean : public value
-    {
-        friend class value;
+        variant &operator=(const variant &other)
+        {
+            if (this != &other)
+            {
+                // Hold no value until the copy succeeds, so a copy that throws isn't destroyed.
+                destroy();
+                _index = -1;
+                copy(other);
+            }
+            return *this;
+        }
 
-        explicit boolean(JsValueRef ref) :
-            value(ref)
+        ~variant()
         {
+            destroy();
         }
 
-    public:
         /// <summary>
-        ///     Creates an invalid value handle.
+        ///     The index of the type of the value held, or -1 if the variant holds no value.
         /// </summary>
-        boolean() :
-            value()
+        int index() const
         {
+            return _index;
         }
 
         /// <summary>
-        ///     Converts the <c>value</c> handle to a <c>boolean</c> handle.
+        ///     Whether the variant holds a value of a type.
         /// </summary>
-        /// <remarks>
-        ///     The type of the underlying value is not checked.
-        /// </remarks>
-        explicit boolean(value object) :
-            value(object.handle())
+        template<class T>
+        bool is() const
         {
+            return _index == index_of<T, Types...>::value;
         }
 
         /// <summary>
-        ///     Retrieves the <c>bool</c> value of a Boolean value.
+        ///     Retrieves the value held.
         /// </summary>
         /// <remarks>
-        ///     Requires an active script context.
+        ///     The variant must hold a value of type <c>T</c>.
         /// </remarks>
-        /// <returns>The converted value.</returns>
-        bool data() const
+        template<class T>
+        T &get()
         {
-            bool result;
-            runtime::translate_error_code(marshal::to_native(_ref, &result));
-            return result;
+            static_assert(index_of<T, Types...>::value >= 0, "The type is not an alternative of the variant.");
+
+            if (!is<T>())
+            {
+                runtime::translate_error_code(JsErrorInvalidArgument);
+            }
+
+            return *reinterpret_cast<T *>(&_storage);
         }
 
         /// <summary>
-        ///     Gets the value of <c>true</c> in the current script context.
+        ///     Retrieves the value held.
         /// </summary>
         /// <remarks>
-        ///     Requires an active script context.
+        ///     The variant must hold a value of type <c>T</c>.
         /// </remarks>
-        /// <returns>The <c>true</c> value.</returns>
-        static boolean true_value()
+        template<class T>
+        const T &get() const
         {
-            JsValueRef trueValue;
-            runtime::translate_error_code(JsGetTrueValue(&trueValue));
-            return boolean(trueValue);
+            return const_cast<variant *>(this)->get<T>();
         }
+    };
 
-        /// <summary>
-        ///     Gets the value of <c>false</c> in the current script context.
-        /// </summary>
-        /// <remarks>
-        ///     Requires an active script context.
-        /// </remarks>
-        /// <returns>The <c>false</c> value.</returns>
-        static boolean false_value()
-        {
-            JsValueRef falseValue;
-            runtime::translate_error_code(JsGetFalseValue(&falseValue));
-            return boolean(falseValue);
-        }
+	/// <summary>
+	///		A class to marshal values to/from native.
+	/// </summary>
+	class marshal
+	{
+	public:
+		template<class T>
+		static JsErrorCode to_native(JsValueRef value, T *result);
 
-        /// <summary>
-        ///     Creates a Boolean value from a <c>bool</c> value.
-        /// </summary>
-        /// <remarks>
-        ///     Requires an active script context.
-        /// </remarks>
-        /// <param name="value">The value to be converted.</param>
-        /// <returns>The converted value.</returns>
-        static boolean create(bool value)
-        {
-            JsValueRef result;
-            runtime::translate_error_code(marshal::from_native(value, &result));
-            return boolean(result);
-        }
+		template<class T>
+		static JsErrorCode to_native(JsValueRef value, optional<T> *result);
 
-        /// <summary>
-        ///     Converts the value to Boolean using standard JavaScript semantics.
-        /// </summary>
-        /// <remarks>
-        ///     Requires an active script context.
-        /// </remarks>
-        /// <param name="value">The value to be converted.</param>
-        /// <returns>The converted value.</returns>
-        static boolean convert(value value);
-    };
+		template<class T>
+		static JsErrorCode from_native(T value, JsValueRef *result);
 
-    /// <summary>
-    ///     A reference to a JavaScript number value.
-    /// </summary>
-    class number : public value
-    {
-        friend class value;
+		template<class T>
+		static JsErrorCode from_native(optional<T> value, JsValueRef *result);
 
-        explicit number(JsValueRef ref) :
-            value(ref)
-        {
-        }
+		template<class T, unsigned int Rank, bool clamped>
+		static JsErrorCode to_native(JsValueRef value, ndarray<T, Rank, clamped> *result);
 
-    public:
-        /// <summary>
-        ///     Creates an invalid value handle.
-        /// </summary>
-        number() :
-            value()
-        {
-        }
+		template<class T, unsigned int Rank, bool clamped>
+		static JsErrorCode from_native(ndarray<T, Rank, clamped> value, JsValueRef *result);
 
-        /// <summary>
-        ///     Converts the <c>value</c> handle to a <c>number</c> handle.
-        /// </summary>
-        /// <remarks>
-        ///     The type of the underlying value is not checked.
-        /// </remarks>
-        explicit number(value object) :
-            value(object.handle())
-        {
-        }
+		template<class T, bool clamped>
+		static JsErrorCode to_native(JsValueRef value, typed_array<T, clamped> *result);
 
-        /// <summary>
-        ///     Retrieves the <c>int</c> value of a number value.
-        /// </summary>
-        /// <remarks>
-        ///     Requires an active script context.
-        /// </remarks>
-        /// <returns>The <c>int</c> value.</returns>
-        int as_int() const
-        {
-            int result;
-            runtime::translate_error_code(marshal::to_native(_ref, &result));
-            return result;
-        }
+		template<class T>
+		static JsErrorCode to_native(JsValueRef value, buffer_view<T> *result);
 
-        /// <summary>
-        ///     Retrieves the <c>double</c> value of a number value.
-        /// </summary>
-        /// <remarks>
-        ///     Requires an active script context.
-        /// </remarks>
-        /// <returns>The <c>double</c> value.</returns>
-        double as_double() const
-        {
-            double result;
-            runtime::translate_error_code(marshal::to_native(_ref, &result));
-            return result;
-        }
+		template<class T>
+		static JsErrorCode from_native(buffer_view<T> value, JsValueRef *result);
 
-        /// <summary>
-        ///     Creates a number value from a <c>double</c> value.
-        /// </summary>
-        /// <remarks>
-        ///     Requires an active script context.
-        /// </remarks>
-        /// <param name="value">The <c>double</c> to convert to a number value.</param>
-        /// <returns>The new number value.</returns>
-        static number create(double value)
-        {
-            JsValueRef result;
-            runtime::translate_error_code(marshal::from_native(value, &result));
-            return number(result);
-        }
+		template<class T>
+		static JsErrorCode to_native(JsValueRef value, std::vector<T> *result);
 
-        /// <summary>
-        ///     Creates a number value from an <c>int</c> value.
-        /// </summary>
-        /// <remarks>
-        ///     Requires an active script context.
-        /// </remarks>
-        /// <param name="value">The <c>int</c> to convert to a number value.</param>
-        /// <returns>The new number value.</returns>
-        static number create(int value)
-        {
-            JsValueRef result;
-            runtime::translate_error_code(marshal::from_native(value, &result));
-            return number(result);
-        }
+		template<class T>
+		static JsErrorCode from_native(const std::vector<T> &value, JsValueRef *result);
 
-        /// <summary>
-        ///     Converts the value to number using standard JavaScript semantics.
-        /// </summary>
-        /// <remarks>
-        ///     Requires an active script context.
-        /// </remarks>
-        /// <param name="value">The value to be converted.</param>
-        /// <returns>The converted value.</returns>
-        static number convert(value value);
-    };
+		template<class T, bool clamped>
+		static JsErrorCode to_native(JsValueRef value, typed_result<T, clamped> *result);
 
-    /// <summary>
-    ///     A reference to a JavaScript string value.
-    /// </summary>
-    class string : public value
-    {
-        friend class value;
+		template<class T, bool clamped>
+		static JsErrorCode from_native(const typed_result<T, clamped> &value, JsValueRef *result);
 
-        explicit string(JsValueRef ref) :
-            value(ref)
-        {
-        }
+		template<class T, size_t N>
+		static JsErrorCode to_native(JsValueRef value, std::array<T, N> *result);
 
-    public:
-        /// <summary>
-        ///     Creates an invalid value handle.
-        /// </summary>
-        string() :
-            value()
-        {
-        }
+		template<class T, size_t N>
+		static JsErrorCode from_native(const std::array<T, N> &value, JsValueRef *result);
 
-        /// <summary>
-        ///     Converts the <c>value</c> handle to a <c>string</c> handle.
-        /// </summary>
-        /// <remarks>
-        ///     The type of the underlying value is not checked.
-        /// </remarks>
-        explicit string(value object) :
-            value(object.handle())
-        {
-        }
+		template<class T>
+		static JsErrorCode to_native(JsValueRef value, std::map<std::wstring, T> *result);
 
-        /// <summary>
-        ///     Gets the length of a string value.
-        /// </summary>
-        /// <remarks>
-        ///     Requires an active script context.
-        /// </remarks>
-        /// <returns>The length of the string.</returns>
-        int length() const
-        {
-            int length;
-            runtime::translate_error_code(JsGetStringLength(_ref, &length));
-            return length;
-        }
+		template<class T>
+		static JsErrorCode from_native(const std::map<std::wstring, T> &value, JsValueRef *result);
 
-        /// <summary>
-        ///     Returns the underlying string value.
-        /// </summary>
-        std::wstring data() const
-        {
-            std::wstring result;
-            runtime::translate_error_code(marshal::to_native(_ref, &result));
-            return result;
-        }
+		template<class T>
+		static JsErrorCode to_native(JsValueRef value, std::unordered_map<std::wstring, T> *result);
 
-        /// <summary>
-        ///     Creates a string value from a <c>std::wstring</c>.
-        /// </summary>
-        /// <remarks>
-        ///     Requires an active script context.
-        /// </remarks>
-        /// <param name="value">The string to convert to a string value.</param>
-        /// <returns>The new string value.</returns>
-        static string create(std::wstring value)
-        {
-            JsValueRef result;
-            runtime::translate_error_code(marshal::from_native(value, &result));
-            return string(result);
-        }
+		template<class T>
+		static JsErrorCode from_native(const std::unordered_map<std::wstring, T> &value, JsValueRef *result);
 
-        /// <summary>
-        ///     Converts the value to string using standard JavaScript semantics.
-        /// </summary>
-        /// <remarks>
-        ///     Requires an active script context.
-        /// </remarks>
-        /// <param name="value">The value to be converted.</param>
-        /// <returns>The converted value.</returns>
-        static string convert(value value);
-    };
+		template<class T1, class T2>
+		static JsErrorCode to_native(JsValueRef value, std::pair<T1, T2> *result);
 
-    /// <summary>
-    ///     A unique symbol that can be used as a property identifier.
-    /// </summary>
-    class symbol : public value
-    {
-        friend class marshal;
-        friend class property_id;
+		template<class T1, class T2>
+		static JsErrorCode from_native(const std::pair<T1, T2> &value, JsValueRef *result);
 
-        explicit symbol(JsValueRef symbol) :
-            value(symbol)
-        {
-        }
+		template<class... Types>
+		static JsErrorCode to_native(JsValueRef value, std::tuple<Types...> *result);
 
-    public:
-        /// <summary>
-        ///     Constructs an invalid symbol.
-        /// </summary>
-        symbol() :
-            value()
-        {
-        }
+		template<class... Types>
+		static JsErrorCode from_native(const std::tuple<Types...> &value, JsValueRef *result);
 
-        /// <summary>
-        ///     Creates a new symbol. 
-        /// </summary>
-        /// <remarks>
-        ///     <para>
-        ///     Symbols are specific to a context and cannot be used across contexts.
-        ///     </para>
-        ///     <para>
-        ///     Requires an active script context.
-        ///     </para>
-        /// </remarks>
-        /// <param name="description">
-        ///     A description of the symbol, can be empty.
-        /// </param>
-        /// <returns>The new symbol.</returns>
-        static symbol create(const std::wstring description)
-        {
-            JsValueRef symbol_value;
-            string description_value = string::create(description);
-            runtime::translate_error_code(JsCreateSymbol(description_value.handle(), &symbol_value));
-            return symbol(symbol_value);
-        }
-    };
+		template<class... Types>
+		static JsErrorCode to_native(JsValueRef value, variant<Types...> *result);
 
-    template<class T, bool clamped>
-    struct typed_array_type
-    {
-    };
+		template<class... Types>
+		static JsErrorCode from_native(const variant<Types...> &value, JsValueRef *result);
 
-    template<>
-    struct typed_array_type<char, false>
-    {
-        static const JsTypedArrayType type = JsArrayTypeInt8;
-        static const std::wstring type_name;
-        static const int size = 1;
-    };
+		template<class T>
+		static JsErrorCode from_native(const task<T> &value, JsValueRef *result);
 
-    template<>
-    struct typed_array_type<unsigned char, false>
-    {
-        static const JsTypedArrayType type = JsArrayTypeUint8;
-        static const std::wstring type_name;
-        static const int size = 1;
-    };
+	private:
+		static JsErrorCode get_element(JsValueRef array, int index, JsValueRef *result)
+		{
+			JsValueRef indexValue;
+			JsErrorCode error = JsIntToNumber(index, &indexValue);
+			if (error != JsNoError)
+			{
+				return error;
+			}
 
-    template<>
-    struct typed_array_type<unsigned char, true>
-    {
-        static const JsTypedArrayType type = JsArrayTypeUint8Clamped;
-        static const int size = 1;
-    };
+			return JsGetIndexedProperty(array, indexValue, result);
+		}
 
-    template<>
-    struct typed_array_type<short, false>
-    {
-        static const JsTypedArrayType type = JsArrayTypeInt16;
-        static const std::wstring type_name;
-        static const int size = 2;
-    };
+		static JsErrorCode set_element(JsValueRef array, int index, JsValueRef value)
+		{
+			JsValueRef indexValue;
+			JsErrorCode error = JsIntToNumber(index, &indexValue);
+			if (error != JsNoError)
+			{
+				return error;
+			}
 
-    template<>
-    struct typed_array_type<unsigned short, false>
-    {
-        static const JsTypedArrayType type = JsArrayTypeUint16;
-        static const std::wstring type_name;
-        static const int size = 2;
-    };
+			return JsSetIndexedProperty(array, indexValue, value);
+		}
 
-    template<>
-    struct typed_array_type<int, false>
-    {
-        static const JsTypedArrayType type = JsArrayTypeInt32;
-        static const std::wstring type_name;
-        static const int size = 4;
-    };
+		static JsErrorCode array_length(JsValueRef array, int *result)
+		{
+			JsValueRef lengthValue;
+			JsErrorCode error = get_named_property(array, L"length", &lengthValue);
+			if (error != JsNoError)
+			{
+				return error;
+			}
 
-    template<>
-    struct typed_array_type<unsigned int, false>
-    {
-        static const JsTypedArrayType type = JsArrayTypeUint32;
-        static const std::wstring type_name;
-        static const int size = 4;
-    };
+			return JsNumberToInt(lengthValue, result);
+		}
 
-    template<>
-    struct typed_array_type<float, false>
-    {
-        static const JsTypedArrayType type = JsArrayTypeFloat32;
-        static const std::wstring type_name;
-        static const int size = 4;
-    };
+		template<class T>
+		static JsErrorCode to_native_element(JsValueRef array, int index, T *result)
+		{
+			JsValueRef elementValue;
+			JsErrorCode error = get_element(array, index, &elementValue);
+			if (error != JsNoError)
+			{
+				return error;
+			}
 
-    template<>
-    struct typed_array_type<double, false>
-    {
-        static const JsTypedArrayType type = JsArrayTypeFloat64;
-        static const std::wstring type_name;
-        static const int size = 8;
-    };
+			return to_native(elementValue, result);
+		}
 
-    /// <summary>
-    ///     A reference to a JavaScript object.
-    /// </summary>
-    class object : public value
-    {
-        friend class function_base;
-        friend class context;
-        friend class marshal;
+		template<class T>
+		static JsErrorCode from_native_element(JsValueRef array, int index, const T &value)
+		{
+			JsValueRef elementValue;
+			JsErrorCode error = from_native(value, &elementValue);
+			if (error != JsNoError)
+			{
+				return error;
+			}
 
-    protected:
-        explicit object(JsValueRef ref) :
-            value(ref)
-        {
-        }
+			return set_element(array, index, elementValue);
+		}
 
-    public:
-        /// <summary>
-        ///     Creates an invalid object handle.
-        /// </summary>
-        object() :
-            value()
-        {
-        }
+		template<class Map>
+		static JsErrorCode to_native_map(JsValueRef value, Map *result);
 
-        /// <summary>
-        ///     Converts the <c>value</c> handle to an <c>object</c> handle.
-        /// </summary>
-        /// <remarks>
-        ///     The type of the underlying value is not checked.
-        /// </remarks>
-        explicit object(value object) :
-            value(object.handle())
-        {
-        }
+		template<class Map>
+		static JsErrorCode from_native_map(const Map &value, JsValueRef *result);
 
-        /// <summary>
-        ///     Determines whether an object is an external object.
-        /// </summary>
-        /// <remarks>
-        ///     Requires an active script context.
-        /// </remarks>
-        /// <returns>Whether the object is an external object.</returns>
-        bool is_external() const
-        {
-            bool hasExternalData;
-            runtime::translate_error_code(JsHasExternalData(handle(), &hasExternalData));
+		template<class Tuple, size_t... Indexes>
+		static JsErrorCode to_native_tuple(JsValueRef value, Tuple *result, std::index_sequence<Indexes...>);
 
-            return hasExternalData;
-        }
+		template<class Tuple, size_t... Indexes>
+		static JsErrorCode from_native_tuple(const Tuple &value, JsValueRef *result, std::index_sequence<Indexes...>);
 
-        /// <summary>
-        ///     Returns a value that indicates whether an object is extensible or not.
-        /// </summary>
-        /// <remarks>
-        ///     Requires an active script context.
-        /// </remarks>
-        /// <returns>Whether the object is extensible or not.</returns>
-        bool is_extension_allowed() const
-        {
-            bool isExtensionaAllowed;
-            runtime::translate_error_code(JsGetExtensionAllowed(handle(), &isExtensionaAllowed));
-            return isExtensionaAllowed;
-        }
+		template<class T>
+		static bool accepts(JsValueType type, T *);
 
-        /// <summary>
-        ///     Returns the prototype of an object.
-        /// </summary>
-        /// <remarks>
-        ///     Requires an active script context.
-        /// </remarks>
-        /// <returns>The object's prototype.</returns>
-        object prototype() const
-        {
-            JsValueRef prototype;
-            runtime::translate_error_code(JsGetPrototype(handle(), &prototype));
-            return object(prototype);
-        }
+		template<class T>
+		static bool accepts(JsValueType type, optional<T> *);
 
-        /// <summary>
-        ///     Sets the prototype of an object.
-        /// </summary>
-        /// <remarks>
-        ///     Requires an active script context.
-        /// </remarks>
-        /// <returns>The object's new prototype.</returns>
-        void set_prototype(object prototype) const
-        {
-            runtime::translate_error_code(JsSetPrototype(handle(), prototype.handle()));
-        }
+		template<class T>
+		static bool accepts(JsValueType type, std::vector<T> *);
 
-        /// <summary>
-        ///     Makes an object non-extensible.
-        /// </summary>
-        /// <remarks>
-        ///     Requires an active script context.
-        /// </remarks>
-        void prevent_extension() const
-        {
-            runtime::translate_error_code(JsPreventExtension(handle()));
-        }
+		template<class T, size_t N>
+		static bool accepts(JsValueType type, std::array<T, N> *);
 
-        /// <summary>
-        ///     Gets an object's property.
-        /// </summary>
-        /// <remarks>
-        ///     Requires an active script context.
-        /// </remarks>
-        /// <param name="name">The ID of the property.</param>
-        /// <returns>The value of the property.</returns>
-        template<class T = value>
-        T get_property(property_id name)
-        {
-            JsValueRef value;
-            runtime::translate_error_code(JsGetProperty(handle(), name.handle(), &value));
+		template<class T>
+		static bool accepts(JsValueType type, std::map<std::wstring, T> *);
 
-            T returnValue;
-            runtime::translate_error_code(marshal::to_native(value, &returnValue));
+		template<class T>
+		static bool accepts(JsValueType type, std::unordered_map<std::wstring, T> *);
 
-            return returnValue;
-        }
+		template<class T1, class T2>
+		static bool accepts(JsValueType type, std::pair<T1, T2> *);
 
-        /// <summary>
-        ///     Gets a property descriptor for an object's own property.
-        /// </summary>
-        /// <remarks>
-        ///     Requires an active script context.
-        /// </remarks>
-        /// <param name="name">The ID of the property.</param>
-        /// <returns>The property descriptor.</returns>
-        template<class T = value>
-        property_descriptor<T> get_own_property_descriptor(property_id name)
-        {
-            JsValueRef valueHandle;
-            runtime::translate_error_code(JsGetOwnPropertyDescriptor(handle(), name.handle(), &valueHandle));
+		template<class... Types>
+		static bool accepts(JsValueType type, std::tuple<Types...> *);
 
-            return property_descriptor<T>(value(valueHandle));
-        }
+		template<class T, class Variant>
+		static JsErrorCode to_native_alternative(JsValueRef value, JsValueType type, Variant *result);
 
-        /// <summary>
-        ///     Gets the list of all named properties on the object.
-        /// </summary>
-        /// <remarks>
-        ///     Requires an active script context.
-        /// </remarks>
-        /// <returns>An array of property names.</returns>
-        std::vector<std::wstring> get_own_property_names() const;
+		template<class T, class Variant>
+		static JsErrorCode from_native_alternative(const Variant &value, JsValueRef *result);
 
-        /// <summary>
-        ///     Gets the list of all symbol properties on the object.
-        /// </summary>
-        /// <remarks>
-        ///     Requires an active script context.
-        /// </remarks>
-        /// <returns>An array of property symbols.</returns>
-        std::vector<symbol> get_own_property_symbols() const;
+		template<class T>
+		static JsErrorCode to_native_object(JsValueRef value, T *result, std::false_type);
 
-        /// <summary>
-        ///     Puts an object's property.
-        /// </summary>
-        /// <remarks>
-        ///     Requires an active script context.
-        /// </remarks>
-        /// <param name="name">The ID of the property.</param>
-        /// <param name="value">The new value of the property.</param>
-        /// <param name="use_strict_rules">The property set should follow strict mode rules.</param>
-        template<class T = value>
-        void set_property(property_id name, T value, bool use_strict_rules = true)
-        {
-            JsValueRef valueReference;
-            runtime::translate_error_code(marshal::from_native(value, &valueReference));
+		template<class T>
+		static JsErrorCode to_native_object(JsValueRef value, T *result, std::true_type);
 
-            runtime::translate_error_code(JsSetProperty(handle(), name.handle(), valueReference, use_strict_rules));
+		template<class T>
+		static JsErrorCode from_native_object(const T &value, JsValueRef *result, std::false_type);
+
+		template<class T>
+		static JsErrorCode from_native_object(const T &value, JsValueRef *result, std::true_type);
+
+		template<class Fields, size_t... Indexes>
+		static std::vector<const wchar_t *> field_names(const Fields &fields, std::index_sequence<Indexes...>)
+		{
+			return std::vector<const wchar_t *> { std::get<Indexes>(fields).name... };
+		}
+
+		template<class T>
+		static JsErrorCode struct_property_ids(const JsPropertyIdRef **result);
+
+		template<class T>
+		static JsErrorCode field_to_native(JsValueRef object, JsPropertyIdRef id, T *result);
+
+		template<class T>
+		static JsErrorCode field_to_native(JsValueRef object, JsPropertyIdRef id, optional<T> *result);
+
+		template<class T>
+		static JsErrorCode field_from_native(JsValueRef object, JsPropertyIdRef id, const T &value);
+
+		template<class T>
+		static JsErrorCode field_from_native(JsValueRef object, JsPropertyIdRef id, const optional<T> &value);
+
+		template<class T, class Fields, size_t... Indexes>
+		static JsErrorCode fields_to_native(JsValueRef value, T *result, const Fields &fields, const JsPropertyIdRef *ids, std::index_sequence<Indexes...>);
+
+		template<class T, class Fields, size_t... Indexes>
+		static JsErrorCode fields_from_native(const T &value, JsValueRef result, const Fields &fields, const JsPropertyIdRef *ids, std::index_sequence<Indexes...>);
+
+		template<class T>
+		static JsErrorCode to_native_array(JsValueRef value, std::vector<T> *result);
+
+		template<class T>
+		static JsErrorCode to_native_vector(JsValueRef value, std::vector<T> *result, std::true_type);
+
+		template<class T>
+		static JsErrorCode to_native_vector(JsValueRef value, std::vector<T> *result, std::false_type);
+
+		template<class T>
+		static JsErrorCode from_native_vector(const std::vector<T> &value, JsValueRef *result, std::true_type);
+
+		template<class T>
+		static JsErrorCode from_native_vector(const std::vector<T> &value, JsValueRef *result, std::false_type);
+
+		template<class T>
+		static JsErrorCode from_native_array(const std::vector<T> &value, JsValueRef *result);
+
+		static JsErrorCode get_named_property(JsValueRef object, const wchar_t *name, JsValueRef *result)
+		{
+			JsPropertyIdRef propertyId;
+			JsErrorCode error = JsGetPropertyIdFromName(name, &propertyId);
+			if (error != JsNoError)
+			{
+				return error;
+			}
+
+			return JsGetProperty(object, propertyId, result);
+		}
+
+		static JsErrorCode set_named_property(JsValueRef object, const wchar_t *name, JsValueRef value)
+		{
+			JsPropertyIdRef propertyId;
+			JsErrorCode error = JsGetPropertyIdFromName(name, &propertyId);
+			if (error != JsNoError)
+			{
+				return error;
+			}
+
+			return JsSetProperty(object, propertyId, value, true);
+		}
+
+		template<class T, size_t N>
+		static JsErrorCode to_native_dimensions(JsValueRef value, std::array<T, N> *result)
+		{
+			JsValueRef lengthValue;
+			int length;
+			JsErrorCode error = get_named_property(value, L"length", &lengthValue);
+			if (error != JsNoError)
+			{
+				return error;
+			}
+
+			error = JsNumberToInt(lengthValue, &length);
+			if (error != JsNoError)
+			{
+				return error;
+			}
+
+			if (length != static_cast<int>(N))
+			{
+				return JsErrorInvalidArgument;
+			}
+
+			for (int index = 0; index < length; index++)
+			{
+				JsValueRef indexValue;
+				JsValueRef elementValue;
+				int element;
+
+				error = JsIntToNumber(index, &indexValue);
+				if (error != JsNoError)
+				{
+					return error;
+				}
+
+				error = JsGetIndexedProperty(value, indexValue, &elementValue);
+				if (error != JsNoError)
+				{
+					return error;
+				}
+
+				error = JsNumberToInt(elementValue, &element);
+				if (error != JsNoError)
+				{
+					return error;
+				}
+
+				if (std::is_unsigned<T>::value && element < 0)
+				{
+					return JsErrorInvalidArgument;
+				}
+
+				(*result)[index] = static_cast<T>(element);
+			}
+
+			return JsNoError;
+		}
+
+		template<class T, bool clamped>
+		static JsErrorCode to_native_elements(JsValueRef value, std::vector<T> *result);
+
+		template<class T, bool clamped>
+		static JsErrorCode from_native_elements(const std::vector<T> &value, JsValueRef *result);
+
+		template<class T, size_t N>
+		static JsErrorCode from_native_dimensions(const std::array<T, N> &value, JsValueRef *result)
+		{
+			JsErrorCode error = JsCreateArray(static_cast<unsigned int>(N), result);
+			if (error != JsNoError)
+			{
+				return error;
+			}
+
+			for (size_t index = 0; index < N; index++)
+			{
+				JsValueRef indexValue;
+				JsValueRef elementValue;
+
+				error = JsIntToNumber(static_cast<int>(index), &indexValue);
+				if (error != JsNoError)
+				{
+					return error;
+				}
+
+				error = JsIntToNumber(static_cast<int>(value[index]), &elementValue);
+				if (error != JsNoError)
+				{
+					return error;
+				}
+
+				error = JsSetIndexedProperty(*result, indexValue, elementValue);
+				if (error != JsNoError)
+				{
+					return error;
+				}
+			}
+
+			return JsNoError;
+		}
+	};
+
+	template<>
+	JsErrorCode marshal::to_native(JsValueRef value, symbol *result);
+
+	template<>
+	JsErrorCode marshal::to_native<int>(JsValueRef value, int *result);
+
+	template<>
+	JsErrorCode marshal::to_native<double>(JsValueRef value, double *result);
+
+	template<>
+	JsErrorCode marshal::to_native<bool>(JsValueRef value, bool *result);
+
+	template<>
+	JsErrorCode marshal::to_native<std::wstring>(JsValueRef value, std::wstring *result);
+
+	template<>
+	JsErrorCode marshal::from_native(double value, JsValueRef *result);
+
+	template<>
+	JsErrorCode marshal::from_native(int value, JsValueRef *result);
+
+	template<>
+	JsErrorCode marshal::from_native(bool value, JsValueRef *result);
+
+	template<>
+	JsErrorCode marshal::from_native(std::wstring value, JsValueRef *result);
+
+	template<>
+	JsErrorCode marshal::from_native(const wchar_t *value, JsValueRef *result);
+
+	/// <summary>
+    ///     A reference to a JavaScript value.
+    /// </summary>
+    class value : public reference
+    {
+        friend class function_base;
+        friend class runtime;
+        friend class context;
+        friend class object;
+        template<endedness byte_order>
+        friend class data_view;
+        template<class T>
+        friend class array_element;
+        template<class T>
+        friend class buffer_view;
+        template<class... Types>
+        friend class object_template;
+        template<class Container>
+        friend class host_collection;
+        template<class T>
+        friend class iterable_iterator;
+        template<class T>
+        friend class iterable;
+        template<class T>
+        friend class host_iterator;
+        template<class T>
+        friend class promise;
+        template<class R, class... Parameters>
+        friend class async_function;
+
+    protected:
+        explicit value(JsValueRef ref) :
+            reference(ref)
+        {
         }
 
+    public:
         /// <summary>
-        ///     Determines whether an object has a property.
+        ///     Creates an invalid value handle.
         /// </summary>
-        /// <remarks>
-        ///     Requires an active script context.
-        /// </remarks>
-        /// <param name="name">The ID of the property.</param>
-        /// <returns>Whether the object (or a prototype) has the property.</returns>
-        bool has_property(property_id name) const
+        value() :
+            reference()
         {
-            bool hasProperty;
-            runtime::translate_error_code(JsHasProperty(handle(), name.handle(), &hasProperty));
-            return hasProperty;
         }
 
         /// <summary>
-        ///     Deletes an object's property.
+        ///     Gets the JavaScript type of a value.
         /// </summary>
         /// <remarks>
         ///     Requires an active script context.
         /// </remarks>
-        /// <param name="name">The ID of the property.</param>
-        /// <param name="use_strict_rules">The property set should follow strict mode rules.</param>
-        /// <results>Whether the property was deleted.</results>
-        template<class T = value>
-        T delete_property(property_id name, bool use_strict_rules = true)
+        /// <returns>The type of the value.</returns>
+        JsValueType type() const
         {
-            JsValueRef value;
-            runtime::translate_error_code(JsDeleteProperty(handle(), name.handle(), use_strict_rules, &value));
-
-            T returnValue;
-            runtime::translate_error_code(marshal::to_native(value, &returnValue));
-
-            return returnValue;
+            JsValueType type;
+            runtime::translate_error_code(JsGetValueType(_ref, &type));
+            return type;
         }
 
         /// <summary>
-        ///     Defines a new object's own property from a property descriptor.
+        ///     Converts the value to a <c>VARIANT</c> as a projection of a JavaScript value.
         /// </summary>
         /// <remarks>
+        ///     <para>
+        ///     The projection <c>VARIANT</c> can be used by COM automation clients to call into the
+        ///     projected JavaScript object.
+        ///     </para>
+        ///     <para>
         ///     Requires an active script context.
+        ///     </para>
         /// </remarks>
-        /// <param name="name">The ID of the property.</param>
-        /// <param name="descriptor">The property descriptor.</param>
-        /// <result>Whether the property was defined.</result>
-        template<class T>
-        bool define_property(property_id name, property_descriptor<T> descriptor)
+        /// <param name="variant">
+        ///     A pointer to a <c>VARIANT</c> struct that will be initialized as a projection.
+        /// </param>
+        void to_variant(VARIANT *variant) const
         {
-            bool value;
-            runtime::translate_error_code(JsDefineProperty(handle(), name.handle(), descriptor.handle(), &value));
-
-            return value;
+            runtime::translate_error_code(JsValueToVariant(_ref, variant));
         }
 
         /// <summary>
-        ///     Retrieve the value at the specified index of an object.
+        ///     Compare two JavaScript values for equality.
         /// </summary>
         /// <remarks>
+        ///     <para>
+        ///     This function is equivalent to the <c>==</c> operator in JavaScript.
+        ///     </para>
+        ///     <para>
         ///     Requires an active script context.
+        ///     </para>
         /// </remarks>
-        /// <param name="index">The index to retrieve.</param>
-        /// <returns>The retrieved value.</returns>
-        template<class T = value>
-        T get_index(value index)
+        /// <param name="other>The object to compare.</param>
+        /// <returns>Whether the values are equal.</returns>
+        bool equals(value other) const
         {
-            JsValueRef value;
-            runtime::translate_error_code(JsGetIndexedProperty(handle(), index.handle(), &value));
-
-            T returnValue;
-            runtime::translate_error_code(marshal::to_native(value, &returnValue));
-
-            return returnValue;
+            bool isEqual;
+            runtime::translate_error_code(JsEquals(handle(), other.handle(), &isEqual));
+            return isEqual;
         }
 
         /// <summary>
-        ///     Retrieve the value at the specified index of an object.
+        ///     Compare two JavaScript values for strict equality.
         /// </summary>
         /// <remarks>
+        ///     <para>
+        ///     This function is equivalent to the <c>===</c> operator in JavaScript.
+        ///     </para>
+        ///     <para>
         ///     Requires an active script context.
+        ///     </para>
         /// </remarks>
-        /// <param name="index">The index to retrieve.</param>
-        /// <returns>The retrieved value.</returns>
-        template<class T = value>
-        T get_index(int index)
+        /// <param name="other>The object to compare.</param>
+        /// <returns>Whether the values are equal.</returns>
+        bool strict_equals(value other) const
         {
-            JsValueRef indexValue;
-            runtime::translate_error_code(JsIntToNumber(index, &indexValue));
-
-            JsValueRef value;
-            runtime::translate_error_code(JsGetIndexedProperty(handle(), indexValue, &value));
-
-            T returnValue;
-            runtime::translate_error_code(marshal::to_native(value, &returnValue));
-
-            return returnValue;
+            bool isEqual;
+            runtime::translate_error_code(JsStrictEquals(handle(), other.handle(), &isEqual));
+            return isEqual;
         }
 
         /// <summary>
-        ///     Set the value at the specified index of an object.
+        ///     Creates a JavaScript value that is a projection of the passed in <c>VARIANT</c>.
         /// </summary>
         /// <remarks>
+        ///     <para>
+        ///     The projected value can be used by script to call a COM automation object from script. 
+        ///     Hosts are responsible for enforcing COM threading rules.
+        ///     </para>
+        ///     <para>
         ///     Requires an active script context.
+        ///     </para>
         /// </remarks>
-        /// <param name="index">The index to set.</param>
-        /// <param name="value">The value to set.</param>
-        template<class T = value>
-        void set_index(value index, T value)
+        /// <param name="variant_value">A <c>VARIANT</c> to be projected.</param>
+        /// <returns>A JavaScript value that is a projection of the <c>VARIANT</c>.</returns>
+        static value from_variant(VARIANT *variant_value)
         {
-            JsValueRef valueReference;
-            runtime::translate_error_code(marshal::from_native(value, &valueReference));
+            JsValueRef result;
+            runtime::translate_error_code(JsVariantToValue(variant_value, &result));
+            return value(result);
+        }
+    };
 
-            runtime::translate_error_code(JsSetIndexedProperty(handle(), index.handle(), valueReference));
+	/// <summary>
+    ///     A reference to a JavaScript Boolean value.
+    /// </summary>
+    class boolean : public value
+    {
+        friend class value;
+
+        explicit boolean(JsValueRef ref) :
+            value(ref)
+        {
         }
 
+    public:
         /// <summary>
-        ///     Set the value at the specified index of an object.
+        ///     Creates an invalid value handle.
         /// </summary>
-        /// <remarks>
-        ///     Requires an active script context.
-        /// </remarks>
-        /// <param name="index">The index to set.</param>
-        /// <param name="value">The value to set.</param>
-        template<class T = value>
-        void set_index(int index, T value)
+        boolean() :
+            value()
         {
-            JsValueRef indexValue;
-            runtime::translate_error_code(JsIntToNumber(index, &indexValue));
-
-            JsValueRef valueReference;
-            runtime::translate_error_code(marshal::from_native(value, &valueReference));
-
-            runtime::translate_error_code(JsSetIndexedProperty(handle(), indexValue, valueReference));
         }
 
         /// <summary>
-        ///     Tests whether an object has a value at the specified index.
+        ///     Converts the <c>value</c> handle to a <c>boolean</c> handle.
         /// </summary>
         /// <remarks>
-        ///     Requires an active script context.
+        ///     The type of the underlying value is not checked.
         /// </remarks>
-        /// <param name="index">The index to test.</param>
-        /// <returns>Whether the object has an value at the specified index.</returns>
-        bool has_index(value index) const
+        explicit boolean(value object) :
+            value(object.handle())
         {
-            bool hasProperty;
-            runtime::translate_error_code(JsHasIndexedProperty(handle(), index.handle(), &hasProperty));
-            return hasProperty;
         }
 
         /// <summary>
-        ///     Tests whether an object has a value at the specified index.
+        ///     Retrieves the <c>bool</c> value of a Boolean value.
         /// </summary>
         /// <remarks>
         ///     Requires an active script context.
         /// </remarks>
-        /// <param name="index">The index to test.</param>
-        /// <returns>Whether the object has an value at the specified index.</returns>
-        bool has_index(int index) const
+        /// <returns>The converted value.</returns>
+        bool data() const
         {
-            JsValueRef indexValue;
-            runtime::translate_error_code(JsIntToNumber(index, &indexValue));
-
-            bool hasProperty;
-            runtime::translate_error_code(JsHasIndexedProperty(handle(), indexValue, &hasProperty));
-            return hasProperty;
+            bool result;
+            runtime::translate_error_code(marshal::to_native(_ref, &result));
+            return result;
         }
 
         /// <summary>
-        ///     Delete the value at the specified index of an object.
+        ///     Gets the value of <c>true</c> in the current script context.
         /// </summary>
         /// <remarks>
         ///     Requires an active script context.
         /// </remarks>
-        /// <param name="index">The index to delete.</param>
-        void delete_index(value index) const
+        /// <returns>The <c>true</c> value.</returns>
+        static boolean true_value()
         {
-            runtime::translate_error_code(JsDeleteIndexedProperty(handle(), index.handle()));
+            JsValueRef trueValue;
+            runtime::translate_error_code(JsGetTrueValue(&trueValue));
+            return boolean(trueValue);
         }
 
         /// <summary>
-        ///     Delete the value at the specified index of an object.
+        ///     Gets the value of <c>false</c> in the current script context.
         /// </summary>
         /// <remarks>
         ///     Requires an active script context.
         /// </remarks>
-        /// <param name="index">The index to delete.</param>
-        void delete_index(int index) const
+        /// <returns>The <c>false</c> value.</returns>
+        static boolean false_value()
         {
-            JsValueRef indexValue;
-            runtime::translate_error_code(JsIntToNumber(index, &indexValue));
-            runtime::translate_error_code(JsDeleteIndexedProperty(handle(), indexValue));
+            JsValueRef falseValue;
+            runtime::translate_error_code(JsGetFalseValue(&falseValue));
+            return boolean(falseValue);
         }
 
         /// <summary>
-        ///     Determines whether an object has its indexed properties in external data.
+        ///     Creates a Boolean value from a <c>bool</c> value.
         /// </summary>
         /// <remarks>
         ///     Requires an active script context.
         /// </remarks>
-        /// <returns>
-        ///     Whether the object has its indexed properties in external data.
-        /// </returns>
-        bool has_external_indexes() const
+        /// <param name="value">The value to be converted.</param>
+        /// <returns>The converted value.</returns>
+        static boolean create(bool value)
         {
-            bool value;
-            runtime::translate_error_code(JsHasIndexedPropertiesExternalData(handle(), &value));
-            return value;
+            JsValueRef result;
+            runtime::translate_error_code(marshal::from_native(value, &result));
+            return boolean(result);
         }
 
         /// <summary>
-        ///     Retrieves the object's indexed properties external data.
+        ///     Converts the value to Boolean using standard JavaScript semantics.
         /// </summary>
         /// <remarks>
         ///     Requires an active script context.
         /// </remarks>
-        /// <returns>
-        ///     The object's indexed properties external data.
-        /// </returns>
-        void *external_indexes_data() const
+        /// <param name="value">The value to be converted.</param>
+        /// <returns>The converted value.</returns>
+        static boolean convert(value value);
+    };
+
+    /// <summary>
+    ///     A reference to a JavaScript number value.
+    /// </summary>
+    class number : public value
+    {
+        friend class value;
+
+        explicit number(JsValueRef ref) :
+            value(ref)
         {
-            void *data;
-            unsigned int size;
-            JsTypedArrayType type;
-            runtime::translate_error_code(JsGetIndexedPropertiesExternalData(handle(), &data, &type, &size));
-            return data;
         }
 
+    public:
         /// <summary>
-        ///     Retrieves the object's indexed properties external data size in elements.
+        ///     Creates an invalid value handle.
         /// </summary>
-        /// <remarks>
-        ///     Requires an active script context.
-        /// </remarks>
-        /// <returns>
-        ///     The object's indexed properties external data size in elements.
-        /// </returns>
-        unsigned int external_indexes_size() const
+        number() :
+            value()
         {
-            void *data;
-            unsigned int size;
-            JsTypedArrayType type;
-            runtime::translate_error_code(JsGetIndexedPropertiesExternalData(handle(), &data, &type, &size));
-            return size;
         }
 
         /// <summary>
-        ///     Retrieves the object's indexed properties external data type.
+        ///     Converts the <c>value</c> handle to a <c>number</c> handle.
         /// </summary>
         /// <remarks>
-        ///     Requires an active script context.
+        ///     The type of the underlying value is not checked.
         /// </remarks>
-        /// <returns>
-        ///     The object's indexed properties external data type.
-        /// </returns>
-        JsTypedArrayType external_indexes_type() const
+        explicit number(value object) :
+            value(object.handle())
         {
-            void *data;
-            unsigned int size;
-            JsTypedArrayType type;
-            runtime::translate_error_code(JsGetIndexedPropertiesExternalData(handle(), &data, &type, &size));
-            return type;
         }
 
         /// <summary>
-        ///     Sets an object's indexed properties to external data. The external data will be used as back
-        ///     store for the object's indexed properties and accessed like a typed array.
+        ///     Retrieves the <c>int</c> value of a number value.
         /// </summary>
         /// <remarks>
         ///     Requires an active script context.
         /// </remarks>
-        /// <param name="data">The external data to be used as back store for the object's indexed properties.</param>
-        /// <param name="arrayType">The array element type in the external data.</param>
-        /// <param name="size">The number of array elements in the external data.</param>
-        template<class T, bool clamped = false>
-        void set_external_indexes(void *data, unsigned int size)
+        /// <returns>The <c>int</c> value.</returns>
+        int as_int() const
         {
-            runtime::translate_error_code(JsSetIndexedPropertiesToExternalData(handle(), data, typed_array_type<T, clamped>::type, size));
+            int result;
+            runtime::translate_error_code(marshal::to_native(_ref, &result));
+            return result;
         }
 
         /// <summary>
-        ///     Sets an object's indexed properties to external data. The external data will be used as back
-        ///     store for the object's indexed properties and accessed like a typed array.
+        ///     Retrieves the <c>double</c> value of a number value.
         /// </summary>
         /// <remarks>
         ///     Requires an active script context.
         /// </remarks>
-        /// <param name="data">The external data to be used as back store for the object's indexed properties.</param>
-        /// <param name="arrayType">The array element type in the external data.</param>
-        /// <param name="size">The number of array elements in the external data.</param>
-        template<class T, bool clamped>
-        void set_external_indexes(typed_array<T, clamped> array)
+        /// <returns>The <c>double</c> value.</returns>
+        double as_double() const
         {
-            runtime::translate_error_code(JsSetIndexedPropertiesToExternalData(handle(), static_cast<void *>(array.data()), array.type(), array.data_size() / array.element_size()));
+            double result;
+            runtime::translate_error_code(marshal::to_native(_ref, &result));
+            return result;
         }
 
         /// <summary>
-        ///     Unwraps a JavaScript object to an <c>IInspectable</c> pointer
+        ///     Creates a number value from a <c>double</c> value.
         /// </summary>
         /// <remarks>
-        ///     <para>
-        ///     Hosts are responsible for enforcing COM threading rules.
-        ///     </para>
-        ///     <para>
         ///     Requires an active script context.
-        ///     </para>
         /// </remarks>
-        /// <returns>
-        ///     The <c>IInspectable</c> value of the object.
-        /// </returns>
-        IInspectable *to_inspectable() const
+        /// <param name="value">The <c>double</c> to convert to a number value.</param>
+        /// <returns>The new number value.</returns>
+        static number create(double value)
         {
-            IInspectable *inspectable;
-            runtime::translate_error_code(JsObjectToInspectable(_ref, &inspectable));
-            return inspectable;
+            JsValueRef result;
+            runtime::translate_error_code(marshal::from_native(value, &result));
+            return number(result);
         }
 
         /// <summary>
-        ///     Creates an object that is a projection of the passed in <c>IInspectable</c> pointer.
+        ///     Creates a number value from an <c>int</c> value.
         /// </summary>
         /// <remarks>
-        ///     <para>
-        ///     The projected value can be used by script to call an IInspectable object.
-        ///     Hosts are responsible for enforcing COM threading rules.
-        ///     </para>
-        ///     <para>
         ///     Requires an active script context.
-        ///     </para>
         /// </remarks>
-        /// <param name="inspectable">A <c>IInspectable</c> to be projected.</param>
-        /// <returns>
-        ///     A JavaScript object that is a projection of the <c>IInspectable</c>.
-        /// </returns>
-        static object create(IInspectable *value)
+        /// <param name="value">The <c>int</c> to convert to a number value.</param>
+        /// <returns>The new number value.</returns>
+        static number create(int value)
         {
             JsValueRef result;
-            runtime::translate_error_code(JsInspectableToObject(value, &result));
-            return object(result);
+            runtime::translate_error_code(marshal::from_native(value, &result));
+            return number(result);
         }
 
         /// <summary>
-        ///     Creates a new object.
+        ///     Converts the value to number using standard JavaScript semantics.
         /// </summary>
         /// <remarks>
         ///     Requires an active script context.
         /// </remarks>
-        /// <returns>The new object.</returns>
-        static object create()
-        {
-            JsValueRef objectValue;
-            runtime::translate_error_code(JsCreateObject(&objectValue));
-            return object(objectValue);
-        }
+        /// <param name="value">The value to be converted.</param>
+        /// <returns>The converted value.</returns>
+        static number convert(value value);
     };
 
     /// <summary>
-    ///     A reference to an external JavaScript object (i.e. one that wraps a void pointer).
+    ///     A reference to a JavaScript string value.
     /// </summary>
-    class external_object : public object
+    class string : public value
     {
         friend class value;
 
-        explicit external_object(JsValueRef ref) :
-            object(ref)
+        explicit string(JsValueRef ref) :
+            value(ref)
         {
         }
 
     public:
         /// <summary>
-        ///     Creates an invalid object handle.
+        ///     Creates an invalid value handle.
         /// </summary>
-        external_object() :
-            object()
+        string() :
+            value()
         {
         }
 
         /// <summary>
-        ///     Converts the <c>value</c> handle to an external <c>object</c> handle.
+        ///     Converts the <c>value</c> handle to a <c>string</c> handle.
         /// </summary>
         /// <remarks>
         ///     The type of the underlying value is not checked.
         /// </remarks>
-        explicit external_object(value object) :
-            object(object.handle())
+        explicit string(value object) :
+            value(object.handle())
         {
         }
 
         /// <summary>
-        ///     Retrieves the data from an external object.
+        ///     Gets the length of a string value.
         /// </summary>
         /// <remarks>
         ///     Requires an active script context.
         /// </remarks>
-        /// <returns>
-        ///     The external data stored in the object. Can be null if no external data is stored
-        ///     in the object.
-        /// </returns>
-        void *data() const
+        /// <returns>The length of the string.</returns>
+        int length() const
         {
-            void *data;
-            runtime::translate_error_code(JsGetExternalData(handle(), &data));
-            return data;
+            int length;
+            runtime::translate_error_code(JsGetStringLength(_ref, &length));
+            return length;
         }
 
         /// <summary>
-        ///     Sets the external data on an external object.
+        ///     Returns the underlying string value.
         /// </summary>
-        /// <remarks>
-        ///     Requires an active script context.
-        /// </remarks>
-        /// <param name="data">
-        ///     The external data to be stored in the object. Can be null if no external data is 
-        ///     to be stored in the object.
-        /// </param>
-        void set_data(void *data) const
+        std::wstring data() const
         {
-            runtime::translate_error_code(JsSetExternalData(handle(), data));
+            std::wstring result;
+            runtime::translate_error_code(marshal::to_native(_ref, &result));
+            return result;
         }
 
         /// <summary>
-        ///     A finalizer callback.
+        ///     Creates a string value from a <c>std::wstring</c>.
         /// </summary>
-        /// <param name="data">
-        ///     The external data that was passed in when creating the object being finalized.
-        /// </param>
-        typedef void (CALLBACK *Finalize)(void *data);
+        /// <remarks>
+        ///     Requires an active script context.
+        /// </remarks>
+        /// <param name="value">The string to convert to a string value.</param>
+        /// <returns>The new string value.</returns>
+        static string create(std::wstring value)
+        {
+            JsValueRef result;
+            runtime::translate_error_code(marshal::from_native(value, &result));
+            return string(result);
+        }
 
         /// <summary>
-        ///     Creates a new object that stores some external data.
+        ///     Converts the value to string using standard JavaScript semantics.
         /// </summary>
         /// <remarks>
         ///     Requires an active script context.
         /// </remarks>
-        /// <param name="data">External data that the object will represent. May be null.</param>
-        /// <param name="finalizeCallback">
-        ///     A callback for when the object is finalized. May be null.
-        /// </param>
-        /// <returns>The new object.</returns>
-        static external_object create(void *data = nullptr, Finalize finalizeCallback = nullptr)
-        {
-            JsValueRef object;
-            runtime::translate_error_code(JsCreateExternalObject(data, finalizeCallback, &object));
-            return external_object(object);
-        }
+        /// <param name="value">The value to be converted.</param>
+        /// <returns>The converted value.</returns>
+        static string convert(value value);
     };
 
     /// <summary>
-    ///     Represents an element of a JavaScript array.
+    ///     A unique symbol that can be used as a property identifier.
     /// </summary>
-    template<class T>
-    class array_element
+    class symbol : public value
     {
-        value _array;
-        value _index;
+        friend class marshal;
+        friend class property_id;
+
+        explicit symbol(JsValueRef symbol) :
+            value(symbol)
+        {
+        }
 
     public:
         /// <summary>
-        ///     Creates a new JavaScript array element handle.
+        ///     Constructs an invalid symbol.
         /// </summary>
-        /// <param name="array">The array the element is from.</param>
-        /// <param name="index">The index of the element.</param>
-        array_element(array<T> array, value index) :
-            _array(array), _index(index)
+        symbol() :
+            value()
         {
         }
 
         /// <summary>
-        ///     Creates a new JavaScript array element handle.
+        ///     Creates a new symbol. 
         /// </summary>
-        /// <param name="array">The array the element is from.</param>
-        /// <param name="index">The index of the element.</param>
-        array_element(typed_array<T> array, value index) :
-            _array(array), _index(index)
+        /// <remarks>
+        ///     <para>
+        ///     Symbols are specific to a context and cannot be used across contexts.
+        ///     </para>
+        ///     <para>
+        ///     Requires an active script context.
+        ///     </para>
+        /// </remarks>
+        /// <param name="description">
+        ///     A description of the symbol, can be empty.
+        /// </param>
+        /// <returns>The new symbol.</returns>
+        static symbol create(const std::wstring description)
         {
+            JsValueRef symbol_value;
+            string description_value = string::create(description);
+            runtime::translate_error_code(JsCreateSymbol(description_value.handle(), &symbol_value));
+            return symbol(symbol_value);
         }
+    };
 
-        array_element operator=(T value)
-        {
-            JsValueRef valueReference;
-            runtime::translate_error_code(marshal::from_native<T>(value, &valueReference));
-            runtime::translate_error_code(JsSetIndexedProperty(_array.handle(), _index.handle(), valueReference));
-            return *this;
-        }
+    template<class T, bool clamped>
+    struct typed_array_type
+    {
+    };
 
-        operator T()
-        {
-            JsValueRef valueReference;
-            runtime::translate_error_code(JsGetIndexedProperty(_array.handle(), _index.handle(), &valueReference));
+    template<>
+    struct typed_array_type<char, false>
+    {
+        static const JsTypedArrayType type = JsArrayTypeInt8;
+        static const std::wstring type_name;
+        static const int size = 1;
+    };
 
-            T value;
-            runtime::translate_error_code(marshal::to_native(valueReference, &value));
+    template<>
+    struct typed_array_type<unsigned char, false>
+    {
+        static const JsTypedArrayType type = JsArrayTypeUint8;
+        static const std::wstring type_name;
+        static const int size = 1;
+    };
 
-            return value;
-        }
+    template<>
+    struct typed_array_type<unsigned char, true>
+    {
+        static const JsTypedArrayType type = JsArrayTypeUint8Clamped;
+        static const int size = 1;
+    };
+
+    template<>
+    struct typed_array_type<short, false>
+    {
+        static const JsTypedArrayType type = JsArrayTypeInt16;
+        static const std::wstring type_name;
+        static const int size = 2;
+    };
+
+    template<>
+    struct typed_array_type<unsigned short, false>
+    {
+        static const JsTypedArrayType type = JsArrayTypeUint16;
+        static const std::wstring type_name;
+        static const int size = 2;
+    };
+
+    template<>
+    struct typed_array_type<int, false>
+    {
+        static const JsTypedArrayType type = JsArrayTypeInt32;
+        static const std::wstring type_name;
+        static const int size = 4;
+    };
+
+    template<>
+    struct typed_array_type<unsigned int, false>
+    {
+        static const JsTypedArrayType type = JsArrayTypeUint32;
+        static const std::wstring type_name;
+        static const int size = 4;
+    };
+
+    template<>
+    struct typed_array_type<float, false>
+    {
+        static const JsTypedArrayType type = JsArrayTypeFloat32;
+        static const std::wstring type_name;
+        static const int size = 4;
+    };
+
+    template<>
+    struct typed_array_type<double, false>
+    {
+        static const JsTypedArrayType type = JsArrayTypeFloat64;
+        static const std::wstring type_name;
+        static const int size = 8;
     };
 
     /// <summary>
-    ///     A reference to a JavaScript array.
+    ///     Whether a native type is the element type of some TypedArray.
     /// </summary>
-    template<class T = value>
-    class array : public object
+    template<class T>
+    struct is_typed_array_element :
+        std::integral_constant<bool,
+            std::is_same<T, char>::value ||
+            std::is_same<T, unsigned char>::value ||
+            std::is_same<T, short>::value ||
+            std::is_same<T, unsigned short>::value ||
+            std::is_same<T, int>::value ||
+            std::is_same<T, unsigned int>::value ||
+            std::is_same<T, float>::value ||
+            std::is_same<T, double>::value>
     {
-        friend class object;
-        friend class value;
+    };
 
-        explicit array(JsValueRef ref) :
-            object(ref)
+    /// <summary>
+    ///     A reference to a JavaScript object.
+    /// </summary>
+    class object : public value
+    {
+        friend class function_base;
+        friend class context;
+        friend class marshal;
+
+    protected:
+        explicit object(JsValueRef ref) :
+            value(ref)
         {
         }
 
     public:
         /// <summary>
-        ///     Creates an invalid handle to an array.
+        ///     Creates an invalid object handle.
         /// </summary>
-        array() :
-            object()
+        object() :
+            value()
         {
         }
 
         /// <summary>
-        ///     Converts the <c>value</c> handle to an <c>array</c> handle.
+        ///     Converts the <c>value</c> handle to an <c>object</c> handle.
         /// </summary>
         /// <remarks>
         ///     The type of the underlying value is not checked.
         /// </remarks>
-        explicit array(value object) :
-            object(object.handle())
-        {
-        }
-
-        array_element<T> operator [](int index)
+        explicit object(value object) :
+            value(object.handle())
         {
-            return array_element<T>(*this, number::create(index));
         }
 
         /// <summary>
-        ///     Gets the size of an array value.
+        ///     Determines whether an object is an external object.
         /// </summary>
         /// <remarks>
         ///     Requires an active script context.
         /// </remarks>
-        /// <returns>The size of the array.</returns>
-        int size() const
+        /// <returns>Whether the object is an external object.</returns>
+        bool is_external() const
         {
-            JsPropertyIdRef lengthName;
-            JsValueRef lengthValue;
-            int length;
+            bool hasExternalData;
+            runtime::translate_error_code(JsHasExternalData(handle(), &hasExternalData));
 
-            // CONSIDER: Caching this somewhere?
-            runtime::translate_error_code(JsGetPropertyIdFromName(L"length", &lengthName));
-            runtime::translate_error_code(JsGetProperty(handle(), lengthName, &lengthValue));
-            runtime::translate_error_code(JsNumberToInt(lengthValue, &length));
-            return length;
+            return hasExternalData;
         }
 
         /// <summary>
-        ///     Creates a JavaScript array object.
+        ///     Returns a value that indicates whether an object is extensible or not.
         /// </summary>
         /// <remarks>
         ///     Requires an active script context.
         /// </remarks>
-        /// <param name="length">The initial length of the array.</param>
-        /// <returns>The new array object.</returns>
-        static array<T> create(unsigned int length)
+        /// <returns>Whether the object is extensible or not.</returns>
+        bool is_extension_allowed() const
         {
-            JsValueRef array;
-            runtime::translate_error_code(JsCreateArray(length, &array));
-            return jsrt::array<T>(array);
+            bool isExtensionaAllowed;
+            runtime::translate_error_code(JsGetExtensionAllowed(handle(), &isExtensionaAllowed));
+            return isExtensionaAllowed;
         }
 
         /// <summary>
-        ///     Creates a JavaScript array object.
+        ///     Returns the prototype of an object.
         /// </summary>
         /// <remarks>
         ///     Requires an active script context.
         /// </remarks>
-        /// <param name="values">The initial values of the array.</param>
-        /// <returns>The new array object.</returns>
-        static array<T> create(std::initializer_list<T> values)
-        {
-            array<T> array = create(static_cast<unsigned int>(values.size()));
-            int index = 0;
-            for (auto iter = values.begin(); iter != values.end(); ++iter)
-            {
-                array[index++] = *iter;
-            }
-
-            return array;
-        }
-    };
-
-    /// <summary>
-    ///     A reference to an ArrayBuffer.
-    /// </summary>
-    class array_buffer : public object
-    {
-        explicit array_buffer(JsValueRef ref) :
-            object(ref)
+        /// <returns>The object's prototype.</returns>
+        object prototype() const
         {
+            JsValueRef prototype;
+            runtime::translate_error_code(JsGetPrototype(handle(), &prototype));
+            return object(prototype);
         }
 
-    public:
         /// <summary>
-        ///     Creates an invalid handle to an ArrayBuffer.
+        ///     Sets the prototype of an object.
         /// </summary>
-        array_buffer() :
-            object()
+        /// <remarks>
+        ///     Requires an active script context.
+        /// </remarks>
+        /// <returns>The object's new prototype.</returns>
+        void set_prototype(object prototype) const
         {
+            runtime::translate_error_code(JsSetPrototype(handle(), prototype.handle()));
         }
 
         /// <summary>
-        ///     Converts the <c>value</c> handle to an <c>array_buffer</c> handle.
+        ///     Makes an object non-extensible.
         /// </summary>
         /// <remarks>
-        ///     The type of the underlying value is not checked.
+        ///     Requires an active script context.
         /// </remarks>
-        explicit array_buffer(value object) :
-            object(object.handle())
+        void prevent_extension() const
         {
+            runtime::translate_error_code(JsPreventExtension(handle()));
         }
 
         /// <summary>
-        ///     Retrieves the data from the ArrayBuffer.
+        ///     Gets an object's property.
         /// </summary>
         /// <remarks>
-        ///     <para>
         ///     Requires an active script context.
-        ///     </para>
-        ///     <para>
-        ///     The lifetime of the data returned is the same as the lifetime of the ArrayBuffer.
-        ///     The pointer does not count as a reference to the ArrayBuffer for the purposes
-        ///     of garbage collection.
-        ///     </para>
         /// </remarks>
-        /// <returns>
-        ///     The data stored in the ArrayBuffer.
-        /// </returns>
-        unsigned char *data() const
+        /// <param name="name">The ID of the property.</param>
+        /// <returns>The value of the property.</returns>
+        template<class T = value>
+        T get_property(property_id name)
         {
-            unsigned char *data;
-            unsigned int size;
-            runtime::translate_error_code(JsGetArrayBufferStorage(handle(), &data, &size));
-            return data;
+            JsValueRef value;
+            runtime::translate_error_code(JsGetProperty(handle(), name.handle(), &value));
+
+            T returnValue;
+            runtime::translate_error_code(marshal::to_native(value, &returnValue));
+
+            return returnValue;
         }
 
         /// <summary>
-        ///     Retrieves the size of the data in the ArrayBuffer in bytes.
+        ///     Gets a property descriptor for an object's own property.
         /// </summary>
         /// <remarks>
         ///     Requires an active script context.
         /// </remarks>
-        /// <returns>
-        ///     The size of the data stored in the ArrayBuffer in bytes.
-        /// </returns>
-        unsigned int size() const
+        /// <param name="name">The ID of the property.</param>
+        /// <returns>The property descriptor.</returns>
+        template<class T = value>
+        property_descriptor<T> get_own_property_descriptor(property_id name)
         {
-            unsigned char *data;
-            unsigned int size;
-            runtime::translate_error_code(JsGetArrayBufferStorage(handle(), &data, &size));
-            return size;
+            JsValueRef valueHandle;
+            runtime::translate_error_code(JsGetOwnPropertyDescriptor(handle(), name.handle(), &valueHandle));
+
+            return property_descriptor<T>(value(valueHandle));
         }
 
         /// <summary>
-        ///     Creates a JavaScript ArrayBuffer object.
+        ///     Gets the list of all named properties on the object.
         /// </summary>
         /// <remarks>
         ///     Requires an active script context.
         /// </remarks>
-        /// <param name="length">The initial byte length of the ArrayBuffer.</param>
-        /// <returns>The new ArrayBuffer object.</returns>
-        static array_buffer create(unsigned int length)
-        {
-            JsValueRef array;
-            runtime::translate_error_code(JsCreateArrayBuffer(length, &array));
-            return array_buffer(array);
-        }
-    };
-
-    /// <summary>
-    ///     A reference to a DataView.
-    /// </summary>
-    template<endedness byte_order = endedness::little_endian>
-    class data_view : public object
-    {
-        explicit data_view(JsValueRef ref) :
-            object(ref)
-        {
-        }
+        /// <returns>An array of property names.</returns>
+        std::vector<std::wstring> get_own_property_names() const;
 
-    public:
         /// <summary>
-        ///     Creates an invalid handle to a DataView.
+        ///     Gets the list of all symbol properties on the object.
         /// </summary>
-        data_view() :
-            object()
-        {
-        }
+        /// <remarks>
+        ///     Requires an active script context.
+        /// </remarks>
+        /// <returns>An array of property symbols.</returns>
+        std::vector<symbol> get_own_property_symbols() const;
 
         /// <summary>
-        ///     Converts the <c>value</c> handle to an <c>data_view</c> handle.
+        ///     Puts an object's property.
         /// </summary>
         /// <remarks>
-        ///     The type of the underlying value is not checked.
+        ///     Requires an active script context.
         /// </remarks>
-        explicit data_view(value object) :
-            object(object.handle())
+        /// <param name="name">The ID of the property.</param>
+        /// <param name="value">The new value of the property.</param>
+        /// <param name="use_strict_rules">The property set should follow strict mode rules.</param>
+        template<class T = value>
+        void set_property(property_id name, T value, bool use_strict_rules = true)
         {
+            JsValueRef valueReference;
+            runtime::translate_error_code(marshal::from_native(value, &valueReference));
+
+            runtime::translate_error_code(JsSetProperty(handle(), name.handle(), valueReference, use_strict_rules));
         }
 
         /// <summary>
-        ///     Retrieves the data from the DataView.
+        ///     Determines whether an object has a property.
         /// </summary>
         /// <remarks>
-        ///     <para>
         ///     Requires an active script context.
-        ///     </para>
-        ///     <para>
-        ///     The lifetime of the data returned is the same as the lifetime of the DataView.
-        ///     The pointer does not count as a reference to the DataView for the purposes
-        ///     of garbage collection.
-        ///     </para>
         /// </remarks>
-        /// <returns>
-        ///     The data stored in the DataView.
-        /// </returns>
-        unsigned char *data() const
+        /// <param name="name">The ID of the property.</param>
+        /// <returns>Whether the object (or a prototype) has the property.</returns>
+        bool has_property(property_id name) const
         {
-            unsigned char *data;
-            unsigned int size;
-            runtime::translate_error_code(JsGetDataViewStorage(handle(), &data, &size));
-            return data;
+            bool hasProperty;
+            runtime::translate_error_code(JsHasProperty(handle(), name.handle(), &hasProperty));
+            return hasProperty;
         }
 
         /// <summary>
-        ///     Retrieves the size of the data in the DataView in bytes.
+        ///     Deletes an object's property.
         /// </summary>
         /// <remarks>
         ///     Requires an active script context.
         /// </remarks>
-        /// <returns>
-        ///     The size of the data stored in the DataView in bytes.
-        /// </returns>
-        unsigned int size() const
+        /// <param name="name">The ID of the property.</param>
+        /// <param name="use_strict_rules">The property set should follow strict mode rules.</param>
+        /// <results>Whether the property was deleted.</results>
+        template<class T = value>
+        T delete_property(property_id name, bool use_strict_rules = true)
         {
-            unsigned char *data;
-            unsigned int size;
-            runtime::translate_error_code(JsGetDataViewStorage(handle(), &data, &size));
-            return size;
+            JsValueRef value;
+            runtime::translate_error_code(JsDeleteProperty(handle(), name.handle(), use_strict_rules, &value));
+
+            T returnValue;
+            runtime::translate_error_code(marshal::to_native(value, &returnValue));
+
+            return returnValue;
         }
 
         /// <summary>
-        ///     Gets a typed value from the <c>data_view</c>.
+        ///     Defines a new object's own property from a property descriptor.
         /// </summary>
-        /// <param name="offset">The byte offset of the value.</param>
-        /// <returns>The value at that position.</returns>
+        /// <remarks>
+        ///     Requires an active script context.
+        /// </remarks>
+        /// <param name="name">The ID of the property.</param>
+        /// <param name="descriptor">The property descriptor.</param>
+        /// <result>Whether the property was defined.</result>
         template<class T>
-        T get(int offset)
+        bool define_property(property_id name, property_descriptor<T> descriptor)
         {
-            if (typed_array_type<T, false>::size > 1)
-            {
-                auto accessor = get_property<function<T, int, bool>>(jsrt::property_id::create(static_cast<std::wstring>(L"get") + typed_array_type<T, false>::type_name));
-                return accessor(jsrt::value(handle()), offset, byte_order == endedness::little_endian);
-            }
+            bool value;
+            runtime::translate_error_code(JsDefineProperty(handle(), name.handle(), descriptor.handle(), &value));
 
-            auto accessor = get_property<function<T, int>>(jsrt::property_id::create(static_cast<std::wstring>(L"get") + typed_array_type<T, false>::type_name));
-            return accessor(jsrt::value(handle()), offset);
+            return value;
         }
 
         /// <summary>
-        ///     Sets a typed value into the <c>data_view</c>.
+        ///     Retrieve the value at the specified index of an object.
         /// </summary>
-        /// <param name="offset">The byte offset to set.</param>
-        /// <param name="value">The value to set.</param>
-        template<class T>
-        void set(int offset, T value)
+        /// <remarks>
+        ///     Requires an active script context.
+        /// </remarks>
+        /// <param name="index">The index to retrieve.</param>
+        /// <returns>The retrieved value.</returns>
+        template<class T = value>
+        T get_index(value index)
         {
-            if (typed_array_type<T, false>::size > 1)
-            {
-                auto accessor = get_property<function<void, int, T, bool>>(jsrt::property_id::create(static_cast<std::wstring>(L"set") + typed_array_type<T, false>::type_name));
-                accessor(jsrt::value(handle()), offset, value, byte_order == endedness::little_endian);
-            }
-            else
-            {
-                auto accessor = get_property<function<void, int, T>>(jsrt::property_id::create(static_cast<std::wstring>(L"set") + typed_array_type<T, false>::type_name));
-                accessor(jsrt::value(handle()), offset, value);
-            }
+            JsValueRef value;
+            runtime::translate_error_code(JsGetIndexedProperty(handle(), index.handle(), &value));
+
+            T returnValue;
+            runtime::translate_error_code(marshal::to_native(value, &returnValue));
+
+            return returnValue;
         }
 
         /// <summary>
-        ///     Creates a JavaScript DataView object.
+        ///     Retrieve the value at the specified index of an object.
         /// </summary>
         /// <remarks>
         ///     Requires an active script context.
         /// </remarks>
-        /// <param name="buffer">The underlying <c>array_buffer</c>.</param>
-        /// <returns>The new DataView object.</returns>
-        static data_view create(array_buffer buffer)
+        /// <param name="index">The index to retrieve.</param>
+        /// <returns>The retrieved value.</returns>
+        template<class T = value>
+        T get_index(int index)
         {
-            JsValueRef view;
-            runtime::translate_error_code(JsCreateDataView(buffer.handle(), 0, buffer.size(), &view));
-            return data_view(view);
+            JsValueRef indexValue;
+            runtime::translate_error_code(JsIntToNumber(index, &indexValue));
+
+            JsValueRef value;
+            runtime::translate_error_code(JsGetIndexedProperty(handle(), indexValue, &value));
+
+            T returnValue;
+            runtime::translate_error_code(marshal::to_native(value, &returnValue));
+
+            return returnValue;
         }
 
         /// <summary>
-        ///     Creates a JavaScript DataView object.
+        ///     Set the value at the specified index of an object.
         /// </summary>
         /// <remarks>
         ///     Requires an active script context.
         /// </remarks>
-        /// <param name="buffer">The underlying <c>array_buffer</c>.</param>
-        /// <param name="offset">The offset in the <c>array_buffer</c> to start. </param>
-        /// <returns>The new DataView object.</returns>
-        static data_view create(array_buffer buffer, unsigned int offset)
+        /// <param name="index">The index to set.</param>
+        /// <param name="value">The value to set.</param>
+        template<class T = value>
+        void set_index(value index, T value)
         {
-            JsValueRef view;
-            runtime::translate_error_code(JsCreateDataView(buffer.handle(), offset, buffer.size(), &view));
-            return data_view(view);
+            JsValueRef valueReference;
+            runtime::translate_error_code(marshal::from_native(value, &valueReference));
+
+            runtime::translate_error_code(JsSetIndexedProperty(handle(), index.handle(), valueReference));
         }
 
         /// <summary>
-        ///     Creates a JavaScript DataView object.
+        ///     Set the value at the specified index of an object.
         /// </summary>
         /// <remarks>
         ///     Requires an active script context.
         /// </remarks>
-        /// <param name="buffer">The underlying <c>array_buffer</c>.</param>
-        /// <param name="offset">The offset in the <c>array_buffer</c> to start. </param>
-        /// <param name="length">The length in the <c>array_buffer</c> to reference.</param>
-        /// <returns>The new DataView object.</returns>
-        static data_view create(array_buffer buffer, unsigned int offset, unsigned int length)
+        /// <param name="index">The index to set.</param>
+        /// <param name="value">The value to set.</param>
+        template<class T = value>
+        void set_index(int index, T value)
         {
-            JsValueRef view;
-            runtime::translate_error_code(JsCreateDataView(buffer.handle(), offset, length, &view));
-            return data_view(view);
+            JsValueRef indexValue;
+            runtime::translate_error_code(JsIntToNumber(index, &indexValue));
+
+            JsValueRef valueReference;
+            runtime::translate_error_code(marshal::from_native(value, &valueReference));
+
+            runtime::translate_error_code(JsSetIndexedProperty(handle(), indexValue, valueReference));
         }
-    };
 
-    /// <summary>
-    ///     A reference to a TypedArray.
-    /// </summary>
-    template<class T, bool clamped>
-    class typed_array : public object
-    {
-        explicit typed_array(JsValueRef ref) :
-            object(ref)
+        /// <summary>
+        ///     Tests whether an object has a value at the specified index.
+        /// </summary>
+        /// <remarks>
+        ///     Requires an active script context.
+        /// </remarks>
+        /// <param name="index">The index to test.</param>
+        /// <returns>Whether the object has an value at the specified index.</returns>
+        bool has_index(value index) const
         {
+            bool hasProperty;
+            runtime::translate_error_code(JsHasIndexedProperty(handle(), index.handle(), &hasProperty));
+            return hasProperty;
         }
 
-    public:
         /// <summary>
-        ///     Creates an invalid handle to a TypedArray.
+        ///     Tests whether an object has a value at the specified index.
         /// </summary>
-        typed_array() :
-            object()
+        /// <remarks>
+        ///     Requires an active script context.
+        /// </remarks>
+        /// <param name="index">The index to test.</param>
+        /// <returns>Whether the object has an value at the specified index.</returns>
+        bool has_index(int index) const
         {
+            JsValueRef indexValue;
+            runtime::translate_error_code(JsIntToNumber(index, &indexValue));
+
+            bool hasProperty;
+            runtime::translate_error_code(JsHasIndexedProperty(handle(), indexValue, &hasProperty));
+            return hasProperty;
         }
 
         /// <summary>
-        ///     Converts the <c>value</c> handle to an <c>typed_array</c> handle.
+        ///     Delete the value at the specified index of an object.
         /// </summary>
         /// <remarks>
-        ///     The type of the underlying value is not checked.
+        ///     Requires an active script context.
         /// </remarks>
-        explicit typed_array(value object) :
-            object(object.handle())
+        /// <param name="index">The index to delete.</param>
+        void delete_index(value index) const
         {
+            runtime::translate_error_code(JsDeleteIndexedProperty(handle(), index.handle()));
         }
 
-        array_element<T> operator [](int index)
+        /// <summary>
+        ///     Delete the value at the specified index of an object.
+        /// </summary>
+        /// <remarks>
+        ///     Requires an active script context.
+        /// </remarks>
+        /// <param name="index">The index to delete.</param>
+        void delete_index(int index) const
         {
-            return array_element<T>(*this, number::create(index));
+            JsValueRef indexValue;
+            runtime::translate_error_code(JsIntToNumber(index, &indexValue));
+            runtime::translate_error_code(JsDeleteIndexedProperty(handle(), indexValue));
         }
 
         /// <summary>
-        ///     Retrieves the data from the TypedArray.
+        ///     Determines whether an object has its indexed properties in external data.
         /// </summary>
         /// <remarks>
-        ///     <para>
         ///     Requires an active script context.
-        ///     </para>
-        ///     <para>
-        ///     The lifetime of the data returned is the same as the lifetime of the TypedArray.
-        ///     The pointer does not count as a reference to the TypedArray for the purposes
-        ///     of garbage collection.
-        ///     </para>
         /// </remarks>
         /// <returns>
-        ///     The data stored in the TypedArray.
+        ///     Whether the object has its indexed properties in external data.
         /// </returns>
-        unsigned char *data() const
+        bool has_external_indexes() const
         {
-            unsigned char *data;
-            unsigned int size;
-            JsTypedArrayType type;
-            int element_size;
-            runtime::translate_error_code(JsGetTypedArrayStorage(handle(), &data, &size, &type, &element_size));
-            return data;
+            bool value;
+            runtime::translate_error_code(JsHasIndexedPropertiesExternalData(handle(), &value));
+            return value;
         }
 
         /// <summary>
-        ///     Retrieves the size of the data in the TypedArray in bytes.
+        ///     Retrieves the object's indexed properties external data.
         /// </summary>
         /// <remarks>
         ///     Requires an active script context.
         /// </remarks>
         /// <returns>
-        ///     The size of the data stored in the TypedArray in bytes.
+        ///     The object's indexed properties external data.
         /// </returns>
-        unsigned int data_size() const
+        void *external_indexes_data() const
         {
-            unsigned char *data;
+            void *data;
             unsigned int size;
             JsTypedArrayType type;
-            int element_size;
-            runtime::translate_error_code(JsGetTypedArrayStorage(handle(), &data, &size, &type, &element_size));
-            return size;
+            runtime::translate_error_code(JsGetIndexedPropertiesExternalData(handle(), &data, &type, &size));
+            return data;
         }
 
         /// <summary>
-        ///     Retrieves the type of the data in the TypedArray.
+        ///     Retrieves the object's indexed properties external data size in elements.
         /// </summary>
         /// <remarks>
         ///     Requires an active script context.
         /// </remarks>
         /// <returns>
-        ///     The type of the data stored in the TypedArray.
+        ///     The object's indexed properties external data size in elements.
         /// </returns>
-        JsTypedArrayType type() const
+        unsigned int external_indexes_size() const
         {
-            unsigned char *data;
+            void *data;
             unsigned int size;
             JsTypedArrayType type;
-            int element_size;
-            runtime::translate_error_code(JsGetTypedArrayStorage(handle(), &data, &size, &type, &element_size));
-            return type;
+            runtime::translate_error_code(JsGetIndexedPropertiesExternalData(handle(), &data, &type, &size));
+            return size;
         }
 
         /// <summary>
-        ///     Retrieves the element size in bytes of the data in the TypedArray.
+        ///     Retrieves the object's indexed properties external data type.
         /// </summary>
         /// <remarks>
         ///     Requires an active script context.
         /// </remarks>
         /// <returns>
-        ///     The element size in bytesof the data stored in the TypedArray.
+        ///     The object's indexed properties external data type.
         /// </returns>
-        int element_size() const
+        JsTypedArrayType external_indexes_type() const
         {
-            unsigned char *data;
+            void *data;
             unsigned int size;
             JsTypedArrayType type;
-            int element_size;
-            runtime::translate_error_code(JsGetTypedArrayStorage(handle(), &data, &size, &type, &element_size));
-            return element_size;
+            runtime::translate_error_code(JsGetIndexedPropertiesExternalData(handle(), &data, &type, &size));
+            return type;
         }
 
         /// <summary>
-        ///     Creates a JavaScript TypedArray object.
+        ///     Sets an object's indexed properties to external data. The external data will be used as back
+        ///     store for the object's indexed properties and accessed like a typed array.
         /// </summary>
         /// <remarks>
         ///     Requires an active script context.
         /// </remarks>
-        /// <param name="length">The length of the new TypedArray.</param>
-        /// <returns>The new TypedArray object.</returns>
-        static typed_array create(unsigned int length)
+        /// <param name="data">The external data to be used as back store for the object's indexed properties.</param>
+        /// <param name="arrayType">The array element type in the external data.</param>
+        /// <param name="size">The number of array elements in the external data.</param>
+        template<class T, bool clamped = false>
+        void set_external_indexes(void *data, unsigned int size)
         {
-            JsValueRef array;
-            array_buffer base = array_buffer::create(typed_array_type<T, clamped>::size * length);
-            runtime::translate_error_code(JsCreateTypedArray(typed_array_type<T, clamped>::type, base.handle(), 0, length, &array));
-            // TODO: This is broken in Windows 10 TH2, incorrectly returns JsInvalidArgument
-            //runtime::translate_error_code(JsCreateTypedArray(typed_array_type<T, clamped>::type, JS_INVALID_REFERENCE, 0, length, &array));
-            return typed_array(array);
+            runtime::translate_error_code(JsSetIndexedPropertiesToExternalData(handle(), data, typed_array_type<T, clamped>::type, size));
         }
 
         /// <summary>
-        ///     Creates a JavaScript TypedArray object backed by an <c>array_buffer</c>.
+        ///     Sets an object's indexed properties to external data. The external data will be used as back
+        ///     store for the object's indexed properties and accessed like a typed array.
         /// </summary>
         /// <remarks>
         ///     Requires an active script context.
         /// </remarks>
-        /// <param name="buffer">The underlying <c>array_buffer</c>.</param>
-        /// <returns>The new TypedArray object.</returns>
-        static typed_array create(array_buffer buffer)
+        /// <param name="data">The external data to be used as back store for the object's indexed properties.</param>
+        /// <param name="arrayType">The array element type in the external data.</param>
+        /// <param name="size">The number of array elements in the external data.</param>
+        template<class T, bool clamped>
+        void set_external_indexes(typed_array<T, clamped> array)
         {
-            JsValueRef array;
-            runtime::translate_error_code(JsCreateTypedArray(typed_array_type<T, clamped>::type, buffer.handle(), 0, buffer.size() / typed_array_type<T, clamped>::size, &array));
-            return typed_array(array);
+            runtime::translate_error_code(JsSetIndexedPropertiesToExternalData(handle(), static_cast<void *>(array.data()), array.type(), array.data_size() / array.element_size()));
         }
 
         /// <summary>
-        ///     Creates a JavaScript TypedArray object backed by an <c>array_buffer</c>.
+        ///     Unwraps a JavaScript object to an <c>IInspectable</c> pointer
         /// </summary>
         /// <remarks>
+        ///     <para>
+        ///     Hosts are responsible for enforcing COM threading rules.
+        ///     </para>
+        ///     <para>
         ///     Requires an active script context.
+        ///     </para>
         /// </remarks>
-        /// <param name="buffer">The underlying <c>array_buffer</c>.</param>
-        /// <param name="offset">The offset in the <c>array_buffer</c> to start. </param>
-        /// <returns>The new TypedArray object.</returns>
-        static typed_array create(array_buffer buffer, unsigned int offset)
+        /// <returns>
+        ///     The <c>IInspectable</c> value of the object.
+        /// </returns>
+        IInspectable *to_inspectable() const
         {
-            JsValueRef array;
-            runtime::translate_error_code(JsCreateTypedArray(typed_array_type<T, clamped>::type, buffer.handle(), offset, buffer.size() / typed_array_type<T, clamped>::size, &array));
-            return typed_array(array);
+            IInspectable *inspectable;
+            runtime::translate_error_code(JsObjectToInspectable(_ref, &inspectable));
+            return inspectable;
         }
 
         /// <summary>
-        ///     Creates a JavaScript TypedArray object backed by an <c>array_buffer</c>.
+        ///     Creates an object that is a projection of the passed in <c>IInspectable</c> pointer.
         /// </summary>
         /// <remarks>
+        ///     <para>
+        ///     The projected value can be used by script to call an IInspectable object.
+        ///     Hosts are responsible for enforcing COM threading rules.
+        ///     </para>
+        ///     <para>
         ///     Requires an active script context.
+        ///     </para>
         /// </remarks>
-        /// <param name="buffer">The underlying <c>array_buffer</c>.</param>
-        /// <param name="offset">The offset in the <c>array_buffer</c> to start. </param>
-        /// <param name="length">The length in the <c>array_buffer</c> to reference.</param>
-        /// <returns>The new TypedArray object.</returns>
-        static typed_array create(array_buffer buffer, unsigned int offset, unsigned int length)
+        /// <param name="inspectable">A <c>IInspectable</c> to be projected.</param>
+        /// <returns>
+        ///     A JavaScript object that is a projection of the <c>IInspectable</c>.
+        /// </returns>
+        static object create(IInspectable *value)
         {
-            JsValueRef array;
-            runtime::translate_error_code(JsCreateTypedArray(typed_array_type<T, clamped>::type, buffer.handle(), offset, length, &array));
-            return typed_array(array);
+            JsValueRef result;
+            runtime::translate_error_code(JsInspectableToObject(value, &result));
+            return object(result);
         }
 
         /// <summary>
-        ///     Creates a JavaScript TypedArray object copied from another <c>typed_array</c>.
+        ///     Creates a new object.
         /// </summary>
         /// <remarks>
         ///     Requires an active script context.
         /// </remarks>
-        /// <param name="buffer">The <c>typed_array</c> to copy from.</param>
-        /// <returns>The new TypedArray object.</returns>
-        template<class base_T, bool base_clamped>
-        static typed_array create(typed_array<base_T, base_clamped> base_array)
+        /// <returns>The new object.</returns>
+        static object create()
+        {
+            JsValueRef objectValue;
+            runtime::translate_error_code(JsCreateObject(&objectValue));
+            return object(objectValue);
+        }
+    };
+
+    /// <summary>
+    ///     A reference to an external JavaScript object (i.e. one that wraps a void pointer).
+    /// </summary>
+    class external_object : public object
+    {
+        friend class value;
+
+        explicit external_object(JsValueRef ref) :
+            object(ref)
         {
-            JsValueRef array;
-            runtime::translate_error_code(JsCreateTypedArray(typed_array_type<T, clamped>::type, base_array.handle(), 0, 0, &array));
-            return typed_array(array);
         }
 
+    public:
         /// <summary>
-        ///     Creates a JavaScript TypedArray object copied from an <c>array</c>.
+        ///     Creates an invalid object handle.
+        /// </summary>
+        external_object() :
+            object()
+        {
+        }
+
+        /// <summary>
+        ///     Converts the <c>value</c> handle to an external <c>object</c> handle.
         /// </summary>
         /// <remarks>
-        ///     Requires an active script context.
+        ///     The type of the underlying value is not checked.
         /// </remarks>
-        /// <param name="buffer">The <c>array</c> to copy from.</param>
-        /// <returns>The new TypedArray object.</returns>
-        template<class U>
-        static typed_array create(array<U> base_array)
+        explicit external_object(value object) :
+            object(object.handle())
         {
-            JsValueRef array;
-            runtime::translate_error_code(JsCreateTypedArray(typed_array_type<U, clamped>::type, base_array.handle(), 0, 0, &array));
-            return typed_array(array);
         }
 
         /// <summary>
-        ///     Creates a JavaScript TypedArray object.
+        ///     Retrieves the data from an external object.
         /// </summary>
         /// <remarks>
         ///     Requires an active script context.
         /// </remarks>
-        /// <param name="values">The values to initialize the array with.</param>
-        /// <returns>The new TypedArray object.</returns>
-        static typed_array<T, false> create(std::initializer_list<T> values)
+        /// <returns>
+        ///     The external data stored in the object. Can be null if no external data is stored
+        ///     in the object.
+        /// </returns>
+        void *data() const
         {
-            auto buffer = array_buffer::create(sizeof(T) * values.size());
-            auto view = data_view<>::create(buffer);
-	        auto index = 0;
-            for (auto iter = values.begin(); iter != values.end(); ++iter)
-            {
-                view.template set<T>(sizeof(T) * index++, *iter);
-            }
+            void *data;
+            runtime::translate_error_code(JsGetExternalData(handle(), &data));
+            return data;
+        }
 
-            return create(buffer);
+        /// <summary>
+        ///     Sets the external data on an external object.
+        /// </summary>
+        /// <remarks>
+        ///     Requires an active script context.
+        /// </remarks>
+        /// <param name="data">
+        ///     The external data to be stored in the object. Can be null if no external data is 
+        ///     to be stored in the object.
+        /// </param>
+        void set_data(void *data) const
+        {
+            runtime::translate_error_code(JsSetExternalData(handle(), data));
         }
 
+        /// <summary>
+        ///     A finalizer callback.
+        /// </summary>
+        /// <param name="data">
+        ///     The external data that was passed in when creating the object being finalized.
+        /// </param>
+        typedef void (CALLBACK *Finalize)(void *data);
+
+        /// <summary>
+        ///     Creates a new object that stores some external data.
+        /// </summary>
+        /// <remarks>
+        ///     Requires an active script context.
+        /// </remarks>
+        /// <param name="data">External data that the object will represent. May be null.</param>
+        /// <param name="finalizeCallback">
+        ///     A callback for when the object is finalized. May be null.
+        /// </param>
+        /// <returns>The new object.</returns>
+        static external_object create(void *data = nullptr, Finalize finalizeCallback = nullptr)
+        {
+            JsValueRef object;
+            runtime::translate_error_code(JsCreateExternalObject(data, finalizeCallback, &object));
+            return external_object(object);
+        }
     };
 
     /// <summary>
-    ///     A reference to a JavaScript error.
+    ///     Native storage that backs the indexed properties of an object.
     /// </summary>
-    class error : public object
+    /// <remarks>
+    ///     <para>
+    ///     <c>create</c> moves a vector into storage owned by the object and attaches it as the 
+    ///     object's indexed properties, so script reads and writes <c>object[i]</c> directly in 
+    ///     native memory. The storage is freed when the object is collected. Resizing the storage 
+    ///     re-attaches it to the object.
+    ///     </para>
+    ///     <para>
+    ///     The storage uses the object's before collect callback, so that callback must not be 
+    ///     set separately, and storage can only be created once for a given object.
+    ///     </para>
+    ///     <para>
+    ///     An <c>external_indexes</c> handle is only valid while its object is alive. Like other 
+    ///     handles, it does not keep the object alive unless it is on the stack or the object has
+    ///     been referenced with <c>add_reference</c>.
+    ///     </para>
+    /// </remarks>
+    template<class T, bool clamped = false>
+    class external_indexes
     {
-        friend class value;
+        object _object;
+        std::vector<T> *_values;
 
-        static JsValueRef format_message(std::wstring message, va_list argptr)
+        external_indexes(object target, std::vector<T> *values) :
+            _object(target),
+            _values(values)
         {
-            wchar_t buffer[2048];
-            _vsnwprintf_s(buffer, _countof(buffer), _TRUNCATE, message.c_str(), argptr);
-
-            JsValueRef errorString;
-            runtime::translate_error_code(JsPointerToString(buffer, wcslen(buffer), &errorString));
+        }
 
-            return errorString;
+        static void CALLBACK before_collect(JsRef ref, void *callback_state)
+        {
+            delete static_cast<std::vector<T> *>(callback_state);
         }
 
-    protected:
-        explicit error(JsValueRef ref) :
-            object(ref)
+        void attach(std::vector<T> &values) const
         {
+            if (values.size() > UINT_MAX)
+            {
+                runtime::translate_error_code(JsErrorInvalidArgument);
+            }
+
+            runtime::translate_error_code(JsSetIndexedPropertiesToExternalData(_object.handle(), values.data(), typed_array_type<T, clamped>::type, static_cast<unsigned int>(values.size())));
         }
 
     public:
         /// <summary>
-        ///     Creates an invalid handle to an error.
+        ///     Creates an invalid handle.
         /// </summary>
-        error() :
-            object()
+        external_indexes() :
+            _object(),
+            _values(nullptr)
         {
         }
 
         /// <summary>
-        ///     Converts the <c>value</c> handle to an <c>error</c> handle.
+        ///     Whether the handle is valid.
         /// </summary>
-        /// <remarks>
-        ///     The type of the underlying value is not checked.
-        /// </remarks>
-        explicit error(value object) :
-            object(object.handle())
+        bool is_valid() const
         {
+            return _values != nullptr;
         }
 
         /// <summary>
-        ///     The <c>name</c> property of the error.
+        ///     The object whose indexed properties are stored.
         /// </summary>
-        std::wstring name()
+        object target() const
         {
-            optional<value> name = get_property<value>(property_id::create(L"name"));
-
-            if (name.has_value() && name.value().type() == JsString)
-            {
-                return static_cast<string>(name.value()).data();
-            }
-
-            return L"";
+            return _object;
         }
 
         /// <summary>
-        ///     The <c>message</c> property of the error.
+        ///     The stored elements.
         /// </summary>
-        std::wstring message()
+        T *data() const
         {
-            optional<value> message = get_property<value>(property_id::create(L"message"));
-
-            if (message.has_value() && message.value().type() == JsString)
-            {
-                return static_cast<string>(message.value()).data();
-            }
-
-            return L"";
+            return _values->data();
         }
 
         /// <summary>
-        ///     Creates a new JavaScript error object
+        ///     The number of stored elements.
         /// </summary>
-        /// <remarks>
-        ///     Requires an active script context.
-        /// </remarks>
-        /// <param name="message">Message for the error object.</param>
-        /// <returns>The new error object.</returns>
-        static error create(std::wstring message, ...)
+        size_t size() const
         {
-            va_list argptr;
-            va_start(argptr, message);
-
-            JsValueRef errorObject;
-
-            runtime::translate_error_code(JsCreateError(format_message(message, argptr), &errorObject));
-            return error(errorObject);
+            return _values->size();
         }
 
         /// <summary>
-        ///     Creates a new JavaScript TypeError error object
+        ///     Accesses a stored element.
         /// </summary>
         /// <remarks>
-        ///     Requires an active script context.
+        ///     The index is not bounds checked.
         /// </remarks>
-        /// <param name="message">Message for the error object.</param>
-        /// <returns>The new error object.</returns>
-        static error create_type_error(std::wstring message, ...)
+        T &operator[](size_t index) const
         {
-            va_list argptr;
-            va_start(argptr, message);
-
-            JsValueRef errorObject;
-
-            runtime::translate_error_code(JsCreateTypeError(format_message(message, argptr), &errorObject));
-            return error(errorObject);
+            return (*_values)[index];
         }
 
         /// <summary>
-        ///     Creates a new JavaScript ReferenceError error object
+        ///     Changes the number of stored elements.
         /// </summary>
         /// <remarks>
         ///     Requires an active script context.
         /// </remarks>
-        /// <param name="message">Message for the error object.</param>
-        /// <returns>The new error object.</returns>
-        static error create_reference_error(std::wstring message, ...)
+        /// <param name="size">The new number of elements.</param>
+        /// <param name="fill_value">The value of any added elements.</param>
+        void resize(size_t size, T fill_value = T()) const
         {
-            va_list argptr;
-            va_start(argptr, message);
-
-            JsValueRef errorObject;
-
-            runtime::translate_error_code(JsCreateReferenceError(format_message(message, argptr), &errorObject));
-            return error(errorObject);
+            if (size > _values->capacity())
+            {
+                // Attach the new storage before the old storage is released, so that script never
+                // sees freed memory.
+                std::vector<T> values;
+                values.reserve((std::max)(size, _values->capacity() * 2));
+                values.assign(_values->begin(), _values->end());
+                values.resize(size, fill_value);
+                attach(values);
+                _values->swap(values);
+            }
+            else
+            {
+                _values->resize(size, fill_value);
+                attach(*_values);
+            }
         }
 
         /// <summary>
-        ///     Creates a new JavaScript RangeError error object
+        ///     Replaces the stored elements.
         /// </summary>
         /// <remarks>
         ///     Requires an active script context.
         /// </remarks>
-        /// <param name="message">Message for the error object.</param>
-        /// <returns>The new error object.</returns>
-        static error create_range_error(std::wstring message, ...)
+        /// <param name="values">The new elements.</param>
+        void assign(std::vector<T> values) const
         {
-            va_list argptr;
-            va_start(argptr, message);
-
-            JsValueRef errorObject;
-
-            runtime::translate_error_code(JsCreateRangeError(format_message(message, argptr), &errorObject));
-            return error(errorObject);
+            attach(values);
+            _values->swap(values);
         }
 
         /// <summary>
-        ///     Creates a new JavaScript SyntaxError error object
+        ///     Adds an element to the end of the stored elements.
         /// </summary>
         /// <remarks>
         ///     Requires an active script context.
         /// </remarks>
-        /// <param name="message">Message for the error object.</param>
-        /// <returns>The new error object.</returns>
-        static error create_syntax_error(std::wstring message, ...)
+        /// <param name="value">The element to add.</param>
+        void push_back(T value) const
         {
-            va_list argptr;
-            va_start(argptr, message);
-
-            JsValueRef errorObject;
-
-            runtime::translate_error_code(JsCreateSyntaxError(format_message(message, argptr), &errorObject));
-            return error(errorObject);
+            resize(_values->size() + 1, value);
         }
 
         /// <summary>
-        ///     Creates a new JavaScript URIError error object
+        ///     Stores an object's indexed properties in native storage.
         /// </summary>
         /// <remarks>
         ///     Requires an active script context.
         /// </remarks>
-        /// <param name="message">Message for the error object.</param>
-        /// <returns>The new error object.</returns>
-        static error create_uri_error(std::wstring message, ...)
+        /// <param name="target">The object whose indexed properties will be stored.</param>
+        /// <param name="values">The initial elements.</param>
+        /// <returns>A handle to the storage.</returns>
+        static external_indexes create(object target, std::vector<T> values = std::vector<T>())
         {
-            va_list argptr;
-            va_start(argptr, message);
-
-            JsValueRef errorObject;
-
-            runtime::translate_error_code(JsCreateURIError(format_message(message, argptr), &errorObject));
-            return error(errorObject);
+            std::unique_ptr<std::vector<T>> storage(new std::vector<T>(std::move(values)));
+            external_indexes result(target, storage.get());
+            result.attach(*storage);
+            target.set_before_collect_callback(storage.get(), before_collect);
+            storage.release();
+            return result;
         }
     };
 
     /// <summary>
-    ///     Information about a function call.
+    ///     Represents an element of a JavaScript array.
     /// </summary>
-    class call_info
+    template<class T>
+    class array_element
     {
-        value _callee;
-        value _this_value;
-        bool _is_construct_call;
+        value _array;
+        value _index;
 
     public:
         /// <summary>
-        ///     Constructs an empty call information instance.
+        ///     Creates a new JavaScript array element handle.
         /// </summary>
-        call_info() :
-            _callee(value()),
-            _this_value(value()),
-            _is_construct_call(false)
+        /// <param name="array">The array the element is from.</param>
+        /// <param name="index">The index of the element.</param>
+        array_element(array<T> array, value index) :
+            _array(array), _index(index)
         {
         }
 
         /// <summary>
-        ///     Constructs a call information instance.
+        ///     Creates a new JavaScript array element handle.
         /// </summary>
-        call_info(value callee, value this_value, bool is_construct_call) :
-            _callee(callee),
-            _this_value(this_value),
-            _is_construct_call(is_construct_call)
+        /// <param name="array">The array the element is from.</param>
+        /// <param name="index">The index of the element.</param>
+        array_element(typed_array<T> array, value index) :
+            _array(array), _index(index)
         {
         }
 
-        /// <summary>
-        ///     The JavaScript function being called.
-        /// </summary>
-        value callee() const
+        array_element operator=(T value)
         {
-            return this->_callee;
+            JsValueRef valueReference;
+            runtime::translate_error_code(marshal::from_native<T>(value, &valueReference));
+            runtime::translate_error_code(JsSetIndexedProperty(_array.handle(), _index.handle(), valueReference));
+            return *this;
         }
 
-        /// <summary>
-        ///     The <c>this</c> value for the function call.
-        /// </summary>
-        value this_value() const
+        operator T()
         {
-            return this->_this_value;
-        }
+            JsValueRef valueReference;
+            runtime::translate_error_code(JsGetIndexedProperty(_array.handle(), _index.handle(), &valueReference));
 
-        /// <summary>
-        ///     Whether the call was a function call or a <c>new</c> call.
-        /// </summary>
-        bool is_construct_call() const
-        {
-            return this->_is_construct_call;
+            T value;
+            runtime::translate_error_code(marshal::to_native(valueReference, &value));
+
+            return value;
         }
     };
 
     /// <summary>
-    ///     A reference to a JavaScript function.
+    ///     A reference to a JavaScript array.
     /// </summary>
-    class function_base : public object
+    template<class T = value>
+    class array : public object
     {
-        friend class context;
+        friend class object;
         friend class value;
 
-        template<class T>
-        static bool is_rest(T value)
+        explicit array(JsValueRef ref) :
+            object(ref)
         {
-            return false;
-        };
+        }
 
-        template<class T>
-        static bool is_rest(std::vector<T> value)
+    public:
+        /// <summary>
+        ///     Creates an invalid handle to an array.
+        /// </summary>
+        array() :
+            object()
         {
-            return true;
-        };
+        }
 
-        template<class T>
-        static bool argument_from_value(int position, JsValueRef *arguments, int argument_count, T &result)
+        /// <summary>
+        ///     Converts the <c>value</c> handle to an <c>array</c> handle.
+        /// </summary>
+        /// <remarks>
+        ///     The type of the underlying value is not checked.
+        /// </remarks>
+        explicit array(value object) :
+            object(object.handle())
         {
-            if (position > argument_count - 1)
-            {
-                context::set_exception(error::create(L"Incorrect number of arguments."));
-                return false;
-            }
-            
-			if (marshal::to_native(arguments[position], &result) != JsNoError)
-            {
-                context::set_exception(error::create_type_error(L"Could not convert value."));
-                return false;
-            }
-
-            return true;
         }
 
-        template<class T>
-        static bool argument_from_value(int position, JsValueRef *arguments, int argument_count, optional<T> &result)
+        array_element<T> operator [](int index)
         {
-            if (position > argument_count - 1)
-            {
-                result = missing();
-            }
-            else
-            {
-                T nativeValue;
-                if (marshal::to_native(arguments[position], &nativeValue) != JsNoError)
-                {
-                    context::set_exception(error::create_type_error(L"Could not convert value."));
-                    result = missing();
-                }
-                else
-                {
-                    result = optional<T>(nativeValue);
-                }
-            }
-
-            return true;
+            return array_element<T>(*this, number::create(index));
         }
 
-        template<class T>
-        static bool argument_from_value(int position, JsValueRef *arguments, int argument_count, std::vector<T> &result)
+        /// <summary>
+        ///     Gets the size of an array value.
+        /// </summary>
+        /// <remarks>
+        ///     Requires an active script context.
+        /// </remarks>
+        /// <returns>The size of the array.</returns>
+        int size() const
         {
-            bool succeeded = true;
-
-            if (position < argument_count)
-            {
-                result = std::vector<T>(argument_count - position);
-                std::transform(arguments + position, arguments + argument_count, result.begin(), [&](JsValueRef v)
-                {
-                    T value;
+            JsPropertyIdRef lengthName;
+            JsValueRef lengthValue;
+            int length;
 
-                    if (marshal::to_native(v, &value) != JsNoError)
-                    {
-                        context::set_exception(error::create_type_error(L"Could not convert value."));
-                        succeeded = true;
-                    }
+            // CONSIDER: Caching this somewhere?
+            runtime::translate_error_code(JsGetPropertyIdFromName(L"length", &lengthName));
+            runtime::translate_error_code(JsGetProperty(handle(), lengthName, &lengthValue));
+            runtime::translate_error_code(JsNumberToInt(lengthValue, &length));
+            return length;
+        }
 
-                    return value;
-                });
+        /// <summary>
+        ///     Extracts properties of the elements of the array into native columns.
+        /// </summary>
+        /// <remarks>
+        ///     <para>
+        ///     Requires an active script context.
+        ///     </para>
+        ///     <para>
+        ///     The extraction runs as a single script call that fills one TypedArray of element 
+        ///     type <c>C</c> per property, and each TypedArray is then copied out in one block. 
+        ///     Property values are converted as they would be when stored into the TypedArray, so 
+        ///     missing properties become <c>NaN</c> (or 0 for integer columns). If an element of the
+        ///     array is not an object, a <c>script_exception</c> is thrown.
+        ///     </para>
+        ///     <para>
+        ///     The property IDs must be string property IDs.
+        ///     </para>
+        /// </remarks>
+        /// <param name="properties">The properties to extract.</param>
+        /// <returns>A column for each property, holding the property's value for each element.</returns>
+        template<class C = double>
+        std::vector<std::vector<C>> columns(const std::vector<property_id> &properties) const
+        {
+            // The helper is built once per context, and the TypedArray constructor for C is 
+            // passed to it rather than written into its source.
+            static const wchar_t script[] =
+                L"(function (rows, names, type) {"
+                L"  var count = rows.length, columns = [];"
+                L"  for (var column = 0; column < names.length; column++) {"
+                L"    var name = names[column], values = new type(count);"
+                L"    for (var row = 0; row < count; row++) { values[row] = rows[row][name]; }"
+                L"    columns.push(values);"
+                L"  }"
+                L"  return columns;"
+                L"})";
+            static const std::wstring constructor_name = typed_array_type<C, false>::type_name + L"Array";
+            static const std::vector<const wchar_t *> constructor_names = { constructor_name.c_str() };
+
+            JsValueRef extract;
+            const JsPropertyIdRef *constructorIds;
+            JsValueRef globalObject;
+            runtime::translate_error_code(property_id_cache::get_script(script, script, &extract));
+            runtime::translate_error_code(property_id_cache::get(&constructor_names, constructor_names, &constructorIds));
+            runtime::translate_error_code(JsGetGlobalObject(&globalObject));
+
+            JsValueRef arguments[4];
+            runtime::translate_error_code(JsGetUndefinedValue(&arguments[0]));
+            arguments[1] = handle();
+            runtime::translate_error_code(JsCreateArray(static_cast<unsigned int>(properties.size()), &arguments[2]));
+            runtime::translate_error_code(JsGetProperty(globalObject, constructorIds[0], &arguments[3]));
+
+            for (size_t index = 0; index < properties.size(); index++)
+            {
+                JsValueRef indexValue;
+                JsValueRef nameValue;
+                runtime::translate_error_code(JsIntToNumber(static_cast<int>(index), &indexValue));
+                runtime::translate_error_code(marshal::from_native(properties[index].name(), &nameValue));
+                runtime::translate_error_code(JsSetIndexedProperty(arguments[2], indexValue, nameValue));
+            }
+
+            JsValueRef columnsValue;
+            runtime::translate_error_code(JsCallFunction(extract, arguments, 4, &columnsValue));
+
+            std::vector<std::vector<C>> result(properties.size());
+            for (size_t index = 0; index < properties.size(); index++)
+            {
+                JsValueRef indexValue;
+                JsValueRef columnValue;
+                runtime::translate_error_code(JsIntToNumber(static_cast<int>(index), &indexValue));
+                runtime::translate_error_code(JsGetIndexedProperty(columnsValue, indexValue, &columnValue));
+                runtime::translate_error_code(marshal::to_native(columnValue, &result[index]));
             }
 
-            return succeeded;
+            return result;
         }
 
-        template<class T>
-        static size_t optional_argument_count(T value)
+        /// <summary>
+        ///     Creates a JavaScript array object.
+        /// </summary>
+        /// <remarks>
+        ///     Requires an active script context.
+        /// </remarks>
+        /// <param name="length">The initial length of the array.</param>
+        /// <returns>The new array object.</returns>
+        static array<T> create(unsigned int length)
         {
-            return 1;
-        };
+            JsValueRef array;
+            runtime::translate_error_code(JsCreateArray(length, &array));
+            return jsrt::array<T>(array);
+        }
 
-        template<class T>
-        static size_t optional_argument_count(optional<T> value)
+        /// <summary>
+        ///     Creates a JavaScript array object.
+        /// </summary>
+        /// <remarks>
+        ///     Requires an active script context.
+        /// </remarks>
+        /// <param name="values">The initial values of the array.</param>
+        /// <returns>The new array object.</returns>
+        static array<T> create(std::initializer_list<T> values)
         {
-            return value.has_value() ? 1 : 0;
-        };
+            array<T> array = create(static_cast<unsigned int>(values.size()));
+            int index = 0;
+            for (auto iter = values.begin(); iter != values.end(); ++iter)
+            {
+                array[index++] = *iter;
+            }
 
-        template<class T>
-        static size_t optional_argument_count(std::vector<T> &value)
+            return array;
+        }
+    };
+
+    /// <summary>
+    ///     A template for creating JavaScript objects that all have the same properties.
+    /// </summary>
+    /// <remarks>
+    ///     <para>
+    ///     The template is built once from a list of property IDs, one for each of <c>Types</c>. 
+    ///     Every object it creates gets those properties added in the same order, so the engine 
+    ///     can share one type between all of them.
+    ///     </para>
+    ///     <para>
+    ///     <c>instantiate_many</c> marshals each column of the rows at once (columns of TypedArray
+    ///     element types are copied in a single block) and then builds all of the objects in one 
+    ///     script call.
+    ///     </para>
+    ///     <para>
+    ///     A template belongs to the context that was current when it was created.
+    ///     </para>
+    /// </remarks>
+    template<class... Types>
+    class object_template
+    {
+        std::vector<pinned<property_id>> _properties;
+        pinned<value> _names;
+        pinned<value> _create;
+
+        template<size_t... Indexes>
+        void set_properties(object target, std::index_sequence<Indexes...>, const Types &... values) const
         {
-            return value.size();
-        };
+            int expand[] = { 0, (target.set_property(*_properties[Indexes], values), 0)... };
+            (void)expand;
+        }
 
         template<class T>
-        static void fill_rest(T argument, unsigned start, std::vector<JsValueRef> &arguments)
+        static JsValueRef column_value(const std::vector<T> &column, std::true_type)
         {
-            runtime::translate_error_code(marshal::from_native(argument, &arguments[start]));
+            JsValueRef result;
+            runtime::translate_error_code(marshal::from_native(column, &result));
+            return result;
         }
 
         template<class T>
-        static void fill_rest(std::vector<T> &rest, unsigned start, std::vector<JsValueRef> &arguments)
+        static JsValueRef column_value(const std::vector<T> &column, std::false_type)
         {
-            std::transform(rest.begin(), rest.end(), arguments.begin() + start, [&](T v)
+            JsValueRef result;
+            runtime::translate_error_code(JsCreateArray(static_cast<unsigned int>(column.size()), &result));
+
+            for (size_t index = 0; index < column.size(); index++)
             {
-                JsValueRef value;
-                runtime::translate_error_code(marshal::from_native(v, &value));
-                return value;
-            });
+                JsValueRef indexValue;
+                JsValueRef elementValue;
+                runtime::translate_error_code(JsIntToNumber(static_cast<int>(index), &indexValue));
+                runtime::translate_error_code(marshal::from_native(column[index], &elementValue));
+                runtime::translate_error_code(JsSetIndexedProperty(result, indexValue, elementValue));
+            }
+
+            return result;
         }
 
-    protected:
-        template <class P1, class P2, class P3, class P4, class P5, class P6, class P7, class P8>
-        static bool unpack_arguments(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, call_info &info, P1 &p1, P2 &p2, P3 &p3, P4 &p4, P5 &p5, P6 &p6, P7 &p7, P8 &p8)
+        template<size_t Index>
+        static void set_column(const std::vector<std::tuple<Types...>> &rows, JsValueRef columns)
         {
-            if (!is_rest(p8) && argument_count > 9)
+            typedef typename std::tuple_element<Index, std::tuple<Types...>>::type column_type;
+
+            std::vector<column_type> column;
+            column.reserve(rows.size());
+            for (const auto &row : rows)
             {
-                context::set_exception(error::create(L"Incorrect number of arguments."));
-                return false;
+                column.push_back(std::get<Index>(row));
             }
 
-            info = call_info(value(callee), value(arguments[0]), is_construct_call);
-
-            return argument_from_value(1, arguments, argument_count, p1) &&
-                argument_from_value(2, arguments, argument_count, p2) &&
-                argument_from_value(3, arguments, argument_count, p3) &&
-                argument_from_value(4, arguments, argument_count, p4) &&
-                argument_from_value(5, arguments, argument_count, p5) &&
-                argument_from_value(6, arguments, argument_count, p6) &&
-                argument_from_value(7, arguments, argument_count, p7) &&
-                argument_from_value(8, arguments, argument_count, p8);
+            JsValueRef indexValue;
+            runtime::translate_error_code(JsIntToNumber(static_cast<int>(Index), &indexValue));
+            runtime::translate_error_code(JsSetIndexedProperty(columns, indexValue, column_value(column, is_typed_array_element<column_type>())));
         }
 
-        template <class P1, class P2, class P3, class P4, class P5, class P6, class P7>
-        static bool unpack_arguments(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, call_info &info, P1 &p1, P2 &p2, P3 &p3, P4 &p4, P5 &p5, P6 &p6, P7 &p7)
+        template<size_t... Indexes>
+        static void set_columns(const std::vector<std::tuple<Types...>> &rows, JsValueRef columns, std::index_sequence<Indexes...>)
         {
-            if (!is_rest(p7) && argument_count > 8)
-            {
-                context::set_exception(error::create(L"Incorrect number of arguments."));
-                return false;
-            }
+            int expand[] = { 0, (set_column<Indexes>(rows, columns), 0)... };
+            (void)expand;
+        }
 
-            info = call_info(value(callee), value(arguments[0]), is_construct_call);
+    public:
+        /// <summary>
+        ///     The native representation of one object.
+        /// </summary>
+        typedef std::tuple<Types...> row_type;
 
-            return argument_from_value(1, arguments, argument_count, p1) &&
-                argument_from_value(2, arguments, argument_count, p2) &&
-                argument_from_value(3, arguments, argument_count, p3) &&
-                argument_from_value(4, arguments, argument_count, p4) &&
-                argument_from_value(5, arguments, argument_count, p5) &&
-                argument_from_value(6, arguments, argument_count, p6) &&
-                argument_from_value(7, arguments, argument_count, p7);
+        /// <summary>
+        ///     Creates an invalid template.
+        /// </summary>
+        object_template() :
+            _properties(),
+            _names(),
+            _create()
+        {
         }
 
-        template <class P1, class P2, class P3, class P4, class P5, class P6>
-        static bool unpack_arguments(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, call_info &info, P1 &p1, P2 &p2, P3 &p3, P4 &p4, P5 &p5, P6 &p6)
+        /// <summary>
+        ///     Creates a template.
+        /// </summary>
+        /// <remarks>
+        ///     <para>
+        ///     Requires an active script context.
+        ///     </para>
+        ///     <para>
+        ///     The property IDs must be string property IDs.
+        ///     </para>
+        /// </remarks>
+        /// <param name="properties">The property for each of <c>Types</c>, in order.</param>
+        explicit object_template(const std::vector<property_id> &properties)
         {
-            if (!is_rest(p6) && argument_count > 7)
+            if (properties.size() != sizeof...(Types))
             {
-                context::set_exception(error::create(L"Incorrect number of arguments."));
-                return false;
+                runtime::translate_error_code(JsErrorInvalidArgument);
             }
 
-            info = call_info(value(callee), value(arguments[0]), is_construct_call);
+            JsValueRef names;
+            runtime::translate_error_code(JsCreateArray(static_cast<unsigned int>(properties.size()), &names));
 
-            return argument_from_value(1, arguments, argument_count, p1) &&
-                argument_from_value(2, arguments, argument_count, p2) &&
-                argument_from_value(3, arguments, argument_count, p3) &&
-                argument_from_value(4, arguments, argument_count, p4) &&
-                argument_from_value(5, arguments, argument_count, p5) &&
-                argument_from_value(6, arguments, argument_count, p6);
+            for (size_t index = 0; index < properties.size(); index++)
+            {
+                JsValueRef indexValue;
+                JsValueRef nameValue;
+                runtime::translate_error_code(JsIntToNumber(static_cast<int>(index), &indexValue));
+                runtime::translate_error_code(marshal::from_native(properties[index].name(), &nameValue));
+                runtime::translate_error_code(JsSetIndexedProperty(names, indexValue, nameValue));
+                _properties.push_back(pinned<property_id>(properties[index]));
+            }
+
+            _names = pinned<value>(value(names));
+            _create = pinned<value>(context::evaluate(
+                L"(function (count, names, columns) {"
+                L"  var result = new Array(count), width = names.length;"
+                L"  for (var row = 0; row < count; row++) {"
+                L"    var item = {};"
+                L"    for (var column = 0; column < width; column++) { item[names[column]] = columns[column][row]; }"
+                L"    result[row] = item;"
+                L"  }"
+                L"  return result;"
+                L"})"));
         }
 
-        template <class P1, class P2, class P3, class P4, class P5>
-        static bool unpack_arguments(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, call_info &info, P1 &p1, P2 &p2, P3 &p3, P4 &p4, P5 &p5)
+        /// <summary>
+        ///     Whether the template is valid.
+        /// </summary>
+        bool is_valid() const
         {
-            if (!is_rest(p5) && argument_count > 6)
-            {
-                context::set_exception(error::create(L"Incorrect number of arguments."));
-                return false;
-            }
+            return _create->is_valid();
+        }
 
-            info = call_info(value(callee), value(arguments[0]), is_construct_call);
+        /// <summary>
+        ///     Creates an object from the template.
+        /// </summary>
+        /// <remarks>
+        ///     Requires an active script context.
+        /// </remarks>
+        /// <param name="values">The value of each property.</param>
+        /// <returns>The new object.</returns>
+        object instantiate(const Types &... values) const
+        {
+            object result = object::create();
+            set_properties(result, std::index_sequence_for<Types...>(), values...);
+            return result;
+        }
 
-            return argument_from_value(1, arguments, argument_count, p1) &&
-                argument_from_value(2, arguments, argument_count, p2) &&
-                argument_from_value(3, arguments, argument_count, p3) &&
-                argument_from_value(4, arguments, argument_count, p4) &&
-                argument_from_value(5, arguments, argument_count, p5);
+        /// <summary>
+        ///     Creates an object from the template.
+        /// </summary>
+        /// <remarks>
+        ///     Requires an active script context.
+        /// </remarks>
+        /// <param name="row">The value of each property.</param>
+        /// <returns>The new object.</returns>
+        object instantiate(const row_type &row) const
+        {
+            return instantiate_many(std::vector<row_type>(1, row))[0];
         }
 
-        template <class P1, class P2, class P3, class P4>
-        static bool unpack_arguments(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, call_info &info, P1 &p1, P2 &p2, P3 &p3, P4 &p4)
+        /// <summary>
+        ///     Creates an array of objects from the template.
+        /// </summary>
+        /// <remarks>
+        ///     Requires an active script context.
+        /// </remarks>
+        /// <param name="rows">The property values of each object.</param>
+        /// <returns>An array holding the new objects.</returns>
+        array<object> instantiate_many(const std::vector<row_type> &rows) const
         {
-            if (!is_rest(p4) && argument_count > 5)
+            if (rows.size() > INT_MAX)
             {
-                context::set_exception(error::create(L"Incorrect number of arguments."));
-                return false;
+                runtime::translate_error_code(JsErrorInvalidArgument);
             }
 
-            info = call_info(value(callee), value(arguments[0]), is_construct_call);
+            JsValueRef arguments[4];
+            runtime::translate_error_code(JsGetUndefinedValue(&arguments[0]));
+            runtime::translate_error_code(JsIntToNumber(static_cast<int>(rows.size()), &arguments[1]));
+            arguments[2] = _names->handle();
+            runtime::translate_error_code(JsCreateArray(sizeof...(Types), &arguments[3]));
+            set_columns(rows, arguments[3], std::index_sequence_for<Types...>());
 
-            return argument_from_value(1, arguments, argument_count, p1) &&
-                argument_from_value(2, arguments, argument_count, p2) &&
-                argument_from_value(3, arguments, argument_count, p3) &&
-                argument_from_value(4, arguments, argument_count, p4);
+            JsValueRef result;
+            runtime::translate_error_code(JsCallFunction(_create->handle(), arguments, 4, &result));
+            return array<object>(value(result));
         }
+    };
 
-        template <class P1, class P2, class P3>
-        static bool unpack_arguments(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, call_info &info, P1 &p1, P2 &p2, P3 &p3)
+    /// <summary>
+    ///     A reference to an ArrayBuffer.
+    /// </summary>
+    class array_buffer : public object
+    {
+        template<class T, bool clamped>
+        friend class typed_array;
+
+        explicit array_buffer(JsValueRef ref) :
+            object(ref)
         {
-            if (!is_rest(p3) && argument_count > 4)
-            {
-                context::set_exception(error::create(L"Incorrect number of arguments."));
-                return false;
-            }
+        }
 
-            info = call_info(value(callee), value(arguments[0]), is_construct_call);
+    public:
+        /// <summary>
+        ///     Creates an invalid handle to an ArrayBuffer.
+        /// </summary>
+        array_buffer() :
+            object()
+        {
+        }
 
-            return argument_from_value(1, arguments, argument_count, p1) &&
-                argument_from_value(2, arguments, argument_count, p2) &&
-                argument_from_value(3, arguments, argument_count, p3);
+        /// <summary>
+        ///     Converts the <c>value</c> handle to an <c>array_buffer</c> handle.
+        /// </summary>
+        /// <remarks>
+        ///     The type of the underlying value is not checked.
+        /// </remarks>
+        explicit array_buffer(value object) :
+            object(object.handle())
+        {
         }
 
-        template <class P1, class P2>
-        static bool unpack_arguments(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, call_info &info, P1 &p1, P2 &p2)
+        /// <summary>
+        ///     Retrieves the data from the ArrayBuffer.
+        /// </summary>
+        /// <remarks>
+        ///     <para>
+        ///     Requires an active script context.
+        ///     </para>
+        ///     <para>
+        ///     The lifetime of the data returned is the same as the lifetime of the ArrayBuffer.
+        ///     The pointer does not count as a reference to the ArrayBuffer for the purposes
+        ///     of garbage collection.
+        ///     </para>
+        /// </remarks>
+        /// <returns>
+        ///     The data stored in the ArrayBuffer.
+        /// </returns>
+        unsigned char *data() const
         {
-            if (!is_rest(p2) && argument_count > 3)
-            {
-                context::set_exception(error::create(L"Incorrect number of arguments."));
-                return false;
-            }
+            unsigned char *data;
+            unsigned int size;
+            runtime::translate_error_code(JsGetArrayBufferStorage(handle(), &data, &size));
+            return data;
+        }
 
-            info = call_info(value(callee), value(arguments[0]), is_construct_call);
+        /// <summary>
+        ///     Retrieves the size of the data in the ArrayBuffer in bytes.
+        /// </summary>
+        /// <remarks>
+        ///     Requires an active script context.
+        /// </remarks>
+        /// <returns>
+        ///     The size of the data stored in the ArrayBuffer in bytes.
+        /// </returns>
+        unsigned int size() const
+        {
+            unsigned char *data;
+            unsigned int size;
+            runtime::translate_error_code(JsGetArrayBufferStorage(handle(), &data, &size));
+            return size;
+        }
 
-            return argument_from_value(1, arguments, argument_count, p1) &&
-                argument_from_value(2, arguments, argument_count, p2);
+        /// <summary>
+        ///     Creates a JavaScript ArrayBuffer object.
+        /// </summary>
+        /// <remarks>
+        ///     Requires an active script context.
+        /// </remarks>
+        /// <param name="length">The initial byte length of the ArrayBuffer.</param>
+        /// <returns>The new ArrayBuffer object.</returns>
+        static array_buffer create(unsigned int length)
+        {
+            JsValueRef array;
+            runtime::translate_error_code(JsCreateArrayBuffer(length, &array));
+            return array_buffer(array);
         }
+    };
 
-        template <class P1>
-        static bool unpack_arguments(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, call_info &info, P1 &p1)
+    /// <summary>
+    ///     Copies arrays of fixed-size elements between native buffers.
+    /// </summary>
+    struct endian_copy
+    {
+        /// <summary>
+        ///     Copies elements from one buffer to another, optionally reversing the byte order of
+        ///     each element.
+        /// </summary>
+        /// <remarks>
+        ///     Byte reversal is vectorized where the processor supports it. The buffers must not
+        ///     overlap.
+        /// </remarks>
+        /// <param name="destination">The buffer to copy to.</param>
+        /// <param name="source">The buffer to copy from.</param>
+        /// <param name="count">The number of elements to copy.</param>
+        /// <param name="element_size">The size of each element in bytes (1, 2, 4 or 8).</param>
+        /// <param name="reverse">Whether to reverse the byte order of each element.</param>
+        static void copy(unsigned char *destination, const unsigned char *source, unsigned int count, int element_size, bool reverse);
+    };
+
+    /// <summary>
+    ///     A field of a fixed-layout binary record.
+    /// </summary>
+    /// <remarks>
+    ///     Fields are combined into a <c>record_layout</c> to describe how a native structure is
+    ///     stored in a <c>data_view</c>.
+    /// </remarks>
+    /// <typeparam name="Record">The native structure the field belongs to.</typeparam>
+    /// <typeparam name="T">The arithmetic type of the field.</typeparam>
+    /// <typeparam name="member">The member of the structure the field is stored in.</typeparam>
+    /// <typeparam name="field_offset">The byte offset of the field within the record.</typeparam>
+    /// <typeparam name="field_order">The byte order of the field.</typeparam>
+    template<class Record, class T, T Record::*member, unsigned int field_offset, endedness field_order = endedness::little_endian>
+    struct record_field
+    {
+        static_assert(std::is_arithmetic<T>::value, "Record fields must be arithmetic types.");
+
+        /// <summary>
+        ///     The byte offset just past the end of the field.
+        /// </summary>
+        static const unsigned int end = field_offset + sizeof(T);
+
+        /// <summary>
+        ///     Decodes the field from a record's storage.
+        /// </summary>
+        /// <param name="data">The start of the record.</param>
+        /// <param name="record">The structure to decode the field into.</param>
+        static void read(const unsigned char *data, Record &record)
         {
-            if (!is_rest(p1) && argument_count > 2)
+            unsigned char bytes[sizeof(T)];
+            memcpy(bytes, data + field_offset, sizeof(T));
+            if (field_order == endedness::big_endian)
             {
-                context::set_exception(error::create(L"Incorrect number of arguments."));
-                return false;
+                std::reverse(bytes, bytes + sizeof(T));
             }
-
-            info = call_info(value(callee), value(arguments[0]), is_construct_call);
-
-            return argument_from_value(1, arguments, argument_count, p1);
+            memcpy(&(record.*member), bytes, sizeof(T));
         }
 
-        static bool unpack_arguments(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, call_info &info)
+        /// <summary>
+        ///     Encodes the field into a record's storage.
+        /// </summary>
+        /// <param name="data">The start of the record.</param>
+        /// <param name="record">The structure to encode the field from.</param>
+        static void write(unsigned char *data, const Record &record)
         {
-            if (argument_count > 1)
+            unsigned char bytes[sizeof(T)];
+            memcpy(bytes, &(record.*member), sizeof(T));
+            if (field_order == endedness::big_endian)
             {
-                context::set_exception(error::create(L"Incorrect number of arguments."));
-                return false;
+                std::reverse(bytes, bytes + sizeof(T));
             }
+            memcpy(data + field_offset, bytes, sizeof(T));
+        }
+    };
 
-            info = call_info(value(callee), value(arguments[0]), is_construct_call);
+    /// <summary>
+    ///     The layout of a fixed-layout binary record, described as a list of <c>record_field</c>s.
+    /// </summary>
+    template<class Record, class... Fields>
+    struct record_layout;
 
-            return true;
-        }
+    template<class Record>
+    struct record_layout<Record>
+    {
+        static const unsigned int size = 0;
 
-        static bool unpack_arguments(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, call_info &info, std::vector<value> &value_arguments)
+        static void read(const unsigned char *data, Record &record)
         {
-            value_arguments = std::vector<value>(argument_count - 1);
+        }
 
-            for (int index = 0; index < argument_count - 1; index++)
-            {
-                value_arguments[index] = value(arguments[index + 1]);
-            }
+        static void write(unsigned char *data, const Record &record)
+        {
+        }
+    };
 
-            info = call_info(value(callee), value(arguments[0]), is_construct_call);
+    template<class Record, class Field, class... Fields>
+    struct record_layout<Record, Field, Fields...>
+    {
+        /// <summary>
+        ///     The size of the record in bytes.
+        /// </summary>
+        static const unsigned int size = Field::end > record_layout<Record, Fields...>::size ? Field::end : record_layout<Record, Fields...>::size;
 
-            return true;
+        /// <summary>
+        ///     Decodes a record.
+        /// </summary>
+        /// <param name="data">The start of the record.</param>
+        /// <param name="record">The structure to decode into.</param>
+        static void read(const unsigned char *data, Record &record)
+        {
+            Field::read(data, record);
+            record_layout<Record, Fields...>::read(data, record);
         }
 
-        template <class P1, class P2, class P3, class P4, class P5, class P6, class P7, class P8>
-        static std::vector<JsValueRef> pack_arguments(value this_value, P1 p1, P2 p2, P3 p3, P4 p4, P5 p5, P6 p6, P7 p7, P8 p8)
+        /// <summary>
+        ///     Encodes a record.
+        /// </summary>
+        /// <param name="data">The start of the record.</param>
+        /// <param name="record">The structure to encode from.</param>
+        static void write(unsigned char *data, const Record &record)
         {
-            size_t argument_count = 1 +
-                optional_argument_count(p1) +
-                optional_argument_count(p2) +
-                optional_argument_count(p3) +
-                optional_argument_count(p4) +
-                optional_argument_count(p5) +
-                optional_argument_count(p6) +
-                optional_argument_count(p7) +
-                optional_argument_count(p8);
-            std::vector<JsValueRef> arguments(argument_count);
+            Field::write(data, record);
+            record_layout<Record, Fields...>::write(data, record);
+        }
+    };
 
-            if (this_value.is_valid())
-            {
-                arguments[0] = this_value.handle();
-            }
-            else
-            {
-                // TODO: Why do we have to do this?
-                runtime::translate_error_code(JsGetUndefinedValue(&arguments[0]));
-            }
+    /// <summary>
+    ///     The binary layout of a native structure.
+    /// </summary>
+    /// <remarks>
+    ///     <para>
+    ///     To make a structure readable and writable through a <c>data_view</c>, specialize this 
+    ///     template for the structure and derive the specialization from a <c>record_layout</c>.
+    ///     For example:
+    ///     </para>
+    ///     <code>
+    ///     template&lt;&gt;
+    ///     struct record_type&lt;header&gt; : record_layout&lt;header,
+    ///         record_field&lt;header, unsigned int, &amp;header::magic, 0, endedness::big_endian&gt;,
+    ///         record_field&lt;header, short, &amp;header::version, 4&gt;&gt;
+    ///     {
+    ///     };
+    ///     </code>
+    ///     <para>
+    ///     The size of the record is the end of its last field. A specialization can declare a 
+    ///     larger <c>size</c> to account for trailing padding.
+    ///     </para>
+    /// </remarks>
+    template<class Record>
+    struct record_type
+    {
+    };
 
-            switch (argument_count)
-            {
-            default:
-                fill_rest(p8, 8, arguments);
-                // fall through
-            case 8:
-                runtime::translate_error_code(marshal::from_native(p7, &arguments[7]));
-                // fall through
-            case 7:
-                runtime::translate_error_code(marshal::from_native(p6, &arguments[6]));
-                // fall through
-            case 6:
-                runtime::translate_error_code(marshal::from_native(p5, &arguments[5]));
-                // fall through
-            case 5:
-                runtime::translate_error_code(marshal::from_native(p4, &arguments[4]));
-                // fall through
-            case 4:
-                runtime::translate_error_code(marshal::from_native(p3, &arguments[3]));
-                // fall through
-            case 3:
-                runtime::translate_error_code(marshal::from_native(p2, &arguments[2]));
-                // fall through
-            case 2:
-                runtime::translate_error_code(marshal::from_native(p1, &arguments[1]));
-                // fall through
-            case 1:
-                // Nothing to do
-                break;
-            }
+    /// <summary>
+    ///     An iterator that decodes consecutive records from native storage.
+    /// </summary>
+    template<class Record>
+    class record_iterator
+    {
+        const unsigned char *_position;
 
-            return arguments;
-        }
+    public:
+        typedef std::input_iterator_tag iterator_category;
+        typedef Record value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const Record *pointer;
+        typedef Record reference;
 
-        template <class P1, class P2, class P3, class P4, class P5, class P6, class P7>
-        static std::vector<JsValueRef> pack_arguments(value this_value, P1 p1, P2 p2, P3 p3, P4 p4, P5 p5, P6 p6, P7 p7)
+        /// <summary>
+        ///     Constructs an iterator positioned at a record.
+        /// </summary>
+        /// <param name="position">The start of the record.</param>
+        explicit record_iterator(const unsigned char *position) :
+            _position(position)
         {
-            size_t argument_count = 1 +
-                optional_argument_count(p1) +
-                optional_argument_count(p2) +
-                optional_argument_count(p3) +
-                optional_argument_count(p4) +
-                optional_argument_count(p5) +
-                optional_argument_count(p6) +
-                optional_argument_count(p7);
-            std::vector<JsValueRef> arguments(argument_count);
+        }
 
-            if (this_value.is_valid())
-            {
-                arguments[0] = this_value.handle();
-            }
-            else
-            {
-                // TODO: Why do we have to do this?
-                runtime::translate_error_code(JsGetUndefinedValue(&arguments[0]));
-            }
+        Record operator*() const
+        {
+            Record record;
+            record_type<Record>::read(_position, record);
+            return record;
+        }
 
-            switch (argument_count)
-            {
-            default:
-                fill_rest(p7, 7, arguments);
-                // fall through
-            case 7:
-                runtime::translate_error_code(marshal::from_native(p6, &arguments[6]));
-                // fall through
-            case 6:
-                runtime::translate_error_code(marshal::from_native(p5, &arguments[5]));
-                // fall through
-            case 5:
-                runtime::translate_error_code(marshal::from_native(p4, &arguments[4]));
-                // fall through
-            case 4:
-                runtime::translate_error_code(marshal::from_native(p3, &arguments[3]));
-                // fall through
-            case 3:
-                runtime::translate_error_code(marshal::from_native(p2, &arguments[2]));
-                // fall through
-            case 2:
-                runtime::translate_error_code(marshal::from_native(p1, &arguments[1]));
-                // fall through
-            case 1:
-                // Nothing to do
-                break;
-            }
+        record_iterator &operator++()
+        {
+            _position += record_type<Record>::size;
+            return *this;
+        }
 
-            return arguments;
+        record_iterator operator++(int)
+        {
+            record_iterator previous = *this;
+            _position += record_type<Record>::size;
+            return previous;
         }
 
-        template <class P1, class P2, class P3, class P4, class P5, class P6>
-        static std::vector<JsValueRef> pack_arguments(value this_value, P1 p1, P2 p2, P3 p3, P4 p4, P5 p5, P6 p6)
+        bool operator==(const record_iterator &other) const
         {
-            size_t argument_count = 1 +
-                optional_argument_count(p1) +
-                optional_argument_count(p2) +
-                optional_argument_count(p3) +
-                optional_argument_count(p4) +
-                optional_argument_count(p5) +
-                optional_argument_count(p6);
-            std::vector<JsValueRef> arguments(argument_count);
+            return _position == other._position;
+        }
 
-            if (this_value.is_valid())
-            {
-                arguments[0] = this_value.handle();
-            }
-            else
-            {
-                // TODO: Why do we have to do this?
-                runtime::translate_error_code(JsGetUndefinedValue(&arguments[0]));
-            }
+        bool operator!=(const record_iterator &other) const
+        {
+            return _position != other._position;
+        }
+    };
 
-            switch (argument_count)
-            {
-            default:
-                fill_rest(p6, 6, arguments);
-                // fall through
-            case 6:
-                runtime::translate_error_code(marshal::from_native(p5, &arguments[5]));
-                // fall through
-            case 5:
-                runtime::translate_error_code(marshal::from_native(p4, &arguments[4]));
-                // fall through
-            case 4:
-                runtime::translate_error_code(marshal::from_native(p3, &arguments[3]));
-                // fall through
-            case 3:
-                runtime::translate_error_code(marshal::from_native(p2, &arguments[2]));
-                // fall through
-            case 2:
-                runtime::translate_error_code(marshal::from_native(p1, &arguments[1]));
-                // fall through
-            case 1:
-                // Nothing to do
-                break;
-            }
+    /// <summary>
+    ///     A range of consecutive records in native storage.
+    /// </summary>
+    /// <remarks>
+    ///     The range points directly into the storage of an <c>array_buffer</c> and is only valid
+    ///     as long as the buffer is alive.
+    /// </remarks>
+    template<class Record>
+    class record_range
+    {
+        const unsigned char *_begin;
+        unsigned int _count;
 
-            return arguments;
+    public:
+        /// <summary>
+        ///     Constructs a range of records.
+        /// </summary>
+        /// <param name="begin">The start of the first record.</param>
+        /// <param name="count">The number of records.</param>
+        record_range(const unsigned char *begin, unsigned int count) :
+            _begin(begin),
+            _count(count)
+        {
         }
 
-        template <class P1, class P2, class P3, class P4, class P5>
-        static std::vector<JsValueRef> pack_arguments(value this_value, P1 p1, P2 p2, P3 p3, P4 p4, P5 p5)
+        /// <summary>
+        ///     The number of records in the range.
+        /// </summary>
+        unsigned int size() const
         {
-            size_t argument_count = 1 +
-                optional_argument_count(p1) +
-                optional_argument_count(p2) +
-                optional_argument_count(p3) +
-                optional_argument_count(p4) +
-                optional_argument_count(p5);
-            std::vector<JsValueRef> arguments(argument_count);
+            return _count;
+        }
 
-            if (this_value.is_valid())
-            {
-                arguments[0] = this_value.handle();
-            }
-            else
-            {
-                // TODO: Why do we have to do this?
-                runtime::translate_error_code(JsGetUndefinedValue(&arguments[0]));
-            }
+        record_iterator<Record> begin() const
+        {
+            return record_iterator<Record>(_begin);
+        }
 
-            switch (argument_count)
-            {
-            default:
-                fill_rest(p5, 5, arguments);
-                // fall through
-            case 5:
-                runtime::translate_error_code(marshal::from_native(p4, &arguments[4]));
-                // fall through
-            case 4:
-                runtime::translate_error_code(marshal::from_native(p3, &arguments[3]));
-                // fall through
-            case 3:
-                runtime::translate_error_code(marshal::from_native(p2, &arguments[2]));
-                // fall through
-            case 2:
-                runtime::translate_error_code(marshal::from_native(p1, &arguments[1]));
-                // fall through
-            case 1:
-                // Nothing to do
-                break;
-            }
+        record_iterator<Record> end() const
+        {
+            return record_iterator<Record>(_begin + static_cast<size_t>(_count) * record_type<Record>::size);
+        }
+    };
 
-            return arguments;
+    /// <summary>
+    ///     A reference to a DataView.
+    /// </summary>
+    template<endedness byte_order = endedness::little_endian>
+    class data_view : public object
+    {
+        explicit data_view(JsValueRef ref) :
+            object(ref)
+        {
         }
 
-        template <class P1, class P2, class P3, class P4>
-        static std::vector<JsValueRef> pack_arguments(value this_value, P1 p1, P2 p2, P3 p3, P4 p4)
+        // Returns a pointer to a run of elements in the storage, checking that it is in bounds.
+        unsigned char *storage(unsigned int offset, unsigned int count, int element_size) const
         {
-            size_t argument_count = 1 +
-                optional_argument_count(p1) +
-                optional_argument_count(p2) +
-                optional_argument_count(p3) +
-                optional_argument_count(p4);
-            std::vector<JsValueRef> arguments(argument_count);
+            unsigned char *data;
+            unsigned int size;
+            runtime::translate_error_code(JsGetDataViewStorage(handle(), &data, &size));
 
-            if (this_value.is_valid())
+            if (offset > size || count > (size - offset) / element_size)
             {
-                arguments[0] = this_value.handle();
-            }
-            else
-            {
-                // TODO: Why do we have to do this?
-                runtime::translate_error_code(JsGetUndefinedValue(&arguments[0]));
-            }
-
-            switch (argument_count)
-            {
-            default:
-                fill_rest(p4, 4, arguments);
-                // fall through
-            case 4:
-                runtime::translate_error_code(marshal::from_native(p3, &arguments[3]));
-                // fall through
-            case 3:
-                runtime::translate_error_code(marshal::from_native(p2, &arguments[2]));
-                // fall through
-            case 2:
-                runtime::translate_error_code(marshal::from_native(p1, &arguments[1]));
-                // fall through
-            case 1:
-                // Nothing to do
-                break;
+                runtime::translate_error_code(JsErrorInvalidArgument);
             }
 
-            return arguments;
+            return data + offset;
         }
 
-        template <class P1, class P2, class P3>
-        static std::vector<JsValueRef> pack_arguments(value this_value, P1 p1, P2 p2, P3 p3)
+    public:
+        /// <summary>
+        ///     Creates an invalid handle to a DataView.
+        /// </summary>
+        data_view() :
+            object()
         {
-            size_t argument_count = 1 +
-                optional_argument_count(p1) +
-                optional_argument_count(p2) +
-                optional_argument_count(p3);
-            std::vector<JsValueRef> arguments(argument_count);
-
-            if (this_value.is_valid())
-            {
-                arguments[0] = this_value.handle();
-            }
-            else
-            {
-                // TODO: Why do we have to do this?
-                runtime::translate_error_code(JsGetUndefinedValue(&arguments[0]));
-            }
-
-            switch (argument_count)
-            {
-            default:
-                fill_rest(p3, 3, arguments);
-                // fall through
-            case 3:
-                runtime::translate_error_code(marshal::from_native(p2, &arguments[2]));
-                // fall through
-            case 2:
-                runtime::translate_error_code(marshal::from_native(p1, &arguments[1]));
-                // fall through
-            case 1:
-                // Nothing to do
-                break;
-            }
-
-            return arguments;
         }
 
-        template <class P1, class P2>
-        static std::vector<JsValueRef> pack_arguments(value this_value, P1 p1, P2 p2)
+        /// <summary>
+        ///     Converts the <c>value</c> handle to an <c>data_view</c> handle.
+        /// </summary>
+        /// <remarks>
+        ///     The type of the underlying value is not checked.
+        /// </remarks>
+        explicit data_view(value object) :
+            object(object.handle())
         {
-            size_t argument_count = 1 +
-                optional_argument_count(p1) +
-                optional_argument_count(p2);
-            std::vector<JsValueRef> arguments(argument_count);
-
-            if (this_value.is_valid())
-            {
-                arguments[0] = this_value.handle();
-            }
-            else
-            {
-                // TODO: Why do we have to do this?
-                runtime::translate_error_code(JsGetUndefinedValue(&arguments[0]));
-            }
-
-            switch (argument_count)
-            {
-            default:
-                fill_rest(p2, 2, arguments);
-                // fall through
-            case 2:
-                runtime::translate_error_code(marshal::from_native(p1, &arguments[1]));
-                // fall through
-            case 1:
-                // Nothing to do
-                break;
-            }
-
-            return arguments;
         }
 
-        template <class P1>
-        static std::vector<JsValueRef> pack_arguments(value this_value, P1 p1)
+        /// <summary>
+        ///     Retrieves the data from the DataView.
+        /// </summary>
+        /// <remarks>
+        ///     <para>
+        ///     Requires an active script context.
+        ///     </para>
+        ///     <para>
+        ///     The lifetime of the data returned is the same as the lifetime of the DataView.
+        ///     The pointer does not count as a reference to the DataView for the purposes
+        ///     of garbage collection.
+        ///     </para>
+        /// </remarks>
+        /// <returns>
+        ///     The data stored in the DataView.
+        /// </returns>
+        unsigned char *data() const
         {
-            size_t argument_count = 1 +
-                optional_argument_count(p1);
-            std::vector<JsValueRef> arguments(argument_count);
+            unsigned char *data;
+            unsigned int size;
+            runtime::translate_error_code(JsGetDataViewStorage(handle(), &data, &size));
+            return data;
+        }
 
-            if (this_value.is_valid())
-            {
-                arguments[0] = this_value.handle();
-            }
-            else
-            {
-                // TODO: Why do we have to do this?
-                runtime::translate_error_code(JsGetUndefinedValue(&arguments[0]));
-            }
+        /// <summary>
+        ///     Retrieves the size of the data in the DataView in bytes.
+        /// </summary>
+        /// <remarks>
+        ///     Requires an active script context.
+        /// </remarks>
+        /// <returns>
+        ///     The size of the data stored in the DataView in bytes.
+        /// </returns>
+        unsigned int size() const
+        {
+            unsigned char *data;
+            unsigned int size;
+            runtime::translate_error_code(JsGetDataViewStorage(handle(), &data, &size));
+            return size;
+        }
 
-            switch (argument_count)
+        /// <summary>
+        ///     Gets a typed value from the <c>data_view</c>.
+        /// </summary>
+        /// <param name="offset">The byte offset of the value.</param>
+        /// <returns>The value at that position.</returns>
+        template<class T>
+        T get(int offset)
+        {
+            if (typed_array_type<T, false>::size > 1)
             {
-            default:
-                fill_rest(p1, 1, arguments);
-                // fall through
-            case 1:
-                // Nothing to do
-                break;
+                auto accessor = get_property<function<T, int, bool>>(jsrt::property_id::create(static_cast<std::wstring>(L"get") + typed_array_type<T, false>::type_name));
+                return accessor(jsrt::value(handle()), offset, byte_order == endedness::little_endian);
             }
 
-            return arguments;
+            auto accessor = get_property<function<T, int>>(jsrt::property_id::create(static_cast<std::wstring>(L"get") + typed_array_type<T, false>::type_name));
+            return accessor(jsrt::value(handle()), offset);
         }
 
-        static std::vector<JsValueRef> pack_arguments(value this_value)
+        /// <summary>
+        ///     Sets a typed value into the <c>data_view</c>.
+        /// </summary>
+        /// <param name="offset">The byte offset to set.</param>
+        /// <param name="value">The value to set.</param>
+        template<class T>
+        void set(int offset, T value)
         {
-            std::vector<JsValueRef> arguments(1);
-
-            if (this_value.is_valid())
+            if (typed_array_type<T, false>::size > 1)
             {
-                arguments[0] = this_value.handle();
+                auto accessor = get_property<function<void, int, T, bool>>(jsrt::property_id::create(static_cast<std::wstring>(L"set") + typed_array_type<T, false>::type_name));
+                accessor(jsrt::value(handle()), offset, value, byte_order == endedness::little_endian);
             }
             else
             {
-                // TODO: Why do we have to do this?
-                runtime::translate_error_code(JsGetUndefinedValue(&arguments[0]));
+                auto accessor = get_property<function<void, int, T>>(jsrt::property_id::create(static_cast<std::wstring>(L"set") + typed_array_type<T, false>::type_name));
+                accessor(jsrt::value(handle()), offset, value);
             }
-
-            return arguments;
         }
 
-        static std::vector<JsValueRef> pack_arguments(value this_value, std::initializer_list<value> arguments)
+        /// <summary>
+        ///     Reads an array of typed values from the <c>data_view</c>.
+        /// </summary>
+        /// <remarks>
+        ///     <para>
+        ///     The values are read directly from the DataView's storage in the byte order of the
+        ///     <c>data_view</c>, without calling into script.
+        ///     </para>
+        ///     <para>
+        ///     Requires an active script context.
+        ///     </para>
+        /// </remarks>
+        /// <param name="offset">The byte offset of the first value.</param>
+        /// <param name="count">The number of values to read.</param>
+        /// <param name="values">The buffer to read the values into.</param>
+        template<class T>
+        void read_array(unsigned int offset, unsigned int count, T *values) const
         {
-            std::vector<JsValueRef> call_args(arguments.size() + 1);
-            call_args[0] = this_value.handle();
-            unsigned int index = 1;
-            for (const value argument : arguments)
-            {
-                call_args[index++] = argument.handle();
-            }
-
-            return call_args;
+            unsigned char *source = storage(offset, count, typed_array_type<T, false>::size);
+            endian_copy::copy(reinterpret_cast<unsigned char *>(values), source, count, typed_array_type<T, false>::size, byte_order == endedness::big_endian);
         }
 
-        template <class R>
-        R call_function(std::vector<JsValueRef> arguments)
+        /// <summary>
+        ///     Reads an array of typed values from the <c>data_view</c>.
+        /// </summary>
+        /// <remarks>
+        ///     <para>
+        ///     The values are read directly from the DataView's storage in the byte order of the
+        ///     <c>data_view</c>, without calling into script.
+        ///     </para>
+        ///     <para>
+        ///     Requires an active script context.
+        ///     </para>
+        /// </remarks>
+        /// <param name="offset">The byte offset of the first value.</param>
+        /// <param name="count">The number of values to read.</param>
+        /// <returns>The values at that position.</returns>
+        template<class T>
+        std::vector<T> read_array(unsigned int offset, unsigned int count) const
         {
-            JsValueRef resultValue;
-            runtime::translate_error_code(JsCallFunction(handle(), arguments.data(), static_cast<unsigned short>(arguments.size()), &resultValue));
-
-            R result;
-            runtime::translate_error_code(marshal::to_native(resultValue, &result));
-            return result;
+            std::vector<T> values(count);
+            read_array<T>(offset, count, values.data());
+            return values;
         }
 
-        explicit function_base(JsValueRef ref) :
-            object(ref)
+        /// <summary>
+        ///     Writes an array of typed values into the <c>data_view</c>.
+        /// </summary>
+        /// <remarks>
+        ///     <para>
+        ///     The values are written directly into the DataView's storage in the byte order of the
+        ///     <c>data_view</c>, without calling into script.
+        ///     </para>
+        ///     <para>
+        ///     Requires an active script context.
+        ///     </para>
+        /// </remarks>
+        /// <param name="offset">The byte offset of the first value.</param>
+        /// <param name="count">The number of values to write.</param>
+        /// <param name="values">The values to write.</param>
+        template<class T>
+        void write_array(unsigned int offset, unsigned int count, const T *values) const
         {
+            unsigned char *destination = storage(offset, count, typed_array_type<T, false>::size);
+            endian_copy::copy(destination, reinterpret_cast<const unsigned char *>(values), count, typed_array_type<T, false>::size, byte_order == endedness::big_endian);
         }
 
-    public:
         /// <summary>
-        ///     The signature of a function callback.
-        /// </summary>
-        /// <param name="call_info">Information about the call.</param>
-        /// <param name="arguments">Arguments to the call.</param>
-        /// <returns>The result of the call.</returns>
-        typedef value(*Signature)(const call_info &call_info, const std::vector<value> &arguments);
-
-    protected:
-        static JsValueRef CALLBACK thunk(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, void *callback_state)
-        {
-            std::vector<value> argument_vector;
-            call_info info;
-
-            if (!unpack_arguments(callee, is_construct_call, arguments, argument_count, info, argument_vector))
-            {
-                return JS_INVALID_REFERENCE;
-            }
-
-            Signature callback = static_cast<Signature>(callback_state);
-            value result;
-            try
-            {
-                result = callback(info, argument_vector);
-            }
-            catch (...)
-            {
-                context::set_exception(error::create(L"Fatal error."));
-                return JS_INVALID_REFERENCE;
-            }
-
-            JsValueRef resultValue;
-            if (marshal::from_native(result, &resultValue) != JsNoError)
-            {
-                context::set_exception(error::create_type_error(L"Could not convert value."));
-                return JS_INVALID_REFERENCE;
-            }
-
-            return resultValue;
-        }
-
-    public:
-        /// <summary>
-        ///     Creates an invalid handle to a function.
-        /// </summary>
-        function_base() :
-            object()
-        {
-        }
-
-        /// <summary>
-        ///     Converts the <c>value</c> handle to a <c>function</c> handle.
+        ///     Writes an array of typed values into the <c>data_view</c>.
         /// </summary>
         /// <remarks>
-        ///     The type of the underlying value is not checked.
+        ///     <para>
+        ///     The values are written directly into the DataView's storage in the byte order of the
+        ///     <c>data_view</c>, without calling into script.
+        ///     </para>
+        ///     <para>
+        ///     Requires an active script context.
+        ///     </para>
         /// </remarks>
-        explicit function_base(value object) :
-            object(object.handle())
+        /// <param name="offset">The byte offset of the first value.</param>
+        /// <param name="values">The values to write.</param>
+        template<class T>
+        void write_array(unsigned int offset, const std::vector<T> &values) const
         {
+            write_array<T>(offset, static_cast<unsigned int>(values.size()), values.data());
         }
 
         /// <summary>
-        ///     Calls the JavaScript function.
+        ///     Reads a record from the <c>data_view</c>.
         /// </summary>
         /// <remarks>
+        ///     <para>
+        ///     The record is decoded directly from the DataView's storage using the layout given by 
+        ///     <c>record_type&lt;Record&gt;</c>, without calling into script.
+        ///     </para>
+        ///     <para>
         ///     Requires an active script context.
+        ///     </para>
         /// </remarks>
-        /// <param name="this_value">The value of <c>this</c> for the call.</param>
-        /// <param name="arguments">Arguments to the call.</param>
-        /// <returns>The result of the call.</returns>
-        value operator()(value this_value, std::initializer_list<value> arguments) const
+        /// <param name="offset">The byte offset of the record.</param>
+        /// <returns>The record at that position.</returns>
+        template<class Record>
+        Record read(unsigned int offset) const
         {
-            std::vector<JsValueRef> call_arguments = pack_arguments(this_value, arguments);
+            static_assert(record_type<Record>::size > 0, "Record layouts must have at least one field.");
 
-            JsValueRef resultValue;
-            runtime::translate_error_code(JsCallFunction(handle(), static_cast<JsValueRef *>(call_arguments.data()), static_cast<unsigned short>(call_arguments.size()), &resultValue));
-            return value(resultValue);
+            Record record;
+            record_type<Record>::read(storage(offset, 1, record_type<Record>::size), record);
+            return record;
         }
 
         /// <summary>
-        ///     Constructs a JavaScript object.
+        ///     Writes a record into the <c>data_view</c>.
         /// </summary>
         /// <remarks>
+        ///     <para>
+        ///     The record is encoded directly into the DataView's storage using the layout given by 
+        ///     <c>record_type&lt;Record&gt;</c>, without calling into script.
+        ///     </para>
+        ///     <para>
         ///     Requires an active script context.
+        ///     </para>
         /// </remarks>
-        /// <param name="arguments">Arguments to the constructor call.</param>
-        /// <returns>The result of the constructor call.</returns>
-        value construct(std::initializer_list<value> arguments) const
+        /// <param name="offset">The byte offset of the record.</param>
+        /// <param name="record">The record to write.</param>
+        template<class Record>
+        void write(unsigned int offset, const Record &record) const
         {
-            std::vector<JsValueRef> call_arguments = pack_arguments(context::undefined(), arguments);
+            static_assert(record_type<Record>::size > 0, "Record layouts must have at least one field.");
 
-            JsValueRef resultValue;
-            runtime::translate_error_code(JsConstructObject(handle(), static_cast<JsValueRef *>(call_arguments.data()), static_cast<unsigned short>(call_arguments.size()), &resultValue));
-            return value(resultValue);
+            record_type<Record>::write(storage(offset, 1, record_type<Record>::size), record);
         }
 
         /// <summary>
-        ///     Creates a new JavaScript function.
+        ///     Gets a range over consecutive records in the <c>data_view</c>.
         /// </summary>
         /// <remarks>
+        ///     <para>
+        ///     The bounds of the range are checked once, and each record is then decoded directly
+        ///     from the DataView's storage as the range is iterated. The range is only valid as long
+        ///     as the underlying <c>array_buffer</c> is alive.
+        ///     </para>
+        ///     <para>
         ///     Requires an active script context.
+        ///     </para>
         /// </remarks>
-        /// <param name="signature">The method to call when the function is invoked.</param>
-        /// <returns>The new function object.</returns>
-        static function_base create(Signature signature)
+        /// <param name="offset">The byte offset of the first record.</param>
+        /// <param name="count">The number of records.</param>
+        /// <returns>The range of records.</returns>
+        template<class Record>
+        record_range<Record> records(unsigned int offset, unsigned int count) const
         {
-            JsValueRef ref;
-            if (signature == nullptr)
-            {
-                runtime::translate_error_code(JsErrorNullArgument);
-            }
-            runtime::translate_error_code(JsCreateFunction(thunk, signature, &ref));
-            return function_base(ref);
+            static_assert(record_type<Record>::size > 0, "Record layouts must have at least one field.");
+
+            return record_range<Record>(storage(offset, count, record_type<Record>::size), count);
         }
 
         /// <summary>
-        ///     Creates a new JavaScript function.
+        ///     Creates a JavaScript DataView object.
         /// </summary>
         /// <remarks>
         ///     Requires an active script context.
         /// </remarks>
-        /// <param name="name">The name of the method for debugging/stringification purposes.</param>
-        /// <param name="signature">The method to call when the function is invoked.</param>
-        /// <returns>The new function object.</returns>
-        static function_base create(std::wstring name, Signature signature)
+        /// <param name="buffer">The underlying <c>array_buffer</c>.</param>
+        /// <returns>The new DataView object.</returns>
+        static data_view create(array_buffer buffer)
         {
-            JsValueRef nameRef;
-            runtime::translate_error_code(marshal::from_native(name, &nameRef));
-            JsValueRef ref;
-            if (signature == nullptr)
-            {
-                runtime::translate_error_code(JsErrorNullArgument);
-            }
-            runtime::translate_error_code(JsCreateNamedFunction(nameRef, thunk, signature, &ref));
-            return function_base(ref);
+            JsValueRef view;
+            runtime::translate_error_code(JsCreateDataView(buffer.handle(), 0, buffer.size(), &view));
+            return data_view(view);
         }
 
         /// <summary>
-        ///     Creates a new JavaScript function.
+        ///     Creates a JavaScript DataView object.
         /// </summary>
         /// <remarks>
         ///     Requires an active script context.
         /// </remarks>
-        /// <param name="signature">The method to call when the function is invoked.</param>
-        /// <returns>The new function object.</returns>
-        template<class R, class... Parameters>
-        static function<R, Parameters...> create(R(*signature)(const jsrt::call_info &info, Parameters...))
+        /// <param name="buffer">The underlying <c>array_buffer</c>.</param>
+        /// <param name="offset">The offset in the <c>array_buffer</c> to start. </param>
+        /// <returns>The new DataView object.</returns>
+        static data_view create(array_buffer buffer, unsigned int offset)
         {
-            return function<R, Parameters...>::create(signature);
+            JsValueRef view;
+            runtime::translate_error_code(JsCreateDataView(buffer.handle(), offset, buffer.size(), &view));
+            return data_view(view);
         }
 
         /// <summary>
-        ///     Creates a new JavaScript function.
+        ///     Creates a JavaScript DataView object.
         /// </summary>
         /// <remarks>
         ///     Requires an active script context.
         /// </remarks>
-        /// <param name="name">The name of the method for debugging/stringification purposes.</param>
-        /// <param name="signature">The method to call when the function is invoked.</param>
-        /// <returns>The new function object.</returns>
-        template<class R, class... Parameters>
-        static function<R, Parameters...> create(std::wstring name, R(*signature)(const jsrt::call_info &info, Parameters...))
+        /// <param name="buffer">The underlying <c>array_buffer</c>.</param>
+        /// <param name="offset">The offset in the <c>array_buffer</c> to start. </param>
+        /// <param name="length">The length in the <c>array_buffer</c> to reference.</param>
+        /// <returns>The new DataView object.</returns>
+        static data_view create(array_buffer buffer, unsigned int offset, unsigned int length)
         {
-            return function<R, Parameters...>::create(name, signature);
+            JsValueRef view;
+            runtime::translate_error_code(JsCreateDataView(buffer.handle(), offset, length, &view));
+            return data_view(view);
         }
     };
 
-	template <>
-	inline void function_base::call_function(std::vector<JsValueRef> arguments)
-	{
-		JsValueRef resultValue;
-		runtime::translate_error_code(JsCallFunction(handle(), arguments.data(), static_cast<unsigned short>(arguments.size()), &resultValue));
-	}
-
-	/// <summary>
-    ///     A reference to a JavaScript function that creates an object.
+    /// <summary>
+    ///     A reference to a TypedArray.
     /// </summary>
-    template<class R>
-    class constructor_function : public function_base
+    template<class T, bool clamped>
+    class typed_array : public object
     {
-        friend class value;
+        friend class marshal;
+        template<class U, bool other_clamped>
+        friend class typed_array;
+        template<class U, unsigned int Rank, bool other_clamped>
+        friend class ndarray;
 
-    protected:
-        constructor_function() :
-            function_base()
+        explicit typed_array(JsValueRef ref) :
+            object(ref)
         {
         }
 
-        explicit constructor_function(JsValueRef ref) :
-            function_base(ref)
+    public:
+        /// <summary>
+        ///     Creates an invalid handle to a TypedArray.
+        /// </summary>
+        typed_array() :
+            object()
         {
         }
 
-        explicit constructor_function(value object) :
-            function_base(object)
+        /// <summary>
+        ///     Converts the <c>value</c> handle to an <c>typed_array</c> handle.
+        /// </summary>
+        /// <remarks>
+        ///     The type of the underlying value is not checked.
+        /// </remarks>
+        explicit typed_array(value object) :
+            object(object.handle())
         {
         }
 
-        R construct_object(std::vector<JsValueRef> &arguments)
+        array_element<T> operator [](int index)
         {
-            JsValueRef resultValue;
-            runtime::translate_error_code(JsConstructObject(handle(), arguments.data(), static_cast<unsigned short>(arguments.size()), &resultValue));
-
-            R result;
-            runtime::translate_error_code(marshal::to_native(resultValue, &result));
-            return result;
+            return array_element<T>(*this, number::create(index));
         }
 
-    public:
         /// <summary>
-        ///     The object that will be the prototype of objects created by this function.
+        ///     Retrieves the data from the TypedArray.
         /// </summary>
-	    object constructor_prototype()
+        /// <remarks>
+        ///     <para>
+        ///     Requires an active script context.
+        ///     </para>
+        ///     <para>
+        ///     The lifetime of the data returned is the same as the lifetime of the TypedArray.
+        ///     The pointer does not count as a reference to the TypedArray for the purposes
+        ///     of garbage collection.
+        ///     </para>
+        /// </remarks>
+        /// <returns>
+        ///     The data stored in the TypedArray.
+        /// </returns>
+        unsigned char *data() const
         {
-            return get_property<object>(property_id::create(L"prototype"));
+            unsigned char *data;
+            unsigned int size;
+            JsTypedArrayType type;
+            int element_size;
+            runtime::translate_error_code(JsGetTypedArrayStorage(handle(), &data, &size, &type, &element_size));
+            return data;
         }
 
         /// <summary>
-        ///     Sets the object that will be the prototype of objects created by this function.
+        ///     Retrieves the size of the data in the TypedArray in bytes.
         /// </summary>
-        /// <param name="prototype">The prototype object.</param>
-        void set_constructor_prototype(object prototype)
+        /// <remarks>
+        ///     Requires an active script context.
+        /// </remarks>
+        /// <returns>
+        ///     The size of the data stored in the TypedArray in bytes.
+        /// </returns>
+        unsigned int data_size() const
         {
-            return set_property<object>(property_id::create(L"prototype"), prototype);
+            unsigned char *data;
+            unsigned int size;
+            JsTypedArrayType type;
+            int element_size;
+            runtime::translate_error_code(JsGetTypedArrayStorage(handle(), &data, &size, &type, &element_size));
+            return size;
         }
-    };
-
-    // An instantiation of constructor_function that disallows constructing non-object values.
-    template<>
-    class constructor_function<value> : public function_base
-    {
-        friend class value;
 
-    protected:
-        constructor_function() :
-            function_base()
+        /// <summary>
+        ///     Retrieves the type of the data in the TypedArray.
+        /// </summary>
+        /// <remarks>
+        ///     Requires an active script context.
+        /// </remarks>
+        /// <returns>
+        ///     The type of the data stored in the TypedArray.
+        /// </returns>
+        JsTypedArrayType type() const
         {
+            unsigned char *data;
+            unsigned int size;
+            JsTypedArrayType type;
+            int element_size;
+            runtime::translate_error_code(JsGetTypedArrayStorage(handle(), &data, &size, &type, &element_size));
+            return type;
         }
 
-        explicit constructor_function(JsValueRef ref) :
-            function_base(ref)
+        /// <summary>
+        ///     Retrieves the element size in bytes of the data in the TypedArray.
+        /// </summary>
+        /// <remarks>
+        ///     Requires an active script context.
+        /// </remarks>
+        /// <returns>
+        ///     The element size in bytesof the data stored in the TypedArray.
+        /// </returns>
+        int element_size() const
         {
+            unsigned char *data;
+            unsigned int size;
+            JsTypedArrayType type;
+            int element_size;
+            runtime::translate_error_code(JsGetTypedArrayStorage(handle(), &data, &size, &type, &element_size));
+            return element_size;
         }
 
-        explicit constructor_function(value object) :
-            function_base(object)
+        /// <summary>
+        ///     Retrieves the number of elements in the TypedArray.
+        /// </summary>
+        /// <remarks>
+        ///     Requires an active script context.
+        /// </remarks>
+        /// <returns>
+        ///     The number of elements in the TypedArray.
+        /// </returns>
+        unsigned int length() const
         {
+            JsTypedArrayType type;
+            JsValueRef buffer;
+            unsigned int byte_offset;
+            unsigned int byte_length;
+            runtime::translate_error_code(JsGetTypedArrayInfo(handle(), &type, &buffer, &byte_offset, &byte_length));
+            return byte_length / typed_array_type<T, clamped>::size;
         }
-    };
-
-    // An instantiation of constructor_function that disallows constructing non-object values.
-    template<>
-    class constructor_function<std::wstring> : public function_base
-    {
-        friend class value;
 
-    protected:
-        constructor_function() :
-            function_base()
+        /// <summary>
+        ///     Retrieves the offset in bytes of the TypedArray in its underlying <c>array_buffer</c>.
+        /// </summary>
+        /// <remarks>
+        ///     Requires an active script context.
+        /// </remarks>
+        /// <returns>
+        ///     The offset in bytes of the TypedArray in its underlying <c>array_buffer</c>.
+        /// </returns>
+        unsigned int byte_offset() const
         {
+            JsTypedArrayType type;
+            JsValueRef buffer;
+            unsigned int byte_offset;
+            unsigned int byte_length;
+            runtime::translate_error_code(JsGetTypedArrayInfo(handle(), &type, &buffer, &byte_offset, &byte_length));
+            return byte_offset;
         }
 
-        explicit constructor_function(JsValueRef ref) :
-            function_base(ref)
+        /// <summary>
+        ///     Retrieves the <c>array_buffer</c> that backs the TypedArray.
+        /// </summary>
+        /// <remarks>
+        ///     Requires an active script context.
+        /// </remarks>
+        /// <returns>
+        ///     The <c>array_buffer</c> that backs the TypedArray.
+        /// </returns>
+        array_buffer buffer() const
         {
+            JsTypedArrayType type;
+            JsValueRef buffer;
+            unsigned int byte_offset;
+            unsigned int byte_length;
+            runtime::translate_error_code(JsGetTypedArrayInfo(handle(), &type, &buffer, &byte_offset, &byte_length));
+            return array_buffer(buffer);
         }
 
-        explicit constructor_function(value object) :
-            function_base(object)
+        /// <summary>
+        ///     Creates a view over a range of the elements of the TypedArray.
+        /// </summary>
+        /// <remarks>
+        ///     <para>
+        ///     The new TypedArray shares the underlying <c>array_buffer</c> with this TypedArray, so
+        ///     no data is copied and writes through either array are visible in the other.
+        ///     </para>
+        ///     <para>
+        ///     Requires an active script context.
+        ///     </para>
+        /// </remarks>
+        /// <param name="begin">The index of the first element of the view.</param>
+        /// <param name="end">The index one past the last element of the view.</param>
+        /// <returns>The new TypedArray object.</returns>
+        typed_array subarray(unsigned int begin, unsigned int end) const
         {
+            JsTypedArrayType type;
+            JsValueRef buffer;
+            unsigned int byte_offset;
+            unsigned int byte_length;
+            runtime::translate_error_code(JsGetTypedArrayInfo(handle(), &type, &buffer, &byte_offset, &byte_length));
+
+            if (begin > end || end > byte_length / typed_array_type<T, clamped>::size)
+            {
+                runtime::translate_error_code(JsErrorInvalidArgument);
+            }
+
+            JsValueRef array;
+            runtime::translate_error_code(JsCreateTypedArray(typed_array_type<T, clamped>::type, buffer, byte_offset + begin * typed_array_type<T, clamped>::size, end - begin, &array));
+            return typed_array(array);
         }
-    };
 
-    // An instantiation of constructor_function that disallows constructing non-object values.
-    template<>
-    class constructor_function<double> : public function_base
-    {
-        friend class value;
+        /// <summary>
+        ///     Creates a view of the TypedArray's data as a different element type.
+        /// </summary>
+        /// <remarks>
+        ///     <para>
+        ///     The new TypedArray shares the underlying <c>array_buffer</c> with this TypedArray, so
+        ///     no data is copied. The byte offset and byte length of this TypedArray must both be
+        ///     multiples of the size of the new element type.
+        ///     </para>
+        ///     <para>
+        ///     Requires an active script context.
+        ///     </para>
+        /// </remarks>
+        /// <returns>The new TypedArray object.</returns>
+        template<class U, bool U_clamped = false>
+        typed_array<U, U_clamped> reinterpret() const
+        {
+            JsTypedArrayType type;
+            JsValueRef buffer;
+            unsigned int byte_offset;
+            unsigned int byte_length;
+            runtime::translate_error_code(JsGetTypedArrayInfo(handle(), &type, &buffer, &byte_offset, &byte_length));
 
-    protected:
-        constructor_function() :
-            function_base()
+            if (byte_offset % typed_array_type<U, U_clamped>::size != 0 || byte_length % typed_array_type<U, U_clamped>::size != 0)
+            {
+                runtime::translate_error_code(JsErrorInvalidArgument);
+            }
+
+            JsValueRef array;
+            runtime::translate_error_code(JsCreateTypedArray(typed_array_type<U, U_clamped>::type, buffer, byte_offset, byte_length / typed_array_type<U, U_clamped>::size, &array));
+            return typed_array<U, U_clamped>(array);
+        }
+
+        /// <summary>
+        ///     Creates a JavaScript TypedArray object.
+        /// </summary>
+        /// <remarks>
+        ///     Requires an active script context.
+        /// </remarks>
+        /// <param name="length">The length of the new TypedArray.</param>
+        /// <returns>The new TypedArray object.</returns>
+        static typed_array create(unsigned int length)
         {
+            JsValueRef array;
+            array_buffer base = array_buffer::create(typed_array_type<T, clamped>::size * length);
+            runtime::translate_error_code(JsCreateTypedArray(typed_array_type<T, clamped>::type, base.handle(), 0, length, &array));
+            // TODO: This is broken in Windows 10 TH2, incorrectly returns JsInvalidArgument
+            //runtime::translate_error_code(JsCreateTypedArray(typed_array_type<T, clamped>::type, JS_INVALID_REFERENCE, 0, length, &array));
+            return typed_array(array);
         }
 
-        explicit constructor_function(JsValueRef ref) :
-            function_base(ref)
+        /// <summary>
+        ///     Creates a JavaScript TypedArray object backed by an <c>array_buffer</c>.
+        /// </summary>
+        /// <remarks>
+        ///     Requires an active script context.
+        /// </remarks>
+        /// <param name="buffer">The underlying <c>array_buffer</c>.</param>
+        /// <returns>The new TypedArray object.</returns>
+        static typed_array create(array_buffer buffer)
         {
+            JsValueRef array;
+            runtime::translate_error_code(JsCreateTypedArray(typed_array_type<T, clamped>::type, buffer.handle(), 0, buffer.size() / typed_array_type<T, clamped>::size, &array));
+            return typed_array(array);
         }
 
-        explicit constructor_function(value object) :
-            function_base(object)
+        /// <summary>
+        ///     Creates a JavaScript TypedArray object backed by an <c>array_buffer</c>.
+        /// </summary>
+        /// <remarks>
+        ///     Requires an active script context.
+        /// </remarks>
+        /// <param name="buffer">The underlying <c>array_buffer</c>.</param>
+        /// <param name="offset">The offset in the <c>array_buffer</c> to start. </param>
+        /// <returns>The new TypedArray object.</returns>
+        static typed_array create(array_buffer buffer, unsigned int offset)
         {
+            JsValueRef array;
+            runtime::translate_error_code(JsCreateTypedArray(typed_array_type<T, clamped>::type, buffer.handle(), offset, buffer.size() / typed_array_type<T, clamped>::size, &array));
+            return typed_array(array);
         }
-    };
 
-    // An instantiation of constructor_function that disallows constructing non-object values.
-    template<>
-    class constructor_function<bool> : public function_base
-    {
-        friend class value;
+        /// <summary>
+        ///     Creates a JavaScript TypedArray object backed by an <c>array_buffer</c>.
+        /// </summary>
+        /// <remarks>
+        ///     Requires an active script context.
+        /// </remarks>
+        /// <param name="buffer">The underlying <c>array_buffer</c>.</param>
+        /// <param name="offset">The offset in the <c>array_buffer</c> to start. </param>
+        /// <param name="length">The length in the <c>array_buffer</c> to reference.</param>
+        /// <returns>The new TypedArray object.</returns>
+        static typed_array create(array_buffer buffer, unsigned int offset, unsigned int length)
+        {
+            JsValueRef array;
+            runtime::translate_error_code(JsCreateTypedArray(typed_array_type<T, clamped>::type, buffer.handle(), offset, length, &array));
+            return typed_array(array);
+        }
 
-    protected:
-        constructor_function() :
-            function_base()
+        /// <summary>
+        ///     Creates a JavaScript TypedArray object copied from another <c>typed_array</c>.
+        /// </summary>
+        /// <remarks>
+        ///     Requires an active script context.
+        /// </remarks>
+        /// <param name="buffer">The <c>typed_array</c> to copy from.</param>
+        /// <returns>The new TypedArray object.</returns>
+        template<class base_T, bool base_clamped>
+        static typed_array create(typed_array<base_T, base_clamped> base_array)
         {
+            JsValueRef array;
+            runtime::translate_error_code(JsCreateTypedArray(typed_array_type<T, clamped>::type, base_array.handle(), 0, 0, &array));
+            return typed_array(array);
         }
 
-        explicit constructor_function(JsValueRef ref) :
-            function_base(ref)
+        /// <summary>
+        ///     Creates a JavaScript TypedArray object copied from an <c>array</c>.
+        /// </summary>
+        /// <remarks>
+        ///     Requires an active script context.
+        /// </remarks>
+        /// <param name="buffer">The <c>array</c> to copy from.</param>
+        /// <returns>The new TypedArray object.</returns>
+        template<class U>
+        static typed_array create(array<U> base_array)
         {
+            JsValueRef array;
+            runtime::translate_error_code(JsCreateTypedArray(typed_array_type<U, clamped>::type, base_array.handle(), 0, 0, &array));
+            return typed_array(array);
         }
 
-        explicit constructor_function(value object) :
-            function_base(object)
+        /// <summary>
+        ///     Creates a JavaScript TypedArray object.
+        /// </summary>
+        /// <remarks>
+        ///     Requires an active script context.
+        /// </remarks>
+        /// <param name="values">The values to initialize the array with.</param>
+        /// <returns>The new TypedArray object.</returns>
+        static typed_array<T, false> create(std::initializer_list<T> values)
         {
+            auto buffer = array_buffer::create(sizeof(T) * values.size());
+            auto view = data_view<>::create(buffer);
+	        auto index = 0;
+            for (auto iter = values.begin(); iter != values.end(); ++iter)
+            {
+                view.template set<T>(sizeof(T) * index++, *iter);
+            }
+
+            return create(buffer);
         }
+
     };
 
-#pragma region Arity 8
-    template<class R, class P1, class P2, class P3, class P4, class P5, class P6, class P7, class P8>
-    class function : public constructor_function<R>
+    /// <summary>
+    ///     A view over a contiguous run of native elements.
+    /// </summary>
+    /// <remarks>
+    ///     <para>
+    ///     A <c>buffer_view</c> can be used as a parameter type of a <c>function</c>. The argument 
+    ///     must then be a TypedArray whose element type is <c>T</c>, or an ArrayBuffer or DataView 
+    ///     whose size and alignment suit <c>T</c>; the view points directly at its storage and 
+    ///     nothing is copied. Any other argument raises a <c>TypeError</c>.
+    ///     </para>
+    ///     <para>
+    ///     The view has the same lifetime as the storage it was created over. A view created from a
+    ///     script value marshals back to that value.
+    ///     </para>
+    /// </remarks>
+    template<class T>
+    class buffer_view
     {
-        friend class value;
+        friend class marshal;
+        template<class U>
+        friend class buffer_view;
 
-    protected:
-        explicit function<R, P1, P2, P3, P4, P5, P6, P7, P8>(JsValueRef ref) :
-            constructor_function<R>(ref)
+        JsValueRef _source;
+        T *_data;
+        size_t _size;
+
+        buffer_view(JsValueRef source, T *data, size_t size) :
+            _source(source),
+            _data(data),
+            _size(size)
         {
         }
 
     public:
-        typedef R(*Signature)(const call_info &call_info, P1 p1, P2 p2, P3 p3, P4 p4, P5 p5, P6 p6, P7 p7, P8 p8);
-
-        function<R, P1, P2, P3, P4, P5, P6, P7, P8>() :
-            constructor_function<R>()
+        /// <summary>
+        ///     Creates an empty view.
+        /// </summary>
+        buffer_view() :
+            _source(JS_INVALID_REFERENCE),
+            _data(nullptr),
+            _size(0)
         {
         }
 
-        explicit function<R, P1, P2, P3, P4, P5, P6, P7, P8>(value object) :
-            constructor_function<R>(object)
+        /// <summary>
+        ///     Creates a view over native memory.
+        /// </summary>
+        /// <param name="data">The first element.</param>
+        /// <param name="size">The number of elements.</param>
+        buffer_view(T *data, size_t size) :
+            _source(JS_INVALID_REFERENCE),
+            _data(data),
+            _size(size)
         {
         }
 
-    protected:
-        static JsValueRef CALLBACK thunk(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, void *callback_state)
+        /// <summary>
+        ///     Converts a view of non-constant elements to a view of constant elements.
+        /// </summary>
+        template<class U, class = typename std::enable_if<std::is_convertible<U(*)[], T(*)[]>::value>::type>
+        buffer_view(const buffer_view<U> &other) :
+            _source(other._source),
+            _data(other._data),
+            _size(other._size)
         {
-            call_info info;
-            P1 p1;
-            P2 p2;
-            P3 p3;
-            P4 p4;
-            P5 p5;
-            P6 p6;
-            P7 p7;
-            P8 p8;
-
-            if (!unpack_arguments(callee, is_construct_call, arguments, argument_count, info, p1, p2, p3, p4, p5, p6, p7, p8))
-            {
-                return JS_INVALID_REFERENCE;
-            }
+        }
 
-            Signature callback = static_cast<Signature>(callback_state);
-            R result;
-            try
-            {
-                result = callback(info, p1, p2, p3, p4, p5, p6, p7, p8);
-            }
-            catch (...)
-            {
-                context::set_exception(error::create(L"Fatal error."));
-                return JS_INVALID_REFERENCE;
-            }
+        /// <summary>
+        ///     The script value the view was created over, if any.
+        /// </summary>
+        value source() const
+        {
+            return value(_source);
+        }
 
-            JsValueRef resultValue;
-            if (marshal::from_native(result, &resultValue) != JsNoError)
-            {
-                context::set_exception(error::create_type_error(L"Could not convert value."));
-                return JS_INVALID_REFERENCE;
-            }
+        /// <summary>
+        ///     The first element.
+        /// </summary>
+        T *data() const
+        {
+            return _data;
+        }
 
-            return resultValue;
+        /// <summary>
+        ///     The number of elements.
+        /// </summary>
+        size_t size() const
+        {
+            return _size;
         }
 
-    public:
-        R operator ()(value this_value, P1 p1, P2 p2, P3 p3, P4 p4, P5 p5, P6 p6, P7 p7, P8 p8)
+        /// <summary>
+        ///     Whether the view has no elements.
+        /// </summary>
+        bool empty() const
         {
-            return call_function<R>(pack_arguments(this_value, p1, p2, p3, p4, p5, p6, p7, p8));
+            return _size == 0;
         }
 
-        R construct(P1 p1, P2 p2, P3 p3, P4 p4, P5 p5, P6 p6, P7 p7, P8 p8)
+        /// <summary>
+        ///     Accesses an element.
+        /// </summary>
+        /// <remarks>
+        ///     The index is not bounds checked.
+        /// </remarks>
+        T &operator[](size_t index) const
         {
-            return construct_object(pack_arguments(context::undefined(), p1, p2, p3, p4, p5, p6, p7, p8));
+            return _data[index];
         }
 
-        static function<R, P1, P2, P3, P4, P5, P6, P7, P8> create(Signature function)
+        T *begin() const
         {
-            JsValueRef ref;
-            if (function == nullptr)
-            {
-                runtime::translate_error_code(JsErrorNullArgument);
-            }
-            runtime::translate_error_code(JsCreateFunction(thunk, function, &ref));
-            return decltype(create(nullptr))(ref);
+            return _data;
         }
 
-        static function<R, P1, P2, P3, P4, P5, P6, P7, P8> create(std::wstring name, Signature function)
+        T *end() const
         {
-            JsValueRef nameRef;
-            runtime::translate_error_code(marshal::from_native(name, &nameRef));
-            JsValueRef ref;
-            if (function == nullptr)
-            {
-                runtime::translate_error_code(JsErrorNullArgument);
-            }
-            runtime::translate_error_code(JsCreateNamedFunction(nameRef, thunk, function, &ref));
-            return decltype(create(nullptr))(ref);
+            return _data + _size;
         }
     };
 
-    template<class P1, class P2, class P3, class P4, class P5, class P6, class P7, class P8>
-    class function<void, P1, P2, P3, P4, P5, P6, P7, P8> : public function_base
+    /// <summary>
+    ///     A native result that is returned to script as a TypedArray.
+    /// </summary>
+    /// <remarks>
+    ///     <para>
+    ///     A <c>typed_result</c> (or a <c>std::vector</c> of a TypedArray element type) can be used 
+    ///     as the return type of a <c>function</c>. The elements are copied into a new TypedArray 
+    ///     with a single block copy, instead of being set one at a time.
+    ///     </para>
+    ///     <para>
+    ///     Use <c>typed_result&lt;unsigned char, true&gt;</c> to return a <c>Uint8ClampedArray</c>.
+    ///     </para>
+    /// </remarks>
+    template<class T, bool clamped>
+    class typed_result
     {
-        friend class value;
+        std::vector<T> _values;
 
-    protected:
-        explicit function<void, P1, P2, P3, P4, P5, P6, P7, P8>(JsValueRef ref) :
-            function_base(ref)
+    public:
+        /// <summary>
+        ///     Creates an empty result.
+        /// </summary>
+        typed_result() :
+            _values()
         {
         }
 
-    public:
-        typedef void(*Signature)(const call_info &call_info, P1 p1, P2 p2, P3 p3, P4 p4, P5 p5, P6 p6, P7 p7, P8 p8);
-
-        function<void, P1, P2, P3, P4, P5, P6, P7, P8>() :
-            function_base()
+        /// <summary>
+        ///     Creates a result from a vector of elements.
+        /// </summary>
+        /// <param name="values">The elements of the result.</param>
+        typed_result(std::vector<T> values) :
+            _values(std::move(values))
         {
         }
 
-        explicit function<void, P1, P2, P3, P4, P5, P6, P7, P8>(value object) :
-            function_base(object)
+        /// <summary>
+        ///     The elements of the result.
+        /// </summary>
+        std::vector<T> &values()
         {
+            return _values;
         }
 
-    protected:
-        static JsValueRef CALLBACK thunk(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, void *callback_state)
+        /// <summary>
+        ///     The elements of the result.
+        /// </summary>
+        const std::vector<T> &values() const
         {
-            if (is_construct_call)
-            {
-                context::set_exception(error::create(L"Cannot call function as a constructor."));
-                return JS_INVALID_REFERENCE;
-            }
+            return _values;
+        }
+    };
 
-            call_info info;
-            P1 p1;
-            P2 p2;
-            P3 p3;
-            P4 p4;
-            P5 p5;
-            P6 p6;
-            P7 p7;
-            P8 p8;
+    /// <summary>
+    ///     An N-dimensional view over the elements of a TypedArray.
+    /// </summary>
+    /// <remarks>
+    ///     <para>
+    ///     An <c>ndarray</c> addresses the storage of a <c>typed_array</c> using a shape, a stride
+    ///     for each dimension (in elements) and the offset of the first element. Slicing and 
+    ///     transposing only change this metadata, so they never copy data.
+    ///     </para>
+    ///     <para>
+    ///     When marshalled to JavaScript, an <c>ndarray</c> becomes an object of the form
+    ///     <c>{ data, shape, strides, offset }</c>, where <c>data</c> is the underlying TypedArray.
+    ///     An object of that form (with <c>strides</c> and <c>offset</c> optional) can be marshalled
+    ///     back, as can a bare TypedArray when the rank is 1.
+    ///     </para>
+    ///     <para>
+    ///     The pointers returned by an <c>ndarray</c> have the same lifetime as the TypedArray's
+    ///     data. The view does not count as a reference to the TypedArray for the purposes of
+    ///     garbage collection.
+    ///     </para>
+    /// </remarks>
+    template<class T, unsigned int Rank, bool clamped>
+    class ndarray
+    {
+        static_assert(Rank > 0, "An ndarray must have at least one dimension.");
 
-            if (!unpack_arguments(callee, is_construct_call, arguments, argument_count, info, p1, p2, p3, p4, p5, p6, p7, p8))
-            {
-                return JS_INVALID_REFERENCE;
-            }
+        friend class marshal;
+        template<class U, unsigned int other_rank, bool other_clamped>
+        friend class ndarray;
 
-            Signature callback = static_cast<Signature>(callback_state);
-            try
-            {
-                callback(info, p1, p2, p3, p4, p5, p6, p7, p8);
-            }
-            catch (...)
-            {
-                context::set_exception(error::create(L"Fatal error."));
-                return JS_INVALID_REFERENCE;
-            }
+        typed_array<T, clamped> _array;
+        T *_base;
+        unsigned int _length;
+        int _offset;
+        std::array<unsigned int, Rank> _shape;
+        std::array<int, Rank> _strides;
 
-            return JS_INVALID_REFERENCE;
+        ndarray(JsValueRef array, T *base, unsigned int length, int offset, const std::array<unsigned int, Rank> &shape, const std::array<int, Rank> &strides) :
+            _array(array),
+            _base(base),
+            _length(length),
+            _offset(offset),
+            _shape(shape),
+            _strides(strides)
+        {
         }
 
-    public:
-        void operator ()(value this_value, P1 p1, P2 p2, P3 p3, P4 p4, P5 p5, P6 p6, P7 p7, P8 p8)
+        ndarray(typed_array<T, clamped> array, T *base, unsigned int length, int offset, const std::array<unsigned int, Rank> &shape, const std::array<int, Rank> &strides) :
+            _array(array),
+            _base(base),
+            _length(length),
+            _offset(offset),
+            _shape(shape),
+            _strides(strides)
         {
-            call_function<void>(pack_arguments(this_value, p1, p2, p3, p4, p5, p6, p7, p8));
         }
 
-        static function<void, P1, P2, P3, P4, P5, P6, P7, P8> create(Signature function)
+        static std::array<int, Rank> row_major_strides(const std::array<unsigned int, Rank> &shape)
         {
-            JsValueRef ref;
-            if (function == nullptr)
+            std::array<int, Rank> strides;
+            int stride = 1;
+            for (unsigned int dimension = Rank; dimension > 0; dimension--)
             {
-                runtime::translate_error_code(JsErrorNullArgument);
+                strides[dimension - 1] = stride;
+                stride *= static_cast<int>(shape[dimension - 1]);
             }
-            runtime::translate_error_code(JsCreateFunction(thunk, function, &ref));
-            return decltype(create(nullptr))(ref);
+            return strides;
         }
 
-        static function<void, P1, P2, P3, P4, P5, P6, P7, P8> create(std::wstring name, Signature function)
+        // Whether every element addressed by the view lies within the underlying array.
+        static bool in_bounds(unsigned int length, int offset, const std::array<unsigned int, Rank> &shape, const std::array<int, Rank> &strides)
         {
-            JsValueRef nameRef;
-            runtime::translate_error_code(marshal::from_native(name, &nameRef));
-            JsValueRef ref;
-            if (function == nullptr)
+            long long low = offset;
+            long long high = offset;
+
+            for (unsigned int dimension = 0; dimension < Rank; dimension++)
             {
-                runtime::translate_error_code(JsErrorNullArgument);
-            }
-            runtime::translate_error_code(JsCreateNamedFunction(nameRef, thunk, function, &ref));
-            return decltype(create(nullptr))(ref);
-        }
-    };
-#pragma endregion
+                if (shape[dimension] == 0)
+                {
+                    return offset >= 0 && static_cast<unsigned int>(offset) <= length;
+                }
 
-#pragma region Arity 7
-    template<class R, class P1, class P2, class P3, class P4, class P5, class P6, class P7>
-    class function<R, P1, P2, P3, P4, P5, P6, P7, notdefined> : public constructor_function<R>
-    {
-        friend class value;
+                long long extent = static_cast<long long>(shape[dimension] - 1) * strides[dimension];
+                if (extent < 0)
+                {
+                    low += extent;
+                }
+                else
+                {
+                    high += extent;
+                }
+            }
 
-    protected:
-        explicit function<R, P1, P2, P3, P4, P5, P6, P7, notdefined>(JsValueRef ref) :
-            constructor_function<R>(ref)
-        {
+            return low >= 0 && high < static_cast<long long>(length);
         }
 
     public:
-        typedef R(*Signature)(const call_info &call_info, P1 p1, P2 p2, P3 p3, P4 p4, P5 p5, P6 p6, P7 p7);
-
-        function<R, P1, P2, P3, P4, P5, P6, P7, notdefined>() :
-            constructor_function<R>()
-        {
-        }
-
-        explicit function<R, P1, P2, P3, P4, P5, P6, P7, notdefined>(value object) :
-            constructor_function<R>(object)
+        /// <summary>
+        ///     Creates an invalid view.
+        /// </summary>
+        ndarray() :
+            _array(),
+            _base(nullptr),
+            _length(0),
+            _offset(0),
+            _shape(),
+            _strides()
         {
         }
 
-    protected:
-        static JsValueRef CALLBACK thunk(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, void *callback_state)
+        /// <summary>
+        ///     Creates a row-major view over all of the elements of a TypedArray.
+        /// </summary>
+        /// <remarks>
+        ///     The number of elements in the TypedArray must equal the product of the shape.
+        /// </remarks>
+        /// <param name="array">The TypedArray to view.</param>
+        /// <param name="shape">The size of each dimension.</param>
+        ndarray(typed_array<T, clamped> array, const std::array<unsigned int, Rank> &shape) :
+            _array(array),
+            _offset(0),
+            _shape(shape),
+            _strides(row_major_strides(shape))
         {
-            call_info info;
-            P1 p1;
-            P2 p2;
-            P3 p3;
-            P4 p4;
-            P5 p5;
-            P6 p6;
-            P7 p7;
+            unsigned char *data;
+            unsigned int size;
+            JsTypedArrayType type;
+            int element_size;
+            runtime::translate_error_code(JsGetTypedArrayStorage(array.handle(), &data, &size, &type, &element_size));
 
-            if (!unpack_arguments(callee, is_construct_call, arguments, argument_count, info, p1, p2, p3, p4, p5, p6, p7))
+            if (type != typed_array_type<T, clamped>::type)
             {
-                return JS_INVALID_REFERENCE;
+                runtime::translate_error_code(JsErrorInvalidArgument);
             }
 
-            Signature callback = static_cast<Signature>(callback_state);
-            R result;
-            try
-            {
-                result = callback(info, p1, p2, p3, p4, p5, p6, p7);
-            }
-            catch (...)
+            unsigned long long count = 1;
+            for (unsigned int dimension = 0; dimension < Rank; dimension++)
             {
-                context::set_exception(error::create(L"Fatal error."));
-                return JS_INVALID_REFERENCE;
+                count *= shape[dimension];
             }
 
-            JsValueRef resultValue;
-            if (marshal::from_native(result, &resultValue) != JsNoError)
+            _base = reinterpret_cast<T *>(data);
+            _length = size / element_size;
+
+            if (count != _length)
             {
-                context::set_exception(error::create_type_error(L"Could not convert value."));
-                return JS_INVALID_REFERENCE;
+                runtime::translate_error_code(JsErrorInvalidArgument);
             }
+        }
 
-            return resultValue;
+        /// <summary>
+        ///     Whether the view is valid.
+        /// </summary>
+        bool is_valid() const
+        {
+            return _array.is_valid();
         }
 
-    public:
-        R operator ()(value this_value, P1 p1, P2 p2, P3 p3, P4 p4, P5 p5, P6 p6, P7 p7)
+        /// <summary>
+        ///     The underlying TypedArray.
+        /// </summary>
+        typed_array<T, clamped> array() const
         {
-            return call_function<R>(pack_arguments(this_value, p1, p2, p3, p4, p5, p6, p7));
+            return _array;
         }
 
-        R construct(P1 p1, P2 p2, P3 p3, P4 p4, P5 p5, P6 p6, P7 p7)
+        /// <summary>
+        ///     The size of each dimension.
+        /// </summary>
+        const std::array<unsigned int, Rank> &shape() const
         {
-            return construct_object(pack_arguments(context::undefined(), p1, p2, p3, p4, p5, p6, p7));
+            return _shape;
         }
 
-        static function<R, P1, P2, P3, P4, P5, P6, P7> create(Signature function)
+        /// <summary>
+        ///     The distance, in elements, between consecutive positions in each dimension.
+        /// </summary>
+        const std::array<int, Rank> &strides() const
         {
-            JsValueRef ref;
-            if (function == nullptr)
-            {
-                runtime::translate_error_code(JsErrorNullArgument);
-            }
-            runtime::translate_error_code(JsCreateFunction(thunk, function, &ref));
-            return decltype(create(nullptr))(ref);
+            return _strides;
         }
 
-        static function<R, P1, P2, P3, P4, P5, P6, P7> create(std::wstring name, Signature function)
+        /// <summary>
+        ///     The index of the first element of the view in the underlying TypedArray.
+        /// </summary>
+        int offset() const
         {
-            JsValueRef nameRef;
-            runtime::translate_error_code(marshal::from_native(name, &nameRef));
-            JsValueRef ref;
-            if (function == nullptr)
+            return _offset;
+        }
+
+        /// <summary>
+        ///     The number of elements in the view.
+        /// </summary>
+        size_t size() const
+        {
+            size_t count = 1;
+            for (unsigned int dimension = 0; dimension < Rank; dimension++)
             {
-                runtime::translate_error_code(JsErrorNullArgument);
+                count *= _shape[dimension];
             }
-            runtime::translate_error_code(JsCreateNamedFunction(nameRef, thunk, function, &ref));
-            return decltype(create(nullptr))(ref);
+            return count;
         }
-    };
-
-    template<class P1, class P2, class P3, class P4, class P5, class P6, class P7>
-    class function<void, P1, P2, P3, P4, P5, P6, P7, notdefined> : public function_base
-    {
-        friend class value;
 
-    protected:
-        explicit function<void, P1, P2, P3, P4, P5, P6, P7, notdefined>(JsValueRef ref) :
-            function_base(ref)
+        /// <summary>
+        ///     A pointer to the first element of the view.
+        /// </summary>
+        T *data() const
         {
+            return _base + _offset;
         }
 
-    public:
-        typedef void(*Signature)(const call_info &call_info, P1 p1, P2 p2, P3 p3, P4 p4, P5 p5, P6 p6, P7 p7);
-
-        function<void, P1, P2, P3, P4, P5, P6, P7, notdefined>() :
-            function_base()
+        /// <summary>
+        ///     Whether the elements of the view are contiguous and in row-major order.
+        /// </summary>
+        bool is_contiguous() const
         {
+            return _strides == row_major_strides(_shape);
         }
 
-        explicit function<void, P1, P2, P3, P4, P5, P6, P7, notdefined>(value object) :
-            function_base(object)
+        /// <summary>
+        ///     Accesses an element of the view.
+        /// </summary>
+        /// <remarks>
+        ///     The indexes are not bounds checked.
+        /// </remarks>
+        /// <param name="indexes">The index of the element in each dimension.</param>
+        /// <returns>A reference to the element.</returns>
+        template<class... Indexes>
+        T &operator()(Indexes... indexes) const
         {
+            static_assert(sizeof...(Indexes) == Rank, "The number of indexes must match the rank.");
+
+            const unsigned int position[] = { static_cast<unsigned int>(indexes)... };
+            ptrdiff_t element = _offset;
+            for (unsigned int dimension = 0; dimension < Rank; dimension++)
+            {
+                element += static_cast<ptrdiff_t>(position[dimension]) * _strides[dimension];
+            }
+            return _base[element];
         }
 
-    protected:
-        static JsValueRef CALLBACK thunk(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, void *callback_state)
+        /// <summary>
+        ///     Accesses an element of the view, checking that the element is in bounds.
+        /// </summary>
+        /// <param name="position">The index of the element in each dimension.</param>
+        /// <returns>A reference to the element.</returns>
+        T &at(const std::array<unsigned int, Rank> &position) const
         {
-            if (is_construct_call)
+            ptrdiff_t element = _offset;
+            for (unsigned int dimension = 0; dimension < Rank; dimension++)
             {
-                context::set_exception(error::create(L"Cannot call function as a constructor."));
-                return JS_INVALID_REFERENCE;
-            }
+                if (position[dimension] >= _shape[dimension])
+                {
+                    runtime::translate_error_code(JsErrorInvalidArgument);
+                }
 
-            call_info info;
-            P1 p1;
-            P2 p2;
-            P3 p3;
-            P4 p4;
-            P5 p5;
-            P6 p6;
-            P7 p7;
+                element += static_cast<ptrdiff_t>(position[dimension]) * _strides[dimension];
+            }
+            return _base[element];
+        }
 
-            if (!unpack_arguments(callee, is_construct_call, arguments, argument_count, info, p1, p2, p3, p4, p5, p6, p7))
+        /// <summary>
+        ///     Creates a view over a range of one dimension of this view.
+        /// </summary>
+        /// <param name="dimension">The dimension to slice.</param>
+        /// <param name="begin">The first position in the dimension to include.</param>
+        /// <param name="end">The position one past the last position to include.</param>
+        /// <param name="step">The distance between included positions.</param>
+        /// <returns>The new view.</returns>
+        ndarray slice(unsigned int dimension, unsigned int begin, unsigned int end, unsigned int step = 1) const
+        {
+            if (dimension >= Rank || begin > end || end > _shape[dimension] || step == 0)
             {
-                return JS_INVALID_REFERENCE;
+                runtime::translate_error_code(JsErrorInvalidArgument);
             }
 
-            Signature callback = static_cast<Signature>(callback_state);
-            try
+            std::array<unsigned int, Rank> shape = _shape;
+            std::array<int, Rank> strides = _strides;
+            shape[dimension] = (end - begin + step - 1) / step;
+            strides[dimension] = _strides[dimension] * static_cast<int>(step);
+            return ndarray(_array, _base, _length, _offset + static_cast<int>(begin) * _strides[dimension], shape, strides);
+        }
+
+        /// <summary>
+        ///     Creates a view of one position of a dimension, removing that dimension.
+        /// </summary>
+        /// <param name="dimension">The dimension to index.</param>
+        /// <param name="position">The position in the dimension.</param>
+        /// <returns>The new view.</returns>
+        template<unsigned int R = Rank>
+        typename std::enable_if<(R > 1), ndarray<T, R - 1, clamped>>::type index(unsigned int dimension, unsigned int position) const
+        {
+            if (dimension >= Rank || position >= _shape[dimension])
             {
-                callback(info, p1, p2, p3, p4, p5, p6, p7);
+                runtime::translate_error_code(JsErrorInvalidArgument);
             }
-            catch (...)
+
+            std::array<unsigned int, Rank - 1> shape;
+            std::array<int, Rank - 1> strides;
+            for (unsigned int source = 0, target = 0; source < Rank; source++)
             {
-                context::set_exception(error::create(L"Fatal error."));
-                return JS_INVALID_REFERENCE;
+                if (source != dimension)
+                {
+                    shape[target] = _shape[source];
+                    strides[target] = _strides[source];
+                    target++;
+                }
             }
 
-            return JS_INVALID_REFERENCE;
-        }
-
-    public:
-        void operator ()(value this_value, P1 p1, P2 p2, P3 p3, P4 p4, P5 p5, P6 p6, P7 p7)
-        {
-            call_function<void>(pack_arguments(this_value, p1, p2, p3, p4, p5, p6, p7));
+            return ndarray<T, Rank - 1, clamped>(_array, _base, _length, _offset + static_cast<int>(position) * _strides[dimension], shape, strides);
         }
 
-        static function<void, P1, P2, P3, P4, P5, P6, P7> create(Signature function)
+        /// <summary>
+        ///     Creates a view with the order of the dimensions reversed.
+        /// </summary>
+        /// <returns>The new view.</returns>
+        ndarray transpose() const
         {
-            JsValueRef ref;
-            if (function == nullptr)
+            std::array<unsigned int, Rank> shape;
+            std::array<int, Rank> strides;
+            for (unsigned int dimension = 0; dimension < Rank; dimension++)
             {
-                runtime::translate_error_code(JsErrorNullArgument);
+                shape[dimension] = _shape[Rank - 1 - dimension];
+                strides[dimension] = _strides[Rank - 1 - dimension];
             }
-            runtime::translate_error_code(JsCreateFunction(thunk, function, &ref));
-            return decltype(create(nullptr))(ref);
+            return ndarray(_array, _base, _length, _offset, shape, strides);
         }
 
-        static function<void, P1, P2, P3, P4, P5, P6, P7> create(std::wstring name, Signature function)
+        /// <summary>
+        ///     Creates a view with two dimensions exchanged.
+        /// </summary>
+        /// <param name="first">The first dimension.</param>
+        /// <param name="second">The second dimension.</param>
+        /// <returns>The new view.</returns>
+        ndarray transpose(unsigned int first, unsigned int second) const
         {
-            JsValueRef nameRef;
-            runtime::translate_error_code(marshal::from_native(name, &nameRef));
-            JsValueRef ref;
-            if (function == nullptr)
+            if (first >= Rank || second >= Rank)
             {
-                runtime::translate_error_code(JsErrorNullArgument);
+                runtime::translate_error_code(JsErrorInvalidArgument);
             }
-            runtime::translate_error_code(JsCreateNamedFunction(nameRef, thunk, function, &ref));
-            return decltype(create(nullptr))(ref);
+
+            std::array<unsigned int, Rank> shape = _shape;
+            std::array<int, Rank> strides = _strides;
+            std::swap(shape[first], shape[second]);
+            std::swap(strides[first], strides[second]);
+            return ndarray(_array, _base, _length, _offset, shape, strides);
         }
     };
-#pragma endregion
 
-#pragma region Arity 6
-    template<class R, class P1, class P2, class P3, class P4, class P5, class P6>
-    class function<R, P1, P2, P3, P4, P5, P6, notdefined, notdefined> : public constructor_function<R>
+    /// <summary>
+    ///     A reference to a JavaScript error.
+    /// </summary>
+    class error : public object
     {
         friend class value;
 
-    protected:
-        explicit function<R, P1, P2, P3, P4, P5, P6, notdefined, notdefined>(JsValueRef ref) :
-            constructor_function<R>(ref)
+        static JsValueRef format_message(std::wstring message, va_list argptr)
         {
-        }
-
-    public:
-        typedef R(*Signature)(const call_info &call_info, P1 p1, P2 p2, P3 p3, P4 p4, P5 p5, P6 p6);
+            wchar_t buffer[2048];
+            _vsnwprintf_s(buffer, _countof(buffer), _TRUNCATE, message.c_str(), argptr);
 
-        function<R, P1, P2, P3, P4, P5, P6, notdefined, notdefined>() :
-            constructor_function<R>()
-        {
-        }
+            JsValueRef errorString;
+            runtime::translate_error_code(JsPointerToString(buffer, wcslen(buffer), &errorString));
 
-        explicit function<R, P1, P2, P3, P4, P5, P6, notdefined, notdefined>(value object) :
-            constructor_function<R>(object)
-        {
+            return errorString;
         }
 
     protected:
-        static JsValueRef CALLBACK thunk(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, void *callback_state)
+        explicit error(JsValueRef ref) :
+            object(ref)
         {
-            call_info info;
-            P1 p1;
-            P2 p2;
-            P3 p3;
-            P4 p4;
-            P5 p5;
-            P6 p6;
-
-            if (!unpack_arguments(callee, is_construct_call, arguments, argument_count, info, p1, p2, p3, p4, p5, p6))
-            {
-                return JS_INVALID_REFERENCE;
-            }
-
-            Signature callback = static_cast<Signature>(callback_state);
-            R result;
-            try
-            {
-                result = callback(info, p1, p2, p3, p4, p5, p6);
-            }
-            catch (...)
-            {
-                context::set_exception(error::create(L"Fatal error."));
-                return JS_INVALID_REFERENCE;
-            }
-
-            JsValueRef resultValue;
-            if (marshal::from_native(result, &resultValue) != JsNoError)
-            {
-                context::set_exception(error::create_type_error(L"Could not convert value."));
-                return JS_INVALID_REFERENCE;
-            }
-
-            return resultValue;
         }
 
     public:
-        R operator ()(value this_value, P1 p1, P2 p2, P3 p3, P4 p4, P5 p5, P6 p6)
+        /// <summary>
+        ///     Creates an invalid handle to an error.
+        /// </summary>
+        error() :
+            object()
         {
-            return call_function<R>(pack_arguments(this_value, p1, p2, p3, p4, p5, p6));
         }
 
-        R construct(P1 p1, P2 p2, P3 p3, P4 p4, P5 p5, P6 p6)
+        /// <summary>
+        ///     Converts the <c>value</c> handle to an <c>error</c> handle.
+        /// </summary>
+        /// <remarks>
+        ///     The type of the underlying value is not checked.
+        /// </remarks>
+        explicit error(value object) :
+            object(object.handle())
         {
-            return construct_object(pack_arguments(context::undefined(), p1, p2, p3, p4, p5, p6));
         }
 
-        static function<R, P1, P2, P3, P4, P5, P6> create(Signature function)
+        /// <summary>
+        ///     The <c>name</c> property of the error.
+        /// </summary>
+        std::wstring name()
         {
-            JsValueRef ref;
-            if (function == nullptr)
+            optional<value> name = get_property<value>(property_id::create(L"name"));
+
+            if (name.has_value() && name.value().type() == JsString)
             {
-                runtime::translate_error_code(JsErrorNullArgument);
+                return static_cast<string>(name.value()).data();
             }
-            runtime::translate_error_code(JsCreateFunction(thunk, function, &ref));
-            return decltype(create(nullptr))(ref);
+
+            return L"";
         }
 
-        static function<R, P1, P2, P3, P4, P5, P6> create(std::wstring name, Signature function)
+        /// <summary>
+        ///     The <c>message</c> property of the error.
+        /// </summary>
+        std::wstring message()
         {
-            JsValueRef nameRef;
-            runtime::translate_error_code(marshal::from_native(name, &nameRef));
-            JsValueRef ref;
-            if (function == nullptr)
+            optional<value> message = get_property<value>(property_id::create(L"message"));
+
+            if (message.has_value() && message.value().type() == JsString)
             {
-                runtime::translate_error_code(JsErrorNullArgument);
+                return static_cast<string>(message.value()).data();
             }
-            runtime::translate_error_code(JsCreateNamedFunction(nameRef, thunk, function, &ref));
-            return decltype(create(nullptr))(ref);
-        }
-    };
-
-    template<class P1, class P2, class P3, class P4, class P5, class P6>
-    class function<void, P1, P2, P3, P4, P5, P6, notdefined, notdefined> : public function_base
-    {
-        friend class value;
 
-    protected:
-        explicit function<void, P1, P2, P3, P4, P5, P6, notdefined, notdefined>(JsValueRef ref) :
-            function_base(ref)
-        {
+            return L"";
         }
 
-    public:
-        typedef void(*Signature)(const call_info &call_info, P1 p1, P2 p2, P3 p3, P4 p4, P5 p5, P6 p6);
-
-        function<void, P1, P2, P3, P4, P5, P6, notdefined, notdefined>() :
-            function_base()
+        /// <summary>
+        ///     Creates a new JavaScript error object
+        /// </summary>
+        /// <remarks>
+        ///     Requires an active script context.
+        /// </remarks>
+        /// <param name="message">Message for the error object.</param>
+        /// <returns>The new error object.</returns>
+        static error create(std::wstring message, ...)
         {
-        }
+            va_list argptr;
+            va_start(argptr, message);
 
-        explicit function<void, P1, P2, P3, P4, P5, P6, notdefined, notdefined>(value object) :
-            function_base(object)
-        {
+            JsValueRef errorObject;
+
+            runtime::translate_error_code(JsCreateError(format_message(message, argptr), &errorObject));
+            return error(errorObject);
         }
 
-    protected:
-        static JsValueRef CALLBACK thunk(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, void *callback_state)
+        /// <summary>
+        ///     Creates a new JavaScript TypeError error object
+        /// </summary>
+        /// <remarks>
+        ///     Requires an active script context.
+        /// </remarks>
+        /// <param name="message">Message for the error object.</param>
+        /// <returns>The new error object.</returns>
+        static error create_type_error(std::wstring message, ...)
         {
-            if (is_construct_call)
-            {
-                context::set_exception(error::create(L"Cannot call function as a constructor."));
-                return JS_INVALID_REFERENCE;
-            }
-
-            call_info info;
-            P1 p1;
-            P2 p2;
-            P3 p3;
-            P4 p4;
-            P5 p5;
-            P6 p6;
-
-            if (!unpack_arguments(callee, is_construct_call, arguments, argument_count, info, p1, p2, p3, p4, p5, p6))
-            {
-                return JS_INVALID_REFERENCE;
-            }
+            va_list argptr;
+            va_start(argptr, message);
 
-            Signature callback = static_cast<Signature>(callback_state);
-            try
-            {
-                callback(info, p1, p2, p3, p4, p5, p6);
-            }
-            catch (...)
-            {
-                context::set_exception(error::create(L"Fatal error."));
-                return JS_INVALID_REFERENCE;
-            }
+            JsValueRef errorObject;
 
-            return JS_INVALID_REFERENCE;
+            runtime::translate_error_code(JsCreateTypeError(format_message(message, argptr), &errorObject));
+            return error(errorObject);
         }
 
-    public:
-        void operator ()(value this_value, P1 p1, P2 p2, P3 p3, P4 p4, P5 p5, P6 p6)
+        /// <summary>
+        ///     Creates a new JavaScript ReferenceError error object
+        /// </summary>
+        /// <remarks>
+        ///     Requires an active script context.
+        /// </remarks>
+        /// <param name="message">Message for the error object.</param>
+        /// <returns>The new error object.</returns>
+        static error create_reference_error(std::wstring message, ...)
         {
-            call_function<void>(pack_arguments(this_value, p1, p2, p3, p4, p5, p6));
-        }
+            va_list argptr;
+            va_start(argptr, message);
 
-        static function<void, P1, P2, P3, P4, P5, P6> create(Signature function)
-        {
-            JsValueRef ref;
-            if (function == nullptr)
-            {
-                runtime::translate_error_code(JsErrorNullArgument);
-            }
-            runtime::translate_error_code(JsCreateFunction(thunk, function, &ref));
-            return decltype(create(nullptr))(ref);
-        }
+            JsValueRef errorObject;
 
-        static function<void, P1, P2, P3, P4, P5, P6> create(std::wstring name, Signature function)
-        {
-            JsValueRef nameRef;
-            runtime::translate_error_code(marshal::from_native(name, &nameRef));
-            JsValueRef ref;
-            if (function == nullptr)
-            {
-                runtime::translate_error_code(JsErrorNullArgument);
-            }
-            runtime::translate_error_code(JsCreateNamedFunction(nameRef, thunk, function, &ref));
-            return decltype(create(nullptr))(ref);
+            runtime::translate_error_code(JsCreateReferenceError(format_message(message, argptr), &errorObject));
+            return error(errorObject);
         }
-    };
-#pragma endregion
-
-#pragma region Arity 5
-    template<class R, class P1, class P2, class P3, class P4, class P5>
-    class function<R, P1, P2, P3, P4, P5, notdefined, notdefined, notdefined> : public constructor_function<R>
-    {
-        friend class value;
 
-    protected:
-        explicit function<R, P1, P2, P3, P4, P5, notdefined, notdefined, notdefined>(JsValueRef ref) :
-            constructor_function<R>(ref)
+        /// <summary>
+        ///     Creates a new JavaScript RangeError error object
+        /// </summary>
+        /// <remarks>
+        ///     Requires an active script context.
+        /// </remarks>
+        /// <param name="message">Message for the error object.</param>
+        /// <returns>The new error object.</returns>
+        static error create_range_error(std::wstring message, ...)
         {
-        }
+            va_list argptr;
+            va_start(argptr, message);
 
-    public:
-        typedef R(*Signature)(const call_info &call_info, P1 p1, P2 p2, P3 p3, P4 p4, P5 p5);
+            JsValueRef errorObject;
 
-        function<R, P1, P2, P3, P4, P5, notdefined, notdefined, notdefined>() :
-            constructor_function<R>()
-        {
+            runtime::translate_error_code(JsCreateRangeError(format_message(message, argptr), &errorObject));
+            return error(errorObject);
         }
 
-        explicit function<R, P1, P2, P3, P4, P5, notdefined, notdefined, notdefined>(value object) :
-            constructor_function<R>(object)
+        /// <summary>
+        ///     Creates a new JavaScript SyntaxError error object
+        /// </summary>
+        /// <remarks>
+        ///     Requires an active script context.
+        /// </remarks>
+        /// <param name="message">Message for the error object.</param>
+        /// <returns>The new error object.</returns>
+        static error create_syntax_error(std::wstring message, ...)
         {
+            va_list argptr;
+            va_start(argptr, message);
+
+            JsValueRef errorObject;
+
+            runtime::translate_error_code(JsCreateSyntaxError(format_message(message, argptr), &errorObject));
+            return error(errorObject);
         }
 
-    protected:
-        static JsValueRef CALLBACK thunk(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, void *callback_state)
+        /// <summary>
+        ///     Creates a new JavaScript URIError error object
+        /// </summary>
+        /// <remarks>
+        ///     Requires an active script context.
+        /// </remarks>
+        /// <param name="message">Message for the error object.</param>
+        /// <returns>The new error object.</returns>
+        static error create_uri_error(std::wstring message, ...)
         {
-            call_info info;
-            P1 p1;
-            P2 p2;
-            P3 p3;
-            P4 p4;
-            P5 p5;
+            va_list argptr;
+            va_start(argptr, message);
 
-            if (!unpack_arguments(callee, is_construct_call, arguments, argument_count, info, p1, p2, p3, p4, p5))
-            {
-                return JS_INVALID_REFERENCE;
-            }
+            JsValueRef errorObject;
 
-            Signature callback = static_cast<Signature>(callback_state);
-            R result;
-            try
-            {
-                result = callback(info, p1, p2, p3, p4, p5);
-            }
-            catch (...)
-            {
-                context::set_exception(error::create(L"Fatal error."));
-                return JS_INVALID_REFERENCE;
-            }
+            runtime::translate_error_code(JsCreateURIError(format_message(message, argptr), &errorObject));
+            return error(errorObject);
+        }
+    };
 
-            JsValueRef resultValue;
-            if (marshal::from_native(result, &resultValue) != JsNoError)
-            {
-                context::set_exception(error::create_type_error(L"Could not convert value."));
-                return JS_INVALID_REFERENCE;
-            }
+    /// <summary>
+    ///     Information about a function call.
+    /// </summary>
+    class call_info
+    {
+        value _callee;
+        value _this_value;
+        bool _is_construct_call;
 
-            return resultValue;
+    public:
+        /// <summary>
+        ///     Constructs an empty call information instance.
+        /// </summary>
+        call_info() :
+            _callee(value()),
+            _this_value(value()),
+            _is_construct_call(false)
+        {
         }
 
-    public:
-        R operator ()(value this_value, P1 p1, P2 p2, P3 p3, P4 p4, P5 p5)
+        /// <summary>
+        ///     Constructs a call information instance.
+        /// </summary>
+        call_info(value callee, value this_value, bool is_construct_call) :
+            _callee(callee),
+            _this_value(this_value),
+            _is_construct_call(is_construct_call)
         {
-            return call_function<R>(pack_arguments(this_value, p1, p2, p3, p4, p5));
         }
 
-        R construct(P1 p1, P2 p2, P3 p3, P4 p4, P5 p5)
+        /// <summary>
+        ///     The JavaScript function being called.
+        /// </summary>
+        value callee() const
         {
-            return construct_object(pack_arguments(context::undefined(), p1, p2, p3, p4, p5));
+            return this->_callee;
         }
 
-        static function<R, P1, P2, P3, P4, P5> create(Signature function)
+        /// <summary>
+        ///     The <c>this</c> value for the function call.
+        /// </summary>
+        value this_value() const
         {
-            JsValueRef ref;
-            if (function == nullptr)
-            {
-                runtime::translate_error_code(JsErrorNullArgument);
-            }
-            runtime::translate_error_code(JsCreateFunction(thunk, function, &ref));
-            return decltype(create(nullptr))(ref);
+            return this->_this_value;
         }
 
-        static function<R, P1, P2, P3, P4, P5> create(std::wstring name, Signature function)
+        /// <summary>
+        ///     Whether the call was a function call or a <c>new</c> call.
+        /// </summary>
+        bool is_construct_call() const
         {
-            JsValueRef nameRef;
-            runtime::translate_error_code(marshal::from_native(name, &nameRef));
-            JsValueRef ref;
-            if (function == nullptr)
-            {
-                runtime::translate_error_code(JsErrorNullArgument);
-            }
-            runtime::translate_error_code(JsCreateNamedFunction(nameRef, thunk, function, &ref));
-            return decltype(create(nullptr))(ref);
+            return this->_is_construct_call;
         }
     };
 
-    template<class P1, class P2, class P3, class P4, class P5>
-    class function<void, P1, P2, P3, P4, P5, notdefined, notdefined, notdefined> : public function_base
+    /// <summary>
+    ///     A reference to a JavaScript function.
+    /// </summary>
+    class function_base : public object
     {
+        friend class context;
         friend class value;
 
-    protected:
-        explicit function<void, P1, P2, P3, P4, P5, notdefined, notdefined, notdefined>(JsValueRef ref) :
-            function_base(ref)
-        {
-        }
-
-    public:
-        typedef void(*Signature)(const call_info &call_info, P1 p1, P2 p2, P3 p3, P4 p4, P5 p5);
-
-        function<void, P1, P2, P3, P4, P5, notdefined, notdefined, notdefined>() :
-            function_base()
+        template<class T>
+        static bool is_rest(T value)
         {
-        }
+            return false;
+        };
 
-        explicit function<void, P1, P2, P3, P4, P5, notdefined, notdefined, notdefined>(value object) :
-            function_base(object)
+        template<class T>
+        static bool is_rest(std::vector<T> value)
         {
-        }
+            return true;
+        };
 
-    protected:
-        static JsValueRef CALLBACK thunk(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, void *callback_state)
+        template<class T>
+        static bool argument_from_value(int position, JsValueRef *arguments, int argument_count, T &result)
         {
-            if (is_construct_call)
+            if (position > argument_count - 1)
             {
-                context::set_exception(error::create(L"Cannot call function as a constructor."));
-                return JS_INVALID_REFERENCE;
+                context::set_exception(error::create(L"Incorrect number of arguments."));
+                return false;
             }
-
-            call_info info;
-            P1 p1;
-            P2 p2;
-            P3 p3;
-            P4 p4;
-            P5 p5;
-
-            if (!unpack_arguments(callee, is_construct_call, arguments, argument_count, info, p1, p2, p3, p4, p5))
+            
+			if (marshal::to_native(arguments[position], &result) != JsNoError)
             {
-                return JS_INVALID_REFERENCE;
+                context::set_exception(error::create_type_error(L"Could not convert value."));
+                return false;
             }
 
-            Signature callback = static_cast<Signature>(callback_state);
-            try
+            return true;
+        }
+
+        template<class T>
+        static bool argument_from_value(int position, JsValueRef *arguments, int argument_count, optional<T> &result)
+        {
+            if (position > argument_count - 1)
             {
-                callback(info, p1, p2, p3, p4, p5);
+                result = missing();
             }
-            catch (...)
+            else
             {
-                context::set_exception(error::create(L"Fatal error."));
-                return JS_INVALID_REFERENCE;
+                T nativeValue;
+                if (marshal::to_native(arguments[position], &nativeValue) != JsNoError)
+                {
+                    context::set_exception(error::create_type_error(L"Could not convert value."));
+                    result = missing();
+                }
+                else
+                {
+                    result = optional<T>(nativeValue);
+                }
             }
 
-            return JS_INVALID_REFERENCE;
+            return true;
         }
 
-    public:
-        void operator ()(value this_value, P1 p1, P2 p2, P3 p3, P4 p4, P5 p5)
+        template<class T>
+        static bool argument_from_value(int position, JsValueRef *arguments, int argument_count, std::vector<T> &result)
         {
-            call_function<void>(pack_arguments(this_value, p1, p2, p3, p4, p5));
-        }
+            bool succeeded = true;
 
-        static function<void, P1, P2, P3, P4, P5> create(Signature function)
-        {
-            JsValueRef ref;
-            if (function == nullptr)
+            if (position < argument_count)
             {
-                runtime::translate_error_code(JsErrorNullArgument);
-            }
-            runtime::translate_error_code(JsCreateFunction(thunk, function, &ref));
-            return decltype(create(nullptr))(ref);
-        }
+                result = std::vector<T>(argument_count - position);
+                std::transform(arguments + position, arguments + argument_count, result.begin(), [&](JsValueRef v)
+                {
+                    T value;
 
-        static function<void, P1, P2, P3, P4, P5> create(std::wstring name, Signature function)
-        {
-            JsValueRef nameRef;
-            runtime::translate_error_code(marshal::from_native(name, &nameRef));
-            JsValueRef ref;
-            if (function == nullptr)
-            {
-                runtime::translate_error_code(JsErrorNullArgument);
+                    if (marshal::to_native(v, &value) != JsNoError)
+                    {
+                        context::set_exception(error::create_type_error(L"Could not convert value."));
+                        succeeded = true;
+                    }
+
+                    return value;
+                });
             }
-            runtime::translate_error_code(JsCreateNamedFunction(nameRef, thunk, function, &ref));
-            return decltype(create(nullptr))(ref);
+
+            return succeeded;
         }
-    };
-#pragma endregion
 
-#pragma region Arity 4
-    template<class R, class P1, class P2, class P3, class P4>
-    class function<R, P1, P2, P3, P4, notdefined, notdefined, notdefined, notdefined> : public constructor_function<R>
-    {
-        friend class value;
+        template<class T>
+        static size_t optional_argument_count(T value)
+        {
+            return 1;
+        };
 
-    protected:
-        explicit function<R, P1, P2, P3, P4, notdefined, notdefined, notdefined, notdefined>(JsValueRef ref) :
-            constructor_function<R>(ref)
+        template<class T>
+        static size_t optional_argument_count(optional<T> value)
         {
-        }
+            return value.has_value() ? 1 : 0;
+        };
 
-    public:
-        typedef R(*Signature)(const call_info &call_info, P1 p1, P2 p2, P3 p3, P4 p4);
+        template<class T>
+        static size_t optional_argument_count(std::vector<T> &value)
+        {
+            return value.size();
+        };
 
-        function<R, P1, P2, P3, P4, notdefined, notdefined, notdefined, notdefined>() :
-            constructor_function<R>()
+        template<class T>
+        static void fill_rest(T argument, unsigned start, std::vector<JsValueRef> &arguments)
         {
+            runtime::translate_error_code(marshal::from_native(argument, &arguments[start]));
         }
 
-        explicit function<R, P1, P2, P3, P4, notdefined, notdefined, notdefined, notdefined>(value object) :
-            constructor_function<R>(object)
+        template<class T>
+        static void fill_rest(std::vector<T> &rest, unsigned start, std::vector<JsValueRef> &arguments)
         {
+            std::transform(rest.begin(), rest.end(), arguments.begin() + start, [&](T v)
+            {
+                JsValueRef value;
+                runtime::translate_error_code(marshal::from_native(v, &value));
+                return value;
+            });
         }
 
     protected:
-        static JsValueRef CALLBACK thunk(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, void *callback_state)
+        template <class P1, class P2, class P3, class P4, class P5, class P6, class P7, class P8>
+        static bool unpack_arguments(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, call_info &info, P1 &p1, P2 &p2, P3 &p3, P4 &p4, P5 &p5, P6 &p6, P7 &p7, P8 &p8)
         {
-            call_info info;
-            P1 p1;
-            P2 p2;
-            P3 p3;
-            P4 p4;
-
-            if (!unpack_arguments(callee, is_construct_call, arguments, argument_count, info, p1, p2, p3, p4))
-            {
-                return JS_INVALID_REFERENCE;
-            }
-
-            Signature callback = static_cast<Signature>(callback_state);
-            R result;
-            try
-            {
-                result = callback(info, p1, p2, p3, p4);
-            }
-            catch (...)
+            if (!is_rest(p8) && argument_count > 9)
             {
-                context::set_exception(error::create(L"Fatal error."));
-                return JS_INVALID_REFERENCE;
+                context::set_exception(error::create(L"Incorrect number of arguments."));
+                return false;
             }
 
-            JsValueRef resultValue;
-            if (marshal::from_native(result, &resultValue) != JsNoError)
-            {
-                context::set_exception(error::create_type_error(L"Could not convert value."));
-                return JS_INVALID_REFERENCE;
-            }
+            info = call_info(value(callee), value(arguments[0]), is_construct_call);
 
-            return resultValue;
+            return argument_from_value(1, arguments, argument_count, p1) &&
+                argument_from_value(2, arguments, argument_count, p2) &&
+                argument_from_value(3, arguments, argument_count, p3) &&
+                argument_from_value(4, arguments, argument_count, p4) &&
+                argument_from_value(5, arguments, argument_count, p5) &&
+                argument_from_value(6, arguments, argument_count, p6) &&
+                argument_from_value(7, arguments, argument_count, p7) &&
+                argument_from_value(8, arguments, argument_count, p8);
         }
 
-    public:
-        R operator ()(value this_value, P1 p1, P2 p2, P3 p3, P4 p4)
+        template <class P1, class P2, class P3, class P4, class P5, class P6, class P7>
+        static bool unpack_arguments(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, call_info &info, P1 &p1, P2 &p2, P3 &p3, P4 &p4, P5 &p5, P6 &p6, P7 &p7)
         {
-            return call_function<R>(pack_arguments(this_value, p1, p2, p3, p4));
-        }
+            if (!is_rest(p7) && argument_count > 8)
+            {
+                context::set_exception(error::create(L"Incorrect number of arguments."));
+                return false;
+            }
 
-        R construct(P1 p1, P2 p2, P3 p3, P4 p4)
-        {
-            return construct_object(pack_arguments(context::undefined(), p1, p2, p3, p4));
+            info = call_info(value(callee), value(arguments[0]), is_construct_call);
+
+            return argument_from_value(1, arguments, argument_count, p1) &&
+                argument_from_value(2, arguments, argument_count, p2) &&
+                argument_from_value(3, arguments, argument_count, p3) &&
+                argument_from_value(4, arguments, argument_count, p4) &&
+                argument_from_value(5, arguments, argument_count, p5) &&
+                argument_from_value(6, arguments, argument_count, p6) &&
+                argument_from_value(7, arguments, argument_count, p7);
         }
 
-        static function<R, P1, P2, P3, P4> create(Signature function)
+        template <class P1, class P2, class P3, class P4, class P5, class P6>
+        static bool unpack_arguments(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, call_info &info, P1 &p1, P2 &p2, P3 &p3, P4 &p4, P5 &p5, P6 &p6)
         {
-            JsValueRef ref;
-            if (function == nullptr)
+            if (!is_rest(p6) && argument_count > 7)
             {
-                runtime::translate_error_code(JsErrorNullArgument);
+                context::set_exception(error::create(L"Incorrect number of arguments."));
+                return false;
             }
-            runtime::translate_error_code(JsCreateFunction(thunk, function, &ref));
-            return decltype(create(nullptr))(ref);
+
+            info = call_info(value(callee), value(arguments[0]), is_construct_call);
+
+            return argument_from_value(1, arguments, argument_count, p1) &&
+                argument_from_value(2, arguments, argument_count, p2) &&
+                argument_from_value(3, arguments, argument_count, p3) &&
+                argument_from_value(4, arguments, argument_count, p4) &&
+                argument_from_value(5, arguments, argument_count, p5) &&
+                argument_from_value(6, arguments, argument_count, p6);
         }
 
-        static function<R, P1, P2, P3, P4> create(std::wstring name, Signature function)
+        template <class P1, class P2, class P3, class P4, class P5>
+        static bool unpack_arguments(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, call_info &info, P1 &p1, P2 &p2, P3 &p3, P4 &p4, P5 &p5)
         {
-            JsValueRef nameRef;
-            runtime::translate_error_code(marshal::from_native(name, &nameRef));
-            JsValueRef ref;
-            if (function == nullptr)
+            if (!is_rest(p5) && argument_count > 6)
             {
-                runtime::translate_error_code(JsErrorNullArgument);
+                context::set_exception(error::create(L"Incorrect number of arguments."));
+                return false;
             }
-            runtime::translate_error_code(JsCreateNamedFunction(nameRef, thunk, function, &ref));
-            return decltype(create(nullptr))(ref);
-        }
-    };
 
-    template<class P1, class P2, class P3, class P4>
-    class function<void, P1, P2, P3, P4, notdefined, notdefined, notdefined, notdefined> : public function_base
-    {
-        friend class value;
+            info = call_info(value(callee), value(arguments[0]), is_construct_call);
 
-    protected:
-        explicit function<void, P1, P2, P3, P4, notdefined, notdefined, notdefined, notdefined>(JsValueRef ref) :
-            function_base(ref)
-        {
+            return argument_from_value(1, arguments, argument_count, p1) &&
+                argument_from_value(2, arguments, argument_count, p2) &&
+                argument_from_value(3, arguments, argument_count, p3) &&
+                argument_from_value(4, arguments, argument_count, p4) &&
+                argument_from_value(5, arguments, argument_count, p5);
         }
 
-    public:
-        typedef void(*Signature)(const call_info &call_info, P1 p1, P2 p2, P3 p3, P4 p4);
-
-        function<void, P1, P2, P3, P4, notdefined, notdefined, notdefined, notdefined>() :
-            function_base()
+        template <class P1, class P2, class P3, class P4>
+        static bool unpack_arguments(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, call_info &info, P1 &p1, P2 &p2, P3 &p3, P4 &p4)
         {
-        }
+            if (!is_rest(p4) && argument_count > 5)
+            {
+                context::set_exception(error::create(L"Incorrect number of arguments."));
+                return false;
+            }
 
-        explicit function<void, P1, P2, P3, P4, notdefined, notdefined, notdefined, notdefined>(value object) :
-            function_base(object)
-        {
+            info = call_info(value(callee), value(arguments[0]), is_construct_call);
+
+            return argument_from_value(1, arguments, argument_count, p1) &&
+                argument_from_value(2, arguments, argument_count, p2) &&
+                argument_from_value(3, arguments, argument_count, p3) &&
+                argument_from_value(4, arguments, argument_count, p4);
         }
 
-    protected:
-        static JsValueRef CALLBACK thunk(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, void *callback_state)
+        template <class P1, class P2, class P3>
+        static bool unpack_arguments(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, call_info &info, P1 &p1, P2 &p2, P3 &p3)
         {
-            if (is_construct_call)
+            if (!is_rest(p3) && argument_count > 4)
             {
-                context::set_exception(error::create(L"Cannot call function as a constructor."));
-                return JS_INVALID_REFERENCE;
+                context::set_exception(error::create(L"Incorrect number of arguments."));
+                return false;
             }
 
-            call_info info;
-            P1 p1;
-            P2 p2;
-            P3 p3;
-            P4 p4;
+            info = call_info(value(callee), value(arguments[0]), is_construct_call);
 
-            if (!unpack_arguments(callee, is_construct_call, arguments, argument_count, info, p1, p2, p3, p4))
-            {
-                return JS_INVALID_REFERENCE;
-            }
+            return argument_from_value(1, arguments, argument_count, p1) &&
+                argument_from_value(2, arguments, argument_count, p2) &&
+                argument_from_value(3, arguments, argument_count, p3);
+        }
 
-            Signature callback = static_cast<Signature>(callback_state);
-            try
-            {
-                callback(info, p1, p2, p3, p4);
-            }
-            catch (...)
+        template <class P1, class P2>
+        static bool unpack_arguments(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, call_info &info, P1 &p1, P2 &p2)
+        {
+            if (!is_rest(p2) && argument_count > 3)
             {
-                context::set_exception(error::create(L"Fatal error."));
-                return JS_INVALID_REFERENCE;
+                context::set_exception(error::create(L"Incorrect number of arguments."));
+                return false;
             }
 
-            return JS_INVALID_REFERENCE;
-        }
+            info = call_info(value(callee), value(arguments[0]), is_construct_call);
 
-    public:
-        void operator ()(value this_value, P1 p1, P2 p2, P3 p3, P4 p4)
-        {
-            call_function<void>(pack_arguments(this_value, p1, p2, p3, p4));
+            return argument_from_value(1, arguments, argument_count, p1) &&
+                argument_from_value(2, arguments, argument_count, p2);
         }
 
-        static function<void, P1, P2, P3, P4> create(Signature function)
+        template <class P1>
+        static bool unpack_arguments(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, call_info &info, P1 &p1)
         {
-            JsValueRef ref;
-            if (function == nullptr)
+            if (!is_rest(p1) && argument_count > 2)
             {
-                runtime::translate_error_code(JsErrorNullArgument);
+                context::set_exception(error::create(L"Incorrect number of arguments."));
+                return false;
             }
-            runtime::translate_error_code(JsCreateFunction(thunk, function, &ref));
-            return decltype(create(nullptr))(ref);
+
+            info = call_info(value(callee), value(arguments[0]), is_construct_call);
+
+            return argument_from_value(1, arguments, argument_count, p1);
         }
 
-        static function<void, P1, P2, P3, P4> create(std::wstring name, Signature function)
+        static bool unpack_arguments(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, call_info &info)
         {
-            JsValueRef nameRef;
-            runtime::translate_error_code(marshal::from_native(name, &nameRef));
-            JsValueRef ref;
-            if (function == nullptr)
+            if (argument_count > 1)
             {
-                runtime::translate_error_code(JsErrorNullArgument);
+                context::set_exception(error::create(L"Incorrect number of arguments."));
+                return false;
             }
-            runtime::translate_error_code(JsCreateNamedFunction(nameRef, thunk, function, &ref));
-            return decltype(create(nullptr))(ref);
-        }
-    };
-#pragma endregion
 
-#pragma region Arity 3
-    template<class R, class P1, class P2, class P3>
-    class function<R, P1, P2, P3, notdefined, notdefined, notdefined, notdefined, notdefined> : public constructor_function<R>
-    {
-        friend class value;
+            info = call_info(value(callee), value(arguments[0]), is_construct_call);
 
-    protected:
-        explicit function<R, P1, P2, P3, notdefined, notdefined, notdefined, notdefined, notdefined>(JsValueRef ref) :
-            constructor_function<R>(ref)
-        {
+            return true;
         }
 
-    public:
-        typedef R(*Signature)(const call_info &call_info, P1 p1, P2 p2, P3 p3);
-
-        function<R, P1, P2, P3, notdefined, notdefined, notdefined, notdefined, notdefined>() :
-            constructor_function<R>()
+        static bool unpack_arguments(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, call_info &info, std::vector<value> &value_arguments)
         {
-        }
+            value_arguments = std::vector<value>(argument_count - 1);
 
-        explicit function<R, P1, P2, P3, notdefined, notdefined, notdefined, notdefined, notdefined>(value object) :
-            constructor_function<R>(object)
-        {
+            for (int index = 0; index < argument_count - 1; index++)
+            {
+                value_arguments[index] = value(arguments[index + 1]);
+            }
+
+            info = call_info(value(callee), value(arguments[0]), is_construct_call);
+
+            return true;
         }
 
-    protected:
-        static JsValueRef CALLBACK thunk(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, void *callback_state)
+        template <class P1, class P2, class P3, class P4, class P5, class P6, class P7, class P8>
+        static std::vector<JsValueRef> pack_arguments(value this_value, P1 p1, P2 p2, P3 p3, P4 p4, P5 p5, P6 p6, P7 p7, P8 p8)
         {
-            call_info info;
-            P1 p1;
-            P2 p2;
-            P3 p3;
-
-            if (!unpack_arguments(callee, is_construct_call, arguments, argument_count, info, p1, p2, p3))
-            {
-                return JS_INVALID_REFERENCE;
-            }
+            size_t argument_count = 1 +
+                optional_argument_count(p1) +
+                optional_argument_count(p2) +
+                optional_argument_count(p3) +
+                optional_argument_count(p4) +
+                optional_argument_count(p5) +
+                optional_argument_count(p6) +
+                optional_argument_count(p7) +
+                optional_argument_count(p8);
+            std::vector<JsValueRef> arguments(argument_count);
 
-            Signature callback = static_cast<Signature>(callback_state);
-            R result;
-            try
+            if (this_value.is_valid())
             {
-                result = callback(info, p1, p2, p3);
+                arguments[0] = this_value.handle();
             }
-            catch (...)
+            else
             {
-                context::set_exception(error::create(L"Fatal error."));
-                return JS_INVALID_REFERENCE;
+                // TODO: Why do we have to do this?
+                runtime::translate_error_code(JsGetUndefinedValue(&arguments[0]));
             }
 
-            JsValueRef resultValue;
-            if (marshal::from_native(result, &resultValue) != JsNoError)
+            switch (argument_count)
             {
-                context::set_exception(error::create_type_error(L"Could not convert value."));
-                return JS_INVALID_REFERENCE;
+            default:
+                fill_rest(p8, 8, arguments);
+                // fall through
+            case 8:
+                runtime::translate_error_code(marshal::from_native(p7, &arguments[7]));
+                // fall through
+            case 7:
+                runtime::translate_error_code(marshal::from_native(p6, &arguments[6]));
+                // fall through
+            case 6:
+                runtime::translate_error_code(marshal::from_native(p5, &arguments[5]));
+                // fall through
+            case 5:
+                runtime::translate_error_code(marshal::from_native(p4, &arguments[4]));
+                // fall through
+            case 4:
+                runtime::translate_error_code(marshal::from_native(p3, &arguments[3]));
+                // fall through
+            case 3:
+                runtime::translate_error_code(marshal::from_native(p2, &arguments[2]));
+                // fall through
+            case 2:
+                runtime::translate_error_code(marshal::from_native(p1, &arguments[1]));
+                // fall through
+            case 1:
+                // Nothing to do
+                break;
             }
 
-            return resultValue;
-        }
-
-    public:
-        R operator ()(value this_value, P1 p1, P2 p2, P3 p3)
-        {
-            return call_function<R>(pack_arguments(this_value, p1, p2, p3));
+            return arguments;
         }
 
-        R construct(P1 p1, P2 p2, P3 p3)
+        template <class P1, class P2, class P3, class P4, class P5, class P6, class P7>
+        static std::vector<JsValueRef> pack_arguments(value this_value, P1 p1, P2 p2, P3 p3, P4 p4, P5 p5, P6 p6, P7 p7)
         {
-            return construct_object(pack_arguments(context::undefined(), p1, p2, p3));
-        }
+            size_t argument_count = 1 +
+                optional_argument_count(p1) +
+                optional_argument_count(p2) +
+                optional_argument_count(p3) +
+                optional_argument_count(p4) +
+                optional_argument_count(p5) +
+                optional_argument_count(p6) +
+                optional_argument_count(p7);
+            std::vector<JsValueRef> arguments(argument_count);
 
-        static function<R, P1, P2, P3> create(Signature function)
-        {
-            JsValueRef ref;
-            if (function == nullptr)
+            if (this_value.is_valid())
             {
-                runtime::translate_error_code(JsErrorNullArgument);
+                arguments[0] = this_value.handle();
             }
-            runtime::translate_error_code(JsCreateFunction(thunk, function, &ref));
-            return decltype(create(nullptr))(ref);
-        }
-
-        static function<R, P1, P2, P3> create(std::wstring name, Signature function)
-        {
-            JsValueRef nameRef;
-            runtime::translate_error_code(marshal::from_native(name, &nameRef));
-            JsValueRef ref;
-            if (function == nullptr)
+            else
             {
-                runtime::translate_error_code(JsErrorNullArgument);
+                // TODO: Why do we have to do this?
+                runtime::translate_error_code(JsGetUndefinedValue(&arguments[0]));
             }
-            runtime::translate_error_code(JsCreateNamedFunction(nameRef, thunk, function, &ref));
-            return decltype(create(nullptr))(ref);
-        }
-    };
-
-    template<class P1, class P2, class P3>
-    class function<void, P1, P2, P3, notdefined, notdefined, notdefined, notdefined, notdefined> : public function_base
-    {
-        friend class value;
-
-    protected:
-        explicit function<void, P1, P2, P3, notdefined, notdefined, notdefined, notdefined, notdefined>(JsValueRef ref) :
-            function_base(ref)
-        {
-        }
 
-    public:
-        typedef void(*Signature)(const call_info &call_info, P1 p1, P2 p2, P3 p3);
+            switch (argument_count)
+            {
+            default:
+                fill_rest(p7, 7, arguments);
+                // fall through
+            case 7:
+                runtime::translate_error_code(marshal::from_native(p6, &arguments[6]));
+                // fall through
+            case 6:
+                runtime::translate_error_code(marshal::from_native(p5, &arguments[5]));
+                // fall through
+            case 5:
+                runtime::translate_error_code(marshal::from_native(p4, &arguments[4]));
+                // fall through
+            case 4:
+                runtime::translate_error_code(marshal::from_native(p3, &arguments[3]));
+                // fall through
+            case 3:
+                runtime::translate_error_code(marshal::from_native(p2, &arguments[2]));
+                // fall through
+            case 2:
+                runtime::translate_error_code(marshal::from_native(p1, &arguments[1]));
+                // fall through
+            case 1:
+                // Nothing to do
+                break;
+            }
 
-        function<void, P1, P2, P3, notdefined, notdefined, notdefined, notdefined, notdefined>() :
-            function_base()
-        {
+            return arguments;
         }
 
-        explicit function<void, P1, P2, P3, notdefined, notdefined, notdefined, notdefined, notdefined>(value object) :
-            function_base(object)
+        template <class P1, class P2, class P3, class P4, class P5, class P6>
+        static std::vector<JsValueRef> pack_arguments(value this_value, P1 p1, P2 p2, P3 p3, P4 p4, P5 p5, P6 p6)
         {
-        }
+            size_t argument_count = 1 +
+                optional_argument_count(p1) +
+                optional_argument_count(p2) +
+                optional_argument_count(p3) +
+                optional_argument_count(p4) +
+                optional_argument_count(p5) +
+                optional_argument_count(p6);
+            std::vector<JsValueRef> arguments(argument_count);
 
-    protected:
-        static JsValueRef CALLBACK thunk(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, void *callback_state)
-        {
-            if (is_construct_call)
+            if (this_value.is_valid())
             {
-                context::set_exception(error::create(L"Cannot call function as a constructor."));
-                return JS_INVALID_REFERENCE;
+                arguments[0] = this_value.handle();
             }
-
-            call_info info;
-            P1 p1;
-            P2 p2;
-            P3 p3;
-
-            if (!unpack_arguments(callee, is_construct_call, arguments, argument_count, info, p1, p2, p3))
+            else
             {
-                return JS_INVALID_REFERENCE;
+                // TODO: Why do we have to do this?
+                runtime::translate_error_code(JsGetUndefinedValue(&arguments[0]));
             }
 
-            Signature callback = static_cast<Signature>(callback_state);
-            try
-            {
-                callback(info, p1, p2, p3);
-            }
-            catch (...)
+            switch (argument_count)
             {
-                context::set_exception(error::create(L"Fatal error."));
-                return JS_INVALID_REFERENCE;
+            default:
+                fill_rest(p6, 6, arguments);
+                // fall through
+            case 6:
+                runtime::translate_error_code(marshal::from_native(p5, &arguments[5]));
+                // fall through
+            case 5:
+                runtime::translate_error_code(marshal::from_native(p4, &arguments[4]));
+                // fall through
+            case 4:
+                runtime::translate_error_code(marshal::from_native(p3, &arguments[3]));
+                // fall through
+            case 3:
+                runtime::translate_error_code(marshal::from_native(p2, &arguments[2]));
+                // fall through
+            case 2:
+                runtime::translate_error_code(marshal::from_native(p1, &arguments[1]));
+                // fall through
+            case 1:
+                // Nothing to do
+                break;
             }
 
-            return JS_INVALID_REFERENCE;
+            return arguments;
         }
 
-    public:
-        void operator ()(value this_value, P1 p1, P2 p2, P3 p3)
+        template <class P1, class P2, class P3, class P4, class P5>
+        static std::vector<JsValueRef> pack_arguments(value this_value, P1 p1, P2 p2, P3 p3, P4 p4, P5 p5)
         {
-            call_function<void>(pack_arguments(this_value, p1, p2, p3));
-        }
+            size_t argument_count = 1 +
+                optional_argument_count(p1) +
+                optional_argument_count(p2) +
+                optional_argument_count(p3) +
+                optional_argument_count(p4) +
+                optional_argument_count(p5);
+            std::vector<JsValueRef> arguments(argument_count);
 
-        static function<void, P1, P2, P3> create(Signature function)
-        {
-            JsValueRef ref;
-            if (function == nullptr)
+            if (this_value.is_valid())
             {
-                runtime::translate_error_code(JsErrorNullArgument);
+                arguments[0] = this_value.handle();
             }
-            runtime::translate_error_code(JsCreateFunction(thunk, function, &ref));
-            return decltype(create(nullptr))(ref);
-        }
-
-        static function<void, P1, P2, P3> create(std::wstring name, Signature function)
-        {
-            JsValueRef nameRef;
-            runtime::translate_error_code(marshal::from_native(name, &nameRef));
-            JsValueRef ref;
-            if (function == nullptr)
+            else
             {
-                runtime::translate_error_code(JsErrorNullArgument);
+                // TODO: Why do we have to do this?
+                runtime::translate_error_code(JsGetUndefinedValue(&arguments[0]));
             }
-            runtime::translate_error_code(JsCreateNamedFunction(nameRef, thunk, function, &ref));
-            return decltype(create(nullptr))(ref);
-        }
-    };
-#pragma endregion
-
-#pragma region Arity 2
-    template<class R, class P1, class P2>
-    class function<R, P1, P2, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined> : public constructor_function<R>
-    {
-        friend class value;
-
-    protected:
-        explicit function<R, P1, P2, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined>(JsValueRef ref) :
-            constructor_function<R>(ref)
-        {
-        }
 
-    public:
-        typedef R(*Signature)(const call_info &call_info, P1 p1, P2 p2);
-
-        function<R, P1, P2, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined>() :
-            constructor_function<R>()
-        {
-        }
+            switch (argument_count)
+            {
+            default:
+                fill_rest(p5, 5, arguments);
+                // fall through
+            case 5:
+                runtime::translate_error_code(marshal::from_native(p4, &arguments[4]));
+                // fall through
+            case 4:
+                runtime::translate_error_code(marshal::from_native(p3, &arguments[3]));
+                // fall through
+            case 3:
+                runtime::translate_error_code(marshal::from_native(p2, &arguments[2]));
+                // fall through
+            case 2:
+                runtime::translate_error_code(marshal::from_native(p1, &arguments[1]));
+                // fall through
+            case 1:
+                // Nothing to do
+                break;
+            }
 
-        explicit function<R, P1, P2, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined>(value object) :
-            constructor_function<R>(object)
-        {
+            return arguments;
         }
 
-    protected:
-        static JsValueRef CALLBACK thunk(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, void *callback_state)
+        template <class P1, class P2, class P3, class P4>
+        static std::vector<JsValueRef> pack_arguments(value this_value, P1 p1, P2 p2, P3 p3, P4 p4)
         {
-            call_info info;
-            P1 p1;
-            P2 p2;
-
-            if (!unpack_arguments(callee, is_construct_call, arguments, argument_count, info, p1, p2))
-            {
-                return JS_INVALID_REFERENCE;
-            }
+            size_t argument_count = 1 +
+                optional_argument_count(p1) +
+                optional_argument_count(p2) +
+                optional_argument_count(p3) +
+                optional_argument_count(p4);
+            std::vector<JsValueRef> arguments(argument_count);
 
-            Signature callback = static_cast<Signature>(callback_state);
-            R result;
-            try
+            if (this_value.is_valid())
             {
-                result = callback(info, p1, p2);
+                arguments[0] = this_value.handle();
             }
-            catch (...)
+            else
             {
-                context::set_exception(error::create(L"Fatal error."));
-                return JS_INVALID_REFERENCE;
+                // TODO: Why do we have to do this?
+                runtime::translate_error_code(JsGetUndefinedValue(&arguments[0]));
             }
 
-            JsValueRef resultValue;
-            if (marshal::from_native(result, &resultValue) != JsNoError)
+            switch (argument_count)
             {
-                context::set_exception(error::create_type_error(L"Could not convert value."));
-                return JS_INVALID_REFERENCE;
+            default:
+                fill_rest(p4, 4, arguments);
+                // fall through
+            case 4:
+                runtime::translate_error_code(marshal::from_native(p3, &arguments[3]));
+                // fall through
+            case 3:
+                runtime::translate_error_code(marshal::from_native(p2, &arguments[2]));
+                // fall through
+            case 2:
+                runtime::translate_error_code(marshal::from_native(p1, &arguments[1]));
+                // fall through
+            case 1:
+                // Nothing to do
+                break;
             }
 
-            return resultValue;
+            return arguments;
         }
 
-    public:
-        R operator ()(value this_value, P1 p1, P2 p2)
+        template <class P1, class P2, class P3>
+        static std::vector<JsValueRef> pack_arguments(value this_value, P1 p1, P2 p2, P3 p3)
         {
-            return call_function<R>(pack_arguments(this_value, p1, p2));
-        }
+            size_t argument_count = 1 +
+                optional_argument_count(p1) +
+                optional_argument_count(p2) +
+                optional_argument_count(p3);
+            std::vector<JsValueRef> arguments(argument_count);
 
-        R construct(P1 p1, P2 p2)
-        {
-            return construct_object(pack_arguments(context::undefined(), p1, p2));
-        }
-
-        static function<R, P1, P2> create(Signature function)
-        {
-            JsValueRef ref;
-            if (function == nullptr)
+            if (this_value.is_valid())
             {
-                runtime::translate_error_code(JsErrorNullArgument);
+                arguments[0] = this_value.handle();
             }
-            runtime::translate_error_code(JsCreateFunction(thunk, function, &ref));
-            return decltype(create(nullptr))(ref);
-        }
-
-        static function<R, P1, P2> create(std::wstring name, Signature function)
-        {
-            JsValueRef nameRef;
-            runtime::translate_error_code(marshal::from_native(name, &nameRef));
-            JsValueRef ref;
-            if (function == nullptr)
+            else
             {
-                runtime::translate_error_code(JsErrorNullArgument);
+                // TODO: Why do we have to do this?
+                runtime::translate_error_code(JsGetUndefinedValue(&arguments[0]));
             }
-            runtime::translate_error_code(JsCreateNamedFunction(nameRef, thunk, function, &ref));
-            return decltype(create(nullptr))(ref);
-        }
-    };
 
-    template<class P1, class P2>
-    class function<void, P1, P2, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined> : public function_base
-    {
-        friend class value;
+            switch (argument_count)
+            {
+            default:
+                fill_rest(p3, 3, arguments);
+                // fall through
+            case 3:
+                runtime::translate_error_code(marshal::from_native(p2, &arguments[2]));
+                // fall through
+            case 2:
+                runtime::translate_error_code(marshal::from_native(p1, &arguments[1]));
+                // fall through
+            case 1:
+                // Nothing to do
+                break;
+            }
 
-    protected:
-        explicit function<void, P1, P2, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined>(JsValueRef ref) :
-            function_base(ref)
-        {
+            return arguments;
         }
 
-    public:
-        typedef void(*Signature)(const call_info &call_info, P1 p1, P2 p2);
-
-        function<void, P1, P2, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined>() :
-            function_base()
+        template <class P1, class P2>
+        static std::vector<JsValueRef> pack_arguments(value this_value, P1 p1, P2 p2)
         {
-        }
+            size_t argument_count = 1 +
+                optional_argument_count(p1) +
+                optional_argument_count(p2);
+            std::vector<JsValueRef> arguments(argument_count);
 
-        explicit function<void, P1, P2, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined>(value object) :
-            function_base(object)
-        {
-        }
+            if (this_value.is_valid())
+            {
+                arguments[0] = this_value.handle();
+            }
+            else
+            {
+                // TODO: Why do we have to do this?
+                runtime::translate_error_code(JsGetUndefinedValue(&arguments[0]));
+            }
 
-    protected:
-        static JsValueRef CALLBACK thunk(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, void *callback_state)
-        {
-            if (is_construct_call)
+            switch (argument_count)
             {
-                context::set_exception(error::create(L"Cannot call function as a constructor."));
-                return JS_INVALID_REFERENCE;
+            default:
+                fill_rest(p2, 2, arguments);
+                // fall through
+            case 2:
+                runtime::translate_error_code(marshal::from_native(p1, &arguments[1]));
+                // fall through
+            case 1:
+                // Nothing to do
+                break;
             }
 
-            call_info info;
-            P1 p1;
-            P2 p2;
+            return arguments;
+        }
 
-            if (!unpack_arguments(callee, is_construct_call, arguments, argument_count, info, p1, p2))
+        template <class P1>
+        static std::vector<JsValueRef> pack_arguments(value this_value, P1 p1)
+        {
+            size_t argument_count = 1 +
+                optional_argument_count(p1);
+            std::vector<JsValueRef> arguments(argument_count);
+
+            if (this_value.is_valid())
             {
-                return JS_INVALID_REFERENCE;
+                arguments[0] = this_value.handle();
             }
-
-            Signature callback = static_cast<Signature>(callback_state);
-            try
+            else
             {
-                callback(info, p1, p2);
+                // TODO: Why do we have to do this?
+                runtime::translate_error_code(JsGetUndefinedValue(&arguments[0]));
             }
-            catch (...)
+
+            switch (argument_count)
             {
-                context::set_exception(error::create(L"Fatal error."));
-                return JS_INVALID_REFERENCE;
+            default:
+                fill_rest(p1, 1, arguments);
+                // fall through
+            case 1:
+                // Nothing to do
+                break;
             }
 
-            return JS_INVALID_REFERENCE;
+            return arguments;
         }
 
-    public:
-        void operator ()(value this_value, P1 p1, P2 p2)
+        static std::vector<JsValueRef> pack_arguments(value this_value)
         {
-            call_function<void>(pack_arguments(this_value, p1, p2));
-        }
+            std::vector<JsValueRef> arguments(1);
 
-        static function<void, P1, P2> create(Signature function)
-        {
-            JsValueRef ref;
-            if (function == nullptr)
+            if (this_value.is_valid())
             {
-                runtime::translate_error_code(JsErrorNullArgument);
+                arguments[0] = this_value.handle();
             }
-            runtime::translate_error_code(JsCreateFunction(thunk, function, &ref));
-            return decltype(create(nullptr))(ref);
+            else
+            {
+                // TODO: Why do we have to do this?
+                runtime::translate_error_code(JsGetUndefinedValue(&arguments[0]));
+            }
+
+            return arguments;
         }
 
-        static function<void, P1, P2> create(std::wstring name, Signature function)
+        static std::vector<JsValueRef> pack_arguments(value this_value, std::initializer_list<value> arguments)
         {
-            JsValueRef nameRef;
-            runtime::translate_error_code(marshal::from_native(name, &nameRef));
-            JsValueRef ref;
-            if (function == nullptr)
+            std::vector<JsValueRef> call_args(arguments.size() + 1);
+            call_args[0] = this_value.handle();
+            unsigned int index = 1;
+            for (const value argument : arguments)
             {
-                runtime::translate_error_code(JsErrorNullArgument);
+                call_args[index++] = argument.handle();
             }
-            runtime::translate_error_code(JsCreateNamedFunction(nameRef, thunk, function, &ref));
-            return decltype(create(nullptr))(ref);
-        }
-    };
-#pragma endregion
-
-#pragma region Arity 1
-    template<class R, class P1>
-    class function<R, P1, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined> : public constructor_function<R>
-    {
-        friend class value;
 
-    protected:
-        explicit function<R, P1, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined>(JsValueRef ref) :
-            constructor_function<R>(ref)
-        {
+            return call_args;
         }
 
-    public:
-        typedef R(*Signature)(const call_info &call_info, P1 p1);
-
-        function<R, P1, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined>() :
-            constructor_function<R>()
+        template <class R>
+        R call_function(std::vector<JsValueRef> arguments)
         {
+            JsValueRef resultValue;
+            runtime::translate_error_code(JsCallFunction(handle(), arguments.data(), static_cast<unsigned short>(arguments.size()), &resultValue));
+
+            R result;
+            runtime::translate_error_code(marshal::to_native(resultValue, &result));
+            return result;
         }
 
-        explicit function<R, P1, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined>(value object) :
-            constructor_function<R>(object)
+        explicit function_base(JsValueRef ref) :
+            object(ref)
         {
         }
 
+    public:
+        /// <summary>
+        ///     The signature of a function callback.
+        /// </summary>
+        /// <param name="call_info">Information about the call.</param>
+        /// <param name="arguments">Arguments to the call.</param>
+        /// <returns>The result of the call.</returns>
+        typedef value(*Signature)(const call_info &call_info, const std::vector<value> &arguments);
+
     protected:
         static JsValueRef CALLBACK thunk(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, void *callback_state)
         {
+            std::vector<value> argument_vector;
             call_info info;
-            P1 p1;
 
-            if (!unpack_arguments(callee, is_construct_call, arguments, argument_count, info, p1))
+            if (!unpack_arguments(callee, is_construct_call, arguments, argument_count, info, argument_vector))
             {
                 return JS_INVALID_REFERENCE;
             }
 
             Signature callback = static_cast<Signature>(callback_state);
-            R result;
+            value result;
             try
             {
-                result = callback(info, p1);
+                result = callback(info, argument_vector);
             }
             catch (...)
             {
@@ -5594,199 +6190,362 @@ namespace jsrt
         }
 
     public:
-        R operator ()(value this_value, P1 p1)
+        /// <summary>
+        ///     Creates an invalid handle to a function.
+        /// </summary>
+        function_base() :
+            object()
         {
-            return call_function<R>(pack_arguments(this_value, p1));
         }
 
-        R construct(P1 p1)
+        /// <summary>
+        ///     Converts the <c>value</c> handle to a <c>function</c> handle.
+        /// </summary>
+        /// <remarks>
+        ///     The type of the underlying value is not checked.
+        /// </remarks>
+        explicit function_base(value object) :
+            object(object.handle())
         {
-            return construct_object(pack_arguments(context::undefined(), p1));
         }
 
-        static function<R, P1> create(Signature function)
+        /// <summary>
+        ///     Calls the JavaScript function.
+        /// </summary>
+        /// <remarks>
+        ///     Requires an active script context.
+        /// </remarks>
+        /// <param name="this_value">The value of <c>this</c> for the call.</param>
+        /// <param name="arguments">Arguments to the call.</param>
+        /// <returns>The result of the call.</returns>
+        value operator()(value this_value, std::initializer_list<value> arguments) const
         {
-            JsValueRef ref;
-            if (function == nullptr)
-            {
-                runtime::translate_error_code(JsErrorNullArgument);
-            }
-            runtime::translate_error_code(JsCreateFunction(thunk, function, &ref));
-            return decltype(create(nullptr))(ref);
+            std::vector<JsValueRef> call_arguments = pack_arguments(this_value, arguments);
+
+            JsValueRef resultValue;
+            runtime::translate_error_code(JsCallFunction(handle(), static_cast<JsValueRef *>(call_arguments.data()), static_cast<unsigned short>(call_arguments.size()), &resultValue));
+            return value(resultValue);
         }
 
-        static function<R, P1> create(std::wstring name, Signature function)
-        {
+        /// <summary>
+        ///     Constructs a JavaScript object.
+        /// </summary>
+        /// <remarks>
+        ///     Requires an active script context.
+        /// </remarks>
+        /// <param name="arguments">Arguments to the constructor call.</param>
+        /// <returns>The result of the constructor call.</returns>
+        value construct(std::initializer_list<value> arguments) const
+        {
+            std::vector<JsValueRef> call_arguments = pack_arguments(context::undefined(), arguments);
+
+            JsValueRef resultValue;
+            runtime::translate_error_code(JsConstructObject(handle(), static_cast<JsValueRef *>(call_arguments.data()), static_cast<unsigned short>(call_arguments.size()), &resultValue));
+            return value(resultValue);
+        }
+
+        /// <summary>
+        ///     Creates a new JavaScript function.
+        /// </summary>
+        /// <remarks>
+        ///     Requires an active script context.
+        /// </remarks>
+        /// <param name="signature">The method to call when the function is invoked.</param>
+        /// <returns>The new function object.</returns>
+        static function_base create(Signature signature)
+        {
+            JsValueRef ref;
+            if (signature == nullptr)
+            {
+                runtime::translate_error_code(JsErrorNullArgument);
+            }
+            runtime::translate_error_code(JsCreateFunction(thunk, signature, &ref));
+            return function_base(ref);
+        }
+
+        /// <summary>
+        ///     Creates a new JavaScript function.
+        /// </summary>
+        /// <remarks>
+        ///     Requires an active script context.
+        /// </remarks>
+        /// <param name="name">The name of the method for debugging/stringification purposes.</param>
+        /// <param name="signature">The method to call when the function is invoked.</param>
+        /// <returns>The new function object.</returns>
+        static function_base create(std::wstring name, Signature signature)
+        {
             JsValueRef nameRef;
             runtime::translate_error_code(marshal::from_native(name, &nameRef));
             JsValueRef ref;
-            if (function == nullptr)
+            if (signature == nullptr)
             {
                 runtime::translate_error_code(JsErrorNullArgument);
             }
-            runtime::translate_error_code(JsCreateNamedFunction(nameRef, thunk, function, &ref));
-            return decltype(create(nullptr))(ref);
+            runtime::translate_error_code(JsCreateNamedFunction(nameRef, thunk, signature, &ref));
+            return function_base(ref);
+        }
+
+        /// <summary>
+        ///     Creates a new JavaScript function.
+        /// </summary>
+        /// <remarks>
+        ///     Requires an active script context.
+        /// </remarks>
+        /// <param name="signature">The method to call when the function is invoked.</param>
+        /// <returns>The new function object.</returns>
+        template<class R, class... Parameters>
+        static function<R, Parameters...> create(R(*signature)(const jsrt::call_info &info, Parameters...))
+        {
+            return function<R, Parameters...>::create(signature);
+        }
+
+        /// <summary>
+        ///     Creates a new JavaScript function.
+        /// </summary>
+        /// <remarks>
+        ///     Requires an active script context.
+        /// </remarks>
+        /// <param name="name">The name of the method for debugging/stringification purposes.</param>
+        /// <param name="signature">The method to call when the function is invoked.</param>
+        /// <returns>The new function object.</returns>
+        template<class R, class... Parameters>
+        static function<R, Parameters...> create(std::wstring name, R(*signature)(const jsrt::call_info &info, Parameters...))
+        {
+            return function<R, Parameters...>::create(name, signature);
         }
     };
 
-    template<class P1>
-    class function<void, P1, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined> : public function_base
+	template <>
+	inline void function_base::call_function(std::vector<JsValueRef> arguments)
+	{
+		JsValueRef resultValue;
+		runtime::translate_error_code(JsCallFunction(handle(), arguments.data(), static_cast<unsigned short>(arguments.size()), &resultValue));
+	}
+
+	/// <summary>
+    ///     A reference to a JavaScript function that creates an object.
+    /// </summary>
+    template<class R>
+    class constructor_function : public function_base
     {
         friend class value;
 
     protected:
-        explicit function<void, P1, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined>(JsValueRef ref) :
-            function_base(ref)
+        constructor_function() :
+            function_base()
         {
         }
 
-    public:
-        typedef void(*Signature)(const call_info &call_info, P1 p1);
-
-        function<void, P1, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined>() :
-            function_base()
+        explicit constructor_function(JsValueRef ref) :
+            function_base(ref)
         {
         }
 
-        explicit function<void, P1, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined>(value object) :
+        explicit constructor_function(value object) :
             function_base(object)
         {
         }
 
-    protected:
-        static JsValueRef CALLBACK thunk(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, void *callback_state)
+        R construct_object(std::vector<JsValueRef> &arguments)
         {
-            if (is_construct_call)
-            {
-                context::set_exception(error::create(L"Cannot call function as a constructor."));
-                return JS_INVALID_REFERENCE;
-            }
-
-            call_info info;
-            P1 p1;
-
-            if (!unpack_arguments(callee, is_construct_call, arguments, argument_count, info, p1))
-            {
-                return JS_INVALID_REFERENCE;
-            }
-
-            Signature callback = static_cast<Signature>(callback_state);
-            try
-            {
-                callback(info, p1);
-            }
-            catch (...)
-            {
-                context::set_exception(error::create(L"Fatal error."));
-                return JS_INVALID_REFERENCE;
-            }
+            JsValueRef resultValue;
+            runtime::translate_error_code(JsConstructObject(handle(), arguments.data(), static_cast<unsigned short>(arguments.size()), &resultValue));
 
-            return JS_INVALID_REFERENCE;
+            R result;
+            runtime::translate_error_code(marshal::to_native(resultValue, &result));
+            return result;
         }
 
     public:
-        void operator ()(value this_value, P1 p1)
-        {
-            call_function<void>(pack_arguments(this_value, p1));
-        }
-
-        static function<void, P1> create(Signature function)
+        /// <summary>
+        ///     The object that will be the prototype of objects created by this function.
+        /// </summary>
+	    object constructor_prototype()
         {
-            JsValueRef ref;
-            if (function == nullptr)
-            {
-                runtime::translate_error_code(JsErrorNullArgument);
-            }
-            runtime::translate_error_code(JsCreateFunction(thunk, function, &ref));
-            return decltype(create(nullptr))(ref);
+            return get_property<object>(property_id::create(L"prototype"));
         }
 
-        static function<void, P1> create(std::wstring name, Signature function)
+        /// <summary>
+        ///     Sets the object that will be the prototype of objects created by this function.
+        /// </summary>
+        /// <param name="prototype">The prototype object.</param>
+        void set_constructor_prototype(object prototype)
         {
-            JsValueRef nameRef;
-            runtime::translate_error_code(marshal::from_native(name, &nameRef));
-            JsValueRef ref;
-            if (function == nullptr)
-            {
-                runtime::translate_error_code(JsErrorNullArgument);
-            }
-            runtime::translate_error_code(JsCreateNamedFunction(nameRef, thunk, function, &ref));
-            return decltype(create(nullptr))(ref);
+            return set_property<object>(property_id::create(L"prototype"), prototype);
         }
     };
-#pragma endregion
 
-#pragma region Arity 0
-    template<class R>
-    class function<R, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined> : public constructor_function<R>
+    // An instantiation of constructor_function that disallows constructing non-object values.
+    template<>
+    class constructor_function<value> : public function_base
     {
         friend class value;
 
     protected:
-        explicit function<R, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined>(JsValueRef ref) :
-            constructor_function<R>(ref)
+        constructor_function() :
+            function_base()
         {
         }
 
-    public:
-        typedef R(*Signature)(const call_info &call_info);
-
-        function<R, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined>() :
-            constructor_function<R>()
+        explicit constructor_function(JsValueRef ref) :
+            function_base(ref)
         {
         }
 
-        explicit function<R, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined>(value object) :
-            constructor_function<R>(object)
+        explicit constructor_function(value object) :
+            function_base(object)
         {
         }
+    };
+
+    // An instantiation of constructor_function that disallows constructing non-object values.
+    template<>
+    class constructor_function<std::wstring> : public function_base
+    {
+        friend class value;
 
     protected:
-        static JsValueRef CALLBACK thunk(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, void *callback_state)
+        constructor_function() :
+            function_base()
         {
-            call_info info;
-
-            if (!unpack_arguments(callee, is_construct_call, arguments, argument_count, info))
-            {
-                return JS_INVALID_REFERENCE;
-            }
-
-            Signature callback = static_cast<Signature>(callback_state);
-            R result;
-            try
-            {
-                result = callback(info);
-            }
-            catch (...)
-            {
-                context::set_exception(error::create(L"Fatal error."));
-                return JS_INVALID_REFERENCE;
-            }
-
-            JsValueRef resultValue;
-            if (marshal::from_native(result, &resultValue) != JsNoError)
-            {
-                context::set_exception(error::create_type_error(L"Could not convert value."));
-                return JS_INVALID_REFERENCE;
-            }
-
-            return resultValue;
         }
 
-    public:
-        R operator ()(value this_value)
+        explicit constructor_function(JsValueRef ref) :
+            function_base(ref)
         {
-            return call_function<R>(pack_arguments(this_value));
         }
 
-        R construct()
+        explicit constructor_function(value object) :
+            function_base(object)
         {
-            return construct_object(pack_arguments(context::undefined()));
         }
+    };
 
-        static function<R> create(Signature function)
+    // An instantiation of constructor_function that disallows constructing non-object values.
+    template<>
+    class constructor_function<double> : public function_base
+    {
+        friend class value;
+
+    protected:
+        constructor_function() :
+            function_base()
         {
-            JsValueRef ref;
+        }
+
+        explicit constructor_function(JsValueRef ref) :
+            function_base(ref)
+        {
+        }
+
+        explicit constructor_function(value object) :
+            function_base(object)
+        {
+        }
+    };
+
+    // An instantiation of constructor_function that disallows constructing non-object values.
+    template<>
+    class constructor_function<bool> : public function_base
+    {
+        friend class value;
+
+    protected:
+        constructor_function() :
+            function_base()
+        {
+        }
+
+        explicit constructor_function(JsValueRef ref) :
+            function_base(ref)
+        {
+        }
+
+        explicit constructor_function(value object) :
+            function_base(object)
+        {
+        }
+    };
+
+#pragma region Arity 8
+    template<class R, class P1, class P2, class P3, class P4, class P5, class P6, class P7, class P8>
+    class function : public constructor_function<R>
+    {
+        friend class value;
+
+    protected:
+        explicit function<R, P1, P2, P3, P4, P5, P6, P7, P8>(JsValueRef ref) :
+            constructor_function<R>(ref)
+        {
+        }
+
+    public:
+        typedef R(*Signature)(const call_info &call_info, P1 p1, P2 p2, P3 p3, P4 p4, P5 p5, P6 p6, P7 p7, P8 p8);
+
+        function<R, P1, P2, P3, P4, P5, P6, P7, P8>() :
+            constructor_function<R>()
+        {
+        }
+
+        explicit function<R, P1, P2, P3, P4, P5, P6, P7, P8>(value object) :
+            constructor_function<R>(object)
+        {
+        }
+
+    protected:
+        static JsValueRef CALLBACK thunk(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, void *callback_state)
+        {
+            call_info info;
+            P1 p1;
+            P2 p2;
+            P3 p3;
+            P4 p4;
+            P5 p5;
+            P6 p6;
+            P7 p7;
+            P8 p8;
+
+            if (!unpack_arguments(callee, is_construct_call, arguments, argument_count, info, p1, p2, p3, p4, p5, p6, p7, p8))
+            {
+                return JS_INVALID_REFERENCE;
+            }
+
+            Signature callback = static_cast<Signature>(callback_state);
+            R result;
+            try
+            {
+                result = callback(info, p1, p2, p3, p4, p5, p6, p7, p8);
+            }
+            catch (...)
+            {
+                context::set_exception(error::create(L"Fatal error."));
+                return JS_INVALID_REFERENCE;
+            }
+
+            JsValueRef resultValue;
+            if (marshal::from_native(result, &resultValue) != JsNoError)
+            {
+                context::set_exception(error::create_type_error(L"Could not convert value."));
+                return JS_INVALID_REFERENCE;
+            }
+
+            return resultValue;
+        }
+
+    public:
+        R operator ()(value this_value, P1 p1, P2 p2, P3 p3, P4 p4, P5 p5, P6 p6, P7 p7, P8 p8)
+        {
+            return call_function<R>(pack_arguments(this_value, p1, p2, p3, p4, p5, p6, p7, p8));
+        }
+
+        R construct(P1 p1, P2 p2, P3 p3, P4 p4, P5 p5, P6 p6, P7 p7, P8 p8)
+        {
+            return construct_object(pack_arguments(context::undefined(), p1, p2, p3, p4, p5, p6, p7, p8));
+        }
+
+        static function<R, P1, P2, P3, P4, P5, P6, P7, P8> create(Signature function)
+        {
+            JsValueRef ref;
             if (function == nullptr)
             {
                 runtime::translate_error_code(JsErrorNullArgument);
@@ -5795,7 +6554,7 @@ namespace jsrt
             return decltype(create(nullptr))(ref);
         }
 
-        static function<R> create(std::wstring name, Signature function)
+        static function<R, P1, P2, P3, P4, P5, P6, P7, P8> create(std::wstring name, Signature function)
         {
             JsValueRef nameRef;
             runtime::translate_error_code(marshal::from_native(name, &nameRef));
@@ -5809,27 +6568,26 @@ namespace jsrt
         }
     };
 
-    template<>
-    class function<void, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined> : public function_base
+    template<class P1, class P2, class P3, class P4, class P5, class P6, class P7, class P8>
+    class function<void, P1, P2, P3, P4, P5, P6, P7, P8> : public function_base
     {
         friend class value;
-        friend class context;
 
     protected:
-        explicit function<void, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined>(JsValueRef ref) :
+        explicit function<void, P1, P2, P3, P4, P5, P6, P7, P8>(JsValueRef ref) :
             function_base(ref)
         {
         }
 
     public:
-        typedef void(*Signature)(const call_info &call_info);
+        typedef void(*Signature)(const call_info &call_info, P1 p1, P2 p2, P3 p3, P4 p4, P5 p5, P6 p6, P7 p7, P8 p8);
 
-        function<void, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined>() :
+        function<void, P1, P2, P3, P4, P5, P6, P7, P8>() :
             function_base()
         {
         }
 
-        explicit function<void, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined>(value object) :
+        explicit function<void, P1, P2, P3, P4, P5, P6, P7, P8>(value object) :
             function_base(object)
         {
         }
@@ -5844,8 +6602,16 @@ namespace jsrt
             }
 
             call_info info;
+            P1 p1;
+            P2 p2;
+            P3 p3;
+            P4 p4;
+            P5 p5;
+            P6 p6;
+            P7 p7;
+            P8 p8;
 
-            if (!unpack_arguments(callee, is_construct_call, arguments, argument_count, info))
+            if (!unpack_arguments(callee, is_construct_call, arguments, argument_count, info, p1, p2, p3, p4, p5, p6, p7, p8))
             {
                 return JS_INVALID_REFERENCE;
             }
@@ -5853,7 +6619,7 @@ namespace jsrt
             Signature callback = static_cast<Signature>(callback_state);
             try
             {
-                callback(info);
+                callback(info, p1, p2, p3, p4, p5, p6, p7, p8);
             }
             catch (...)
             {
@@ -5865,655 +6631,6754 @@ namespace jsrt
         }
 
     public:
-        void operator ()(value this_value)
+        void operator ()(value this_value, P1 p1, P2 p2, P3 p3, P4 p4, P5 p5, P6 p6, P7 p7, P8 p8)
         {
-            call_function<void>(pack_arguments(this_value));
+            call_function<void>(pack_arguments(this_value, p1, p2, p3, p4, p5, p6, p7, p8));
         }
 
-        static function<void> create(Signature function_signature)
+        static function<void, P1, P2, P3, P4, P5, P6, P7, P8> create(Signature function)
         {
             JsValueRef ref;
-            if (function_signature == nullptr)
+            if (function == nullptr)
             {
                 runtime::translate_error_code(JsErrorNullArgument);
             }
-            runtime::translate_error_code(JsCreateFunction(thunk, function_signature, &ref));
+            runtime::translate_error_code(JsCreateFunction(thunk, function, &ref));
             return decltype(create(nullptr))(ref);
         }
 
-        static function<void> create(std::wstring name, Signature function_signature)
+        static function<void, P1, P2, P3, P4, P5, P6, P7, P8> create(std::wstring name, Signature function)
         {
             JsValueRef nameRef;
             runtime::translate_error_code(marshal::from_native(name, &nameRef));
             JsValueRef ref;
-            if (function_signature == nullptr)
+            if (function == nullptr)
             {
                 runtime::translate_error_code(JsErrorNullArgument);
             }
-            runtime::translate_error_code(JsCreateNamedFunction(nameRef, thunk, function_signature, &ref));
+            runtime::translate_error_code(JsCreateNamedFunction(nameRef, thunk, function, &ref));
             return decltype(create(nullptr))(ref);
         }
     };
 #pragma endregion
 
-    /// <summary>
-    ///     A JavaScript function that is bound to a particular <c>this</c> value.
-    /// </summary>
-    template<class TThis, class R, class... Parameters>
-    class bound_function : public function<R, Parameters...>
+#pragma region Arity 7
+    template<class R, class P1, class P2, class P3, class P4, class P5, class P6, class P7>
+    class function<R, P1, P2, P3, P4, P5, P6, P7, notdefined> : public constructor_function<R>
     {
         friend class value;
 
-	    TThis _this_value;
-
-        explicit bound_function<TThis, R, Parameters...>(TThis this_value, JsValueRef ref) :
-            function<R, Parameters...>(ref),
-            _this_value(this_value)
+    protected:
+        explicit function<R, P1, P2, P3, P4, P5, P6, P7, notdefined>(JsValueRef ref) :
+            constructor_function<R>(ref)
         {
         }
 
     public:
-        /// <summary>
-        ///     Creates an invalid handle to a bound function.
-        /// </summary>
-        bound_function<TThis, R, Parameters...>() :
-            function<R, Parameters...>()
-        {
-        }
+        typedef R(*Signature)(const call_info &call_info, P1 p1, P2 p2, P3 p3, P4 p4, P5 p5, P6 p6, P7 p7);
 
-        /// <summary>
-        ///     Creates a value handle from a <c>this</c> value and a function.
-        /// </summary>
-        /// <param name="this_value">
-        ///     The value the <c>this</c> parameter should be bound to.
-        /// </param>
-        /// <param name="func">A reference to the function.</param>
-        bound_function<TThis, R, Parameters...>(TThis this_value, function<R, Parameters...> func) :
-            function<R, Parameters...>(func),
-            _this_value(this_value)
+        function<R, P1, P2, P3, P4, P5, P6, P7, notdefined>() :
+            constructor_function<R>()
         {
         }
 
-        /// <summary>
-        ///     Calls the bound JavaScript function.
-        /// </summary>
-        /// <remarks>
-        ///     Requires an active script context.
-        /// </remarks>
-        /// <param name="arguments">Arguments to the call.</param>
-        /// <returns>The result of the call.</returns>
-        R operator()(Parameters... arguments)
+        explicit function<R, P1, P2, P3, P4, P5, P6, P7, notdefined>(value object) :
+            constructor_function<R>(object)
         {
-            return call_function<R>(pack_arguments(_this_value, arguments...));
         }
 
-        /// <summary>
-        ///     Creates a new bound JavaScript function.
-        /// </summary>
-        /// <remarks>
-        ///     Requires an active script context.
-        /// </remarks>
-        /// <param name="this_value">
-        ///     The value of <c>this</c> for all calls to this function.
-        /// </param>
-        /// <param name="function">The method to call when the function is invoked.</param>
-        /// <returns>The new function object.</returns>
-        static bound_function<TThis, R, Parameters...> create(TThis this_value, Signature function_signature)
+    protected:
+        static JsValueRef CALLBACK thunk(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, void *callback_state)
         {
-            JsValueRef ref;
-            if (function_signature == nullptr)
+            call_info info;
+            P1 p1;
+            P2 p2;
+            P3 p3;
+            P4 p4;
+            P5 p5;
+            P6 p6;
+            P7 p7;
+
+            if (!unpack_arguments(callee, is_construct_call, arguments, argument_count, info, p1, p2, p3, p4, p5, p6, p7))
             {
-                runtime::translate_error_code(JsErrorNullArgument);
+                return JS_INVALID_REFERENCE;
             }
-            runtime::translate_error_code(JsCreateFunction(thunk, function_signature, &ref));
-            return decltype(create(TThis(), nullptr))(this_value, ref);
-        }
-
-        /// <summary>
-        ///     Creates a new bound JavaScript function.
-        /// </summary>
-        /// <remarks>
-        ///     Requires an active script context.
-        /// </remarks>
-        /// <param name="this_value">
-        ///     The value of <c>this</c> for all calls to this function.
-        /// </param>
-        /// <param name="name">The name of the method for debugging/stringification purposes.</param>
-        /// <param name="function">The method to call when the function is invoked.</param>
-        /// <returns>The new function object.</returns>
-        static bound_function<TThis, R, Parameters...> create(std::wstring name, TThis this_value, Signature function_signature)
-        {
-            JsValueRef nameRef;
-            runtime::translate_error_code(marshal::from_native(name, &nameRef));
-            JsValueRef ref;
-            runtime::translate_error_code(JsCreateNamedFunction(nameRef, thunk, function_signature, &ref));
 
-            return decltype(create(TThis(), nullptr))(this_value, ref);
+            Signature callback = static_cast<Signature>(callback_state);
+            R result;
+            try
+            {
+                result = callback(info, p1, p2, p3, p4, p5, p6, p7);
+            }
+            catch (...)
+            {
+                context::set_exception(error::create(L"Fatal error."));
+                return JS_INVALID_REFERENCE;
+            }
+
+            JsValueRef resultValue;
+            if (marshal::from_native(result, &resultValue) != JsNoError)
+            {
+                context::set_exception(error::create_type_error(L"Could not convert value."));
+                return JS_INVALID_REFERENCE;
+            }
+
+            return resultValue;
+        }
+
+    public:
+        R operator ()(value this_value, P1 p1, P2 p2, P3 p3, P4 p4, P5 p5, P6 p6, P7 p7)
+        {
+            return call_function<R>(pack_arguments(this_value, p1, p2, p3, p4, p5, p6, p7));
+        }
+
+        R construct(P1 p1, P2 p2, P3 p3, P4 p4, P5 p5, P6 p6, P7 p7)
+        {
+            return construct_object(pack_arguments(context::undefined(), p1, p2, p3, p4, p5, p6, p7));
+        }
+
+        static function<R, P1, P2, P3, P4, P5, P6, P7> create(Signature function)
+        {
+            JsValueRef ref;
+            if (function == nullptr)
+            {
+                runtime::translate_error_code(JsErrorNullArgument);
+            }
+            runtime::translate_error_code(JsCreateFunction(thunk, function, &ref));
+            return decltype(create(nullptr))(ref);
+        }
+
+        static function<R, P1, P2, P3, P4, P5, P6, P7> create(std::wstring name, Signature function)
+        {
+            JsValueRef nameRef;
+            runtime::translate_error_code(marshal::from_native(name, &nameRef));
+            JsValueRef ref;
+            if (function == nullptr)
+            {
+                runtime::translate_error_code(JsErrorNullArgument);
+            }
+            runtime::translate_error_code(JsCreateNamedFunction(nameRef, thunk, function, &ref));
+            return decltype(create(nullptr))(ref);
         }
     };
 
-    /// <summary>
-    ///     A reference to a JavaScript property descriptor.
-    /// </summary>
-    template<class T>
-    class property_descriptor : public object
+    template<class P1, class P2, class P3, class P4, class P5, class P6, class P7>
+    class function<void, P1, P2, P3, P4, P5, P6, P7, notdefined> : public function_base
     {
         friend class value;
 
-        explicit property_descriptor(JsValueRef ref) :
-            object(ref)
+    protected:
+        explicit function<void, P1, P2, P3, P4, P5, P6, P7, notdefined>(JsValueRef ref) :
+            function_base(ref)
         {
         }
 
     public:
-        /// <summary>
-        ///     Creates an invalid handle to a property descriptor.
-        /// </summary>
-        property_descriptor() :
-            object()
+        typedef void(*Signature)(const call_info &call_info, P1 p1, P2 p2, P3 p3, P4 p4, P5 p5, P6 p6, P7 p7);
+
+        function<void, P1, P2, P3, P4, P5, P6, P7, notdefined>() :
+            function_base()
         {
         }
 
-        /// <summary>
-        ///     Converts the <c>value</c> handle to a property descriptor handle.
-        /// </summary>
-        /// <remarks>
-        ///     The type of the underlying value is not checked.
-        /// </remarks>
-        explicit property_descriptor(value object) :
-            object(object.handle())
+        explicit function<void, P1, P2, P3, P4, P5, P6, P7, notdefined>(value object) :
+            function_base(object)
         {
         }
 
-        /// <summary>
-        ///     Returns the <c>writable</c> property of the descriptor.
-        /// </summary>
-        bool writable()
+    protected:
+        static JsValueRef CALLBACK thunk(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, void *callback_state)
         {
-            return get_property<bool>(property_id::create(L"writable"));
+            if (is_construct_call)
+            {
+                context::set_exception(error::create(L"Cannot call function as a constructor."));
+                return JS_INVALID_REFERENCE;
+            }
+
+            call_info info;
+            P1 p1;
+            P2 p2;
+            P3 p3;
+            P4 p4;
+            P5 p5;
+            P6 p6;
+            P7 p7;
+
+            if (!unpack_arguments(callee, is_construct_call, arguments, argument_count, info, p1, p2, p3, p4, p5, p6, p7))
+            {
+                return JS_INVALID_REFERENCE;
+            }
+
+            Signature callback = static_cast<Signature>(callback_state);
+            try
+            {
+                callback(info, p1, p2, p3, p4, p5, p6, p7);
+            }
+            catch (...)
+            {
+                context::set_exception(error::create(L"Fatal error."));
+                return JS_INVALID_REFERENCE;
+            }
+
+            return JS_INVALID_REFERENCE;
         }
 
-        /// <summary>
-        ///     Sets the <c>writable</c> property of the descriptor.
-        /// </summary>
-        void set_writable(bool value)
+    public:
+        void operator ()(value this_value, P1 p1, P2 p2, P3 p3, P4 p4, P5 p5, P6 p6, P7 p7)
         {
-            set_property<bool>(property_id::create(L"writable"), value);
+            call_function<void>(pack_arguments(this_value, p1, p2, p3, p4, p5, p6, p7));
         }
 
-        /// <summary>
-        ///     Returns the <c>enumerable</c> property of the descriptor.
-        /// </summary>
-        bool enumerable()
+        static function<void, P1, P2, P3, P4, P5, P6, P7> create(Signature function)
         {
-            return get_property<bool>(property_id::create(L"enumerable"));
+            JsValueRef ref;
+            if (function == nullptr)
+            {
+                runtime::translate_error_code(JsErrorNullArgument);
+            }
+            runtime::translate_error_code(JsCreateFunction(thunk, function, &ref));
+            return decltype(create(nullptr))(ref);
         }
 
-        /// <summary>
-        ///     Sets the <c>enumerable</c> property of the descriptor.
-        /// </summary>
-        void set_enumerable(bool value)
+        static function<void, P1, P2, P3, P4, P5, P6, P7> create(std::wstring name, Signature function)
         {
-            set_property(property_id::create(L"enumerable"), value);
+            JsValueRef nameRef;
+            runtime::translate_error_code(marshal::from_native(name, &nameRef));
+            JsValueRef ref;
+            if (function == nullptr)
+            {
+                runtime::translate_error_code(JsErrorNullArgument);
+            }
+            runtime::translate_error_code(JsCreateNamedFunction(nameRef, thunk, function, &ref));
+            return decltype(create(nullptr))(ref);
         }
+    };
+#pragma endregion
 
-        /// <summary>
-        ///     Returns the <c>configurable</c> property of the descriptor.
-        /// </summary>
-        bool configurable()
+#pragma region Arity 6
+    template<class R, class P1, class P2, class P3, class P4, class P5, class P6>
+    class function<R, P1, P2, P3, P4, P5, P6, notdefined, notdefined> : public constructor_function<R>
+    {
+        friend class value;
+
+    protected:
+        explicit function<R, P1, P2, P3, P4, P5, P6, notdefined, notdefined>(JsValueRef ref) :
+            constructor_function<R>(ref)
         {
-            return get_property<bool>(property_id::create(L"configurable"));
         }
 
-        /// <summary>
-        ///     Sets the <c>enumerable</c> property of the descriptor.
-        /// </summary>
-        void set_configurable(bool value)
+    public:
+        typedef R(*Signature)(const call_info &call_info, P1 p1, P2 p2, P3 p3, P4 p4, P5 p5, P6 p6);
+
+        function<R, P1, P2, P3, P4, P5, P6, notdefined, notdefined>() :
+            constructor_function<R>()
         {
-            set_property(property_id::create(L"configurable"), value);
         }
 
-        /// <summary>
-        ///     Returns the <c>value</c> property of the descriptor.
-        /// </summary>
-        T value()
+        explicit function<R, P1, P2, P3, P4, P5, P6, notdefined, notdefined>(value object) :
+            constructor_function<R>(object)
         {
-            return get_property<T>(property_id::create(L"value"));
         }
 
-        /// <summary>
-        ///     Sets the <c>value</c> property of the descriptor.
-        /// </summary>
-        void set_value(T value)
+    protected:
+        static JsValueRef CALLBACK thunk(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, void *callback_state)
         {
-            set_property(property_id::create(L"value"), value);
+            call_info info;
+            P1 p1;
+            P2 p2;
+            P3 p3;
+            P4 p4;
+            P5 p5;
+            P6 p6;
+
+            if (!unpack_arguments(callee, is_construct_call, arguments, argument_count, info, p1, p2, p3, p4, p5, p6))
+            {
+                return JS_INVALID_REFERENCE;
+            }
+
+            Signature callback = static_cast<Signature>(callback_state);
+            R result;
+            try
+            {
+                result = callback(info, p1, p2, p3, p4, p5, p6);
+            }
+            catch (...)
+            {
+                context::set_exception(error::create(L"Fatal error."));
+                return JS_INVALID_REFERENCE;
+            }
+
+            JsValueRef resultValue;
+            if (marshal::from_native(result, &resultValue) != JsNoError)
+            {
+                context::set_exception(error::create_type_error(L"Could not convert value."));
+                return JS_INVALID_REFERENCE;
+            }
+
+            return resultValue;
         }
 
-        /// <summary>
-        ///     Returns the <c>get</c> property of the descriptor.
-        /// </summary>
-        function<T> getter()
+    public:
+        R operator ()(value this_value, P1 p1, P2 p2, P3 p3, P4 p4, P5 p5, P6 p6)
         {
-            return get_property<function<T>>(property_id::create(L"get"));
+            return call_function<R>(pack_arguments(this_value, p1, p2, p3, p4, p5, p6));
         }
 
-        /// <summary>
-        ///     Sets the <c>get</c> property of the descriptor.
-        /// </summary>
-        void set_getter(function<T> value)
+        R construct(P1 p1, P2 p2, P3 p3, P4 p4, P5 p5, P6 p6)
         {
-            set_property(property_id::create(L"get"), value);
+            return construct_object(pack_arguments(context::undefined(), p1, p2, p3, p4, p5, p6));
         }
 
-        /// <summary>
-        ///     Returns the <c>set</c> property of the descriptor.
-        /// </summary>
-        function<void, T> setter()
-        {
-            return get_property<function<void, T>>(property_id::create(L"set"));
-        }
+        static function<R, P1, P2, P3, P4, P5, P6> create(Signature function)
+        {
+            JsValueRef ref;
+            if (function == nullptr)
+            {
+                runtime::translate_error_code(JsErrorNullArgument);
+            }
+            runtime::translate_error_code(JsCreateFunction(thunk, function, &ref));
+            return decltype(create(nullptr))(ref);
+        }
+
+        static function<R, P1, P2, P3, P4, P5, P6> create(std::wstring name, Signature function)
+        {
+            JsValueRef nameRef;
+            runtime::translate_error_code(marshal::from_native(name, &nameRef));
+            JsValueRef ref;
+            if (function == nullptr)
+            {
+                runtime::translate_error_code(JsErrorNullArgument);
+            }
+            runtime::translate_error_code(JsCreateNamedFunction(nameRef, thunk, function, &ref));
+            return decltype(create(nullptr))(ref);
+        }
+    };
+
+    template<class P1, class P2, class P3, class P4, class P5, class P6>
+    class function<void, P1, P2, P3, P4, P5, P6, notdefined, notdefined> : public function_base
+    {
+        friend class value;
+
+    protected:
+        explicit function<void, P1, P2, P3, P4, P5, P6, notdefined, notdefined>(JsValueRef ref) :
+            function_base(ref)
+        {
+        }
+
+    public:
+        typedef void(*Signature)(const call_info &call_info, P1 p1, P2 p2, P3 p3, P4 p4, P5 p5, P6 p6);
+
+        function<void, P1, P2, P3, P4, P5, P6, notdefined, notdefined>() :
+            function_base()
+        {
+        }
+
+        explicit function<void, P1, P2, P3, P4, P5, P6, notdefined, notdefined>(value object) :
+            function_base(object)
+        {
+        }
+
+    protected:
+        static JsValueRef CALLBACK thunk(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, void *callback_state)
+        {
+            if (is_construct_call)
+            {
+                context::set_exception(error::create(L"Cannot call function as a constructor."));
+                return JS_INVALID_REFERENCE;
+            }
+
+            call_info info;
+            P1 p1;
+            P2 p2;
+            P3 p3;
+            P4 p4;
+            P5 p5;
+            P6 p6;
+
+            if (!unpack_arguments(callee, is_construct_call, arguments, argument_count, info, p1, p2, p3, p4, p5, p6))
+            {
+                return JS_INVALID_REFERENCE;
+            }
+
+            Signature callback = static_cast<Signature>(callback_state);
+            try
+            {
+                callback(info, p1, p2, p3, p4, p5, p6);
+            }
+            catch (...)
+            {
+                context::set_exception(error::create(L"Fatal error."));
+                return JS_INVALID_REFERENCE;
+            }
+
+            return JS_INVALID_REFERENCE;
+        }
+
+    public:
+        void operator ()(value this_value, P1 p1, P2 p2, P3 p3, P4 p4, P5 p5, P6 p6)
+        {
+            call_function<void>(pack_arguments(this_value, p1, p2, p3, p4, p5, p6));
+        }
+
+        static function<void, P1, P2, P3, P4, P5, P6> create(Signature function)
+        {
+            JsValueRef ref;
+            if (function == nullptr)
+            {
+                runtime::translate_error_code(JsErrorNullArgument);
+            }
+            runtime::translate_error_code(JsCreateFunction(thunk, function, &ref));
+            return decltype(create(nullptr))(ref);
+        }
+
+        static function<void, P1, P2, P3, P4, P5, P6> create(std::wstring name, Signature function)
+        {
+            JsValueRef nameRef;
+            runtime::translate_error_code(marshal::from_native(name, &nameRef));
+            JsValueRef ref;
+            if (function == nullptr)
+            {
+                runtime::translate_error_code(JsErrorNullArgument);
+            }
+            runtime::translate_error_code(JsCreateNamedFunction(nameRef, thunk, function, &ref));
+            return decltype(create(nullptr))(ref);
+        }
+    };
+#pragma endregion
+
+#pragma region Arity 5
+    template<class R, class P1, class P2, class P3, class P4, class P5>
+    class function<R, P1, P2, P3, P4, P5, notdefined, notdefined, notdefined> : public constructor_function<R>
+    {
+        friend class value;
+
+    protected:
+        explicit function<R, P1, P2, P3, P4, P5, notdefined, notdefined, notdefined>(JsValueRef ref) :
+            constructor_function<R>(ref)
+        {
+        }
+
+    public:
+        typedef R(*Signature)(const call_info &call_info, P1 p1, P2 p2, P3 p3, P4 p4, P5 p5);
+
+        function<R, P1, P2, P3, P4, P5, notdefined, notdefined, notdefined>() :
+            constructor_function<R>()
+        {
+        }
+
+        explicit function<R, P1, P2, P3, P4, P5, notdefined, notdefined, notdefined>(value object) :
+            constructor_function<R>(object)
+        {
+        }
+
+    protected:
+        static JsValueRef CALLBACK thunk(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, void *callback_state)
+        {
+            call_info info;
+            P1 p1;
+            P2 p2;
+            P3 p3;
+            P4 p4;
+            P5 p5;
+
+            if (!unpack_arguments(callee, is_construct_call, arguments, argument_count, info, p1, p2, p3, p4, p5))
+            {
+                return JS_INVALID_REFERENCE;
+            }
+
+            Signature callback = static_cast<Signature>(callback_state);
+            R result;
+            try
+            {
+                result = callback(info, p1, p2, p3, p4, p5);
+            }
+            catch (...)
+            {
+                context::set_exception(error::create(L"Fatal error."));
+                return JS_INVALID_REFERENCE;
+            }
+
+            JsValueRef resultValue;
+            if (marshal::from_native(result, &resultValue) != JsNoError)
+            {
+                context::set_exception(error::create_type_error(L"Could not convert value."));
+                return JS_INVALID_REFERENCE;
+            }
+
+            return resultValue;
+        }
+
+    public:
+        R operator ()(value this_value, P1 p1, P2 p2, P3 p3, P4 p4, P5 p5)
+        {
+            return call_function<R>(pack_arguments(this_value, p1, p2, p3, p4, p5));
+        }
+
+        R construct(P1 p1, P2 p2, P3 p3, P4 p4, P5 p5)
+        {
+            return construct_object(pack_arguments(context::undefined(), p1, p2, p3, p4, p5));
+        }
+
+        static function<R, P1, P2, P3, P4, P5> create(Signature function)
+        {
+            JsValueRef ref;
+            if (function == nullptr)
+            {
+                runtime::translate_error_code(JsErrorNullArgument);
+            }
+            runtime::translate_error_code(JsCreateFunction(thunk, function, &ref));
+            return decltype(create(nullptr))(ref);
+        }
+
+        static function<R, P1, P2, P3, P4, P5> create(std::wstring name, Signature function)
+        {
+            JsValueRef nameRef;
+            runtime::translate_error_code(marshal::from_native(name, &nameRef));
+            JsValueRef ref;
+            if (function == nullptr)
+            {
+                runtime::translate_error_code(JsErrorNullArgument);
+            }
+            runtime::translate_error_code(JsCreateNamedFunction(nameRef, thunk, function, &ref));
+            return decltype(create(nullptr))(ref);
+        }
+    };
+
+    template<class P1, class P2, class P3, class P4, class P5>
+    class function<void, P1, P2, P3, P4, P5, notdefined, notdefined, notdefined> : public function_base
+    {
+        friend class value;
+
+    protected:
+        explicit function<void, P1, P2, P3, P4, P5, notdefined, notdefined, notdefined>(JsValueRef ref) :
+            function_base(ref)
+        {
+        }
+
+    public:
+        typedef void(*Signature)(const call_info &call_info, P1 p1, P2 p2, P3 p3, P4 p4, P5 p5);
+
+        function<void, P1, P2, P3, P4, P5, notdefined, notdefined, notdefined>() :
+            function_base()
+        {
+        }
+
+        explicit function<void, P1, P2, P3, P4, P5, notdefined, notdefined, notdefined>(value object) :
+            function_base(object)
+        {
+        }
+
+    protected:
+        static JsValueRef CALLBACK thunk(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, void *callback_state)
+        {
+            if (is_construct_call)
+            {
+                context::set_exception(error::create(L"Cannot call function as a constructor."));
+                return JS_INVALID_REFERENCE;
+            }
+
+            call_info info;
+            P1 p1;
+            P2 p2;
+            P3 p3;
+            P4 p4;
+            P5 p5;
+
+            if (!unpack_arguments(callee, is_construct_call, arguments, argument_count, info, p1, p2, p3, p4, p5))
+            {
+                return JS_INVALID_REFERENCE;
+            }
+
+            Signature callback = static_cast<Signature>(callback_state);
+            try
+            {
+                callback(info, p1, p2, p3, p4, p5);
+            }
+            catch (...)
+            {
+                context::set_exception(error::create(L"Fatal error."));
+                return JS_INVALID_REFERENCE;
+            }
+
+            return JS_INVALID_REFERENCE;
+        }
+
+    public:
+        void operator ()(value this_value, P1 p1, P2 p2, P3 p3, P4 p4, P5 p5)
+        {
+            call_function<void>(pack_arguments(this_value, p1, p2, p3, p4, p5));
+        }
+
+        static function<void, P1, P2, P3, P4, P5> create(Signature function)
+        {
+            JsValueRef ref;
+            if (function == nullptr)
+            {
+                runtime::translate_error_code(JsErrorNullArgument);
+            }
+            runtime::translate_error_code(JsCreateFunction(thunk, function, &ref));
+            return decltype(create(nullptr))(ref);
+        }
+
+        static function<void, P1, P2, P3, P4, P5> create(std::wstring name, Signature function)
+        {
+            JsValueRef nameRef;
+            runtime::translate_error_code(marshal::from_native(name, &nameRef));
+            JsValueRef ref;
+            if (function == nullptr)
+            {
+                runtime::translate_error_code(JsErrorNullArgument);
+            }
+            runtime::translate_error_code(JsCreateNamedFunction(nameRef, thunk, function, &ref));
+            return decltype(create(nullptr))(ref);
+        }
+    };
+#pragma endregion
+
+#pragma region Arity 4
+    template<class R, class P1, class P2, class P3, class P4>
+    class function<R, P1, P2, P3, P4, notdefined, notdefined, notdefined, notdefined> : public constructor_function<R>
+    {
+        friend class value;
+
+    protected:
+        explicit function<R, P1, P2, P3, P4, notdefined, notdefined, notdefined, notdefined>(JsValueRef ref) :
+            constructor_function<R>(ref)
+        {
+        }
+
+    public:
+        typedef R(*Signature)(const call_info &call_info, P1 p1, P2 p2, P3 p3, P4 p4);
+
+        function<R, P1, P2, P3, P4, notdefined, notdefined, notdefined, notdefined>() :
+            constructor_function<R>()
+        {
+        }
+
+        explicit function<R, P1, P2, P3, P4, notdefined, notdefined, notdefined, notdefined>(value object) :
+            constructor_function<R>(object)
+        {
+        }
+
+    protected:
+        static JsValueRef CALLBACK thunk(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, void *callback_state)
+        {
+            call_info info;
+            P1 p1;
+            P2 p2;
+            P3 p3;
+            P4 p4;
+
+            if (!unpack_arguments(callee, is_construct_call, arguments, argument_count, info, p1, p2, p3, p4))
+            {
+                return JS_INVALID_REFERENCE;
+            }
+
+            Signature callback = static_cast<Signature>(callback_state);
+            R result;
+            try
+            {
+                result = callback(info, p1, p2, p3, p4);
+            }
+            catch (...)
+            {
+                context::set_exception(error::create(L"Fatal error."));
+                return JS_INVALID_REFERENCE;
+            }
+
+            JsValueRef resultValue;
+            if (marshal::from_native(result, &resultValue) != JsNoError)
+            {
+                context::set_exception(error::create_type_error(L"Could not convert value."));
+                return JS_INVALID_REFERENCE;
+            }
+
+            return resultValue;
+        }
+
+    public:
+        R operator ()(value this_value, P1 p1, P2 p2, P3 p3, P4 p4)
+        {
+            return call_function<R>(pack_arguments(this_value, p1, p2, p3, p4));
+        }
+
+        R construct(P1 p1, P2 p2, P3 p3, P4 p4)
+        {
+            return construct_object(pack_arguments(context::undefined(), p1, p2, p3, p4));
+        }
+
+        static function<R, P1, P2, P3, P4> create(Signature function)
+        {
+            JsValueRef ref;
+            if (function == nullptr)
+            {
+                runtime::translate_error_code(JsErrorNullArgument);
+            }
+            runtime::translate_error_code(JsCreateFunction(thunk, function, &ref));
+            return decltype(create(nullptr))(ref);
+        }
+
+        static function<R, P1, P2, P3, P4> create(std::wstring name, Signature function)
+        {
+            JsValueRef nameRef;
+            runtime::translate_error_code(marshal::from_native(name, &nameRef));
+            JsValueRef ref;
+            if (function == nullptr)
+            {
+                runtime::translate_error_code(JsErrorNullArgument);
+            }
+            runtime::translate_error_code(JsCreateNamedFunction(nameRef, thunk, function, &ref));
+            return decltype(create(nullptr))(ref);
+        }
+    };
+
+    template<class P1, class P2, class P3, class P4>
+    class function<void, P1, P2, P3, P4, notdefined, notdefined, notdefined, notdefined> : public function_base
+    {
+        friend class value;
+
+    protected:
+        explicit function<void, P1, P2, P3, P4, notdefined, notdefined, notdefined, notdefined>(JsValueRef ref) :
+            function_base(ref)
+        {
+        }
+
+    public:
+        typedef void(*Signature)(const call_info &call_info, P1 p1, P2 p2, P3 p3, P4 p4);
+
+        function<void, P1, P2, P3, P4, notdefined, notdefined, notdefined, notdefined>() :
+            function_base()
+        {
+        }
+
+        explicit function<void, P1, P2, P3, P4, notdefined, notdefined, notdefined, notdefined>(value object) :
+            function_base(object)
+        {
+        }
+
+    protected:
+        static JsValueRef CALLBACK thunk(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, void *callback_state)
+        {
+            if (is_construct_call)
+            {
+                context::set_exception(error::create(L"Cannot call function as a constructor."));
+                return JS_INVALID_REFERENCE;
+            }
+
+            call_info info;
+            P1 p1;
+            P2 p2;
+            P3 p3;
+            P4 p4;
+
+            if (!unpack_arguments(callee, is_construct_call, arguments, argument_count, info, p1, p2, p3, p4))
+            {
+                return JS_INVALID_REFERENCE;
+            }
+
+            Signature callback = static_cast<Signature>(callback_state);
+            try
+            {
+                callback(info, p1, p2, p3, p4);
+            }
+            catch (...)
+            {
+                context::set_exception(error::create(L"Fatal error."));
+                return JS_INVALID_REFERENCE;
+            }
+
+            return JS_INVALID_REFERENCE;
+        }
+
+    public:
+        void operator ()(value this_value, P1 p1, P2 p2, P3 p3, P4 p4)
+        {
+            call_function<void>(pack_arguments(this_value, p1, p2, p3, p4));
+        }
+
+        static function<void, P1, P2, P3, P4> create(Signature function)
+        {
+            JsValueRef ref;
+            if (function == nullptr)
+            {
+                runtime::translate_error_code(JsErrorNullArgument);
+            }
+            runtime::translate_error_code(JsCreateFunction(thunk, function, &ref));
+            return decltype(create(nullptr))(ref);
+        }
+
+        static function<void, P1, P2, P3, P4> create(std::wstring name, Signature function)
+        {
+            JsValueRef nameRef;
+            runtime::translate_error_code(marshal::from_native(name, &nameRef));
+            JsValueRef ref;
+            if (function == nullptr)
+            {
+                runtime::translate_error_code(JsErrorNullArgument);
+            }
+            runtime::translate_error_code(JsCreateNamedFunction(nameRef, thunk, function, &ref));
+            return decltype(create(nullptr))(ref);
+        }
+    };
+#pragma endregion
+
+#pragma region Arity 3
+    template<class R, class P1, class P2, class P3>
+    class function<R, P1, P2, P3, notdefined, notdefined, notdefined, notdefined, notdefined> : public constructor_function<R>
+    {
+        friend class value;
+
+    protected:
+        explicit function<R, P1, P2, P3, notdefined, notdefined, notdefined, notdefined, notdefined>(JsValueRef ref) :
+            constructor_function<R>(ref)
+        {
+        }
+
+    public:
+        typedef R(*Signature)(const call_info &call_info, P1 p1, P2 p2, P3 p3);
+
+        function<R, P1, P2, P3, notdefined, notdefined, notdefined, notdefined, notdefined>() :
+            constructor_function<R>()
+        {
+        }
+
+        explicit function<R, P1, P2, P3, notdefined, notdefined, notdefined, notdefined, notdefined>(value object) :
+            constructor_function<R>(object)
+        {
+        }
+
+    protected:
+        static JsValueRef CALLBACK thunk(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, void *callback_state)
+        {
+            call_info info;
+            P1 p1;
+            P2 p2;
+            P3 p3;
+
+            if (!unpack_arguments(callee, is_construct_call, arguments, argument_count, info, p1, p2, p3))
+            {
+                return JS_INVALID_REFERENCE;
+            }
+
+            Signature callback = static_cast<Signature>(callback_state);
+            R result;
+            try
+            {
+                result = callback(info, p1, p2, p3);
+            }
+            catch (...)
+            {
+                context::set_exception(error::create(L"Fatal error."));
+                return JS_INVALID_REFERENCE;
+            }
+
+            JsValueRef resultValue;
+            if (marshal::from_native(result, &resultValue) != JsNoError)
+            {
+                context::set_exception(error::create_type_error(L"Could not convert value."));
+                return JS_INVALID_REFERENCE;
+            }
+
+            return resultValue;
+        }
+
+    public:
+        R operator ()(value this_value, P1 p1, P2 p2, P3 p3)
+        {
+            return call_function<R>(pack_arguments(this_value, p1, p2, p3));
+        }
+
+        R construct(P1 p1, P2 p2, P3 p3)
+        {
+            return construct_object(pack_arguments(context::undefined(), p1, p2, p3));
+        }
+
+        static function<R, P1, P2, P3> create(Signature function)
+        {
+            JsValueRef ref;
+            if (function == nullptr)
+            {
+                runtime::translate_error_code(JsErrorNullArgument);
+            }
+            runtime::translate_error_code(JsCreateFunction(thunk, function, &ref));
+            return decltype(create(nullptr))(ref);
+        }
+
+        static function<R, P1, P2, P3> create(std::wstring name, Signature function)
+        {
+            JsValueRef nameRef;
+            runtime::translate_error_code(marshal::from_native(name, &nameRef));
+            JsValueRef ref;
+            if (function == nullptr)
+            {
+                runtime::translate_error_code(JsErrorNullArgument);
+            }
+            runtime::translate_error_code(JsCreateNamedFunction(nameRef, thunk, function, &ref));
+            return decltype(create(nullptr))(ref);
+        }
+    };
+
+    template<class P1, class P2, class P3>
+    class function<void, P1, P2, P3, notdefined, notdefined, notdefined, notdefined, notdefined> : public function_base
+    {
+        friend class value;
+
+    protected:
+        explicit function<void, P1, P2, P3, notdefined, notdefined, notdefined, notdefined, notdefined>(JsValueRef ref) :
+            function_base(ref)
+        {
+        }
+
+    public:
+        typedef void(*Signature)(const call_info &call_info, P1 p1, P2 p2, P3 p3);
+
+        function<void, P1, P2, P3, notdefined, notdefined, notdefined, notdefined, notdefined>() :
+            function_base()
+        {
+        }
+
+        explicit function<void, P1, P2, P3, notdefined, notdefined, notdefined, notdefined, notdefined>(value object) :
+            function_base(object)
+        {
+        }
+
+    protected:
+        static JsValueRef CALLBACK thunk(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, void *callback_state)
+        {
+            if (is_construct_call)
+            {
+                context::set_exception(error::create(L"Cannot call function as a constructor."));
+                return JS_INVALID_REFERENCE;
+            }
+
+            call_info info;
+            P1 p1;
+            P2 p2;
+            P3 p3;
+
+            if (!unpack_arguments(callee, is_construct_call, arguments, argument_count, info, p1, p2, p3))
+            {
+                return JS_INVALID_REFERENCE;
+            }
+
+            Signature callback = static_cast<Signature>(callback_state);
+            try
+            {
+                callback(info, p1, p2, p3);
+            }
+            catch (...)
+            {
+                context::set_exception(error::create(L"Fatal error."));
+                return JS_INVALID_REFERENCE;
+            }
+
+            return JS_INVALID_REFERENCE;
+        }
+
+    public:
+        void operator ()(value this_value, P1 p1, P2 p2, P3 p3)
+        {
+            call_function<void>(pack_arguments(this_value, p1, p2, p3));
+        }
+
+        static function<void, P1, P2, P3> create(Signature function)
+        {
+            JsValueRef ref;
+            if (function == nullptr)
+            {
+                runtime::translate_error_code(JsErrorNullArgument);
+            }
+            runtime::translate_error_code(JsCreateFunction(thunk, function, &ref));
+            return decltype(create(nullptr))(ref);
+        }
+
+        static function<void, P1, P2, P3> create(std::wstring name, Signature function)
+        {
+            JsValueRef nameRef;
+            runtime::translate_error_code(marshal::from_native(name, &nameRef));
+            JsValueRef ref;
+            if (function == nullptr)
+            {
+                runtime::translate_error_code(JsErrorNullArgument);
+            }
+            runtime::translate_error_code(JsCreateNamedFunction(nameRef, thunk, function, &ref));
+            return decltype(create(nullptr))(ref);
+        }
+    };
+#pragma endregion
+
+#pragma region Arity 2
+    template<class R, class P1, class P2>
+    class function<R, P1, P2, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined> : public constructor_function<R>
+    {
+        friend class value;
+
+    protected:
+        explicit function<R, P1, P2, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined>(JsValueRef ref) :
+            constructor_function<R>(ref)
+        {
+        }
+
+    public:
+        typedef R(*Signature)(const call_info &call_info, P1 p1, P2 p2);
+
+        function<R, P1, P2, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined>() :
+            constructor_function<R>()
+        {
+        }
+
+        explicit function<R, P1, P2, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined>(value object) :
+            constructor_function<R>(object)
+        {
+        }
+
+    protected:
+        static JsValueRef CALLBACK thunk(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, void *callback_state)
+        {
+            call_info info;
+            P1 p1;
+            P2 p2;
+
+            if (!unpack_arguments(callee, is_construct_call, arguments, argument_count, info, p1, p2))
+            {
+                return JS_INVALID_REFERENCE;
+            }
+
+            Signature callback = static_cast<Signature>(callback_state);
+            R result;
+            try
+            {
+                result = callback(info, p1, p2);
+            }
+            catch (...)
+            {
+                context::set_exception(error::create(L"Fatal error."));
+                return JS_INVALID_REFERENCE;
+            }
+
+            JsValueRef resultValue;
+            if (marshal::from_native(result, &resultValue) != JsNoError)
+            {
+                context::set_exception(error::create_type_error(L"Could not convert value."));
+                return JS_INVALID_REFERENCE;
+            }
+
+            return resultValue;
+        }
+
+    public:
+        R operator ()(value this_value, P1 p1, P2 p2)
+        {
+            return call_function<R>(pack_arguments(this_value, p1, p2));
+        }
+
+        R construct(P1 p1, P2 p2)
+        {
+            return construct_object(pack_arguments(context::undefined(), p1, p2));
+        }
+
+        static function<R, P1, P2> create(Signature function)
+        {
+            JsValueRef ref;
+            if (function == nullptr)
+            {
+                runtime::translate_error_code(JsErrorNullArgument);
+            }
+            runtime::translate_error_code(JsCreateFunction(thunk, function, &ref));
+            return decltype(create(nullptr))(ref);
+        }
+
+        static function<R, P1, P2> create(std::wstring name, Signature function)
+        {
+            JsValueRef nameRef;
+            runtime::translate_error_code(marshal::from_native(name, &nameRef));
+            JsValueRef ref;
+            if (function == nullptr)
+            {
+                runtime::translate_error_code(JsErrorNullArgument);
+            }
+            runtime::translate_error_code(JsCreateNamedFunction(nameRef, thunk, function, &ref));
+            return decltype(create(nullptr))(ref);
+        }
+    };
+
+    template<class P1, class P2>
+    class function<void, P1, P2, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined> : public function_base
+    {
+        friend class value;
+
+    protected:
+        explicit function<void, P1, P2, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined>(JsValueRef ref) :
+            function_base(ref)
+        {
+        }
+
+    public:
+        typedef void(*Signature)(const call_info &call_info, P1 p1, P2 p2);
+
+        function<void, P1, P2, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined>() :
+            function_base()
+        {
+        }
+
+        explicit function<void, P1, P2, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined>(value object) :
+            function_base(object)
+        {
+        }
+
+    protected:
+        static JsValueRef CALLBACK thunk(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, void *callback_state)
+        {
+            if (is_construct_call)
+            {
+                context::set_exception(error::create(L"Cannot call function as a constructor."));
+                return JS_INVALID_REFERENCE;
+            }
+
+            call_info info;
+            P1 p1;
+            P2 p2;
+
+            if (!unpack_arguments(callee, is_construct_call, arguments, argument_count, info, p1, p2))
+            {
+                return JS_INVALID_REFERENCE;
+            }
+
+            Signature callback = static_cast<Signature>(callback_state);
+            try
+            {
+                callback(info, p1, p2);
+            }
+            catch (...)
+            {
+                context::set_exception(error::create(L"Fatal error."));
+                return JS_INVALID_REFERENCE;
+            }
+
+            return JS_INVALID_REFERENCE;
+        }
+
+    public:
+        void operator ()(value this_value, P1 p1, P2 p2)
+        {
+            call_function<void>(pack_arguments(this_value, p1, p2));
+        }
+
+        static function<void, P1, P2> create(Signature function)
+        {
+            JsValueRef ref;
+            if (function == nullptr)
+            {
+                runtime::translate_error_code(JsErrorNullArgument);
+            }
+            runtime::translate_error_code(JsCreateFunction(thunk, function, &ref));
+            return decltype(create(nullptr))(ref);
+        }
+
+        static function<void, P1, P2> create(std::wstring name, Signature function)
+        {
+            JsValueRef nameRef;
+            runtime::translate_error_code(marshal::from_native(name, &nameRef));
+            JsValueRef ref;
+            if (function == nullptr)
+            {
+                runtime::translate_error_code(JsErrorNullArgument);
+            }
+            runtime::translate_error_code(JsCreateNamedFunction(nameRef, thunk, function, &ref));
+            return decltype(create(nullptr))(ref);
+        }
+    };
+#pragma endregion
+
+#pragma region Arity 1
+    template<class R, class P1>
+    class function<R, P1, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined> : public constructor_function<R>
+    {
+        friend class value;
+
+    protected:
+        explicit function<R, P1, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined>(JsValueRef ref) :
+            constructor_function<R>(ref)
+        {
+        }
+
+    public:
+        typedef R(*Signature)(const call_info &call_info, P1 p1);
+
+        function<R, P1, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined>() :
+            constructor_function<R>()
+        {
+        }
+
+        explicit function<R, P1, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined>(value object) :
+            constructor_function<R>(object)
+        {
+        }
+
+    protected:
+        static JsValueRef CALLBACK thunk(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, void *callback_state)
+        {
+            call_info info;
+            P1 p1;
+
+            if (!unpack_arguments(callee, is_construct_call, arguments, argument_count, info, p1))
+            {
+                return JS_INVALID_REFERENCE;
+            }
+
+            Signature callback = static_cast<Signature>(callback_state);
+            R result;
+            try
+            {
+                result = callback(info, p1);
+            }
+            catch (...)
+            {
+                context::set_exception(error::create(L"Fatal error."));
+                return JS_INVALID_REFERENCE;
+            }
+
+            JsValueRef resultValue;
+            if (marshal::from_native(result, &resultValue) != JsNoError)
+            {
+                context::set_exception(error::create_type_error(L"Could not convert value."));
+                return JS_INVALID_REFERENCE;
+            }
+
+            return resultValue;
+        }
+
+    public:
+        R operator ()(value this_value, P1 p1)
+        {
+            return call_function<R>(pack_arguments(this_value, p1));
+        }
+
+        R construct(P1 p1)
+        {
+            return construct_object(pack_arguments(context::undefined(), p1));
+        }
+
+        static function<R, P1> create(Signature function)
+        {
+            JsValueRef ref;
+            if (function == nullptr)
+            {
+                runtime::translate_error_code(JsErrorNullArgument);
+            }
+            runtime::translate_error_code(JsCreateFunction(thunk, function, &ref));
+            return decltype(create(nullptr))(ref);
+        }
+
+        static function<R, P1> create(std::wstring name, Signature function)
+        {
+            JsValueRef nameRef;
+            runtime::translate_error_code(marshal::from_native(name, &nameRef));
+            JsValueRef ref;
+            if (function == nullptr)
+            {
+                runtime::translate_error_code(JsErrorNullArgument);
+            }
+            runtime::translate_error_code(JsCreateNamedFunction(nameRef, thunk, function, &ref));
+            return decltype(create(nullptr))(ref);
+        }
+    };
+
+    template<class P1>
+    class function<void, P1, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined> : public function_base
+    {
+        friend class value;
+
+    protected:
+        explicit function<void, P1, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined>(JsValueRef ref) :
+            function_base(ref)
+        {
+        }
+
+    public:
+        typedef void(*Signature)(const call_info &call_info, P1 p1);
+
+        function<void, P1, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined>() :
+            function_base()
+        {
+        }
+
+        explicit function<void, P1, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined>(value object) :
+            function_base(object)
+        {
+        }
+
+    protected:
+        static JsValueRef CALLBACK thunk(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, void *callback_state)
+        {
+            if (is_construct_call)
+            {
+                context::set_exception(error::create(L"Cannot call function as a constructor."));
+                return JS_INVALID_REFERENCE;
+            }
+
+            call_info info;
+            P1 p1;
+
+            if (!unpack_arguments(callee, is_construct_call, arguments, argument_count, info, p1))
+            {
+                return JS_INVALID_REFERENCE;
+            }
+
+            Signature callback = static_cast<Signature>(callback_state);
+            try
+            {
+                callback(info, p1);
+            }
+            catch (...)
+            {
+                context::set_exception(error::create(L"Fatal error."));
+                return JS_INVALID_REFERENCE;
+            }
+
+            return JS_INVALID_REFERENCE;
+        }
+
+    public:
+        void operator ()(value this_value, P1 p1)
+        {
+            call_function<void>(pack_arguments(this_value, p1));
+        }
+
+        static function<void, P1> create(Signature function)
+        {
+            JsValueRef ref;
+            if (function == nullptr)
+            {
+                runtime::translate_error_code(JsErrorNullArgument);
+            }
+            runtime::translate_error_code(JsCreateFunction(thunk, function, &ref));
+            return decltype(create(nullptr))(ref);
+        }
+
+        static function<void, P1> create(std::wstring name, Signature function)
+        {
+            JsValueRef nameRef;
+            runtime::translate_error_code(marshal::from_native(name, &nameRef));
+            JsValueRef ref;
+            if (function == nullptr)
+            {
+                runtime::translate_error_code(JsErrorNullArgument);
+            }
+            runtime::translate_error_code(JsCreateNamedFunction(nameRef, thunk, function, &ref));
+            return decltype(create(nullptr))(ref);
+        }
+    };
+#pragma endregion
+
+#pragma region Arity 0
+    template<class R>
+    class function<R, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined> : public constructor_function<R>
+    {
+        friend class value;
+
+    protected:
+        explicit function<R, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined>(JsValueRef ref) :
+            constructor_function<R>(ref)
+        {
+        }
+
+    public:
+        typedef R(*Signature)(const call_info &call_info);
+
+        function<R, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined>() :
+            constructor_function<R>()
+        {
+        }
+
+        explicit function<R, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined>(value object) :
+            constructor_function<R>(object)
+        {
+        }
+
+    protected:
+        static JsValueRef CALLBACK thunk(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, void *callback_state)
+        {
+            call_info info;
+
+            if (!unpack_arguments(callee, is_construct_call, arguments, argument_count, info))
+            {
+                return JS_INVALID_REFERENCE;
+            }
+
+            Signature callback = static_cast<Signature>(callback_state);
+            R result;
+            try
+            {
+                result = callback(info);
+            }
+            catch (...)
+            {
+                context::set_exception(error::create(L"Fatal error."));
+                return JS_INVALID_REFERENCE;
+            }
+
+            JsValueRef resultValue;
+            if (marshal::from_native(result, &resultValue) != JsNoError)
+            {
+                context::set_exception(error::create_type_error(L"Could not convert value."));
+                return JS_INVALID_REFERENCE;
+            }
+
+            return resultValue;
+        }
+
+    public:
+        R operator ()(value this_value)
+        {
+            return call_function<R>(pack_arguments(this_value));
+        }
+
+        R construct()
+        {
+            return construct_object(pack_arguments(context::undefined()));
+        }
+
+        static function<R> create(Signature function)
+        {
+            JsValueRef ref;
+            if (function == nullptr)
+            {
+                runtime::translate_error_code(JsErrorNullArgument);
+            }
+            runtime::translate_error_code(JsCreateFunction(thunk, function, &ref));
+            return decltype(create(nullptr))(ref);
+        }
+
+        static function<R> create(std::wstring name, Signature function)
+        {
+            JsValueRef nameRef;
+            runtime::translate_error_code(marshal::from_native(name, &nameRef));
+            JsValueRef ref;
+            if (function == nullptr)
+            {
+                runtime::translate_error_code(JsErrorNullArgument);
+            }
+            runtime::translate_error_code(JsCreateNamedFunction(nameRef, thunk, function, &ref));
+            return decltype(create(nullptr))(ref);
+        }
+    };
+
+    template<>
+    class function<void, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined> : public function_base
+    {
+        friend class value;
+        friend class context;
+
+    protected:
+        explicit function<void, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined>(JsValueRef ref) :
+            function_base(ref)
+        {
+        }
+
+    public:
+        typedef void(*Signature)(const call_info &call_info);
+
+        function<void, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined>() :
+            function_base()
+        {
+        }
+
+        explicit function<void, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined, notdefined>(value object) :
+            function_base(object)
+        {
+        }
+
+    protected:
+        static JsValueRef CALLBACK thunk(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, void *callback_state)
+        {
+            if (is_construct_call)
+            {
+                context::set_exception(error::create(L"Cannot call function as a constructor."));
+                return JS_INVALID_REFERENCE;
+            }
+
+            call_info info;
+
+            if (!unpack_arguments(callee, is_construct_call, arguments, argument_count, info))
+            {
+                return JS_INVALID_REFERENCE;
+            }
+
+            Signature callback = static_cast<Signature>(callback_state);
+            try
+            {
+                callback(info);
+            }
+            catch (...)
+            {
+                context::set_exception(error::create(L"Fatal error."));
+                return JS_INVALID_REFERENCE;
+            }
+
+            return JS_INVALID_REFERENCE;
+        }
+
+    public:
+        void operator ()(value this_value)
+        {
+            call_function<void>(pack_arguments(this_value));
+        }
+
+        static function<void> create(Signature function_signature)
+        {
+            JsValueRef ref;
+            if (function_signature == nullptr)
+            {
+                runtime::translate_error_code(JsErrorNullArgument);
+            }
+            runtime::translate_error_code(JsCreateFunction(thunk, function_signature, &ref));
+            return decltype(create(nullptr))(ref);
+        }
+
+        static function<void> create(std::wstring name, Signature function_signature)
+        {
+            JsValueRef nameRef;
+            runtime::translate_error_code(marshal::from_native(name, &nameRef));
+            JsValueRef ref;
+            if (function_signature == nullptr)
+            {
+                runtime::translate_error_code(JsErrorNullArgument);
+            }
+            runtime::translate_error_code(JsCreateNamedFunction(nameRef, thunk, function_signature, &ref));
+            return decltype(create(nullptr))(ref);
+        }
+    };
+#pragma endregion
+
+    /// <summary>
+    ///     A JavaScript function that is bound to a particular <c>this</c> value.
+    /// </summary>
+    template<class TThis, class R, class... Parameters>
+    class bound_function : public function<R, Parameters...>
+    {
+        friend class value;
+
+	    TThis _this_value;
+
+        explicit bound_function<TThis, R, Parameters...>(TThis this_value, JsValueRef ref) :
+            function<R, Parameters...>(ref),
+            _this_value(this_value)
+        {
+        }
+
+    public:
+        /// <summary>
+        ///     Creates an invalid handle to a bound function.
+        /// </summary>
+        bound_function<TThis, R, Parameters...>() :
+            function<R, Parameters...>()
+        {
+        }
+
+        /// <summary>
+        ///     Creates a value handle from a <c>this</c> value and a function.
+        /// </summary>
+        /// <param name="this_value">
+        ///     The value the <c>this</c> parameter should be bound to.
+        /// </param>
+        /// <param name="func">A reference to the function.</param>
+        bound_function<TThis, R, Parameters...>(TThis this_value, function<R, Parameters...> func) :
+            function<R, Parameters...>(func),
+            _this_value(this_value)
+        {
+        }
+
+        /// <summary>
+        ///     Calls the bound JavaScript function.
+        /// </summary>
+        /// <remarks>
+        ///     Requires an active script context.
+        /// </remarks>
+        /// <param name="arguments">Arguments to the call.</param>
+        /// <returns>The result of the call.</returns>
+        R operator()(Parameters... arguments)
+        {
+            return call_function<R>(pack_arguments(_this_value, arguments...));
+        }
+
+        /// <summary>
+        ///     Creates a new bound JavaScript function.
+        /// </summary>
+        /// <remarks>
+        ///     Requires an active script context.
+        /// </remarks>
+        /// <param name="this_value">
+        ///     The value of <c>this</c> for all calls to this function.
+        /// </param>
+        /// <param name="function">The method to call when the function is invoked.</param>
+        /// <returns>The new function object.</returns>
+        static bound_function<TThis, R, Parameters...> create(TThis this_value, Signature function_signature)
+        {
+            JsValueRef ref;
+            if (function_signature == nullptr)
+            {
+                runtime::translate_error_code(JsErrorNullArgument);
+            }
+            runtime::translate_error_code(JsCreateFunction(thunk, function_signature, &ref));
+            return decltype(create(TThis(), nullptr))(this_value, ref);
+        }
+
+        /// <summary>
+        ///     Creates a new bound JavaScript function.
+        /// </summary>
+        /// <remarks>
+        ///     Requires an active script context.
+        /// </remarks>
+        /// <param name="this_value">
+        ///     The value of <c>this</c> for all calls to this function.
+        /// </param>
+        /// <param name="name">The name of the method for debugging/stringification purposes.</param>
+        /// <param name="function">The method to call when the function is invoked.</param>
+        /// <returns>The new function object.</returns>
+        static bound_function<TThis, R, Parameters...> create(std::wstring name, TThis this_value, Signature function_signature)
+        {
+            JsValueRef nameRef;
+            runtime::translate_error_code(marshal::from_native(name, &nameRef));
+            JsValueRef ref;
+            runtime::translate_error_code(JsCreateNamedFunction(nameRef, thunk, function_signature, &ref));
+
+            return decltype(create(TThis(), nullptr))(this_value, ref);
+        }
+    };
+
+    /// <summary>
+    ///     A reference to a JavaScript property descriptor.
+    /// </summary>
+    template<class T>
+    class property_descriptor : public object
+    {
+        friend class value;
+
+        explicit property_descriptor(JsValueRef ref) :
+            object(ref)
+        {
+        }
+
+    public:
+        /// <summary>
+        ///     Creates an invalid handle to a property descriptor.
+        /// </summary>
+        property_descriptor() :
+            object()
+        {
+        }
+
+        /// <summary>
+        ///     Converts the <c>value</c> handle to a property descriptor handle.
+        /// </summary>
+        /// <remarks>
+        ///     The type of the underlying value is not checked.
+        /// </remarks>
+        explicit property_descriptor(value object) :
+            object(object.handle())
+        {
+        }
+
+        /// <summary>
+        ///     Returns the <c>writable</c> property of the descriptor.
+        /// </summary>
+        bool writable()
+        {
+            return get_property<bool>(property_id::create(L"writable"));
+        }
+
+        /// <summary>
+        ///     Sets the <c>writable</c> property of the descriptor.
+        /// </summary>
+        void set_writable(bool value)
+        {
+            set_property<bool>(property_id::create(L"writable"), value);
+        }
+
+        /// <summary>
+        ///     Returns the <c>enumerable</c> property of the descriptor.
+        /// </summary>
+        bool enumerable()
+        {
+            return get_property<bool>(property_id::create(L"enumerable"));
+        }
+
+        /// <summary>
+        ///     Sets the <c>enumerable</c> property of the descriptor.
+        /// </summary>
+        void set_enumerable(bool value)
+        {
+            set_property(property_id::create(L"enumerable"), value);
+        }
+
+        /// <summary>
+        ///     Returns the <c>configurable</c> property of the descriptor.
+        /// </summary>
+        bool configurable()
+        {
+            return get_property<bool>(property_id::create(L"configurable"));
+        }
+
+        /// <summary>
+        ///     Sets the <c>enumerable</c> property of the descriptor.
+        /// </summary>
+        void set_configurable(bool value)
+        {
+            set_property(property_id::create(L"configurable"), value);
+        }
+
+        /// <summary>
+        ///     Returns the <c>value</c> property of the descriptor.
+        /// </summary>
+        T value()
+        {
+            return get_property<T>(property_id::create(L"value"));
+        }
+
+        /// <summary>
+        ///     Sets the <c>value</c> property of the descriptor.
+        /// </summary>
+        void set_value(T value)
+        {
+            set_property(property_id::create(L"value"), value);
+        }
+
+        /// <summary>
+        ///     Returns the <c>get</c> property of the descriptor.
+        /// </summary>
+        function<T> getter()
+        {
+            return get_property<function<T>>(property_id::create(L"get"));
+        }
+
+        /// <summary>
+        ///     Sets the <c>get</c> property of the descriptor.
+        /// </summary>
+        void set_getter(function<T> value)
+        {
+            set_property(property_id::create(L"get"), value);
+        }
+
+        /// <summary>
+        ///     Returns the <c>set</c> property of the descriptor.
+        /// </summary>
+        function<void, T> setter()
+        {
+            return get_property<function<void, T>>(property_id::create(L"set"));
+        }
+
+        /// <summary>
+        ///     Sets the <c>set</c> property of the descriptor.
+        /// </summary>
+        void set_setter(function<void, T> value)
+        {
+            set_property(property_id::create(L"set"), value);
+        }
+
+        /// <summary>
+        ///     Creates a new property descriptor.
+        /// </summary>
+        /// <returns>The new property descriptor.</returns>
+        static property_descriptor<T> create()
+        {
+            return static_cast<property_descriptor<T>>(object::create());
+        }
+
+        /// <summary>
+        ///     Creates a new property descriptor.
+        /// </summary>
+        /// <param name="getter">The property getter.</param>
+        /// <param name="setter">The property setter.</param>
+        /// <returns>The new property descriptor.</returns>
+        static property_descriptor<T> create(function<T> getter, function<void, T> setter)
+        {
+            property_descriptor<T> desc = static_cast<property_descriptor<T>>(object::create());
+            desc.set_getter(getter);
+            desc.set_setter(setter);
+            return desc;
+        }
+    };
+
+    /// <summary>
+    ///     Native numeric kernels over the contents of TypedArrays.
+    /// </summary>
+    /// <remarks>
+    ///     <para>
+    ///     The kernels operate directly on TypedArray storage and use SSE2 where it is available.
+    ///     They can be called from C++ or installed into a script context with <c>install</c>.
+    ///     </para>
+    ///     <para>
+    ///     Floating point results can differ in the last bits from a sequential JavaScript loop,
+    ///     because the vectorized kernels add elements in a different order.
+    ///     </para>
+    /// </remarks>
+    class numeric
+    {
+        static double dot_callback(const call_info &info, object left, object right);
+        static void prefix_sum_callback(const call_info &info, object input, object output);
+        static double min_callback(const call_info &info, object input);
+        static double max_callback(const call_info &info, object input);
+        static void histogram_callback(const call_info &info, object input, object bins, double low, double high);
+
+    public:
+        /// <summary>
+        ///     Computes the dot product of two arrays.
+        /// </summary>
+        /// <param name="left">The first array.</param>
+        /// <param name="right">The second array.</param>
+        /// <param name="count">The number of elements in each array.</param>
+        /// <returns>The sum of the products of the elements.</returns>
+        static double dot(const double *left, const double *right, size_t count);
+
+        /// <summary>
+        ///     Computes the dot product of two arrays.
+        /// </summary>
+        /// <remarks>
+        ///     As in JavaScript, the products and the sum are computed as doubles.
+        /// </remarks>
+        /// <param name="left">The first array.</param>
+        /// <param name="right">The second array.</param>
+        /// <param name="count">The number of elements in each array.</param>
+        /// <returns>The sum of the products of the elements.</returns>
+        static double dot(const int *left, const int *right, size_t count);
+
+        /// <summary>
+        ///     Computes the running sum of an array.
+        /// </summary>
+        /// <remarks>
+        ///     The input and output may be the same array.
+        /// </remarks>
+        /// <param name="input">The array to sum.</param>
+        /// <param name="output">The array that receives the running sums.</param>
+        /// <param name="count">The number of elements in each array.</param>
+        static void prefix_sum(const double *input, double *output, size_t count);
+
+        /// <summary>
+        ///     Computes the running sum of an array.
+        /// </summary>
+        /// <remarks>
+        ///     The input and output may be the same array. Sums wrap around on overflow, as they do
+        ///     when a sum is stored into an <c>Int32Array</c>.
+        /// </remarks>
+        /// <param name="input">The array to sum.</param>
+        /// <param name="output">The array that receives the running sums.</param>
+        /// <param name="count">The number of elements in each array.</param>
+        static void prefix_sum(const int *input, int *output, size_t count);
+
+        /// <summary>
+        ///     Finds the smallest element of an array.
+        /// </summary>
+        /// <param name="input">The array.</param>
+        /// <param name="count">The number of elements in the array.</param>
+        /// <returns>
+        ///     The smallest element, <c>NaN</c> if any element is <c>NaN</c>, or positive infinity if 
+        ///     the array is empty.
+        /// </returns>
+        static double min(const double *input, size_t count);
+
+        /// <summary>
+        ///     Finds the smallest element of an array.
+        /// </summary>
+        /// <param name="input">The array.</param>
+        /// <param name="count">The number of elements in the array.</param>
+        /// <returns>The smallest element, or positive infinity if the array is empty.</returns>
+        static double min(const int *input, size_t count);
+
+        /// <summary>
+        ///     Finds the largest element of an array.
+        /// </summary>
+        /// <param name="input">The array.</param>
+        /// <param name="count">The number of elements in the array.</param>
+        /// <returns>
+        ///     The largest element, <c>NaN</c> if any element is <c>NaN</c>, or negative infinity if 
+        ///     the array is empty.
+        /// </returns>
+        static double max(const double *input, size_t count);
+
+        /// <summary>
+        ///     Finds the largest element of an array.
+        /// </summary>
+        /// <param name="input">The array.</param>
+        /// <param name="count">The number of elements in the array.</param>
+        /// <returns>The largest element, or negative infinity if the array is empty.</returns>
+        static double max(const int *input, size_t count);
+
+        /// <summary>
+        ///     Counts the elements of an array that fall into equal-width bins.
+        /// </summary>
+        /// <remarks>
+        ///     The bins evenly divide the range [<c>low</c>, <c>high</c>). Elements outside of the
+        ///     range and <c>NaN</c> elements are not counted. The bins are cleared first.
+        /// </remarks>
+        /// <param name="input">The array.</param>
+        /// <param name="count">The number of elements in the array.</param>
+        /// <param name="low">The lowest value of the first bin.</param>
+        /// <param name="high">The value just above the last bin.</param>
+        /// <param name="bins">The array that receives the count for each bin.</param>
+        /// <param name="bin_count">The number of bins.</param>
+        static void histogram(const double *input, size_t count, double low, double high, unsigned int *bins, size_t bin_count);
+
+        /// <summary>
+        ///     Counts the elements of an array that fall into equal-width bins.
+        /// </summary>
+        /// <remarks>
+        ///     The bins evenly divide the range [<c>low</c>, <c>high</c>). Elements outside of the
+        ///     range are not counted. The bins are cleared first.
+        /// </remarks>
+        /// <param name="input">The array.</param>
+        /// <param name="count">The number of elements in the array.</param>
+        /// <param name="low">The lowest value of the first bin.</param>
+        /// <param name="high">The value just above the last bin.</param>
+        /// <param name="bins">The array that receives the count for each bin.</param>
+        /// <param name="bin_count">The number of bins.</param>
+        static void histogram(const int *input, size_t count, double low, double high, unsigned int *bins, size_t bin_count);
+
+        /// <summary>
+        ///     Installs the kernels as functions on an object.
+        /// </summary>
+        /// <remarks>
+        ///     <para>
+        ///     Requires an active script context.
+        ///     </para>
+        ///     <para>
+        ///     The functions installed are <c>dot(a, b)</c>, <c>prefixSum(input, output)</c>, 
+        ///     <c>min(a)</c>, <c>max(a)</c> and <c>histogram(input, bins, low, high)</c>. The arrays 
+        ///     passed to them must be <c>Float64Array</c> or <c>Int32Array</c> objects of matching 
+        ///     type and length, except that <c>bins</c> must be a <c>Uint32Array</c>. Any other 
+        ///     arguments cause a <c>TypeError</c>.
+        ///     </para>
+        /// </remarks>
+        /// <param name="target">The object to install the functions on.</param>
+        static void install(object target);
+    };
+
+    /// <summary>
+    ///     A queue that runs the promise tasks of a script context.
+    /// </summary>
+    /// <remarks>
+    ///     <para>
+    ///     <c>install</c> makes the queue the promise continuation callback of the current 
+    ///     context. Tasks are kept alive in a ring buffer that only allocates when it has to grow,
+    ///     and are run in order by <c>drain</c>, or after a script by <c>run</c> and 
+    ///     <c>evaluate</c>.
+    ///     </para>
+    ///     <para>
+    ///     A drain can be limited to a number of tasks or an amount of time, so that a context 
+    ///     that keeps queuing tasks cannot keep the thread from other work. Tasks that are not run
+    ///     stay queued for the next drain.
+    ///     </para>
+    ///     <para>
+    ///     The queue is stored in raw form by the context, so it must be kept alive as long as 
+    ///     the context can queue tasks, and destroyed before the runtime is disposed.
+    ///     </para>
+    /// </remarks>
+    class microtask_queue
+    {
+        JsContextRef _context;
+        JsErrorCode _error;
+        std::vector<JsValueRef> _tasks;
+        size_t _head;
+        size_t _count;
+        size_t _task_budget;
+        std::chrono::nanoseconds _time_budget;
+        size_t _max_depth;
+        unsigned long long _tasks_run;
+        unsigned long long _drains;
+        std::chrono::nanoseconds _last_drain_time;
+        std::chrono::nanoseconds _max_drain_time;
+
+        // Disallow copying, as the context holds a pointer to the queue.
+        microtask_queue(const microtask_queue&);
+        void operator=(const microtask_queue&);
+
+        static void CALLBACK enqueue_thunk(JsValueRef task, void *callbackState);
+
+        void enqueue(JsValueRef task);
+
+    public:
+        /// <summary>
+        ///     Statistics about a queue.
+        /// </summary>
+        struct statistics
+        {
+            /// <summary>
+            ///     The number of tasks waiting to run.
+            /// </summary>
+            size_t depth;
+
+            /// <summary>
+            ///     The largest number of tasks that have been waiting at once.
+            /// </summary>
+            size_t max_depth;
+
+            /// <summary>
+            ///     The number of tasks that have been run.
+            /// </summary>
+            unsigned long long tasks_run;
+
+            /// <summary>
+            ///     The number of drains that ran at least one task.
+            /// </summary>
+            unsigned long long drains;
+
+            /// <summary>
+            ///     How long the last drain that ran at least one task took.
+            /// </summary>
+            std::chrono::nanoseconds last_drain_time;
+
+            /// <summary>
+            ///     How long the longest drain took.
+            /// </summary>
+            std::chrono::nanoseconds max_drain_time;
+        };
+
+        /// <summary>
+        ///     Creates an empty queue.
+        /// </summary>
+        /// <param name="capacity">The number of tasks the queue can hold before it grows.</param>
+        explicit microtask_queue(size_t capacity = 256);
+
+        /// <summary>
+        ///     Removes the queue from the context it was installed in and releases any tasks that
+        ///     have not been run.
+        /// </summary>
+        ~microtask_queue();
+
+        /// <summary>
+        ///     Makes the queue the promise continuation callback of the current context.
+        /// </summary>
+        /// <remarks>
+        ///     Requires an active script context.
+        /// </remarks>
+        void install();
+
+        /// <summary>
+        ///     The largest number of tasks run by one drain, or 0 if there is no limit.
+        /// </summary>
+        size_t task_budget() const
+        {
+            return _task_budget;
+        }
+
+        /// <summary>
+        ///     Limits the number of tasks run by one drain.
+        /// </summary>
+        /// <param name="budget">The number of tasks, or 0 for no limit.</param>
+        void set_task_budget(size_t budget)
+        {
+            _task_budget = budget;
+        }
+
+        /// <summary>
+        ///     How long one drain can run tasks for, or 0 if there is no limit.
+        /// </summary>
+        std::chrono::nanoseconds time_budget() const
+        {
+            return _time_budget;
+        }
+
+        /// <summary>
+        ///     Limits how long one drain can run tasks for.
+        /// </summary>
+        /// <remarks>
+        ///     The time is checked between tasks, so at least one task is run by each drain and a 
+        ///     long task can overrun the budget.
+        /// </remarks>
+        /// <param name="budget">The time, or 0 for no limit.</param>
+        void set_time_budget(std::chrono::nanoseconds budget)
+        {
+            _time_budget = budget;
+        }
+
+        /// <summary>
+        ///     The number of tasks waiting to run.
+        /// </summary>
+        size_t depth() const
+        {
+            return _count;
+        }
+
+        /// <summary>
+        ///     Retrieves statistics about the queue.
+        /// </summary>
+        statistics stats() const;
+
+        /// <summary>
+        ///     Runs waiting tasks, including tasks queued by the tasks that are run, until the 
+        ///     queue is empty or a budget is used up.
+        /// </summary>
+        /// <remarks>
+        ///     <para>
+        ///     Requires an active script context.
+        ///     </para>
+        ///     <para>
+        ///     If a task throws, the drain stops and the exception is thrown as a 
+        ///     <c>script_exception</c>. The remaining tasks stay queued.
+        ///     </para>
+        ///     <para>
+        ///     If a task could not be queued, for example because the engine ran out of memory, 
+        ///     the error is thrown by the next drain before any task is run.
+        ///     </para>
+        /// </remarks>
+        /// <returns>The number of tasks that were run.</returns>
+        size_t drain();
+
+        /// <summary>
+        ///     Executes a script and then drains the queue.
+        /// </summary>
+        /// <remarks>
+        ///     Requires an active script context.
+        /// </remarks>
+        /// <param name="script">The script to run.</param>
+        void run(const std::wstring &script);
+
+        /// <summary>
+        ///     Executes a script and then drains the queue.
+        /// </summary>
+        /// <remarks>
+        ///     Requires an active script context.
+        /// </remarks>
+        /// <param name="script">The script to run.</param>
+        /// <returns>The result of the script, if any.</returns>
+        value evaluate(const std::wstring &script);
+    };
+
+    /// <summary>
+    ///     Specifies how worker threads are placed on the processors of the machine.
+    /// </summary>
+    enum class placement_policy
+    {
+        /// <summary>
+        ///     The operating system places the threads.
+        /// </summary>
+        none,
+
+        /// <summary>
+        ///     Each thread is pinned to one physical core, spreading the threads across NUMA nodes.
+        /// </summary>
+        cores,
+
+        /// <summary>
+        ///     Each thread is pinned to the processors of one NUMA node, spreading the threads 
+        ///     across nodes.
+        /// </summary>
+        nodes
+    };
+
+    /// <summary>
+    ///     Where a placement policy puts each worker thread of a pool.
+    /// </summary>
+    /// <remarks>
+    ///     <para>
+    ///     The processors are found when the placement is created. Worker <c>i</c> is put in slot
+    ///     <c>i</c> modulo the number of slots, and consecutive slots are on different NUMA 
+    ///     nodes, so a pool's threads, and the runtimes created on them, are spread across nodes.
+    ///     </para>
+    ///     <para>
+    ///     Memory is allocated from the node of the thread that first touches it, so a runtime 
+    ///     that is created and run by a thread pinned to a node keeps its heap on that node. If 
+    ///     the processors can't be found, there are no slots and threads aren't pinned.
+    ///     </para>
+    /// </remarks>
+    class thread_placement
+    {
+        struct slot
+        {
+            unsigned short group;
+            unsigned long long mask;
+            unsigned int node;
+        };
+
+        placement_policy _policy;
+        std::vector<slot> _slots;
+        size_t _node_count;
+
+    public:
+        /// <summary>
+        ///     Finds the processors to place threads on.
+        /// </summary>
+        /// <param name="policy">The placement policy.</param>
+        explicit thread_placement(placement_policy policy = placement_policy::none);
+
+        /// <summary>
+        ///     The placement policy.
+        /// </summary>
+        placement_policy policy() const
+        {
+            return _policy;
+        }
+
+        /// <summary>
+        ///     The number of NUMA nodes that have processors to place threads on.
+        /// </summary>
+        size_t node_count() const
+        {
+            return _node_count;
+        }
+
+        /// <summary>
+        ///     The number of places a thread can be pinned to, or 0 if threads aren't pinned.
+        /// </summary>
+        size_t size() const
+        {
+            return _slots.size();
+        }
+
+        /// <summary>
+        ///     The NUMA node that a worker is placed on.
+        /// </summary>
+        /// <param name="worker">The index of the worker.</param>
+        /// <returns>The node number, or 0 if threads aren't pinned.</returns>
+        unsigned int node_of(size_t worker) const
+        {
+            return _slots.empty() ? 0 : _slots[worker % _slots.size()].node;
+        }
+
+        /// <summary>
+        ///     Pins the calling thread to the place of a worker.
+        /// </summary>
+        /// <param name="worker">The index of the worker.</param>
+        /// <returns>Whether the thread was pinned.</returns>
+        bool apply(size_t worker) const;
+    };
+
+    /// <summary>
+    ///     A fixed set of worker threads that run native work.
+    /// </summary>
+    /// <remarks>
+    ///     Work is run in the order it is submitted. Work must not use script handles, as a 
+    ///     runtime can only be used by one thread at a time. The destructor waits for the work
+    ///     that has been submitted to finish.
+    /// </remarks>
+    class thread_pool
+    {
+        std::mutex _lock;
+        std::condition_variable _available;
+        std::deque<std::function<void()>> _work;
+        std::vector<std::thread> _threads;
+        thread_placement _placement;
+        bool _stopping;
+
+        // Disallow copying, as the workers hold a pointer to the pool.
+        thread_pool(const thread_pool&);
+        void operator=(const thread_pool&);
+
+        void work(size_t index);
+
+    public:
+        /// <summary>
+        ///     Starts the worker threads.
+        /// </summary>
+        /// <param name="thread_count">
+        ///     The number of threads, or 0 for the number of hardware threads.
+        /// </param>
+        /// <param name="placement">Where to place the worker threads.</param>
+        explicit thread_pool(unsigned int thread_count = 0, const thread_placement &placement = thread_placement());
+
+        /// <summary>
+        ///     Waits for submitted work to finish and stops the worker threads.
+        /// </summary>
+        ~thread_pool();
+
+        /// <summary>
+        ///     The number of worker threads.
+        /// </summary>
+        size_t size() const
+        {
+            return _threads.size();
+        }
+
+        /// <summary>
+        ///     Where the worker threads are placed.
+        /// </summary>
+        const thread_placement &placement() const
+        {
+            return _placement;
+        }
+
+        /// <summary>
+        ///     Queues work to run on a worker thread.
+        /// </summary>
+        /// <remarks>
+        ///     Can be called from any thread. If the work throws, the exception is ignored.
+        /// </remarks>
+        /// <param name="work">The work.</param>
+        void submit(std::function<void()> work);
+    };
+
+    /// <summary>
+    ///     A queue of completions that other threads post back to a runtime's thread.
+    /// </summary>
+    /// <remarks>
+    ///     <para>
+    ///     The runtime's thread calls <c>expect</c> before it starts work on another thread, and 
+    ///     the work posts a completion when it is done. The runtime's thread then runs the 
+    ///     completions with <c>drain</c>, so completions can use script handles. An 
+    ///     <c>event_loop</c> drains its queue and keeps running while completions are expected.
+    ///     </para>
+    ///     <para>
+    ///     Only <c>post</c> can be called from other threads.
+    ///     </para>
+    /// </remarks>
+    class completion_queue
+    {
+        mutable std::mutex _lock;
+        void *_posted;
+        void *_timer;
+        std::vector<std::function<void()>> _completions;
+        size_t _outstanding;
+
+        // Disallow copying, as other threads hold a pointer to the queue.
+        completion_queue(const completion_queue&);
+        void operator=(const completion_queue&);
+
+        void close_handles();
+
+    public:
+        /// <summary>
+        ///     Creates an empty queue.
+        /// </summary>
+        completion_queue();
+
+        /// <summary>
+        ///     Destroys the queue.
+        /// </summary>
+        ~completion_queue();
+
+        /// <summary>
+        ///     Notes that a completion will be posted.
+        /// </summary>
+        void expect()
+        {
+            _outstanding++;
+        }
+
+        /// <summary>
+        ///     The number of expected completions that have not been run.
+        /// </summary>
+        size_t outstanding() const
+        {
+            return _outstanding;
+        }
+
+        /// <summary>
+        ///     Whether any completions have been posted and not run.
+        /// </summary>
+        bool ready() const;
+
+        /// <summary>
+        ///     Posts a completion to run on the runtime's thread.
+        /// </summary>
+        /// <remarks>
+        ///     Can be called from any thread. Each completion is matched with an earlier call to 
+        ///     <c>expect</c>.
+        /// </remarks>
+        /// <param name="completion">The completion.</param>
+        void post(std::function<void()> completion);
+
+        /// <summary>
+        ///     Waits until a completion is posted or a time is reached.
+        /// </summary>
+        /// <remarks>
+        ///     The time is waited for with a high-resolution waitable timer where the system has 
+        ///     one, so the wait isn't rounded up to a scheduler tick.
+        /// </remarks>
+        /// <param name="deadline">The time to stop waiting.</param>
+        /// <returns>Whether any completions are ready to run.</returns>
+        bool wait_until(std::chrono::steady_clock::time_point deadline);
+
+        /// <summary>
+        ///     Runs the completions that have been posted.
+        /// </summary>
+        /// <remarks>
+        ///     If a completion throws, the drain stops and the exception is rethrown. The 
+        ///     remaining completions stay queued.
+        /// </remarks>
+        /// <returns>The number of completions that were run.</returns>
+        size_t drain();
+    };
+
+    /// <summary>
+    ///     An event loop that runs timers and promise tasks for a script context.
+    /// </summary>
+    /// <remarks>
+    ///     <para>
+    ///     <c>install</c> adds native <c>setTimeout</c>, <c>setInterval</c>, <c>clearTimeout</c> 
+    ///     and <c>clearInterval</c> functions to the global object of the current context and 
+    ///     installs the loop's <c>microtask_queue</c>. The promise tasks are drained after each 
+    ///     timer callback.
+    ///     </para>
+    ///     <para>
+    ///     The loop also runs the completions that other threads post to its 
+    ///     <c>completion_queue</c>, and waits for expected completions as well as timers. Posting
+    ///     a completion wakes the loop.
+    ///     </para>
+    ///     <para>
+    ///     Timers are kept in a hierarchical timer wheel with a resolution of one millisecond, so 
+    ///     adding and clearing a timer takes constant time no matter how many are pending. Timers
+    ///     with the same deadline fire in the order they were created. <c>run</c> sleeps until the
+    ///     next deadline on a high-resolution timer, so that timers are not late by the length 
+    ///     of a scheduler tick.
+    ///     </para>
+    ///     <para>
+    ///     If a callback throws, the exception is thrown from <c>run</c> or <c>run_once</c> as a 
+    ///     <c>script_exception</c>; the loop can then be run again. The loop is stored in raw form
+    ///     by the context, so it must be kept alive as long as the context can call it.
+    ///     </para>
+    /// </remarks>
+    class event_loop
+    {
+        static const int slot_bits = 6;
+        static const int slot_count = 1 << slot_bits;
+        static const int level_count = 6;
+
+        struct timer
+        {
+            unsigned int id;
+            JsValueRef callback;
+            std::vector<JsValueRef> arguments;
+            unsigned long long deadline;
+            unsigned int interval;
+            bool repeat;
+            int level;
+            int slot;
+            timer *previous;
+            timer *next;
+        };
+
+        microtask_queue _microtasks;
+        completion_queue _completions;
+        std::chrono::steady_clock::time_point _start;
+        unsigned long long _now;
+        timer *_heads[level_count][slot_count];
+        timer *_tails[level_count][slot_count];
+        unsigned long long _occupied[level_count];
+        std::unordered_map<unsigned int, timer *> _timers;
+        std::vector<timer *> _free;
+        std::vector<unsigned int> _due;
+        size_t _next_due;
+        unsigned int _next_id;
+        bool _stopped;
+        JsContextRef _context;
+
+        // Disallow copying, as the context holds a pointer to the loop.
+        event_loop(const event_loop&);
+        void operator=(const event_loop&);
+
+        static JsValueRef CALLBACK set_timeout_thunk(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, void *callback_state);
+        static JsValueRef CALLBACK set_interval_thunk(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, void *callback_state);
+        static JsValueRef CALLBACK clear_thunk(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, void *callback_state);
+        static JsValueRef add_from_script(event_loop *loop, bool repeat, JsValueRef *arguments, unsigned short argument_count);
+
+        unsigned int add(JsValueRef callback, double delay, bool repeat, const JsValueRef *arguments, size_t argument_count);
+        void link(timer *entry);
+        void unlink(timer *entry);
+        void release(timer *entry);
+        void cascade(int level);
+        void collect(int slot);
+        void advance(unsigned long long target);
+        unsigned long long next_deadline() const;
+        unsigned long long elapsed() const;
+        void fire_due();
+
+    public:
+        /// <summary>
+        ///     Creates an event loop with no timers.
+        /// </summary>
+        event_loop();
+
+        /// <summary>
+        ///     Removes the timer functions from the context the loop was installed in and releases
+        ///     any timers that have not fired.
+        /// </summary>
+        ~event_loop();
+
+        /// <summary>
+        ///     Adds the timer functions to the global object of the current context and installs 
+        ///     the loop's microtask queue.
+        /// </summary>
+        /// <remarks>
+        ///     Requires an active script context.
+        /// </remarks>
+        void install();
+
+        /// <summary>
+        ///     The queue that runs the promise tasks of the context.
+        /// </summary>
+        microtask_queue &microtasks()
+        {
+            return _microtasks;
+        }
+
+        /// <summary>
+        ///     The queue that runs completions posted by other threads.
+        /// </summary>
+        completion_queue &completions()
+        {
+            return _completions;
+        }
+
+        /// <summary>
+        ///     The number of timers that are pending.
+        /// </summary>
+        size_t pending() const
+        {
+            return _timers.size();
+        }
+
+        /// <summary>
+        ///     Calls a function once after a delay.
+        /// </summary>
+        /// <param name="callback">The function.</param>
+        /// <param name="delay">The delay.</param>
+        /// <returns>The ID of the timer.</returns>
+        unsigned int set_timeout(function_base callback, std::chrono::milliseconds delay);
+
+        /// <summary>
+        ///     Calls a function repeatedly.
+        /// </summary>
+        /// <param name="callback">The function.</param>
+        /// <param name="interval">The time between calls.</param>
+        /// <returns>The ID of the timer.</returns>
+        unsigned int set_interval(function_base callback, std::chrono::milliseconds interval);
+
+        /// <summary>
+        ///     Cancels a timer.
+        /// </summary>
+        /// <param name="id">The ID of the timer. Unknown IDs are ignored.</param>
+        void clear(unsigned int id);
+
+        /// <summary>
+        ///     Runs the completions that have been posted and fires the timers that are due 
+        ///     without waiting.
+        /// </summary>
+        /// <remarks>
+        ///     Requires an active script context.
+        /// </remarks>
+        /// <returns>Whether any timers or completions are still pending.</returns>
+        bool run_once();
+
+        /// <summary>
+        ///     Runs timers, completions and promise tasks until no timers or completions are 
+        ///     pending or <c>stop</c> is called.
+        /// </summary>
+        /// <remarks>
+        ///     Requires an active script context.
+        /// </remarks>
+        void run();
+
+        /// <summary>
+        ///     Makes <c>run</c> return after the current callback.
+        /// </summary>
+        void stop()
+        {
+            _stopped = true;
+        }
+    };
+
+    /// <summary>
+    ///     Describes how a host collection looks up and enumerates the entries of a container.
+    /// </summary>
+    /// <remarks>
+    ///     The default traits work for associative containers such as <c>std::map</c> and 
+    ///     <c>std::unordered_map</c>. Specialize the traits to expose other containers.
+    /// </remarks>
+    template<class Container>
+    struct host_collection_traits
+    {
+        /// <summary>
+        ///     The type of the keys.
+        /// </summary>
+        typedef typename Container::key_type key_type;
+
+        /// <summary>
+        ///     The type of the values.
+        /// </summary>
+        typedef typename Container::mapped_type mapped_type;
+
+        /// <summary>
+        ///     Finds the value for a key.
+        /// </summary>
+        /// <returns>The value, or null if the container has no value for the key.</returns>
+        static const mapped_type *find(const Container &values, const key_type &key)
+        {
+            auto position = values.find(key);
+            return position == values.end() ? nullptr : &position->second;
+        }
+
+        /// <summary>
+        ///     Calls a callback with each key and value, stopping if the callback returns false.
+        /// </summary>
+        /// <returns>Whether every call returned true.</returns>
+        template<class Callback>
+        static bool for_each(const Container &values, Callback callback)
+        {
+            for (const auto &entry : values)
+            {
+                if (!callback(entry.first, entry.second))
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+    };
+
+    /// <summary>
+    ///     Describes how a host collection looks up and enumerates the entries of a vector.
+    /// </summary>
+    template<class T, class Allocator>
+    struct host_collection_traits<std::vector<T, Allocator>>
+    {
+        typedef int key_type;
+        typedef T mapped_type;
+
+        static const mapped_type *find(const std::vector<T, Allocator> &values, const key_type &key)
+        {
+            return key >= 0 && static_cast<size_t>(key) < values.size() ? &values[key] : nullptr;
+        }
+
+        template<class Callback>
+        static bool for_each(const std::vector<T, Allocator> &values, Callback callback)
+        {
+            for (size_t index = 0; index < values.size() && index <= INT_MAX; index++)
+            {
+                if (!callback(static_cast<int>(index), values[index]))
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+    };
+
+    /// <summary>
+    ///     A native container exposed to script without copying its contents.
+    /// </summary>
+    /// <remarks>
+    ///     <para>
+    ///     <c>create</c> moves a container into storage owned by an external object that has 
+    ///     native <c>get(key)</c>, <c>has(key)</c>, <c>keys()</c> and <c>forEach(callback)</c> 
+    ///     methods and a <c>size</c> property, like a read-only <c>Map</c>. <c>create_proxy</c> 
+    ///     instead returns a <c>Proxy</c> whose traps are native, so script can read entries as
+    ///     properties (<c>collection[key]</c>, <c>key in collection</c>, <c>Object.keys</c>).
+    ///     Either way, only the entries that script actually reads are marshalled. The storage is 
+    ///     freed when the object is collected.
+    ///     </para>
+    ///     <para>
+    ///     Keys and values are marshalled with <c>marshal</c>. A proxy converts property names to
+    ///     keys, so it only finds numeric keys when the name is the canonical string for the 
+    ///     number. The proxy's target has no prototype, so properties such as <c>toString</c> are
+    ///     undefined, and script cannot add, change or delete properties.
+    ///     </para>
+    ///     <para>
+    ///     The container can be changed from native code through <c>data</c>, but not while script
+    ///     is in the middle of <c>forEach</c>. A <c>host_collection</c> handle is only valid while
+    ///     its object is alive and, like other handles, does not keep the object alive unless it 
+    ///     is on the stack or the object has been referenced with <c>add_reference</c>.
+    ///     </para>
+    /// </remarks>
+    template<class Container>
+    class host_collection
+    {
+        typedef host_collection_traits<Container> traits;
+
+    public:
+        /// <summary>
+        ///     The type of the keys.
+        /// </summary>
+        typedef typename traits::key_type key_type;
+
+        /// <summary>
+        ///     The type of the values.
+        /// </summary>
+        typedef typename traits::mapped_type mapped_type;
+
+    private:
+        struct storage
+        {
+            const void *tag;
+            Container values;
+        };
+
+        object _object;
+        Container *_values;
+
+        host_collection(object target, Container *values) :
+            _object(target),
+            _values(values)
+        {
+        }
+
+        // Identifies the external data of collections of this type, so that the native methods
+        // can't be called on other external objects.
+        static const void *tag()
+        {
+            static const char tag = 0;
+            return &tag;
+        }
+
+        static void CALLBACK finalize(void *data)
+        {
+            delete static_cast<storage *>(data);
+        }
+
+        static storage *create_storage(Container &values, external_object *owner)
+        {
+            std::unique_ptr<storage> result(new storage { tag(), std::move(values) });
+            *owner = external_object::create(result.get(), finalize);
+            return result.release();
+        }
+
+        static Container *values_of(value target)
+        {
+            bool hasData = false;
+            void *data = nullptr;
+
+            if (target.is_valid() &&
+                JsHasExternalData(target.handle(), &hasData) == JsNoError && hasData &&
+                JsGetExternalData(target.handle(), &data) == JsNoError && data != nullptr &&
+                static_cast<storage *>(data)->tag == tag())
+            {
+                return &static_cast<storage *>(data)->values;
+            }
+
+            context::set_exception(error::create_type_error(L"Object is not a host collection."));
+            return nullptr;
+        }
+
+        static bool key_from_property(JsValueRef property, std::wstring *key, std::true_type)
+        {
+            return marshal::to_native(property, key) == JsNoError;
+        }
+
+        static bool key_from_property(JsValueRef property, key_type *key, std::false_type)
+        {
+            // Property names are strings, so only accept the canonical string of a number.
+            JsValueRef number;
+            JsValueRef canonical;
+            std::wstring name;
+            std::wstring canonicalName;
+            double numberValue;
+
+            if (marshal::to_native(property, &name) != JsNoError ||
+                JsConvertValueToNumber(property, &number) != JsNoError ||
+                JsConvertValueToString(number, &canonical) != JsNoError ||
+                marshal::to_native(canonical, &canonicalName) != JsNoError ||
+                name != canonicalName ||
+                JsNumberToDouble(number, &numberValue) != JsNoError)
+            {
+                return false;
+            }
+
+            if (std::is_integral<key_type>::value &&
+                (numberValue != std::floor(numberValue) ||
+                    numberValue < static_cast<double>((std::numeric_limits<key_type>::min)()) ||
+                    numberValue > static_cast<double>((std::numeric_limits<key_type>::max)())))
+            {
+                return false;
+            }
+
+            return marshal::to_native(number, key) == JsNoError;
+        }
+
+        static bool key_from_property(value property, key_type *key)
+        {
+            JsValueType type;
+            return JsGetValueType(property.handle(), &type) == JsNoError && type == JsString &&
+                key_from_property(property.handle(), key, std::is_same<key_type, std::wstring>());
+        }
+
+        static value from_native(const mapped_type &element)
+        {
+            JsValueRef result;
+            if (marshal::from_native(element, &result) != JsNoError)
+            {
+                context::set_exception(error::create_type_error(L"Could not convert value."));
+                return context::undefined();
+            }
+
+            return value(result);
+        }
+
+        static value get_callback(const call_info &info, value key)
+        {
+            Container *values = values_of(info.this_value());
+            key_type nativeKey;
+            if (values == nullptr || marshal::to_native(key.handle(), &nativeKey) != JsNoError)
+            {
+                return context::undefined();
+            }
+
+            const mapped_type *element = traits::find(*values, nativeKey);
+            return element == nullptr ? context::undefined() : from_native(*element);
+        }
+
+        static bool has_callback(const call_info &info, value key)
+        {
+            Container *values = values_of(info.this_value());
+            key_type nativeKey;
+            return values != nullptr && marshal::to_native(key.handle(), &nativeKey) == JsNoError &&
+                traits::find(*values, nativeKey) != nullptr;
+        }
+
+        static double size_callback(const call_info &info)
+        {
+            Container *values = values_of(info.this_value());
+            return values == nullptr ? 0 : static_cast<double>(values->size());
+        }
+
+        static value keys(value target, bool as_strings)
+        {
+            Container *values = values_of(target);
+            if (values == nullptr)
+            {
+                return context::undefined();
+            }
+
+            JsValueRef result;
+            runtime::translate_error_code(JsCreateArray(0, &result));
+
+            int index = 0;
+            traits::for_each(*values, [&](const key_type &key, const mapped_type &)
+            {
+                JsValueRef indexValue;
+                JsValueRef keyValue;
+                runtime::translate_error_code(JsIntToNumber(index++, &indexValue));
+                runtime::translate_error_code(marshal::from_native(key, &keyValue));
+                if (as_strings)
+                {
+                    runtime::translate_error_code(JsConvertValueToString(keyValue, &keyValue));
+                }
+                runtime::translate_error_code(JsSetIndexedProperty(result, indexValue, keyValue));
+                return true;
+            });
+
+            return value(result);
+        }
+
+        static value keys_callback(const call_info &info)
+        {
+            return keys(info.this_value(), false);
+        }
+
+        static void for_each_callback(const call_info &info, value callback)
+        {
+            Container *values = values_of(info.this_value());
+            if (values == nullptr)
+            {
+                return;
+            }
+
+            JsValueType type;
+            runtime::translate_error_code(JsGetValueType(callback.handle(), &type));
+            if (type != JsFunction)
+            {
+                context::set_exception(error::create_type_error(L"Callback is not a function."));
+                return;
+            }
+
+            JsValueRef arguments[4];
+            runtime::translate_error_code(JsGetUndefinedValue(&arguments[0]));
+            arguments[3] = info.this_value().handle();
+
+            // If the callback throws, stop and leave the exception for the caller.
+            traits::for_each(*values, [&](const key_type &key, const mapped_type &element)
+            {
+                JsValueRef result;
+                if (marshal::from_native(element, &arguments[1]) != JsNoError || marshal::from_native(key, &arguments[2]) != JsNoError)
+                {
+                    context::set_exception(error::create_type_error(L"Could not convert value."));
+                    return false;
+                }
+
+                return JsCallFunction(callback.handle(), arguments, 4, &result) == JsNoError;
+            });
+        }
+
+        static value get_trap(const call_info &info, value target, value property)
+        {
+            Container *values = values_of(info.this_value());
+            key_type key;
+            if (values == nullptr || !key_from_property(property, &key))
+            {
+                return context::undefined();
+            }
+
+            const mapped_type *element = traits::find(*values, key);
+            return element == nullptr ? context::undefined() : from_native(*element);
+        }
+
+        static bool has_trap(const call_info &info, value target, value property)
+        {
+            Container *values = values_of(info.this_value());
+            key_type key;
+            return values != nullptr && key_from_property(property, &key) && traits::find(*values, key) != nullptr;
+        }
+
+        static value own_keys_trap(const call_info &info, value target)
+        {
+            return keys(info.this_value(), true);
+        }
+
+        static value descriptor_trap(const call_info &info, value target, value property)
+        {
+            Container *values = values_of(info.this_value());
+            key_type key;
+            if (values == nullptr || !key_from_property(property, &key))
+            {
+                return context::undefined();
+            }
+
+            const mapped_type *element = traits::find(*values, key);
+            if (element == nullptr)
+            {
+                return context::undefined();
+            }
+
+            object descriptor = object::create();
+            descriptor.set_property(property_id::create(L"value"), from_native(*element));
+            descriptor.set_property(property_id::create(L"writable"), false);
+            descriptor.set_property(property_id::create(L"enumerable"), true);
+            descriptor.set_property(property_id::create(L"configurable"), true);
+            return descriptor;
+        }
+
+        static bool read_only_trap(const call_info &info, value target, optional<value> property, optional<value> element, optional<value> receiver)
+        {
+            return false;
+        }
+
+    public:
+        /// <summary>
+        ///     Creates an invalid handle.
+        /// </summary>
+        host_collection() :
+            _object(),
+            _values(nullptr)
+        {
+        }
+
+        /// <summary>
+        ///     Whether the handle is valid.
+        /// </summary>
+        bool is_valid() const
+        {
+            return _values != nullptr;
+        }
+
+        /// <summary>
+        ///     The object that script uses to access the collection.
+        /// </summary>
+        object target() const
+        {
+            return _object;
+        }
+
+        /// <summary>
+        ///     The container.
+        /// </summary>
+        Container &data() const
+        {
+            return *_values;
+        }
+
+        /// <summary>
+        ///     Exposes a container to script as an object with <c>Map</c>-like methods.
+        /// </summary>
+        /// <remarks>
+        ///     Requires an active script context.
+        /// </remarks>
+        /// <param name="values">The container.</param>
+        /// <returns>A handle to the collection.</returns>
+        static host_collection create(Container values)
+        {
+            external_object target;
+            storage *data = create_storage(values, &target);
+
+            target.set_property(property_id::create(L"get"), function<value, value>::create(L"get", get_callback));
+            target.set_property(property_id::create(L"has"), function<bool, value>::create(L"has", has_callback));
+            target.set_property(property_id::create(L"keys"), function<value>::create(L"keys", keys_callback));
+            target.set_property(property_id::create(L"forEach"), function<void, value>::create(L"forEach", for_each_callback));
+
+            property_descriptor<double> size = property_descriptor<double>::create();
+            size.set_getter(function<double>::create(L"size", size_callback));
+            target.define_property(property_id::create(L"size"), size);
+
+            return host_collection(target, &data->values);
+        }
+
+        /// <summary>
+        ///     Exposes a container to script as a <c>Proxy</c> whose properties are its entries.
+        /// </summary>
+        /// <remarks>
+        ///     Requires an active script context.
+        /// </remarks>
+        /// <param name="values">The container.</param>
+        /// <returns>A handle to the collection.</returns>
+        static host_collection create_proxy(Container values)
+        {
+            external_object handler;
+            storage *data = create_storage(values, &handler);
+
+            handler.set_property(property_id::create(L"get"), function<value, value, value>::create(L"get", get_trap));
+            handler.set_property(property_id::create(L"has"), function<bool, value, value>::create(L"has", has_trap));
+            handler.set_property(property_id::create(L"ownKeys"), function<value, value>::create(L"ownKeys", own_keys_trap));
+            handler.set_property(property_id::create(L"getOwnPropertyDescriptor"), function<value, value, value>::create(L"getOwnPropertyDescriptor", descriptor_trap));
+
+            auto read_only = function<bool, value, optional<value>, optional<value>, optional<value>>::create(read_only_trap);
+            handler.set_property(property_id::create(L"set"), read_only);
+            handler.set_property(property_id::create(L"defineProperty"), read_only);
+            handler.set_property(property_id::create(L"deleteProperty"), read_only);
+            handler.set_property(property_id::create(L"preventExtensions"), read_only);
+
+            JsValueRef target;
+            JsValueRef null;
+            runtime::translate_error_code(JsCreateObject(&target));
+            runtime::translate_error_code(JsGetNullValue(&null));
+            runtime::translate_error_code(JsSetPrototype(target, null));
+
+            function_base proxy = context::global().get_property<function_base>(property_id::create(L"Proxy"));
+            return host_collection(object(proxy.construct({ value(target), handler })), &data->values);
+        }
+    };
+
+    /// <summary>
+    ///     An iterator that steps through a JavaScript iterator.
+    /// </summary>
+    /// <remarks>
+    ///     <para>
+    ///     Iterators are created by <c>iterable::begin</c>. Copies of an iterator share the same
+    ///     underlying JavaScript iterator, so advancing one advances them all.
+    ///     </para>
+    ///     <para>
+    ///     If the iterator is destroyed before the JavaScript iterator is finished, for example 
+    ///     by leaving a range-based for loop early, the JavaScript iterator's <c>return</c> method
+    ///     is called if it has one.
+    ///     </para>
+    /// </remarks>
+    template<class T>
+    class iterable_iterator
+    {
+        static_assert(!std::is_same<T, bool>::value, "Iterating bool elements is not supported; iterate over value instead.");
+
+        enum property
+        {
+            next_property,
+            done_property,
+            value_property,
+            return_property,
+            length_property
+        };
+
+        struct state
+        {
+            pinned<value> iterator;
+            pinned<value> next;
+            pinned<value> fill;
+            const JsPropertyIdRef *ids;
+            unsigned int batch_size;
+            std::vector<T> buffer;
+            size_t position;
+            bool exhausted;
+            bool done;
+
+            state(value iterator, value next, value fill, const JsPropertyIdRef *ids, unsigned int batch_size) :
+                iterator(iterator),
+                next(next),
+                fill(fill),
+                ids(ids),
+                batch_size(batch_size),
+                buffer(),
+                position(0),
+                exhausted(false),
+                done(false)
+            {
+            }
+
+            ~state()
+            {
+                if (!exhausted)
+                {
+                    close();
+                }
+            }
+
+            void close()
+            {
+                // Errors are ignored, because the iterator is being abandoned anyway.
+                JsValueRef method;
+                JsValueType type;
+                JsValueRef result;
+                JsValueRef thisValue = iterator->handle();
+
+                if (JsGetProperty(thisValue, ids[return_property], &method) == JsNoError &&
+                    JsGetValueType(method, &type) == JsNoError && type == JsFunction)
+                {
+                    JsCallFunction(method, &thisValue, 1, &result);
+                }
+            }
+
+            void fill_one()
+            {
+                // Assume the iterator is finished until it produces a value, so that an iterator
+                // that throws is not closed.
+                exhausted = true;
+
+                JsValueRef thisValue = iterator->handle();
+                JsValueRef result;
+                runtime::translate_error_code(JsCallFunction(next->handle(), &thisValue, 1, &result));
+
+                JsValueType type;
+                runtime::translate_error_code(JsGetValueType(result, &type));
+                if (type == JsUndefined || type == JsNull || type == JsNumber || type == JsString || type == JsBoolean || type == JsSymbol)
+                {
+                    runtime::translate_error_code(JsErrorInvalidArgument);
+                }
+
+                JsValueRef doneValue;
+                bool isDone;
+                runtime::translate_error_code(JsGetProperty(result, ids[done_property], &doneValue));
+                runtime::translate_error_code(JsConvertValueToBoolean(doneValue, &doneValue));
+                runtime::translate_error_code(JsBooleanToBool(doneValue, &isDone));
+                if (isDone)
+                {
+                    return;
+                }
+
+                exhausted = false;
+
+                JsValueRef elementValue;
+                runtime::translate_error_code(JsGetProperty(result, ids[value_property], &elementValue));
+                buffer.resize(1);
+                runtime::translate_error_code(marshal::to_native(elementValue, &buffer[0]));
+            }
+
+            void fill_batch()
+            {
+                exhausted = true;
+
+                JsValueRef arguments[4];
+                JsValueRef result;
+                runtime::translate_error_code(JsGetUndefinedValue(&arguments[0]));
+                arguments[1] = iterator->handle();
+                arguments[2] = next->handle();
+                runtime::translate_error_code(JsIntToNumber(static_cast<int>(batch_size), &arguments[3]));
+                runtime::translate_error_code(JsCallFunction(fill->handle(), arguments, 4, &result));
+
+                int count;
+                JsValueRef countValue;
+                runtime::translate_error_code(JsGetProperty(result, ids[length_property], &countValue));
+                runtime::translate_error_code(JsNumberToInt(countValue, &count));
+
+                // A short batch means that the iterator finished.
+                exhausted = static_cast<unsigned int>(count) < batch_size;
+                runtime::translate_error_code(marshal::to_native(result, &buffer));
+            }
+
+            void advance()
+            {
+                if (++position < buffer.size())
+                {
+                    return;
+                }
+
+                position = 0;
+                buffer.clear();
+
+                if (!exhausted)
+                {
+                    if (fill->is_valid())
+                    {
+                        fill_batch();
+                    }
+                    else
+                    {
+                        fill_one();
+                    }
+                }
+
+                done = buffer.empty();
+            }
+        };
+
+        std::shared_ptr<state> _state;
+
+        bool at_end() const
+        {
+            return !_state || _state->done;
+        }
+
+    public:
+        typedef std::input_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const T *pointer;
+        typedef const T &reference;
+
+        /// <summary>
+        ///     Constructs an iterator positioned at the end.
+        /// </summary>
+        iterable_iterator() :
+            _state()
+        {
+        }
+
+        /// <summary>
+        ///     Constructs an iterator positioned at the first element of a JavaScript iterator.
+        /// </summary>
+        /// <remarks>
+        ///     Requires an active script context.
+        /// </remarks>
+        /// <param name="iterator">The JavaScript iterator.</param>
+        /// <param name="fill">
+        ///     A function that retrieves a batch of elements, or an invalid value to retrieve one 
+        ///     element at a time.
+        /// </param>
+        /// <param name="batch_size">The number of elements in a batch.</param>
+        iterable_iterator(value iterator, value fill, unsigned int batch_size)
+        {
+            // The property IDs live as long as the runtime, so they are only resolved once.
+            static const std::vector<const wchar_t *> names = { L"next", L"done", L"value", L"return", L"length" };
+            const JsPropertyIdRef *ids;
+            JsValueRef next;
+            runtime::translate_error_code(property_id_cache::get(&names, names, &ids));
+            runtime::translate_error_code(JsGetProperty(iterator.handle(), ids[next_property], &next));
+            _state = std::make_shared<state>(iterator, value(next), fill, ids, batch_size);
+            _state->advance();
+        }
+
+        const T &operator*() const
+        {
+            return _state->buffer[_state->position];
+        }
+
+        const T *operator->() const
+        {
+            return &_state->buffer[_state->position];
+        }
+
+        iterable_iterator &operator++()
+        {
+            _state->advance();
+            return *this;
+        }
+
+        void operator++(int)
+        {
+            _state->advance();
+        }
+
+        bool operator==(const iterable_iterator &other) const
+        {
+            return at_end() ? other.at_end() : _state == other._state;
+        }
+
+        bool operator!=(const iterable_iterator &other) const
+        {
+            return !(*this == other);
+        }
+    };
+
+    /// <summary>
+    ///     A JavaScript value that can be iterated, such as an array, string, <c>Map</c>, 
+    ///     <c>Set</c> or generator.
+    /// </summary>
+    /// <remarks>
+    ///     <para>
+    ///     An <c>iterable</c> can be used in a range-based for loop. Each element is marshalled to
+    ///     <c>T</c>; an element that can't be converted throws an exception. <c>T</c> can't be 
+    ///     <c>bool</c>, because elements are buffered in a <c>std::vector</c>.
+    ///     </para>
+    ///     <para>
+    ///     By default, every element is a separate call to the iterator's <c>next</c> method. An
+    ///     iterable returned by <c>batched</c> instead retrieves elements in batches with one call
+    ///     into script each.
+    ///     </para>
+    /// </remarks>
+    template<class T>
+    class iterable : public value
+    {
+        unsigned int _batch_size;
+
+    public:
+        /// <summary>
+        ///     Creates an invalid handle.
+        /// </summary>
+        iterable() :
+            value(),
+            _batch_size(1)
+        {
+        }
+
+        /// <summary>
+        ///     Converts a <c>value</c> handle to an <c>iterable</c> handle.
+        /// </summary>
+        /// <remarks>
+        ///     The value is not checked until it is iterated.
+        /// </remarks>
+        explicit iterable(value iterable) :
+            value(iterable.handle()),
+            _batch_size(1)
+        {
+        }
+
+        /// <summary>
+        ///     The number of elements retrieved by each call into script.
+        /// </summary>
+        unsigned int batch_size() const
+        {
+            return _batch_size;
+        }
+
+        /// <summary>
+        ///     Retrieves elements in batches.
+        /// </summary>
+        /// <param name="batch_size">The number of elements to retrieve by each call into script.</param>
+        /// <returns>An iterable over the same value.</returns>
+        iterable batched(unsigned int batch_size) const
+        {
+            if (batch_size == 0 || batch_size > INT_MAX)
+            {
+                runtime::translate_error_code(JsErrorInvalidArgument);
+            }
+
+            iterable result(*this);
+            result._batch_size = batch_size;
+            return result;
+        }
+
+        /// <summary>
+        ///     Starts iterating.
+        /// </summary>
+        /// <remarks>
+        ///     Requires an active script context.
+        /// </remarks>
+        /// <returns>An iterator positioned at the first element.</returns>
+        iterable_iterator<T> begin() const
+        {
+            JsPropertyIdRef iteratorSymbol;
+            runtime::translate_error_code(property_id_cache::get_symbol(L"iterator", &iteratorSymbol));
+
+            // Primitives such as strings are iterable too, so look the method up on their wrapper.
+            JsValueRef target;
+            JsValueRef method;
+            JsValueType type;
+            runtime::translate_error_code(JsConvertValueToObject(handle(), &target));
+            runtime::translate_error_code(JsGetProperty(target, iteratorSymbol, &method));
+            runtime::translate_error_code(JsGetValueType(method, &type));
+            if (type != JsFunction)
+            {
+                runtime::translate_error_code(JsErrorInvalidArgument);
+            }
+
+            JsValueRef thisValue = handle();
+            JsValueRef iterator;
+            runtime::translate_error_code(JsCallFunction(method, &thisValue, 1, &iterator));
+
+            value fill;
+            if (_batch_size > 1)
+            {
+                static const wchar_t script[] =
+                    L"(function (iterator, next, count) {"
+                    L"  var result = [];"
+                    L"  while (result.length < count) {"
+                    L"    var step = next.call(iterator);"
+                    L"    if (Object(step) !== step) { throw new TypeError('Iterator result is not an object.'); }"
+                    L"    if (step.done) { break; }"
+                    L"    result.push(step.value);"
+                    L"  }"
+                    L"  return result;"
+                    L"})";
+                JsValueRef fillValue;
+                runtime::translate_error_code(property_id_cache::get_script(script, script, &fillValue));
+                fill = value(fillValue);
+            }
+
+            return iterable_iterator<T>(value(iterator), fill, _batch_size);
+        }
+
+        /// <summary>
+        ///     The end of the iteration.
+        /// </summary>
+        iterable_iterator<T> end() const
+        {
+            return iterable_iterator<T>();
+        }
+    };
+
+    /// <summary>
+    ///     Native sequences exposed to script as iterators.
+    /// </summary>
+    /// <remarks>
+    ///     <para>
+    ///     The iterators pull elements from native code as script asks for them, so large or
+    ///     unbounded sequences such as query cursors never have to be materialized. Elements are 
+    ///     marshalled to script with <c>marshal</c>. The native state is owned by an external 
+    ///     object and is released when the sequence finishes, when script calls the iterator's
+    ///     <c>return</c> method (for example by leaving a <c>for...of</c> loop early), or when 
+    ///     the iterator is collected.
+    ///     </para>
+    ///     <para>
+    ///     By default, each element is a separate call to native code. With a chunk size greater 
+    ///     than one, the iterator is a small script object that pulls elements from native code
+    ///     a chunk at a time. Numeric elements are delivered in TypedArrays.
+    ///     </para>
+    /// </remarks>
+    template<class T>
+    class host_iterator
+    {
+        static_assert(!std::is_same<T, bool>::value, "A host iterator can't produce bool elements.");
+
+        struct storage
+        {
+            const void *tag;
+            std::function<bool(T &)> next;
+        };
+
+        template<class Range>
+        struct range_state
+        {
+            typedef decltype(std::begin(std::declval<Range &>())) iterator;
+
+            Range range;
+            iterator position;
+
+            explicit range_state(Range &&range) :
+                range(std::move(range)),
+                position(std::begin(this->range))
+            {
+            }
+        };
+
+        enum property
+        {
+            value_property,
+            done_property
+        };
+
+        enum source_property
+        {
+            return_property,
+            next_property,
+            pull_property
+        };
+
+        static const void *tag()
+        {
+            static const char tag = 0;
+            return &tag;
+        }
+
+        static void CALLBACK finalize(void *data)
+        {
+            delete static_cast<storage *>(data);
+        }
+
+        static storage *storage_of(value target)
+        {
+            bool hasData = false;
+            void *data = nullptr;
+
+            if (target.is_valid() &&
+                JsHasExternalData(target.handle(), &hasData) == JsNoError && hasData &&
+                JsGetExternalData(target.handle(), &data) == JsNoError && data != nullptr &&
+                static_cast<storage *>(data)->tag == tag())
+            {
+                return static_cast<storage *>(data);
+            }
+
+            context::set_exception(error::create_type_error(L"Object is not a host iterator."));
+            return nullptr;
+        }
+
+        static bool pull(storage *data, T &element)
+        {
+            if (!data->next)
+            {
+                return false;
+            }
+
+            if (!data->next(element))
+            {
+                // Release the native state as soon as the sequence is finished.
+                data->next = nullptr;
+                return false;
+            }
+
+            return true;
+        }
+
+        static value result(JsValueRef element, bool done)
+        {
+            static const std::vector<const wchar_t *> names = { L"value", L"done" };
+            const JsPropertyIdRef *ids;
+            runtime::translate_error_code(property_id_cache::get(&names, names, &ids));
+
+            JsValueRef resultValue;
+            JsValueRef doneValue;
+            runtime::translate_error_code(JsCreateObject(&resultValue));
+            runtime::translate_error_code(JsBoolToBoolean(done, &doneValue));
+            runtime::translate_error_code(JsSetProperty(resultValue, ids[value_property], element, true));
+            runtime::translate_error_code(JsSetProperty(resultValue, ids[done_property], doneValue, true));
+            return value(resultValue);
+        }
+
+        static value next_callback(const call_info &info)
+        {
+            storage *data = storage_of(info.this_value());
+            if (data == nullptr)
+            {
+                return context::undefined();
+            }
+
+            T element = T();
+            if (!pull(data, element))
+            {
+                return result(context::undefined().handle(), true);
+            }
+
+            JsValueRef elementValue;
+            if (marshal::from_native(element, &elementValue) != JsNoError)
+            {
+                context::set_exception(error::create_type_error(L"Could not convert value."));
+                return context::undefined();
+            }
+
+            return result(elementValue, false);
+        }
+
+        static std::vector<T> pull_callback(const call_info &info, int count)
+        {
+            std::vector<T> elements;
+            storage *data = storage_of(info.this_value());
+            if (data == nullptr)
+            {
+                return elements;
+            }
+
+            if (count <= 0)
+            {
+                context::set_exception(error::create_type_error(L"Count must be positive."));
+                return elements;
+            }
+
+            T element = T();
+            while (elements.size() < static_cast<size_t>(count) && pull(data, element))
+            {
+                elements.push_back(element);
+            }
+
+            return elements;
+        }
+
+        static value return_callback(const call_info &info)
+        {
+            storage *data = storage_of(info.this_value());
+            if (data == nullptr)
+            {
+                return context::undefined();
+            }
+
+            data->next = nullptr;
+            return result(context::undefined().handle(), true);
+        }
+
+        static value iterator_callback(const call_info &info)
+        {
+            return info.this_value();
+        }
+
+    public:
+        /// <summary>
+        ///     Creates an iterator over the elements produced by a function.
+        /// </summary>
+        /// <remarks>
+        ///     Requires an active script context.
+        /// </remarks>
+        /// <param name="next">
+        ///     A function that stores the next element and returns true, or returns false when there
+        ///     are no more elements. It is not called again after it returns false.
+        /// </param>
+        /// <param name="chunk_size">The number of elements to pull from native code at a time.</param>
+        /// <returns>An object that is both an iterator and iterable.</returns>
+        static object create(std::function<bool(T &)> next, unsigned int chunk_size = 1)
+        {
+            if (!next || chunk_size == 0 || chunk_size > INT_MAX)
+            {
+                runtime::translate_error_code(JsErrorInvalidArgument);
+            }
+
+            std::unique_ptr<storage> data(new storage { tag(), std::move(next) });
+            external_object source = external_object::create(data.get(), finalize);
+            data.release();
+
+            static const std::vector<const wchar_t *> names = { L"return", L"next", L"pull" };
+            const JsPropertyIdRef *ids;
+            runtime::translate_error_code(property_id_cache::get(&names, names, &ids));
+            runtime::translate_error_code(JsSetProperty(source.handle(), ids[return_property], function<value>::create(L"return", return_callback).handle(), true));
+
+            if (chunk_size == 1)
+            {
+                JsPropertyIdRef iteratorSymbol;
+                runtime::translate_error_code(property_id_cache::get_symbol(L"iterator", &iteratorSymbol));
+                runtime::translate_error_code(JsSetProperty(source.handle(), ids[next_property], function<value>::create(L"next", next_callback).handle(), true));
+                runtime::translate_error_code(JsSetProperty(source.handle(), iteratorSymbol, function<value>::create(iterator_callback).handle(), true));
+                return source;
+            }
+
+            runtime::translate_error_code(JsSetProperty(source.handle(), ids[pull_property], function<std::vector<T>, int>::create(L"pull", pull_callback).handle(), true));
+
+            // The wrapper is built once per context and element type.
+            static const wchar_t script[] =
+                L"(function (source, count) {"
+                L"  var buffer = [], position = 0, done = false;"
+                L"  var iterator = {"
+                L"    next: function () {"
+                L"      if (position == buffer.length) {"
+                L"        if (done) { return { value: undefined, done: true }; }"
+                L"        buffer = source.pull(count);"
+                L"        position = 0;"
+                L"        done = buffer.length < count;"
+                L"        if (buffer.length == 0) { return { value: undefined, done: true }; }"
+                L"      }"
+                L"      return { value: buffer[position++], done: false };"
+                L"    },"
+                L"    return: function (value) {"
+                L"      done = true; buffer = []; position = 0; source.return();"
+                L"      return { value: value, done: true };"
+                L"    }"
+                L"  };"
+                L"  iterator[Symbol.iterator] = function () { return this; };"
+                L"  return iterator;"
+                L"})";
+            JsValueRef wrap;
+            runtime::translate_error_code(property_id_cache::get_script(script, script, &wrap));
+
+            JsValueRef arguments[3];
+            JsValueRef iterator;
+            runtime::translate_error_code(JsGetUndefinedValue(&arguments[0]));
+            arguments[1] = source.handle();
+            runtime::translate_error_code(JsIntToNumber(static_cast<int>(chunk_size), &arguments[2]));
+            runtime::translate_error_code(JsCallFunction(wrap, arguments, 3, &iterator));
+            return object(value(iterator));
+        }
+
+        /// <summary>
+        ///     Creates an iterator over the elements of a range.
+        /// </summary>
+        /// <remarks>
+        ///     Requires an active script context.
+        /// </remarks>
+        /// <param name="range">
+        ///     The range, which is moved into the iterator's native state. It can be any type 
+        ///     that works with a range-based for loop, and is only traversed once.
+        /// </param>
+        /// <param name="chunk_size">The number of elements to pull from native code at a time.</param>
+        /// <returns>An object that is both an iterator and iterable.</returns>
+        template<class Range>
+        static object from_range(Range range, unsigned int chunk_size = 1)
+        {
+            std::shared_ptr<range_state<Range>> state = std::make_shared<range_state<Range>>(std::move(range));
+            return create([state](T &element)
+            {
+                if (state->position == std::end(state->range))
+                {
+                    return false;
+                }
+
+                element = *state->position;
+                ++state->position;
+                return true;
+            }, chunk_size);
+        }
+    };
+
+    /// <summary>
+    ///     An exception used to indicate failure of a JsRT call.
+    /// </summary>
+    class exception
+    {
+    protected:
+        exception() { }
+    };
+
+    class invalid_argument_exception : public exception
+    {
+    };
+
+    class out_of_memory_exception : public exception
+    {
+    };
+
+    class in_disabled_state_exception : public exception
+    {
+    };
+
+    class null_argument_exception : public exception
+    {
+    };
+
+    class no_current_context_exception : public exception
+    {
+    };
+
+    class in_exception_state_exception : public exception
+    {
+    };
+
+    class not_implemented_exception : public exception
+    {
+    };
+
+    class wrong_thread_exception : public exception
+    {
+    };
+
+    class runtime_in_use_exception : public exception
+    {
+    };
+
+    class cannot_disable_execution_exception : public exception
+    {
+    };
+
+    class heap_enum_in_progress_exception : public exception
+    {
+    };
+
+    class argument_not_object_exception : public exception
+    {
+    };
+
+    class in_profile_callback_exception : public exception
+    {
+    };
+
+    class in_thread_service_callback_exception : public exception
+    {
+    };
+
+    class cannot_serialize_debug_script_exception : public exception
+    {
+    };
+
+    class already_debugging_context_exception : public exception
+    {
+    };
+
+    class already_profiling_context_exception : public exception
+    {
+    };
+
+    class idle_not_enabled_exception : public exception
+    {
+    };
+
+    class cannot_set_projection_enqueue_callback_exception : public exception
+    {
+    };
+
+    class cannot_start_projection_exception : public exception
+    {
+    };
+
+    class in_object_before_collect_callback_exception : public exception
+    {
+    };
+
+    class object_not_inspectable_exception : public exception
+    {
+    };
+
+    class property_not_symbol_exception : public exception
+    {
+    };
+
+    class property_not_string_exception : public exception
+    {
+    };
+
+    class bad_serialized_script_exception : public exception
+    {
+    };
+
+    class script_terminated_exception : public exception
+    {
+    };
+
+    class script_eval_disabled_exception : public exception
+    {
+    };
+
+    class fatal_exception : public exception
+    {
+    };
+
+    class script_exception : public exception
+    {
+        value _error;
+
+    public:
+        /// <summary>
+        ///     Creates a script exception with the specified error.
+        /// </summary>
+        /// <param name="error">The script error.</param>
+        script_exception(value error) :
+            _error(error)
+        {
+        }
+
+        /// <summary>
+        ///     The error object.
+        /// </summary>
+        value error() const
+        {
+            return _error;
+        }
+    };
+
+    /// <summary>
+    ///     A JavaScript error object representing a compilation error.
+    /// </summary>
+    class compile_error : public error
+    {
+        friend class runtime;
+        friend class value;
+
+        explicit compile_error(JsValueRef ref) :
+            error(ref)
+        {
+        }
+
+    public:
+        /// <summary>
+        ///     Creates an invalid handle.
+        /// </summary>
+        compile_error() :
+            error()
+        {
+        }
+
+        /// <summary>
+        ///     Converts the <c>value</c> handle to a compile error handle.
+        /// </summary>
+        /// <remarks>
+        ///     The type of the underlying value is not checked.
+        /// </remarks>
+        explicit compile_error(value object) :
+            error(object.handle())
+        {
+        }
+
+        /// <summary>
+        ///     The <c>message</c> property of the error.
+        /// </summary>
+        std::wstring message()
+        {
+            return get_property<std::wstring>(property_id::create(L"message"));
+        }
+
+        /// <summary>
+        ///     The <c>line</c> property of the error.
+        /// </summary>
+        double line()
+        {
+            return get_property<double>(property_id::create(L"line"));
+        }
+
+        /// <summary>
+        ///     The <c>column</c> property of the error.
+        /// </summary>
+        double column()
+        {
+            return get_property<double>(property_id::create(L"column"));
+        }
+
+        /// <summary>
+        ///     The <c>length</c> property of the error.
+        /// </summary>
+        double length()
+        {
+            return get_property<double>(property_id::create(L"length"));
+        }
+
+        /// <summary>
+        ///     The <c>source</c> property of the error.
+        /// </summary>
+        std::wstring source()
+        {
+            return get_property<std::wstring>(property_id::create(L"source"));
+        }
+    };
+
+    class script_compile_exception : public exception
+    {
+        compile_error _error;
+
+    public:
+        /// <summary>
+        ///     Creates a compile exception with the specified error.
+        /// </summary>
+        /// <param name="error">The compile error.</param>
+        script_compile_exception(compile_error error) :
+            _error(error)
+        {
+        }
+
+        /// <summary>
+        ///     The compile error.
+        /// </summary>
+        compile_error error() const
+        {
+            return _error;
+        }
+    };
+
+    /// <summary>
+    ///     A reference to a JavaScript promise.
+    /// </summary>
+    /// <remarks>
+    ///     <para>
+    ///     Native code can register continuations with <c>then</c>, which marshals the fulfillment
+    ///     value with <c>marshal</c>. A value that can't be converted rejects the continuation with
+    ///     a <c>TypeError</c>. Any object with a <c>then</c> method can be used as a promise.
+    ///     </para>
+    ///     <para>
+    ///     The class also implements the awaitable protocol (<c>await_ready</c>, 
+    ///     <c>await_suspend</c> and <c>await_resume</c>), so when coroutines are enabled a 
+    ///     coroutine can <c>co_await</c> a promise. The coroutine is resumed from the promise's 
+    ///     continuation with the fulfillment value, or <c>await_resume</c> throws a 
+    ///     <c>script_exception</c> holding the rejection reason.
+    ///     </para>
+    ///     <para>
+    ///     Continuations only run when the context's promise tasks are run, for example by a 
+    ///     <c>microtask_queue</c> or an <c>event_loop</c>, so many promises can be waiting on one 
+    ///     thread without blocking it.
+    ///     </para>
+    /// </remarks>
+    template<class T = value>
+    class promise : public object
+    {
+        struct reaction
+        {
+            std::function<void(const T &)> fulfilled;
+            std::function<void(value)> rejected;
+        };
+
+        struct settlement
+        {
+            bool rejected;
+            T result;
+            pinned<value> reason;
+        };
+
+        std::shared_ptr<settlement> _settlement;
+
+        static void CALLBACK release_reaction(JsRef ref, void *callbackState)
+        {
+            delete static_cast<std::shared_ptr<reaction> *>(callbackState);
+        }
+
+        static JsValueRef CALLBACK fulfilled_thunk(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, void *callback_state)
+        {
+            reaction &target = **static_cast<std::shared_ptr<reaction> *>(callback_state);
+            JsValueRef undefinedValue;
+            JsGetUndefinedValue(&undefinedValue);
+
+            try
+            {
+                T result = T();
+                if (marshal::to_native(argument_count > 1 ? arguments[1] : undefinedValue, &result) != JsNoError)
+                {
+                    target.rejected(error::create_type_error(L"Could not convert value."));
+                }
+                else
+                {
+                    target.fulfilled(result);
+                }
+            }
+            catch (...)
+            {
+                context::set_exception(error::create(L"Fatal error."));
+                return JS_INVALID_REFERENCE;
+            }
+
+            return undefinedValue;
+        }
+
+        static JsValueRef CALLBACK rejected_thunk(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, void *callback_state)
+        {
+            reaction &target = **static_cast<std::shared_ptr<reaction> *>(callback_state);
+            JsValueRef undefinedValue;
+            JsGetUndefinedValue(&undefinedValue);
+
+            try
+            {
+                target.rejected(value(argument_count > 1 ? arguments[1] : undefinedValue));
+            }
+            catch (...)
+            {
+                context::set_exception(error::create(L"Fatal error."));
+                return JS_INVALID_REFERENCE;
+            }
+
+            return undefinedValue;
+        }
+
+        static JsValueRef create_reaction(JsNativeFunction thunk, const std::shared_ptr<reaction> &target)
+        {
+            // Each function owns a reference to the shared state, which is released when the 
+            // function is collected after the promise settles.
+            std::unique_ptr<std::shared_ptr<reaction>> state(new std::shared_ptr<reaction>(target));
+            JsValueRef function;
+            runtime::translate_error_code(JsCreateFunction(thunk, state.get(), &function));
+            runtime::translate_error_code(JsSetObjectBeforeCollectCallback(function, state.get(), release_reaction));
+            state.release();
+            return function;
+        }
+
+    public:
+        /// <summary>
+        ///     Creates an invalid handle.
+        /// </summary>
+        promise() :
+            object()
+        {
+        }
+
+        /// <summary>
+        ///     Converts the <c>value</c> handle to a promise handle.
+        /// </summary>
+        /// <remarks>
+        ///     The type of the underlying value is not checked.
+        /// </remarks>
+        explicit promise(value object) :
+            jsrt::object(object.handle())
+        {
+        }
+
+        /// <summary>
+        ///     Registers native continuations for when the promise settles.
+        /// </summary>
+        /// <remarks>
+        ///     <para>
+        ///     Requires an active script context.
+        ///     </para>
+        ///     <para>
+        ///     Exactly one of the functions is called, from a promise task of the context. If a 
+        ///     function throws a native exception, the task fails with a <c>Fatal error.</c>.
+        ///     </para>
+        /// </remarks>
+        /// <param name="fulfilled">The function to call with the fulfillment value.</param>
+        /// <param name="rejected">The function to call with the rejection reason.</param>
+        void then(std::function<void(const T &)> fulfilled, std::function<void(value)> rejected) const
+        {
+            if (!fulfilled || !rejected)
+            {
+                runtime::translate_error_code(JsErrorInvalidArgument);
+            }
+
+            static const std::vector<const wchar_t *> names = { L"then" };
+            const JsPropertyIdRef *ids;
+            runtime::translate_error_code(property_id_cache::get(&names, names, &ids));
+
+            JsValueRef thenFunction;
+            JsValueType type;
+            runtime::translate_error_code(JsGetProperty(handle(), ids[0], &thenFunction));
+            runtime::translate_error_code(JsGetValueType(thenFunction, &type));
+            if (type != JsFunction)
+            {
+                runtime::translate_error_code(JsErrorInvalidArgument);
+            }
+
+            std::shared_ptr<reaction> target = std::make_shared<reaction>();
+            target->fulfilled = std::move(fulfilled);
+            target->rejected = std::move(rejected);
+
+            JsValueRef arguments[3];
+            JsValueRef result;
+            arguments[0] = handle();
+            arguments[1] = create_reaction(fulfilled_thunk, target);
+            arguments[2] = create_reaction(rejected_thunk, target);
+            runtime::translate_error_code(JsCallFunction(thenFunction, arguments, 3, &result));
+        }
+
+        /// <summary>
+        ///     Part of the awaitable protocol. A promise is never treated as already settled.
+        /// </summary>
+        bool await_ready() const
+        {
+            return false;
+        }
+
+        /// <summary>
+        ///     Part of the awaitable protocol. Resumes a coroutine when the promise settles.
+        /// </summary>
+        /// <remarks>
+        ///     Requires an active script context.
+        /// </remarks>
+        /// <param name="coroutine">The handle of the suspended coroutine.</param>
+        template<class Handle>
+        void await_suspend(Handle coroutine)
+        {
+            std::shared_ptr<settlement> state = std::make_shared<settlement>();
+            _settlement = state;
+
+            then(
+                [state, coroutine](const T &result) mutable
+                {
+                    state->rejected = false;
+                    state->result = result;
+                    coroutine();
+                },
+                [state, coroutine](value reason) mutable
+                {
+                    state->rejected = true;
+                    state->reason = pinned<value>(reason);
+                    coroutine();
+                });
+        }
+
+        /// <summary>
+        ///     Part of the awaitable protocol. Retrieves the settled value.
+        /// </summary>
+        /// <remarks>
+        ///     If the promise was rejected, a <c>script_exception</c> holding the rejection reason
+        ///     is thrown.
+        /// </remarks>
+        /// <returns>The fulfillment value.</returns>
+        T await_resume() const
+        {
+            if (!_settlement)
+            {
+                runtime::translate_error_code(JsErrorInvalidArgument);
+            }
+
+            if (_settlement->rejected)
+            {
+                throw script_exception(*_settlement->reason);
+            }
+
+            return _settlement->result;
+        }
+    };
+
+    /// <summary>
+    ///     A promise that is settled from native code.
+    /// </summary>
+    /// <remarks>
+    ///     <para>
+    ///     A <c>task</c> can be returned from a native function, in which case script receives its
+    ///     promise, and settled later with <c>resolve</c> or <c>reject</c>, for example when 
+    ///     asynchronous native work completes. Like in script, only the first call to 
+    ///     <c>resolve</c> or <c>reject</c> has any effect.
+    ///     </para>
+    ///     <para>
+    ///     The task keeps its promise and settling functions alive until it is settled or the 
+    ///     last copy of the task is destroyed.
+    ///     </para>
+    /// </remarks>
+    template<class T>
+    class task
+    {
+        friend class marshal;
+
+        struct state
+        {
+            pinned<object> target;
+            pinned<value> resolve;
+            pinned<value> reject;
+        };
+
+        std::shared_ptr<state> _state;
+
+        void settle(bool fulfilled, JsValueRef result) const
+        {
+            if (!_state)
+            {
+                runtime::translate_error_code(JsErrorInvalidArgument);
+            }
+
+            if (!_state->resolve->is_valid())
+            {
+                return;
+            }
+
+            JsValueRef function = fulfilled ? _state->resolve->handle() : _state->reject->handle();
+            JsValueRef arguments[2];
+            JsValueRef returnValue;
+            runtime::translate_error_code(JsGetUndefinedValue(&arguments[0]));
+            arguments[1] = result;
+            runtime::translate_error_code(JsCallFunction(function, arguments, 2, &returnValue));
+
+            _state->resolve.release();
+            _state->reject.release();
+        }
+
+    public:
+        /// <summary>
+        ///     Creates an invalid task.
+        /// </summary>
+        task()
+        {
+        }
+
+        /// <summary>
+        ///     Creates a task with a new pending promise.
+        /// </summary>
+        /// <remarks>
+        ///     Requires an active script context.
+        /// </remarks>
+        static task<T> create()
+        {
+            // The factory and the property IDs are resolved once per context and runtime.
+            static const wchar_t script[] =
+                L"(function () {"
+                L"  var parts = {};"
+                L"  parts.promise = new Promise(function (resolve, reject) {"
+                L"    parts.resolve = resolve; parts.reject = reject;"
+                L"  });"
+                L"  return parts;"
+                L"})";
+            static const std::vector<const wchar_t *> names = { L"promise", L"resolve", L"reject" };
+
+            JsValueRef factory;
+            const JsPropertyIdRef *ids;
+            JsValueRef undefinedValue;
+            JsValueRef parts;
+            JsValueRef partValues[3];
+            runtime::translate_error_code(property_id_cache::get_script(script, script, &factory));
+            runtime::translate_error_code(property_id_cache::get(&names, names, &ids));
+            runtime::translate_error_code(JsGetUndefinedValue(&undefinedValue));
+            runtime::translate_error_code(JsCallFunction(factory, &undefinedValue, 1, &parts));
+            for (int index = 0; index < 3; index++)
+            {
+                runtime::translate_error_code(JsGetProperty(parts, ids[index], &partValues[index]));
+            }
+
+            object promiseObject;
+            value resolveFunction;
+            value rejectFunction;
+            runtime::translate_error_code(marshal::to_native(partValues[0], &promiseObject));
+            runtime::translate_error_code(marshal::to_native(partValues[1], &resolveFunction));
+            runtime::translate_error_code(marshal::to_native(partValues[2], &rejectFunction));
+
+            task<T> result;
+            result._state = std::make_shared<state>();
+            result._state->target = pinned<object>(promiseObject);
+            result._state->resolve = pinned<value>(resolveFunction);
+            result._state->reject = pinned<value>(rejectFunction);
+            return result;
+        }
+
+        /// <summary>
+        ///     Whether the task has a promise.
+        /// </summary>
+        bool is_valid() const
+        {
+            return _state != nullptr;
+        }
+
+        /// <summary>
+        ///     Whether <c>resolve</c> or <c>reject</c> has been called.
+        /// </summary>
+        bool is_settled() const
+        {
+            return _state && !_state->resolve->is_valid();
+        }
+
+        /// <summary>
+        ///     The promise of the task.
+        /// </summary>
+        jsrt::promise<T> promise() const
+        {
+            if (!_state)
+            {
+                runtime::translate_error_code(JsErrorInvalidArgument);
+            }
+
+            return jsrt::promise<T>(*_state->target);
+        }
+
+        /// <summary>
+        ///     Fulfills the promise.
+        /// </summary>
+        /// <remarks>
+        ///     Requires an active script context.
+        /// </remarks>
+        /// <param name="result">The fulfillment value, which is converted with <c>marshal</c>.</param>
+        void resolve(const T &result) const
+        {
+            JsValueRef resultValue;
+            runtime::translate_error_code(marshal::from_native(result, &resultValue));
+            settle(true, resultValue);
+        }
+
+        /// <summary>
+        ///     Rejects the promise.
+        /// </summary>
+        /// <remarks>
+        ///     Requires an active script context.
+        /// </remarks>
+        /// <param name="reason">The rejection reason, usually an error.</param>
+        void reject(value reason) const
+        {
+            settle(false, reason.handle());
+        }
+    };
+
+    /// <summary>
+    ///     A script function whose native body runs on a thread pool.
+    /// </summary>
+    /// <remarks>
+    ///     <para>
+    ///     When script calls the function, the arguments are marshalled on the runtime's thread
+    ///     and script immediately receives a promise. The body runs on a <c>thread_pool</c>, and 
+    ///     the promise is settled back on the runtime's thread by a completion that the body 
+    ///     posts to an <c>event_loop</c>, which keeps running until the completion has run. The 
+    ///     promise is pinned until it settles.
+    ///     </para>
+    ///     <para>
+    ///     The promise is fulfilled with the marshalled result of the body, or with 
+    ///     <c>undefined</c> if <c>R</c> is <c>void</c>. If the body throws, the promise is 
+    ///     rejected with a <c>Fatal error.</c>. The parameters must be native types, as the body
+    ///     can't use script handles. Missing arguments are converted from <c>undefined</c>.
+    ///     </para>
+    /// </remarks>
+    template<class R, class... Parameters>
+    class async_function
+    {
+        typedef std::tuple<typename std::decay<Parameters>::type...> arguments_type;
+
+        struct state
+        {
+            std::function<R(Parameters...)> body;
+            thread_pool *pool;
+            event_loop *loop;
+        };
+
+        static void CALLBACK release_state(JsRef ref, void *callbackState)
+        {
+            delete static_cast<std::shared_ptr<state> *>(callbackState);
+        }
+
+        template<size_t... Indexes>
+        static bool unpack(JsValueRef *arguments, unsigned short argument_count, arguments_type &result, std::index_sequence<Indexes...>)
+        {
+            JsValueRef undefinedValue;
+            runtime::translate_error_code(JsGetUndefinedValue(&undefinedValue));
+
+            // Skip the this argument.
+            JsErrorCode errors[] = { JsNoError, marshal::to_native(Indexes + 1 < argument_count ? arguments[Indexes + 1] : undefinedValue, &std::get<Indexes>(result))... };
+            for (JsErrorCode error : errors)
+            {
+                if (error != JsNoError)
+                {
+                    context::set_exception(error::create_type_error(L"Could not convert value."));
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        template<size_t... Indexes>
+        static std::function<void()> invoke(const state &data, arguments_type &arguments, std::shared_ptr<task<value>> &pending, std::false_type, std::index_sequence<Indexes...>)
+        {
+            R result = data.body(std::get<Indexes>(arguments)...);
+            return [pending = std::move(pending), result = std::move(result)]()
+            {
+                JsValueRef resultValue;
+                if (marshal::from_native(result, &resultValue) != JsNoError)
+                {
+                    pending->reject(error::create_type_error(L"Could not convert value."));
+                    return;
+                }
+
+                pending->resolve(value(resultValue));
+            };
+        }
+
+        template<size_t... Indexes>
+        static std::function<void()> invoke(const state &data, arguments_type &arguments, std::shared_ptr<task<value>> &pending, std::true_type, std::index_sequence<Indexes...>)
+        {
+            data.body(std::get<Indexes>(arguments)...);
+            return [pending = std::move(pending)]()
+            {
+                pending->resolve(context::undefined());
+            };
+        }
+
+        static JsValueRef CALLBACK thunk(JsValueRef callee, bool is_construct_call, JsValueRef *arguments, unsigned short argument_count, void *callback_state)
+        {
+            std::shared_ptr<state> data = *static_cast<std::shared_ptr<state> *>(callback_state);
+
+            try
+            {
+                std::shared_ptr<arguments_type> nativeArguments = std::make_shared<arguments_type>();
+                if (!unpack(arguments, argument_count, *nativeArguments, std::index_sequence_for<Parameters...>()))
+                {
+                    return JS_INVALID_REFERENCE;
+                }
+
+                // The task is moved into the completion, so that it is only settled and released
+                // on the runtime's thread.
+                std::shared_ptr<task<value>> pending = std::make_shared<task<value>>(task<value>::create());
+                JsValueRef result = pending->promise().handle();
+
+                data->pool->submit([data, nativeArguments, pending]() mutable
+                {
+                    std::function<void()> completion;
+                    try
+                    {
+                        completion = invoke(*data, *nativeArguments, pending, std::is_void<R>(), std::index_sequence_for<Parameters...>());
+                    }
+                    catch (...)
+                    {
+                        completion = [pending = std::move(pending)]()
+                        {
+                            pending->reject(error::create(L"Fatal error."));
+                        };
+                    }
+                    data->loop->completions().post(std::move(completion));
+                });
+                data->loop->completions().expect();
+
+                return result;
+            }
+            catch (...)
+            {
+                context::set_exception(error::create(L"Fatal error."));
+                return JS_INVALID_REFERENCE;
+            }
+        }
+
+        static function_base create_function(JsValueRef name, std::function<R(Parameters...)> body, thread_pool &pool, event_loop &loop)
+        {
+            if (!body)
+            {
+                runtime::translate_error_code(JsErrorInvalidArgument);
+            }
+
+            std::unique_ptr<std::shared_ptr<state>> data(new std::shared_ptr<state>(std::make_shared<state>()));
+            (*data)->body = std::move(body);
+            (*data)->pool = &pool;
+            (*data)->loop = &loop;
+
+            JsValueRef function;
+            if (name == JS_INVALID_REFERENCE)
+            {
+                runtime::translate_error_code(JsCreateFunction(thunk, data.get(), &function));
+            }
+            else
+            {
+                runtime::translate_error_code(JsCreateNamedFunction(name, thunk, data.get(), &function));
+            }
+            runtime::translate_error_code(JsSetObjectBeforeCollectCallback(function, data.get(), release_state));
+            data.release();
+            return function_base(value(function));
+        }
+
+    public:
+        /// <summary>
+        ///     Creates a new function that runs a native body on a thread pool.
+        /// </summary>
+        /// <remarks>
+        ///     Requires an active script context. The pool and the loop must outlive the function
+        ///     and any calls that have not completed.
+        /// </remarks>
+        /// <param name="body">The native body, which runs on a worker thread.</param>
+        /// <param name="pool">The pool to run the body on.</param>
+        /// <param name="loop">The event loop of the runtime's thread.</param>
+        /// <returns>The new function.</returns>
+        static function_base create(std::function<R(Parameters...)> body, thread_pool &pool, event_loop &loop)
+        {
+            return create_function(JS_INVALID_REFERENCE, std::move(body), pool, loop);
+        }
+
+        /// <summary>
+        ///     Creates a new named function that runs a native body on a thread pool.
+        /// </summary>
+        /// <remarks>
+        ///     Requires an active script context. The pool and the loop must outlive the function
+        ///     and any calls that have not completed.
+        /// </remarks>
+        /// <param name="name">The name of the function.</param>
+        /// <param name="body">The native body, which runs on a worker thread.</param>
+        /// <param name="pool">The pool to run the body on.</param>
+        /// <param name="loop">The event loop of the runtime's thread.</param>
+        /// <returns>The new function.</returns>
+        static function_base create(const std::wstring &name, std::function<R(Parameters...)> body, thread_pool &pool, event_loop &loop)
+        {
+            return create_function(string::create(name).handle(), std::move(body), pool, loop);
+        }
+    };
+
+    /// <summary>
+    ///     A thread that owns a runtime and runs calls into it from other threads.
+    /// </summary>
+    /// <remarks>
+    ///     <para>
+    ///     The dispatcher creates a runtime and a context on its own thread and runs an 
+    ///     <c>event_loop</c> there, so script can use timers and promises. Any thread can queue a 
+    ///     call with <c>post</c> or <c>call</c> and receives a future for the result. The calls 
+    ///     are queued on a lock-free multiple-producer, single-consumer queue. Only the first 
+    ///     call queued since the dispatcher last drained the queue wakes its thread, and the 
+    ///     dispatcher runs every queued call in one batch.
+    ///     </para>
+    ///     <para>
+    ///     Native arguments and results are marshalled on the dispatcher's thread, so callers 
+    ///     never touch script handles. If a call throws, the exception is stored in the future; 
+    ///     the handle in a <c>script_exception</c> can only be used by code that the dispatcher runs.
+    ///     Exceptions thrown by timers are ignored.
+    ///     </para>
+    ///     <para>
+    ///     The destructor runs the calls that have been queued and then disposes the runtime.
+    ///     </para>
+    /// </remarks>
+    class runtime_dispatcher
+    {
+    public:
+        /// <summary>
+        ///     Statistics about a dispatcher.
+        /// </summary>
+        struct statistics
+        {
+            /// <summary>
+            ///     The number of calls that have been run.
+            /// </summary>
+            unsigned long long calls;
+
+            /// <summary>
+            ///     The number of batches of calls that have been run.
+            /// </summary>
+            unsigned long long batches;
+
+            /// <summary>
+            ///     The largest number of calls run in one batch.
+            /// </summary>
+            size_t largest_batch;
+        };
+
+    private:
+        struct call_node
+        {
+            std::atomic<call_node *> next;
+
+            // Runs the call if run is true, and then deletes it.
+            void (*complete)(call_node *call, bool run);
+        };
+
+        template<class R>
+        struct packaged_call : call_node
+        {
+            std::packaged_task<R()> task;
+
+            static void finish(call_node *call, bool run)
+            {
+                std::unique_ptr<packaged_call<R>> owner(static_cast<packaged_call<R> *>(call));
+                if (run)
+                {
+                    owner->task();
+                }
+            }
+        };
+
+        std::atomic<call_node *> _head;
+        call_node *_tail;
+        call_node _stub;
+        std::atomic<bool> _scheduled;
+        std::atomic<unsigned long long> _calls;
+        std::atomic<unsigned long long> _batches;
+        std::atomic<size_t> _largest_batch;
+        bool _stopping;
+        event_loop *_loop;
+        std::thread _thread;
+
+        // Disallow copying, as the dispatcher's thread holds a pointer to it.
+        runtime_dispatcher(const runtime_dispatcher&);
+        void operator=(const runtime_dispatcher&);
+
+        void link(call_node *call);
+        call_node *unlink();
+        void enqueue(call_node *call);
+        void drain();
+        void main(JsRuntimeAttributes attributes, std::promise<void> *started);
+
+    public:
+        /// <summary>
+        ///     Starts the dispatcher's thread and creates its runtime and context.
+        /// </summary>
+        /// <param name="attributes">The attributes of the runtime.</param>
+        explicit runtime_dispatcher(JsRuntimeAttributes attributes = JsRuntimeAttributeNone);
+
+        /// <summary>
+        ///     Runs the queued calls, disposes the runtime and stops the dispatcher's thread.
+        /// </summary>
+        /// <remarks>
+        ///     Must not be called by the dispatcher's thread.
+        /// </remarks>
+        ~runtime_dispatcher();
+
+        /// <summary>
+        ///     The ID of the dispatcher's thread.
+        /// </summary>
+        std::thread::id thread_id() const
+        {
+            return _thread.get_id();
+        }
+
+        /// <summary>
+        ///     Retrieves statistics about the dispatcher.
+        /// </summary>
+        statistics stats() const;
+
+        /// <summary>
+        ///     Queues work to run on the dispatcher's thread.
+        /// </summary>
+        /// <remarks>
+        ///     Can be called from any thread. The work runs with the dispatcher's context active, 
+        ///     so it can use script handles.
+        /// </remarks>
+        /// <param name="work">A function that takes no arguments.</param>
+        /// <returns>A future for the result of the work.</returns>
+        template<class Work>
+        auto post(Work work) -> std::future<decltype(work())>
+        {
+            typedef decltype(work()) result_type;
+
+            std::unique_ptr<packaged_call<result_type>> call(new packaged_call<result_type>());
+            call->complete = &packaged_call<result_type>::finish;
+            call->task = std::packaged_task<result_type()>(std::move(work));
+            std::future<result_type> result = call->task.get_future();
+            enqueue(call.release());
+            return result;
+        }
+
+        /// <summary>
+        ///     Queues a call to a function in the global object of the dispatcher's context.
+        /// </summary>
+        /// <remarks>
+        ///     Can be called from any thread. The arguments are copied and converted with 
+        ///     <c>marshal</c> on the dispatcher's thread, as is the result. As with 
+        ///     <c>function</c>, a <c>std::vector</c> as the last argument is passed as rest 
+        ///     arguments, one per element, not as an array.
+        /// </remarks>
+        /// <param name="name">The name of the function.</param>
+        /// <param name="arguments">The arguments, which must be native values.</param>
+        /// <returns>A future for the result of the call.</returns>
+        template<class R, class... Arguments>
+        std::future<R> call(const std::wstring &name, Arguments... arguments)
+        {
+            return post([name, arguments...]() -> R
+            {
+                function<R, Arguments...> target(context::global().get_property<value>(property_id::create(name)));
+                return target(context::undefined(), arguments...);
+            });
+        }
+    };
+
+    /// <summary>
+    ///     A set of worker threads, each with its own runtime, that run independent scripts.
+    /// </summary>
+    /// <remarks>
+    ///     <para>
+    ///     Scripts are added once with <c>add_script</c>. A script is source code that evaluates
+    ///     to a function, such as <c>(function (a, b) { return a + b; })</c>. The first worker
+    ///     that needs a script serializes it, and each worker loads the serialized script into
+    ///     its own context the first time it runs it and keeps the function for later tasks.
+    ///     </para>
+    ///     <para>
+    ///     <c>submit</c> queues a call of a script with native arguments and returns a future for
+    ///     the result. The arguments and the result are converted with <c>marshal</c> on the 
+    ///     worker's thread. Each worker has its own task queue. Submitted tasks are spread across
+    ///     the queues, tasks submitted by a worker go on its own queue, and a worker with nothing
+    ///     to do steals tasks from the other queues. Promise tasks queued by a script are run 
+    ///     after it returns.
+    ///     </para>
+    ///     <para>
+    ///     Each worker creates its runtime on its own thread, after the thread is placed, so a 
+    ///     runtime's memory stays on the NUMA node of its worker.
+    ///     </para>
+    ///     <para>
+    ///     The destructor runs the tasks that have been submitted and then disposes the runtimes.
+    ///     </para>
+    /// </remarks>
+    class script_executor
+    {
+    public:
+        /// <summary>
+        ///     Statistics about an executor.
+        /// </summary>
+        struct statistics
+        {
+            /// <summary>
+            ///     The number of tasks that have been run.
+            /// </summary>
+            unsigned long long tasks;
+
+            /// <summary>
+            ///     The number of tasks that were run by a worker other than the one they were 
+            ///     queued on.
+            /// </summary>
+            unsigned long long steals;
+        };
+
+    private:
+        struct worker;
+
+        struct task_node
+        {
+            // Runs the task on a worker, or abandons it if the worker is null, and then deletes it.
+            void (*finish)(task_node *task, worker *owner);
+        };
+
+        template<class R>
+        struct packaged_task_node : task_node
+        {
+            std::packaged_task<R(worker &)> task;
+
+            static void run(task_node *task, worker *owner)
+            {
+                std::unique_ptr<packaged_task_node<R>> node(static_cast<packaged_task_node<R> *>(task));
+                if (owner != nullptr)
+                {
+                    node->task(*owner);
+                }
+            }
+        };
+
+        struct worker
+        {
+            script_executor *executor;
+            std::mutex lock;
+            std::deque<task_node *> tasks;
+            std::vector<pinned<value>> scripts;
+            runtime script_runtime;
+            context script_context;
+            std::thread thread;
+        };
+
+        struct script_entry
+        {
+            std::wstring source;
+            std::vector<unsigned char> serialized;
+            std::once_flag serialize_once;
+        };
+
+        std::vector<std::unique_ptr<worker>> _workers;
+        std::mutex _scripts_lock;
+        std::deque<script_entry> _scripts;
+        std::mutex _lock;
+        std::condition_variable _available;
+        std::atomic<size_t> _pending;
+        std::atomic<size_t> _sleeping;
+        std::atomic<unsigned int> _next_worker;
+        std::atomic<unsigned long long> _tasks;
+        std::atomic<unsigned long long> _steals;
+        thread_placement _placement;
+        bool _stopping;
+
+        // The worker of the current thread, so that tasks submitted by a task stay on its queue.
+        static thread_local worker *current_worker;
+
+        // Disallow copying, as the workers hold a pointer to the executor.
+        script_executor(const script_executor&);
+        void operator=(const script_executor&);
+
+        void work(size_t index, JsRuntimeAttributes attributes, std::promise<void> *started);
+        void enqueue(task_node *task);
+        task_node *take(size_t index);
+        value load(worker &owner, unsigned int script);
+        void stop();
+
+    public:
+        /// <summary>
+        ///     Creates the runtimes and starts the worker threads.
+        /// </summary>
+        /// <param name="worker_count">
+        ///     The number of workers, or 0 for the number of hardware threads.
+        /// </param>
+        /// <param name="attributes">The attributes of the runtimes.</param>
+        /// <param name="placement">Where to place the worker threads.</param>
+        explicit script_executor(unsigned int worker_count = 0, JsRuntimeAttributes attributes = JsRuntimeAttributeNone, const thread_placement &placement = thread_placement());
+
+        /// <summary>
+        ///     Runs the submitted tasks, stops the worker threads and disposes the runtimes.
+        /// </summary>
+        /// <remarks>
+        ///     Must not be called by a worker.
+        /// </remarks>
+        ~script_executor();
+
+        /// <summary>
+        ///     The number of workers.
+        /// </summary>
+        size_t size() const
+        {
+            return _workers.size();
+        }
+
+        /// <summary>
+        ///     Where the worker threads are placed.
+        /// </summary>
+        const thread_placement &placement() const
+        {
+            return _placement;
+        }
+
+        /// <summary>
+        ///     Retrieves statistics about the executor.
+        /// </summary>
+        statistics stats() const;
+
+        /// <summary>
+        ///     Adds a script that tasks can call.
+        /// </summary>
+        /// <remarks>
+        ///     Can be called from any thread. The script is not parsed until a task uses it, so 
+        ///     syntax errors are reported through the futures of its tasks.
+        /// </remarks>
+        /// <param name="source">Source code that evaluates to a function.</param>
+        /// <returns>The ID of the script.</returns>
+        unsigned int add_script(const std::wstring &source);
+
+        /// <summary>
+        ///     Queues a call of a script.
+        /// </summary>
+        /// <remarks>
+        ///     Can be called from any thread. The arguments are copied and converted with 
+        ///     <c>marshal</c> on the worker's thread, as is the result. As with <c>function</c>,
+        ///     a <c>std::vector</c> as the last argument is passed as rest arguments, one per 
+        ///     element, not as an array.
+        /// </remarks>
+        /// <param name="script">The ID of the script.</param>
+        /// <param name="arguments">The arguments, which must be native values.</param>
+        /// <returns>A future for the result of the call.</returns>
+        template<class R, class... Arguments>
+        std::future<R> submit(unsigned int script, Arguments... arguments)
+        {
+            return post(script, [arguments...](value script_value) -> R
+            {
+                function<R, Arguments...> target(script_value);
+                return target(context::undefined(), arguments...);
+            });
+        }
+
+        /// <summary>
+        ///     Queues native work that uses a script.
+        /// </summary>
+        /// <remarks>
+        ///     Can be called from any thread. The work runs on a worker with the worker's context 
+        ///     active, so it can use script handles, and is passed the value of the script in that
+        ///     context.
+        /// </remarks>
+        /// <param name="script">The ID of the script.</param>
+        /// <param name="work">A function that takes the value of the script.</param>
+        /// <returns>A future for the result of the work.</returns>
+        template<class Work>
+        auto post(unsigned int script, Work work) -> std::future<decltype(work(value()))>
+        {
+            typedef decltype(work(value())) result_type;
+
+            std::unique_ptr<packaged_task_node<result_type>> task(new packaged_task_node<result_type>());
+            task->finish = &packaged_task_node<result_type>::run;
+            task->task = std::packaged_task<result_type(worker &)>([this, script, work](worker &owner) mutable -> result_type
+            {
+                return work(load(owner, script));
+            });
+            std::future<result_type> result = task->task.get_future();
+            enqueue(task.release());
+            return result;
+        }
+    };
+
+    /// <summary>
+    ///     Applies a script kernel to every element of a large buffer, using the workers of a 
+    ///     <c>script_executor</c>.
+    /// </summary>
+    /// <remarks>
+    ///     <para>
+    ///     The kernel is source code that evaluates to a function taking an element and its index 
+    ///     and returning the new element, such as <c>(function (x, i) { return x * x; })</c>. It is
+    ///     added to the executor once, so each worker loads it from the same serialized script.
+    ///     The kernel should be pure, as its calls run concurrently in different runtimes.
+    ///     </para>
+    ///     <para>
+    ///     <c>run</c> splits the buffer into chunks and maps the chunks concurrently. Each chunk 
+    ///     is passed to script as TypedArrays over the native input and output memory, so 
+    ///     nothing is copied, and the loop over the elements of a chunk runs in script. The 
+    ///     kernel must not keep references to the arrays.
+    ///     </para>
+    /// </remarks>
+    template<class T>
+    class parallel_map
+    {
+        // Chunk boundaries fall on cache lines of the output, so that chunks running on 
+        // different workers don't write to the same line.
+        static const size_t cache_line_size = 64;
+        static const size_t default_chunk_bytes = 64 * 1024;
+
+        script_executor *_executor;
+        unsigned int _script;
+
+        static std::wstring driver(const std::wstring &kernel)
+        {
+            return
+                L"(function (kernel) {"
+                L"  return function (input, output, offset) {"
+                L"    for (var i = 0, n = input.length; i < n; i++) { output[i] = kernel(input[i], offset + i); }"
+                L"  };"
+                L"})(" + kernel + L")";
+        }
+
+        static void map_chunk(value script, const T *input, T *output, size_t length, size_t offset)
+        {
+            JsValueRef arguments[4];
+            JsValueRef inputBuffer;
+            JsValueRef outputBuffer;
+            JsValueRef result;
+            unsigned int byteLength = static_cast<unsigned int>(length * sizeof(T));
+
+            runtime::translate_error_code(JsGetUndefinedValue(&arguments[0]));
+            runtime::translate_error_code(JsCreateExternalArrayBuffer(const_cast<T *>(input), byteLength, nullptr, nullptr, &inputBuffer));
+            runtime::translate_error_code(JsCreateTypedArray(typed_array_type<T, false>::type, inputBuffer, 0, static_cast<unsigned int>(length), &arguments[1]));
+            runtime::translate_error_code(JsCreateExternalArrayBuffer(output, byteLength, nullptr, nullptr, &outputBuffer));
+            runtime::translate_error_code(JsCreateTypedArray(typed_array_type<T, false>::type, outputBuffer, 0, static_cast<unsigned int>(length), &arguments[2]));
+            runtime::translate_error_code(JsDoubleToNumber(static_cast<double>(offset), &arguments[3]));
+            runtime::translate_error_code(JsCallFunction(script.handle(), arguments, 4, &result));
+        }
+
+    public:
+        /// <summary>
+        ///     Adds a kernel to an executor.
+        /// </summary>
+        /// <param name="executor">The executor, which must outlive the map.</param>
+        /// <param name="kernel">Source code that evaluates to the kernel function.</param>
+        parallel_map(script_executor &executor, const std::wstring &kernel) :
+            _executor(&executor),
+            _script(executor.add_script(driver(kernel)))
+        {
+        }
+
+        /// <summary>
+        ///     Maps the elements of a buffer into another buffer.
+        /// </summary>
+        /// <remarks>
+        ///     <para>
+        ///     Blocks until every chunk has been mapped, so it must not be called by a worker of 
+        ///     the executor. If the kernel throws, the first exception is rethrown after the other
+        ///     chunks finish.
+        ///     </para>
+        ///     <para>
+        ///     The input and output can be the same buffer.
+        ///     </para>
+        /// </remarks>
+        /// <param name="input">The elements to map.</param>
+        /// <param name="output">The buffer to write the mapped elements to.</param>
+        /// <param name="count">The number of elements.</param>
+        /// <param name="chunk_size">
+        ///     The number of elements in each chunk, or 0 to choose a size that fits in a 
+        ///     processor's cache.
+        /// </param>
+        void run(const T *input, T *output, size_t count, size_t chunk_size = 0) const
+        {
+            if (count == 0)
+            {
+                return;
+            }
+
+            if (input == nullptr || output == nullptr)
+            {
+                runtime::translate_error_code(JsErrorNullArgument);
+            }
+
+            const size_t line = (std::max)(cache_line_size / sizeof(T), static_cast<size_t>(1));
+            if (chunk_size == 0)
+            {
+                // Use cache-sized chunks, but make sure that every worker gets some.
+                chunk_size = (std::min)(default_chunk_bytes / sizeof(T), (count + _executor->size() - 1) / _executor->size());
+            }
+            chunk_size = (std::min)((chunk_size + line - 1) / line * line, static_cast<size_t>(UINT_MAX / sizeof(T)) / line * line);
+
+            // The first chunk is shortened to end on a line boundary if the output isn't aligned.
+            size_t lead = (cache_line_size - reinterpret_cast<std::uintptr_t>(output) % cache_line_size) % cache_line_size / sizeof(T);
+            size_t end = lead == 0 ? chunk_size : lead + chunk_size - line;
+
+            std::vector<std::future<void>> chunks;
+            chunks.reserve((count + chunk_size - 1) / chunk_size + 1);
+            for (size_t offset = 0; offset < count; offset = end, end += chunk_size)
+            {
+                size_t length = (std::min)(end, count) - offset;
+                chunks.push_back(_executor->post(_script, [input, output, length, offset](value script)
+                {
+                    map_chunk(script, input + offset, output + offset, length, offset);
+                }));
+            }
+
+            // Wait for every chunk before rethrowing, as the others still use the buffers.
+            std::exception_ptr failure;
+            for (std::future<void> &chunk : chunks)
+            {
+                try
+                {
+                    chunk.get();
+                }
+                catch (...)
+                {
+                    if (!failure)
+                    {
+                        failure = std::current_exception();
+                    }
+                }
+            }
+
+            if (failure)
+            {
+                std::rethrow_exception(failure);
+            }
+        }
+
+        /// <summary>
+        ///     Maps the elements of a vector into another vector.
+        /// </summary>
+        /// <remarks>
+        ///     Blocks until every chunk has been mapped, so it must not be called by a worker of 
+        ///     the executor.
+        /// </remarks>
+        /// <param name="input">The elements to map.</param>
+        /// <param name="output">The vector to write the mapped elements to, which is resized to fit.</param>
+        /// <param name="chunk_size">The number of elements in each chunk, or 0 to choose a size.</param>
+        void run(const std::vector<T> &input, std::vector<T> &output, size_t chunk_size = 0) const
+        {
+            output.resize(input.size());
+            run(input.data(), output.data(), input.size(), chunk_size);
+        }
+    };
+
+    /// <summary>
+    ///     Runs many runtimes on one thread, each on its own fiber.
+    /// </summary>
+    /// <remarks>
+    ///     <para>
+    ///     Each fiber created by <c>spawn</c> gets its own runtime and context, which are created, 
+    ///     used and disposed only on that fiber. <c>run</c> switches between the fibers that are 
+    ///     ready on the thread that calls it, so a thread can host thousands of mostly idle 
+    ///     runtimes. A fiber gives up the thread by calling <c>yield</c>, <c>suspend</c>, 
+    ///     <c>run_blocking</c> or <c>wait</c>.
+    ///     </para>
+    ///     <para>
+    ///     A runtime can only be left while it isn't running script, so a fiber can only give up
+    ///     the thread from native code that wasn't called by script, such as the body passed to 
+    ///     <c>spawn</c>. Doing so from a native function called by script throws a 
+    ///     <c>runtime_in_use_exception</c>.
+    ///     </para>
+    ///     <para>
+    ///     Work can be sent to a fiber from any thread with <c>post</c>. It runs on the fiber, 
+    ///     with the fiber's context active, the next time the fiber resumes, followed by the 
+    ///     context's promise tasks.
+    ///     </para>
+    /// </remarks>
+    class fiber_scheduler
+    {
+        struct fiber
+        {
+            fiber_scheduler *scheduler;
+            unsigned int id;
+            void *handle;
+            std::function<void()> body;
+            std::vector<std::function<void()>> inbox;
+            microtask_queue *microtasks;
+            bool queued;
+            bool finished;
+            std::exception_ptr failure;
+        };
+
+        std::mutex _lock;
+        std::condition_variable _ready_changed;
+        std::deque<fiber *> _ready;
+        std::map<unsigned int, std::unique_ptr<fiber>> _fibers;
+        unsigned int _next_id;
+        size_t _stack_size;
+        JsRuntimeAttributes _attributes;
+        void *_main_fiber;
+        bool _running;
+        std::thread::id _thread;
+
+        static thread_local fiber *current_fiber;
+
+        // Disallow copying, as the fibers hold a pointer to the scheduler.
+        fiber_scheduler(const fiber_scheduler&);
+        void operator=(const fiber_scheduler&);
+
+        static void CALLBACK start(void *parameter);
+        static fiber &running();
+
+        void schedule(fiber &target);
+        void leave(fiber &self);
+        void run_inbox(fiber &self);
+
+    public:
+        /// <summary>
+        ///     Creates a scheduler with no fibers.
+        /// </summary>
+        /// <param name="attributes">The attributes of the fibers' runtimes.</param>
+        /// <param name="stack_size">
+        ///     The size of the stack reserved for each fiber, or 0 to use the size of the 
+        ///     executable's default stack.
+        /// </param>
+        explicit fiber_scheduler(JsRuntimeAttributes attributes = JsRuntimeAttributeNone, size_t stack_size = 0);
+
+        /// <summary>
+        ///     Deletes the fibers that have not finished.
+        /// </summary>
+        /// <remarks>
+        ///     A fiber that has started but not finished is deleted without unwinding its stack, 
+        ///     so its runtime is never disposed. <c>run</c> should be allowed to finish instead.
+        /// </remarks>
+        ~fiber_scheduler();
+
+        /// <summary>
+        ///     The number of fibers that have not finished.
+        /// </summary>
+        size_t size();
+
+        /// <summary>
+        ///     Creates a fiber with its own runtime.
+        /// </summary>
+        /// <remarks>
+        ///     <para>
+        ///     Can be called before <c>run</c> or by a fiber of the scheduler. The fiber is ready
+        ///     to run; it creates its runtime and context when it first runs and then calls the 
+        ///     body with the context active. The fiber finishes when the body returns.
+        ///     </para>
+        /// </remarks>
+        /// <param name="body">The function to run on the fiber.</param>
+        /// <returns>The ID of the fiber.</returns>
+        unsigned int spawn(std::function<void()> body);
+
+        /// <summary>
+        ///     Queues work to run on a fiber and makes the fiber ready.
+        /// </summary>
+        /// <remarks>
+        ///     Can be called from any thread. If the work throws, the exception is thrown from the
+        ///     call that suspended the fiber.
+        /// </remarks>
+        /// <param name="id">The ID of the fiber.</param>
+        /// <param name="work">The work to run.</param>
+        void post(unsigned int id, std::function<void()> work);
+
+        /// <summary>
+        ///     Runs fibers on the calling thread until every fiber has finished.
+        /// </summary>
+        /// <remarks>
+        ///     <para>
+        ///     If no fiber is ready, the thread waits for <c>post</c> to make one ready, so a 
+        ///     fiber that suspends with nothing left to wake it keeps <c>run</c> from returning.
+        ///     </para>
+        ///     <para>
+        ///     If a fiber's body throws, the other fibers keep running and the first exception is
+        ///     rethrown when they have finished. The fiber's runtime has been disposed by then, so 
+        ///     the handle in a <c>script_exception</c> can't be used.
+        ///     </para>
+        /// </remarks>
+        void run();
+
+        /// <summary>
+        ///     The ID of the fiber that is running.
+        /// </summary>
+        /// <remarks>
+        ///     Must be called by a fiber of a scheduler.
+        /// </remarks>
+        static unsigned int current();
+
+        /// <summary>
+        ///     The scheduler of the fiber that is running.
+        /// </summary>
+        /// <remarks>
+        ///     Must be called by a fiber of a scheduler.
+        /// </remarks>
+        static fiber_scheduler &current_scheduler();
+
+        /// <summary>
+        ///     Lets the other ready fibers run before the running fiber continues.
+        /// </summary>
+        /// <remarks>
+        ///     Must be called by a fiber of a scheduler, outside of any call from script.
+        /// </remarks>
+        static void yield();
+
+        /// <summary>
+        ///     Gives up the thread until work is posted to the running fiber.
+        /// </summary>
+        /// <remarks>
+        ///     Must be called by a fiber of a scheduler, outside of any call from script. The 
+        ///     posted work and the context's promise tasks have run by the time it returns.
+        /// </remarks>
+        static void suspend();
+
+        /// <summary>
+        ///     Runs a blocking call on a thread pool, letting other fibers run until it finishes.
+        /// </summary>
+        /// <remarks>
+        ///     Must be called by a fiber of a scheduler, outside of any call from script. The call
+        ///     runs on a pool thread, so it must not use script handles. If work posted to the 
+        ///     fiber throws while it waits, the exception is thrown once the call has finished.
+        /// </remarks>
+        /// <param name="pool">The pool to run the call on.</param>
+        /// <param name="call">A function that takes no arguments.</param>
+        /// <returns>The result of the call.</returns>
+        template<class Call>
+        static auto run_blocking(thread_pool &pool, Call call) -> decltype(call())
+        {
+            typedef decltype(call()) result_type;
+
+            struct blocking_call
+            {
+                std::packaged_task<result_type()> task;
+                bool done;
+            };
+
+            fiber_scheduler &scheduler = current_scheduler();
+            unsigned int id = current();
+            std::shared_ptr<blocking_call> state = std::make_shared<blocking_call>();
+            state->task = std::packaged_task<result_type()>(std::move(call));
+            state->done = false;
+            std::future<result_type> result = state->task.get_future();
+
+            pool.submit([&scheduler, state, id]()
+            {
+                state->task();
+                scheduler.post(id, [state]() { state->done = true; });
+            });
+
+            // Work posted to the fiber can throw while it waits. The exception is held until the
+            // call is done, so that the pool thread doesn't post to a fiber that has finished.
+            std::exception_ptr failure;
+            while (!state->done)
+            {
+                try
+                {
+                    suspend();
+                }
+                catch (...)
+                {
+                    if (!failure)
+                    {
+                        failure = std::current_exception();
+                    }
+                }
+            }
+
+            if (failure)
+            {
+                std::rethrow_exception(failure);
+            }
+
+            return result.get();
+        }
+
+        /// <summary>
+        ///     Waits for a promise to settle, letting other fibers run until it does.
+        /// </summary>
+        /// <remarks>
+        ///     Must be called by a fiber of a scheduler, outside of any call from script. The 
+        ///     promise settles when the context's promise tasks run, so something must post to 
+        ///     the fiber if the promise doesn't settle from tasks that are already queued.
+        /// </remarks>
+        /// <param name="target">The promise to wait for.</param>
+        /// <returns>
+        ///     The fulfillment value. If the promise is rejected, a <c>script_exception</c> 
+        ///     holding the rejection reason is thrown.
+        /// </returns>
+        template<class T>
+        static T wait(promise<T> target)
+        {
+            fiber &self = running();
+
+            // The continuation can run after an exception has unwound this call, so the flag it
+            // sets isn't kept on the fiber's stack.
+            std::shared_ptr<bool> settled = std::make_shared<bool>(false);
+
+            target.await_suspend([settled]() { *settled = true; });
+            self.microtasks->drain();
+
+            while (!*settled)
+            {
+                suspend();
+            }
+
+            return target.await_resume();
+        }
+    };
+
+    /// <summary>
+    ///     A runtime that can be moved between threads by leasing it.
+    /// </summary>
+    /// <remarks>
+    ///     <para>
+    ///     A runtime can run on any thread, as long as it runs on only one thread at a time and 
+    ///     no context of it is current on the thread it leaves. A <c>runtime_handle</c> owns a 
+    ///     runtime and one context. <c>attach</c> leases the runtime to the calling thread with 
+    ///     the context current, and fails if the runtime is leased by another thread.
+    ///     </para>
+    ///     <para>
+    ///     <c>lease::detach</c> makes the previous context current again. It checks that the 
+    ///     lease's context is current and that no <c>context::scope</c> created under the lease 
+    ///     is still alive. It can't tell whether a reference added with <c>add_reference</c> 
+    ///     (such as a <c>pinned</c> value) that was created under the lease is still alive, so 
+    ///     those must be released before the lease detaches, as they would use the runtime from
+    ///     this thread after it moves.
+    ///     </para>
+    ///     <para>
+    ///     Copies of a handle refer to the same runtime.
+    ///     </para>
+    /// </remarks>
+    class runtime_handle
+    {
+        struct state
+        {
+            mutable std::mutex lock;
+            runtime script_runtime;
+            context script_context;
+            bool attached;
+            std::thread::id thread;
+            unsigned long long migrations;
+        };
+
+        std::shared_ptr<state> _state;
+
+        static unsigned int scope_depth();
+
+    public:
+        /// <summary>
+        ///     A lease of a runtime to a thread.
+        /// </summary>
+        /// <remarks>
+        ///     The destructor detaches the runtime without the checks made by <c>detach</c>, so 
+        ///     a runtime whose lease didn't detach cleanly should only be attached to the same 
+        ///     thread again.
+        /// </remarks>
+        class lease
+        {
+            friend class runtime_handle;
+
+            std::shared_ptr<state> _state;
+            JsContextRef _previous;
+            unsigned int _depth;
+
+            // Disallow copying, as only one lease can hold a runtime.
+            lease(const lease&);
+            void operator=(const lease&);
+
+            lease(std::shared_ptr<state> attached, JsContextRef previous);
+
+        public:
+            /// <summary>
+            ///     Constructs a lease that holds no runtime.
+            /// </summary>
+            lease() :
+                _state(),
+                _previous(JS_INVALID_REFERENCE),
+                _depth(0)
+            {
+            }
+
+            /// <summary>
+            ///     Takes over another lease.
+            /// </summary>
+            /// <param name="other">The lease to take over, which holds no runtime afterwards.</param>
+            lease(lease &&other) :
+                _state(std::move(other._state)),
+                _previous(other._previous),
+                _depth(other._depth)
+            {
+            }
+
+            /// <summary>
+            ///     Detaches the runtime if the lease still holds it.
+            /// </summary>
+            ~lease();
+
+            /// <summary>
+            ///     Whether the lease holds a runtime.
+            /// </summary>
+            bool is_valid() const
+            {
+                return _state != nullptr;
+            }
+
+            /// <summary>
+            ///     Detaches the runtime from the thread, so it can be attached to another thread.
+            /// </summary>
+            /// <remarks>
+            ///     Must be called by the thread that attached the runtime. If a scope created 
+            ///     under the lease is still alive, another context is current, or script is 
+            ///     running, a <c>runtime_in_use_exception</c> is thrown and the lease still holds 
+            ///     the runtime.
+            /// </remarks>
+            void detach();
+        };
+
+        /// <summary>
+        ///     Constructs an invalid handle.
+        /// </summary>
+        runtime_handle() :
+            _state()
+        {
+        }
+
+        /// <summary>
+        ///     Creates a runtime and a context that are not attached to any thread.
+        /// </summary>
+        /// <param name="attributes">The attributes of the runtime.</param>
+        /// <returns>The handle.</returns>
+        static runtime_handle create(JsRuntimeAttributes attributes = JsRuntimeAttributeNone);
+
+        /// <summary>
+        ///     Whether the handle refers to a runtime that hasn't been disposed.
+        /// </summary>
+        bool is_valid() const;
+
+        /// <summary>
+        ///     Whether a thread holds a lease of the runtime.
+        /// </summary>
+        bool is_attached() const;
+
+        /// <summary>
+        ///     The last thread the runtime was attached to.
+        /// </summary>
+        std::thread::id thread_id() const;
+
+        /// <summary>
+        ///     The number of times the runtime has been attached to a different thread than the 
+        ///     last time.
+        /// </summary>
+        unsigned long long migrations() const;
+
+        /// <summary>
+        ///     The runtime.
+        /// </summary>
+        runtime script_runtime() const;
+
+        /// <summary>
+        ///     The context that a lease makes current.
+        /// </summary>
+        context script_context() const;
+
+        /// <summary>
+        ///     Leases the runtime to the calling thread and makes its context current.
+        /// </summary>
+        /// <remarks>
+        ///     If another lease holds the runtime, a <c>runtime_in_use_exception</c> is thrown.
+        /// </remarks>
+        /// <returns>The lease.</returns>
+        lease attach() const;
+
+        /// <summary>
+        ///     Disposes the runtime.
+        /// </summary>
+        /// <remarks>
+        ///     If a lease holds the runtime, a <c>runtime_in_use_exception</c> is thrown.
+        /// </remarks>
+        void dispose();
+    };
+
+    /// <summary>
+    ///     Runs the work of many runtimes on a few threads, moving runtimes from busy threads to
+    ///     idle ones.
+    /// </summary>
+    /// <remarks>
+    ///     <para>
+    ///     Each tenant added with <c>add_tenant</c> has its own runtime, which is placed on the 
+    ///     thread with the fewest tenants. Work posted to a tenant runs in batches on the 
+    ///     tenant's thread, under a lease of its runtime, followed by the context's promise tasks.
+    ///     Each thread runs one tenant at a time, so the work of a tenant never runs concurrently.
+    ///     </para>
+    ///     <para>
+    ///     <c>rebalance</c> compares how long each thread has spent running work since the last
+    ///     rebalance, and moves tenants that aren't running from the busiest thread to the least 
+    ///     busy one, as long as each move narrows the gap between them. The runtime of a moved 
+    ///     tenant is attached to its new thread by the next batch. A tenant whose lease can't 
+    ///     be detached cleanly, because a scope or a reference created by its work is still 
+    ///     alive, stays on its thread.
+    ///     </para>
+    ///     <para>
+    ///     A tenant's runtime is created by its thread. When the threads are pinned, tenants are
+    ///     spread across the NUMA nodes, and <c>rebalance</c> only moves a tenant to a thread on
+    ///     the same node, so that the runtime's memory stays local to the thread that uses it.
+    ///     </para>
+    /// </remarks>
+    class runtime_balancer
+    {
+    public:
+        /// <summary>
+        ///     Statistics about a balancer.
+        /// </summary>
+        struct statistics
+        {
+            /// <summary>
+            ///     The number of work items that have been run.
+            /// </summary>
+            unsigned long long tasks;
+
+            /// <summary>
+            ///     The number of times a tenant has been moved to another thread.
+            /// </summary>
+            unsigned long long migrations;
+        };
+
+    private:
+        struct tenant
+        {
+            runtime_handle handle;
+            std::unique_ptr<microtask_queue> microtasks;
+            std::deque<std::function<void()>> work;
+            size_t worker;
+            bool queued;
+            bool running;
+            bool movable;
+            bool starting;
+            std::chrono::nanoseconds busy;
+            std::promise<void> started;
+        };
+
+        struct worker
+        {
+            std::thread thread;
+            std::deque<tenant *> ready;
+            std::condition_variable available;
+            size_t tenants;
+            std::chrono::nanoseconds busy;
+        };
+
+        std::mutex _lock;
+        std::vector<std::unique_ptr<worker>> _workers;
+        std::vector<std::unique_ptr<tenant>> _tenants;
+        JsRuntimeAttributes _attributes;
+        thread_placement _placement;
+        unsigned long long _tasks;
+        unsigned long long _migrations;
+        bool _stopping;
+
+        // Disallow copying, as the worker threads hold a pointer to the balancer.
+        runtime_balancer(const runtime_balancer&);
+        void operator=(const runtime_balancer&);
+
+        void schedule(tenant &target);
+        void enqueue(unsigned int id, std::function<void()> work);
+        void work(size_t index);
+        void stop();
+
+    public:
+        /// <summary>
+        ///     Starts the worker threads.
+        /// </summary>
+        /// <param name="thread_count">
+        ///     The number of threads, or 0 to use the number of hardware threads.
+        /// </param>
+        /// <param name="attributes">The attributes of the tenants' runtimes.</param>
+        /// <param name="placement">Where to place the worker threads.</param>
+        explicit runtime_balancer(unsigned int thread_count = 0, JsRuntimeAttributes attributes = JsRuntimeAttributeNone, const thread_placement &placement = thread_placement());
+
+        /// <summary>
+        ///     Runs the posted work, stops the worker threads and disposes the runtimes.
+        /// </summary>
+        /// <remarks>
+        ///     Must not be called by a worker thread.
+        /// </remarks>
+        ~runtime_balancer();
+
+        /// <summary>
+        ///     The number of worker threads.
+        /// </summary>
+        size_t size() const
+        {
+            return _workers.size();
+        }
+
+        /// <summary>
+        ///     Where the worker threads are placed.
+        /// </summary>
+        const thread_placement &placement() const
+        {
+            return _placement;
+        }
+
+        /// <summary>
+        ///     Creates a tenant with its own runtime.
+        /// </summary>
+        /// <remarks>
+        ///     Can be called from any thread other than a worker thread. Waits for the tenant's 
+        ///     thread to create the runtime. If the runtime can't be created, the exception is 
+        ///     rethrown and no tenant is added.
+        /// </remarks>
+        /// <returns>The ID of the tenant.</returns>
+        unsigned int add_tenant();
+
+        /// <summary>
+        ///     The index of the worker thread that runs a tenant's work.
+        /// </summary>
+        /// <param name="id">The ID of the tenant.</param>
+        size_t worker_of(unsigned int id);
+
+        /// <summary>
+        ///     Moves tenants from the busiest worker thread to the least busy one.
+        /// </summary>
+        /// <remarks>
+        ///     When the threads are pinned, only threads on the busiest thread's NUMA node are 
+        ///     considered. Starts a new measurement of how busy each thread is.
+        /// </remarks>
+        /// <returns>The number of tenants that were moved.</returns>
+        size_t rebalance();
+
+        /// <summary>
+        ///     Retrieves statistics about the balancer.
+        /// </summary>
+        statistics stats();
+
+        /// <summary>
+        ///     Queues work for a tenant.
+        /// </summary>
+        /// <remarks>
+        ///     Can be called from any thread. The work runs with the tenant's context active, so it
+        ///     can use script handles, but it must release any references it adds before it 
+        ///     returns or the tenant can't be moved.
+        /// </remarks>
+        /// <param name="id">The ID of the tenant.</param>
+        /// <param name="work">A function that takes no arguments.</param>
+        /// <returns>A future for the result of the work.</returns>
+        template<class Work>
+        auto post(unsigned int id, Work work) -> std::future<decltype(work())>
+        {
+            typedef decltype(work()) result_type;
+
+            std::shared_ptr<std::packaged_task<result_type()>> task = std::make_shared<std::packaged_task<result_type()>>(std::move(work));
+            std::future<result_type> result = task->get_future();
+            enqueue(id, [task]() { (*task)(); });
+            return result;
+        }
+    };
+
+	template<class T>
+	inline JsErrorCode marshal::to_native(JsValueRef value, T *result)
+	{
+		return to_native_object(value, result, is_mapped_struct<T>());
+	}
+
+	template<class T>
+	inline JsErrorCode marshal::to_native(JsValueRef value, optional<T> *result)
+	{
+		JsValueType type;
+		JsErrorCode error = JsGetValueType(value, &type);
+		if (error != JsNoError)
+		{
+			return error;
+		}
+
+		if (type == JsUndefined)
+		{
+			*result = missing();
+			return JsNoError;
+		}
+
+		T innerValue;
+		error = to_native(value, &innerValue);
+
+		if (error != JsNoError)
+		{
+			return error;
+		}
+
+		*result = optional<T>(innerValue);
+		return JsNoError;
+	}
+
+	template<>
+	inline JsErrorCode marshal::to_native(JsValueRef value, symbol *result)
+	{
+		*result = symbol(value);
+		return JsNoError;
+	}
+
+	template<>
+	inline JsErrorCode marshal::to_native<int>(JsValueRef value, int *result)
+	{
+		return JsNumberToInt(value, result);
+	}
+
+	template<>
+	inline JsErrorCode marshal::to_native<double>(JsValueRef value, double *result)
+	{
+		return JsNumberToDouble(value, result);
+	}
+
+	template<>
+	inline JsErrorCode marshal::to_native<bool>(JsValueRef value, bool *result)
+	{
+		return JsBooleanToBool(value, result);
+	}
+
+	template<>
+	inline JsErrorCode marshal::to_native<std::wstring>(JsValueRef value, std::wstring *result)
+	{
+		JsValueType type;
+		JsErrorCode error = JsGetValueType(value, &type);
+		if (error != JsNoError)
+		{
+			return error;
+		}
+
+		if (type == JsNull)
+		{
+			*result = std::wstring();
+		}
+		else
+		{
+			const wchar_t *resultptr = nullptr;
+			size_t length;
+			error = JsStringToPointer(value, &resultptr, &length);
+			if (error == JsNoError)
+			{
+				*result = std::wstring(resultptr, length);
+			}
+		}
+		return error;
+	}
+
+	template<class T>
+	inline JsErrorCode marshal::from_native(T value, JsValueRef *result)
+	{
+		return from_native_object(value, result, is_mapped_struct<T>());
+	}
+
+	template<class T>
+	inline JsErrorCode marshal::from_native(optional<T> value, JsValueRef *result)
+	{
+		if (!value.has_value())
+		{
+			return JsGetUndefinedValue(result);
+		}
+
+		return from_native(value.value(), result);
+	}
+
+	template<>
+	inline JsErrorCode marshal::from_native(double value, JsValueRef *result)
+	{
+		return JsDoubleToNumber(value, result);
+	}
+
+	template<>
+	inline JsErrorCode marshal::from_native(int value, JsValueRef *result)
+	{
+		return JsIntToNumber(value, result);
+	}
+
+	template<>
+	inline JsErrorCode marshal::from_native(bool value, JsValueRef *result)
+	{
+		return JsBoolToBoolean(value, result);
+	}
+
+	template<>
+	inline JsErrorCode marshal::from_native(std::wstring value, JsValueRef *result)
+	{
+		if (value.empty())
+		{
+			return JsGetNullValue(result);
+		}
+		return JsPointerToString(value.c_str(), value.length(), result);
+	}
+
+	template<>
+	inline JsErrorCode marshal::from_native(const wchar_t *value, JsValueRef *result)
+	{
+		if (value == nullptr)
+		{
+			return JsGetNullValue(result);
+		}
+		return JsPointerToString(value, wcslen(value), result);
+	}
+
+	template<class T, unsigned int Rank, bool clamped>
+	inline JsErrorCode marshal::to_native(JsValueRef value, ndarray<T, Rank, clamped> *result)
+	{
+		JsValueType type;
+		JsErrorCode error = JsGetValueType(value, &type);
+		if (error != JsNoError)
+		{
+			return error;
+		}
+
+		JsValueRef data = value;
+		JsValueRef shape = JS_INVALID_REFERENCE;
+		JsValueRef strides = JS_INVALID_REFERENCE;
+		JsValueRef offset = JS_INVALID_REFERENCE;
+
+		// A bare TypedArray can stand in for a one-dimensional view.
+		if (type != JsTypedArray || Rank != 1)
+		{
+			error = get_named_property(value, L"data", &data);
+			if (error != JsNoError)
+			{
+				return error;
+			}
+
+			error = get_named_property(value, L"shape", &shape);
+			if (error != JsNoError)
+			{
+				return error;
+			}
+
+			error = get_named_property(value, L"strides", &strides);
+			if (error != JsNoError)
+			{
+				return error;
+			}
+
+			error = get_named_property(value, L"offset", &offset);
+			if (error != JsNoError)
+			{
+				return error;
+			}
+		}
+
+		unsigned char *storage;
+		unsigned int storageSize;
+		JsTypedArrayType arrayType;
+		int elementSize;
+		error = JsGetTypedArrayStorage(data, &storage, &storageSize, &arrayType, &elementSize);
+		if (error != JsNoError)
+		{
+			return error;
+		}
+
+		if (arrayType != typed_array_type<T, clamped>::type)
+		{
+			return JsErrorInvalidArgument;
+		}
+
+		unsigned int length = storageSize / elementSize;
+		std::array<unsigned int, Rank> shapeValues;
+		std::array<int, Rank> strideValues;
+		int offsetValue = 0;
+
+		if (shape == JS_INVALID_REFERENCE)
+		{
+			shapeValues[0] = length;
+		}
+		else
+		{
+			error = to_native_dimensions(shape, &shapeValues);
+			if (error != JsNoError)
+			{
+				return error;
+			}
+		}
+
+		if (strides != JS_INVALID_REFERENCE && JsGetValueType(strides, &type) == JsNoError && type != JsUndefined)
+		{
+			error = to_native_dimensions(strides, &strideValues);
+			if (error != JsNoError)
+			{
+				return error;
+			}
+		}
+		else
+		{
+			strideValues = ndarray<T, Rank, clamped>::row_major_strides(shapeValues);
+		}
+
+		if (offset != JS_INVALID_REFERENCE && JsGetValueType(offset, &type) == JsNoError && type != JsUndefined)
+		{
+			error = JsNumberToInt(offset, &offsetValue);
+			if (error != JsNoError)
+			{
+				return error;
+			}
+		}
+
+		if (!ndarray<T, Rank, clamped>::in_bounds(length, offsetValue, shapeValues, strideValues))
+		{
+			return JsErrorInvalidArgument;
+		}
+
+		*result = ndarray<T, Rank, clamped>(data, reinterpret_cast<T *>(storage), length, offsetValue, shapeValues, strideValues);
+		return JsNoError;
+	}
+
+	template<class T, unsigned int Rank, bool clamped>
+	inline JsErrorCode marshal::from_native(ndarray<T, Rank, clamped> value, JsValueRef *result)
+	{
+		if (!value.is_valid())
+		{
+			return JsErrorInvalidArgument;
+		}
+
+		JsValueRef shape;
+		JsValueRef strides;
+		JsValueRef offset;
+
+		JsErrorCode error = from_native_dimensions(value.shape(), &shape);
+		if (error != JsNoError)
+		{
+			return error;
+		}
+
+		error = from_native_dimensions(value.strides(), &strides);
+		if (error != JsNoError)
+		{
+			return error;
+		}
+
+		error = JsIntToNumber(value.offset(), &offset);
+		if (error != JsNoError)
+		{
+			return error;
+		}
+
+		error = JsCreateObject(result);
+		if (error != JsNoError)
+		{
+			return error;
+		}
+
+		error = set_named_property(*result, L"data", value.array().handle());
+		if (error != JsNoError)
+		{
+			return error;
+		}
+
+		error = set_named_property(*result, L"shape", shape);
+		if (error != JsNoError)
+		{
+			return error;
+		}
+
+		error = set_named_property(*result, L"strides", strides);
+		if (error != JsNoError)
+		{
+			return error;
+		}
+
+		return set_named_property(*result, L"offset", offset);
+	}
+
+	template<class T, bool clamped>
+	inline JsErrorCode marshal::to_native(JsValueRef value, typed_array<T, clamped> *result)
+	{
+		JsTypedArrayType type;
+		JsErrorCode error = JsGetTypedArrayInfo(value, &type, nullptr, nullptr, nullptr);
+		if (error != JsNoError)
+		{
+			return error;
+		}
+
+		if (type != typed_array_type<T, clamped>::type)
+		{
+			return JsErrorInvalidArgument;
+		}
+
+		*result = typed_array<T, clamped>(value);
+		return JsNoError;
+	}
+
+	template<class T>
+	inline JsErrorCode marshal::to_native(JsValueRef value, buffer_view<T> *result)
+	{
+		typedef typename std::remove_const<T>::type element_type;
+
+		JsValueType valueType;
+		JsErrorCode error = JsGetValueType(value, &valueType);
+		if (error != JsNoError)
+		{
+			return error;
+		}
+
+		unsigned char *storage;
+		unsigned int storageSize;
+
+		switch (valueType)
+		{
+		case JsTypedArray:
+			{
+				JsTypedArrayType arrayType;
+				int elementSize;
+				error = JsGetTypedArrayStorage(value, &storage, &storageSize, &arrayType, &elementSize);
+				if (error != JsNoError)
+				{
+					return error;
+				}
+
+				if (arrayType != typed_array_type<element_type, false>::type &&
+					!(std::is_same<element_type, unsigned char>::value && arrayType == JsArrayTypeUint8Clamped))
+				{
+					return JsErrorInvalidArgument;
+				}
+				break;
+			}
+
+		case JsArrayBuffer:
+			error = JsGetArrayBufferStorage(value, &storage, &storageSize);
+			break;
+
+		case JsDataView:
+			error = JsGetDataViewStorage(value, &storage, &storageSize);
+			break;
+
+		default:
+			return JsErrorInvalidArgument;
+		}
+
+		if (error != JsNoError)
+		{
+			return error;
+		}
+
+		// Raw buffers must hold a whole number of suitably aligned elements.
+		if (storageSize % sizeof(T) != 0 || reinterpret_cast<uintptr_t>(storage) % std::alignment_of<T>::value != 0)
+		{
+			return JsErrorInvalidArgument;
+		}
+
+		*result = buffer_view<T>(value, reinterpret_cast<T *>(storage), storageSize / sizeof(T));
+		return JsNoError;
+	}
+
+	template<class T>
+	inline JsErrorCode marshal::from_native(buffer_view<T> value, JsValueRef *result)
+	{
+		if (value._source == JS_INVALID_REFERENCE)
+		{
+			return JsErrorInvalidArgument;
+		}
+
+		*result = value._source;
+		return JsNoError;
+	}
+
+	template<class T, bool clamped>
+	inline JsErrorCode marshal::to_native_elements(JsValueRef value, std::vector<T> *result)
+	{
+		unsigned char *storage;
+		unsigned int storageSize;
+		JsTypedArrayType type;
+		int elementSize;
+		JsErrorCode error = JsGetTypedArrayStorage(value, &storage, &storageSize, &type, &elementSize);
+		if (error != JsNoError)
+		{
+			return error;
+		}
+
+		if (type != typed_array_type<T, clamped>::type)
+		{
+			return JsErrorInvalidArgument;
+		}
+
+		result->resize(storageSize / sizeof(T));
+		if (storageSize != 0)
+		{
+			memcpy(result->data(), storage, storageSize);
+		}
+		return JsNoError;
+	}
+
+	template<class T, bool clamped>
+	inline JsErrorCode marshal::from_native_elements(const std::vector<T> &value, JsValueRef *result)
+	{
+		if (value.size() > UINT_MAX / sizeof(T))
+		{
+			return JsErrorInvalidArgument;
+		}
+
+		unsigned int length = static_cast<unsigned int>(value.size());
+		JsValueRef buffer;
+		JsErrorCode error = JsCreateArrayBuffer(length * sizeof(T), &buffer);
+		if (error != JsNoError)
+		{
+			return error;
+		}
+
+		unsigned char *storage;
+		unsigned int storageSize;
+		error = JsGetArrayBufferStorage(buffer, &storage, &storageSize);
+		if (error != JsNoError)
+		{
+			return error;
+		}
+
+		if (storageSize != 0)
+		{
+			memcpy(storage, value.data(), storageSize);
+		}
+		return JsCreateTypedArray(typed_array_type<T, clamped>::type, buffer, 0, length, result);
+	}
+
+	template<class T>
+	inline JsErrorCode marshal::to_native(JsValueRef value, std::vector<T> *result)
+	{
+		return to_native_vector(value, result, is_typed_array_element<T>());
+	}
+
+	template<class T>
+	inline JsErrorCode marshal::from_native(const std::vector<T> &value, JsValueRef *result)
+	{
+		return from_native_vector(value, result, is_typed_array_element<T>());
+	}
+
+	template<class T>
+	inline JsErrorCode marshal::to_native_vector(JsValueRef value, std::vector<T> *result, std::true_type)
+	{
+		JsValueType type;
+		JsErrorCode error = JsGetValueType(value, &type);
+		if (error != JsNoError)
+		{
+			return error;
+		}
+
+		return type == JsTypedArray ? to_native_elements<T, false>(value, result) : to_native_array(value, result);
+	}
+
+	template<class T>
+	inline JsErrorCode marshal::to_native_vector(JsValueRef value, std::vector<T> *result, std::false_type)
+	{
+		return to_native_array(value, result);
+	}
+
+	template<class T>
+	inline JsErrorCode marshal::from_native_vector(const std::vector<T> &value, JsValueRef *result, std::true_type)
+	{
+		return from_native_elements<T, false>(value, result);
+	}
+
+	template<class T>
+	inline JsErrorCode marshal::from_native_vector(const std::vector<T> &value, JsValueRef *result, std::false_type)
+	{
+		return from_native_array(value, result);
+	}
+
+	template<class T, bool clamped>
+	inline JsErrorCode marshal::to_native(JsValueRef value, typed_result<T, clamped> *result)
+	{
+		return to_native_elements<T, clamped>(value, &result->values());
+	}
+
+	template<class T, bool clamped>
+	inline JsErrorCode marshal::from_native(const typed_result<T, clamped> &value, JsValueRef *result)
+	{
+		return from_native_elements<T, clamped>(value.values(), result);
+	}
+
+	template<class T>
+	inline JsErrorCode marshal::to_native_object(JsValueRef value, T *result, std::false_type)
+	{
+		*result = T(object(value));
+		return JsNoError;
+	}
+
+	template<class T>
+	inline JsErrorCode marshal::from_native_object(const T &value, JsValueRef *result, std::false_type)
+	{
+		*result = value.handle();
+		return JsNoError;
+	}
+
+	template<class T>
+	inline JsErrorCode marshal::struct_property_ids(const JsPropertyIdRef **result)
+	{
+		typedef decltype(struct_type<T>::fields()) fields_type;
+		static const std::vector<const wchar_t *> names = field_names(struct_type<T>::fields(), std::make_index_sequence<std::tuple_size<fields_type>::value>());
+		return property_id_cache::get(&names, names, result);
+	}
+
+	template<class T>
+	inline JsErrorCode marshal::field_to_native(JsValueRef object, JsPropertyIdRef id, T *result)
+	{
+		JsValueRef propertyValue;
+		JsErrorCode error = JsGetProperty(object, id, &propertyValue);
+		if (error != JsNoError)
+		{
+			return error;
+		}
+
+		return to_native(propertyValue, result);
+	}
+
+	template<class T>
+	inline JsErrorCode marshal::field_to_native(JsValueRef object, JsPropertyIdRef id, optional<T> *result)
+	{
+		JsValueRef propertyValue;
+		JsErrorCode error = JsGetProperty(object, id, &propertyValue);
+		if (error != JsNoError)
+		{
+			return error;
+		}
+
+		JsValueType type;
+		error = JsGetValueType(propertyValue, &type);
+		if (error != JsNoError)
+		{
+			return error;
+		}
+
+		if (type == JsUndefined)
+		{
+			*result = missing();
+			return JsNoError;
+		}
+
+		T innerValue;
+		error = to_native(propertyValue, &innerValue);
+		if (error != JsNoError)
+		{
+			return error;
+		}
+
+		*result = optional<T>(innerValue);
+		return JsNoError;
+	}
+
+	template<class T>
+	inline JsErrorCode marshal::field_from_native(JsValueRef object, JsPropertyIdRef id, const T &value)
+	{
+		JsValueRef propertyValue;
+		JsErrorCode error = from_native(value, &propertyValue);
+		if (error != JsNoError)
+		{
+			return error;
+		}
+
+		return JsSetProperty(object, id, propertyValue, true);
+	}
+
+	template<class T>
+	inline JsErrorCode marshal::field_from_native(JsValueRef object, JsPropertyIdRef id, const optional<T> &value)
+	{
+		if (!value.has_value())
+		{
+			return JsNoError;
+		}
 
-        /// <summary>
-        ///     Sets the <c>set</c> property of the descriptor.
-        /// </summary>
-        void set_setter(function<void, T> value)
-        {
-            set_property(property_id::create(L"set"), value);
-        }
+		return field_from_native(object, id, const_cast<optional<T> &>(value).value());
+	}
 
-        /// <summary>
-        ///     Creates a new property descriptor.
-        /// </summary>
-        /// <returns>The new property descriptor.</returns>
-        static property_descriptor<T> create()
-        {
-            return static_cast<property_descriptor<T>>(object::create());
-        }
+	template<class T, class Fields, size_t... Indexes>
+	inline JsErrorCode marshal::fields_to_native(JsValueRef value, T *result, const Fields &fields, const JsPropertyIdRef *ids, std::index_sequence<Indexes...>)
+	{
+		// The braced list runs the conversions in order, and each one only runs if the ones before it succeeded.
+		JsErrorCode error = JsNoError;
+		int converted[] = { 0, (error == JsNoError ? (error = field_to_native(value, ids[Indexes], &(result->*std::get<Indexes>(fields).member)), 0) : 0)... };
+		(void)converted;
+		return error;
+	}
 
-        /// <summary>
-        ///     Creates a new property descriptor.
-        /// </summary>
-        /// <param name="getter">The property getter.</param>
-        /// <param name="setter">The property setter.</param>
-        /// <returns>The new property descriptor.</returns>
-        static property_descriptor<T> create(function<T> getter, function<void, T> setter)
-        {
-            property_descriptor<T> desc = static_cast<property_descriptor<T>>(object::create());
-            desc.set_getter(getter);
-            desc.set_setter(setter);
-            return desc;
-        }
-    };
+	template<class T, class Fields, size_t... Indexes>
+	inline JsErrorCode marshal::fields_from_native(const T &value, JsValueRef result, const Fields &fields, const JsPropertyIdRef *ids, std::index_sequence<Indexes...>)
+	{
+		JsErrorCode error = JsNoError;
+		int converted[] = { 0, (error == JsNoError ? (error = field_from_native(result, ids[Indexes], value.*std::get<Indexes>(fields).member), 0) : 0)... };
+		(void)converted;
+		return error;
+	}
 
-    /// <summary>
-    ///     An exception used to indicate failure of a JsRT call.
-    /// </summary>
-    class exception
-    {
-    protected:
-        exception() { }
-    };
+	template<class T>
+	inline JsErrorCode marshal::to_native_object(JsValueRef value, T *result, std::true_type)
+	{
+		JsValueType type;
+		JsErrorCode error = JsGetValueType(value, &type);
+		if (error != JsNoError)
+		{
+			return error;
+		}
 
-    class invalid_argument_exception : public exception
-    {
-    };
+		if (type == JsUndefined || type == JsNull)
+		{
+			return JsErrorInvalidArgument;
+		}
 
-    class out_of_memory_exception : public exception
-    {
-    };
+		const JsPropertyIdRef *ids;
+		error = struct_property_ids<T>(&ids);
+		if (error != JsNoError)
+		{
+			return error;
+		}
 
-    class in_disabled_state_exception : public exception
-    {
-    };
+		auto fields = struct_type<T>::fields();
+		return fields_to_native(value, result, fields, ids, std::make_index_sequence<std::tuple_size<decltype(fields)>::value>());
+	}
 
-    class null_argument_exception : public exception
-    {
-    };
+	template<class T>
+	inline JsErrorCode marshal::from_native_object(const T &value, JsValueRef *result, std::true_type)
+	{
+		const JsPropertyIdRef *ids;
+		JsErrorCode error = struct_property_ids<T>(&ids);
+		if (error != JsNoError)
+		{
+			return error;
+		}
 
-    class no_current_context_exception : public exception
-    {
-    };
+		error = JsCreateObject(result);
+		if (error != JsNoError)
+		{
+			return error;
+		}
 
-    class in_exception_state_exception : public exception
-    {
-    };
+		auto fields = struct_type<T>::fields();
+		return fields_from_native(value, *result, fields, ids, std::make_index_sequence<std::tuple_size<decltype(fields)>::value>());
+	}
 
-    class not_implemented_exception : public exception
-    {
-    };
+	template<class T>
+	inline JsErrorCode marshal::to_native_array(JsValueRef value, std::vector<T> *result)
+	{
+		JsPropertyIdRef lengthId;
+		JsValueRef lengthValue;
+		int length;
 
-    class wrong_thread_exception : public exception
-    {
-    };
+		JsErrorCode error = JsGetPropertyIdFromName(L"length", &lengthId);
+		if (error != JsNoError)
+		{
+			return error;
+		}
 
-    class runtime_in_use_exception : public exception
-    {
-    };
+		error = JsGetProperty(value, lengthId, &lengthValue);
+		if (error != JsNoError)
+		{
+			return error;
+		}
 
-    class cannot_disable_execution_exception : public exception
-    {
-    };
+		error = JsNumberToInt(lengthValue, &length);
+		if (error != JsNoError)
+		{
+			return error;
+		}
 
-    class heap_enum_in_progress_exception : public exception
-    {
-    };
+		if (length < 0)
+		{
+			return JsErrorInvalidArgument;
+		}
 
-    class argument_not_object_exception : public exception
-    {
-    };
+		result->resize(length);
+		for (int index = 0; index < length; index++)
+		{
+			JsValueRef indexValue;
+			JsValueRef elementValue;
 
-    class in_profile_callback_exception : public exception
-    {
-    };
+			error = JsIntToNumber(index, &indexValue);
+			if (error != JsNoError)
+			{
+				return error;
+			}
 
-    class in_thread_service_callback_exception : public exception
-    {
-    };
+			error = JsGetIndexedProperty(value, indexValue, &elementValue);
+			if (error != JsNoError)
+			{
+				return error;
+			}
 
-    class cannot_serialize_debug_script_exception : public exception
-    {
-    };
+			T element;
+			error = to_native(elementValue, &element);
+			if (error != JsNoError)
+			{
+				return error;
+			}
 
-    class already_debugging_context_exception : public exception
-    {
-    };
+			(*result)[index] = std::move(element);
+		}
 
-    class already_profiling_context_exception : public exception
-    {
-    };
+		return JsNoError;
+	}
 
-    class idle_not_enabled_exception : public exception
-    {
-    };
+	template<class T>
+	inline JsErrorCode marshal::from_native_array(const std::vector<T> &value, JsValueRef *result)
+	{
+		if (value.size() > INT_MAX)
+		{
+			return JsErrorInvalidArgument;
+		}
 
-    class cannot_set_projection_enqueue_callback_exception : public exception
-    {
-    };
+		JsErrorCode error = JsCreateArray(static_cast<unsigned int>(value.size()), result);
+		if (error != JsNoError)
+		{
+			return error;
+		}
 
-    class cannot_start_projection_exception : public exception
-    {
-    };
+		for (size_t index = 0; index < value.size(); index++)
+		{
+			JsValueRef indexValue;
+			JsValueRef elementValue;
 
-    class in_object_before_collect_callback_exception : public exception
-    {
-    };
+			error = JsIntToNumber(static_cast<int>(index), &indexValue);
+			if (error != JsNoError)
+			{
+				return error;
+			}
 
-    class object_not_inspectable_exception : public exception
-    {
-    };
+			error = from_native(value[index], &elementValue);
+			if (error != JsNoError)
+			{
+				return error;
+			}
 
-    class property_not_symbol_exception : public exception
-    {
-    };
+			error = JsSetIndexedProperty(*result, indexValue, elementValue);
+			if (error != JsNoError)
+			{
+				return error;
+			}
+		}
 
-    class property_not_string_exception : public exception
-    {
-    };
+		return JsNoError;
+	}
 
-    class bad_serialized_script_exception : public exception
-    {
-    };
+	template<class T, size_t N>
+	inline JsErrorCode marshal::to_native(JsValueRef value, std::array<T, N> *result)
+	{
+		int length;
+		JsErrorCode error = array_length(value, &length);
+		if (error != JsNoError)
+		{
+			return error;
+		}
 
-    class script_terminated_exception : public exception
-    {
-    };
+		if (static_cast<size_t>(length) != N)
+		{
+			return JsErrorInvalidArgument;
+		}
 
-    class script_eval_disabled_exception : public exception
-    {
-    };
+		for (size_t index = 0; index < N; index++)
+		{
+			error = to_native_element(value, static_cast<int>(index), &(*result)[index]);
+			if (error != JsNoError)
+			{
+				return error;
+			}
+		}
 
-    class fatal_exception : public exception
-    {
-    };
+		return JsNoError;
+	}
 
-    class script_exception : public exception
-    {
-        value _error;
+	template<class T, size_t N>
+	inline JsErrorCode marshal::from_native(const std::array<T, N> &value, JsValueRef *result)
+	{
+		JsErrorCode error = JsCreateArray(static_cast<unsigned int>(N), result);
+		if (error != JsNoError)
+		{
+			return error;
+		}
 
-    public:
-        /// <summary>
-        ///     Creates a script exception with the specified error.
-        /// </summary>
-        /// <param name="error">The script error.</param>
-        script_exception(value error) :
-            _error(error)
-        {
-        }
+		for (size_t index = 0; index < N; index++)
+		{
+			error = from_native_element(*result, static_cast<int>(index), value[index]);
+			if (error != JsNoError)
+			{
+				return error;
+			}
+		}
 
-        /// <summary>
-        ///     The error object.
-        /// </summary>
-        value error() const
-        {
-            return _error;
-        }
-    };
+		return JsNoError;
+	}
 
-    /// <summary>
-    ///     A JavaScript error object representing a compilation error.
-    /// </summary>
-    class compile_error : public error
-    {
-        friend class runtime;
-        friend class value;
+	template<class Map>
+	inline JsErrorCode marshal::to_native_map(JsValueRef value, Map *result)
+	{
+		JsValueRef names;
+		JsErrorCode error = JsGetOwnPropertyNames(value, &names);
+		if (error != JsNoError)
+		{
+			return error;
+		}
 
-        explicit compile_error(JsValueRef ref) :
-            error(ref)
-        {
-        }
+		int length;
+		error = array_length(names, &length);
+		if (error != JsNoError)
+		{
+			return error;
+		}
 
-    public:
-        /// <summary>
-        ///     Creates an invalid handle.
-        /// </summary>
-        compile_error() :
-            error()
-        {
-        }
+		result->clear();
+		for (int index = 0; index < length; index++)
+		{
+			std::wstring name;
+			error = to_native_element(names, index, &name);
+			if (error != JsNoError)
+			{
+				return error;
+			}
 
-        /// <summary>
-        ///     Converts the <c>value</c> handle to a compile error handle.
-        /// </summary>
-        /// <remarks>
-        ///     The type of the underlying value is not checked.
-        /// </remarks>
-        explicit compile_error(value object) :
-            error(object.handle())
-        {
-        }
+			JsValueRef propertyValue;
+			error = get_named_property(value, name.c_str(), &propertyValue);
+			if (error != JsNoError)
+			{
+				return error;
+			}
 
-        /// <summary>
-        ///     The <c>message</c> property of the error.
-        /// </summary>
-        std::wstring message()
-        {
-            return get_property<std::wstring>(property_id::create(L"message"));
-        }
+			typename Map::mapped_type element;
+			error = to_native(propertyValue, &element);
+			if (error != JsNoError)
+			{
+				return error;
+			}
 
-        /// <summary>
-        ///     The <c>line</c> property of the error.
-        /// </summary>
-        double line()
-        {
-            return get_property<double>(property_id::create(L"line"));
-        }
+			(*result)[name] = std::move(element);
+		}
 
-        /// <summary>
-        ///     The <c>column</c> property of the error.
-        /// </summary>
-        double column()
-        {
-            return get_property<double>(property_id::create(L"column"));
-        }
+		return JsNoError;
+	}
 
-        /// <summary>
-        ///     The <c>length</c> property of the error.
-        /// </summary>
-        double length()
-        {
-            return get_property<double>(property_id::create(L"length"));
-        }
+	template<class Map>
+	inline JsErrorCode marshal::from_native_map(const Map &value, JsValueRef *result)
+	{
+		JsErrorCode error = JsCreateObject(result);
+		if (error != JsNoError)
+		{
+			return error;
+		}
 
-        /// <summary>
-        ///     The <c>source</c> property of the error.
-        /// </summary>
-        std::wstring source()
-        {
-            return get_property<std::wstring>(property_id::create(L"source"));
-        }
-    };
+		for (const auto &entry : value)
+		{
+			JsValueRef propertyValue;
+			error = from_native(entry.second, &propertyValue);
+			if (error != JsNoError)
+			{
+				return error;
+			}
 
-    class script_compile_exception : public exception
-    {
-        compile_error _error;
+			error = set_named_property(*result, entry.first.c_str(), propertyValue);
+			if (error != JsNoError)
+			{
+				return error;
+			}
+		}
 
-    public:
-        /// <summary>
-        ///     Creates a compile exception with the specified error.
-        /// </summary>
-        /// <param name="error">The compile error.</param>
-        script_compile_exception(compile_error error) :
-            _error(error)
-        {
-        }
+		return JsNoError;
+	}
 
-        /// <summary>
-        ///     The compile error.
-        /// </summary>
-        compile_error error() const
-        {
-            return _error;
-        }
-    };
+	template<class T>
+	inline JsErrorCode marshal::to_native(JsValueRef value, std::map<std::wstring, T> *result)
+	{
+		return to_native_map(value, result);
+	}
 
 	template<class T>
-	inline JsErrorCode marshal::to_native(JsValueRef value, T *result)
+	inline JsErrorCode marshal::from_native(const std::map<std::wstring, T> &value, JsValueRef *result)
 	{
-		*result = T(object(value));
-		return JsNoError;
+		return from_native_map(value, result);
 	}
 
 	template<class T>
-	inline JsErrorCode marshal::to_native(JsValueRef value, optional<T> *result)
+	inline JsErrorCode marshal::to_native(JsValueRef value, std::unordered_map<std::wstring, T> *result)
 	{
-		T innerValue;
-		JsErrorCode error = to_native(value, &innerValue);
+		return to_native_map(value, result);
+	}
 
+	template<class T>
+	inline JsErrorCode marshal::from_native(const std::unordered_map<std::wstring, T> &value, JsValueRef *result)
+	{
+		return from_native_map(value, result);
+	}
+
+	template<class Tuple, size_t... Indexes>
+	inline JsErrorCode marshal::to_native_tuple(JsValueRef value, Tuple *result, std::index_sequence<Indexes...>)
+	{
+		int length;
+		JsErrorCode error = array_length(value, &length);
 		if (error != JsNoError)
 		{
 			return error;
 		}
 
-		*result = optional<T>(innerValue);
-		return JsNoError;
+		if (length != static_cast<int>(sizeof...(Indexes)))
+		{
+			return JsErrorInvalidArgument;
+		}
+
+		int converted[] = { 0, (error == JsNoError ? (error = to_native_element(value, static_cast<int>(Indexes), &std::get<Indexes>(*result)), 0) : 0)... };
+		(void)converted;
+		return error;
 	}
 
-	template<>
-	inline JsErrorCode marshal::to_native(JsValueRef value, symbol *result)
+	template<class Tuple, size_t... Indexes>
+	inline JsErrorCode marshal::from_native_tuple(const Tuple &value, JsValueRef *result, std::index_sequence<Indexes...>)
 	{
-		*result = symbol(value);
-		return JsNoError;
+		JsErrorCode error = JsCreateArray(static_cast<unsigned int>(sizeof...(Indexes)), result);
+		if (error != JsNoError)
+		{
+			return error;
+		}
+
+		int converted[] = { 0, (error == JsNoError ? (error = from_native_element(*result, static_cast<int>(Indexes), std::get<Indexes>(value)), 0) : 0)... };
+		(void)converted;
+		return error;
 	}
 
-	template<>
-	inline JsErrorCode marshal::to_native<int>(JsValueRef value, int *result)
+	template<class T1, class T2>
+	inline JsErrorCode marshal::to_native(JsValueRef value, std::pair<T1, T2> *result)
 	{
-		return JsNumberToInt(value, result);
+		return to_native_tuple(value, result, std::make_index_sequence<2>());
 	}
 
-	template<>
-	inline JsErrorCode marshal::to_native<double>(JsValueRef value, double *result)
+	template<class T1, class T2>
+	inline JsErrorCode marshal::from_native(const std::pair<T1, T2> &value, JsValueRef *result)
 	{
-		return JsNumberToDouble(value, result);
+		return from_native_tuple(value, result, std::make_index_sequence<2>());
 	}
 
-	template<>
-	inline JsErrorCode marshal::to_native<bool>(JsValueRef value, bool *result)
+	template<class... Types>
+	inline JsErrorCode marshal::to_native(JsValueRef value, std::tuple<Types...> *result)
 	{
-		return JsBooleanToBool(value, result);
+		return to_native_tuple(value, result, std::index_sequence_for<Types...>());
 	}
 
-	template<>
-	inline JsErrorCode marshal::to_native<std::wstring>(JsValueRef value, std::wstring *result)
+	template<class... Types>
+	inline JsErrorCode marshal::from_native(const std::tuple<Types...> &value, JsValueRef *result)
 	{
-		JsValueType type;
-		JsErrorCode error = JsGetValueType(value, &type);
-		if (error != JsNoError)
+		return from_native_tuple(value, result, std::index_sequence_for<Types...>());
+	}
+
+	template<class T>
+	inline bool marshal::accepts(JsValueType type, T *)
+	{
+		if (std::is_same<T, bool>::value)
 		{
-			return error;
+			return type == JsBoolean;
 		}
 
-		if (type == JsNull)
+		if (std::is_arithmetic<T>::value)
 		{
-			*result = std::wstring();
+			return type == JsNumber;
 		}
-		else
+
+		if (std::is_same<T, std::wstring>::value)
 		{
-			const wchar_t *resultptr = nullptr;
-			size_t length;
-			error = JsStringToPointer(value, &resultptr, &length);
-			if (error == JsNoError)
-			{
-				*result = std::wstring(resultptr, length);
-			}
+			return type == JsString || type == JsNull;
 		}
-		return error;
+
+		if (is_mapped_struct<T>::value)
+		{
+			return type == JsObject;
+		}
+
+		return true;
 	}
 
 	template<class T>
-	inline JsErrorCode marshal::from_native(T value, JsValueRef *result)
+	inline bool marshal::accepts(JsValueType type, optional<T> *)
 	{
-		*result = value.handle();
-		return JsNoError;
+		return type == JsUndefined || accepts(type, static_cast<T *>(nullptr));
 	}
 
 	template<class T>
-	inline JsErrorCode marshal::from_native(optional<T> value, JsValueRef *result)
+	inline bool marshal::accepts(JsValueType type, std::vector<T> *)
 	{
-		if (!value.has_value())
+		return type == JsArray || (is_typed_array_element<T>::value && type == JsTypedArray);
+	}
+
+	template<class T, size_t N>
+	inline bool marshal::accepts(JsValueType type, std::array<T, N> *)
+	{
+		return type == JsArray;
+	}
+
+	template<class T>
+	inline bool marshal::accepts(JsValueType type, std::map<std::wstring, T> *)
+	{
+		return type == JsObject;
+	}
+
+	template<class T>
+	inline bool marshal::accepts(JsValueType type, std::unordered_map<std::wstring, T> *)
+	{
+		return type == JsObject;
+	}
+
+	template<class T1, class T2>
+	inline bool marshal::accepts(JsValueType type, std::pair<T1, T2> *)
+	{
+		return type == JsArray;
+	}
+
+	template<class... Types>
+	inline bool marshal::accepts(JsValueType type, std::tuple<Types...> *)
+	{
+		return type == JsArray;
+	}
+
+	template<class T, class Variant>
+	inline JsErrorCode marshal::to_native_alternative(JsValueRef value, JsValueType type, Variant *result)
+	{
+		if (!accepts(type, static_cast<T *>(nullptr)))
 		{
-			// shouldn't get here
 			return JsErrorInvalidArgument;
 		}
 
-		return from_native(value.value(), result);
-	}
+		T alternative;
+		JsErrorCode error = to_native(value, &alternative);
+		if (error != JsNoError)
+		{
+			return error;
+		}
 
-	template<>
-	inline JsErrorCode marshal::from_native(double value, JsValueRef *result)
-	{
-		return JsDoubleToNumber(value, result);
+		*result = Variant(std::move(alternative));
+		return JsNoError;
 	}
 
-	template<>
-	inline JsErrorCode marshal::from_native(int value, JsValueRef *result)
+	template<class T, class Variant>
+	inline JsErrorCode marshal::from_native_alternative(const Variant &value, JsValueRef *result)
 	{
-		return JsIntToNumber(value, result);
+		return from_native(value.template get<T>(), result);
 	}
 
-	template<>
-	inline JsErrorCode marshal::from_native(bool value, JsValueRef *result)
+	template<class... Types>
+	inline JsErrorCode marshal::to_native(JsValueRef value, variant<Types...> *result)
 	{
-		return JsBoolToBoolean(value, result);
+		static JsErrorCode (*const converters[])(JsValueRef, JsValueType, variant<Types...> *) = { &to_native_alternative<Types, variant<Types...>>... };
+
+		JsValueType type;
+		JsErrorCode error = JsGetValueType(value, &type);
+		if (error != JsNoError)
+		{
+			return error;
+		}
+
+		// Try each alternative that can hold this type of value in order; only a failed conversion
+		// moves on to the next one.
+		for (JsErrorCode (*converter)(JsValueRef, JsValueType, variant<Types...> *) : converters)
+		{
+			error = converter(value, type, result);
+			if (error != JsErrorInvalidArgument)
+			{
+				return error;
+			}
+		}
+
+		return JsErrorInvalidArgument;
 	}
 
-	template<>
-	inline JsErrorCode marshal::from_native(std::wstring value, JsValueRef *result)
+	template<class... Types>
+	inline JsErrorCode marshal::from_native(const variant<Types...> &value, JsValueRef *result)
 	{
-		if (value.empty())
+		static JsErrorCode (*const converters[])(const variant<Types...> &, JsValueRef *) = { &from_native_alternative<Types, variant<Types...>>... };
+		if (value.index() < 0)
 		{
-			return JsGetNullValue(result);
+			return JsErrorInvalidArgument;
 		}
-		return JsPointerToString(value.c_str(), value.length(), result);
+
+		return converters[value.index()](value, result);
 	}
 
-	template<>
-	inline JsErrorCode marshal::from_native(const wchar_t *value, JsValueRef *result)
+	template<class T>
+	inline JsErrorCode marshal::from_native(const task<T> &value, JsValueRef *result)
 	{
-		if (value == nullptr)
+		if (!value._state)
 		{
-			return JsGetNullValue(result);
+			return JsErrorInvalidArgument;
 		}
-		return JsPointerToString(value, wcslen(value), result);
+
+		*result = value._state->target->handle();
+		return JsNoError;
 	}
 }
@@ -15,6 +15,8 @@
 #include "stdafx.h"
 #include "CppUnitTest.h"
 
+#include <cmath>
+
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 
 namespace jsrtwrapperstest
@@ -103,5 +105,34 @@ namespace jsrtwrapperstest
             }
             runtime.dispose();
         }
+
+        MY_TEST_METHOD(columns, "Test extracting columns.")
+        {
+            jsrt::runtime runtime = jsrt::runtime::create();
+            jsrt::context context = runtime.create_context();
+            {
+                jsrt::context::scope scope(context);
+                jsrt::array<jsrt::object> rows = static_cast<jsrt::array<jsrt::object>>(jsrt::context::evaluate(L"[{ x: 1, y: 2.5 }, { x: 3, y: -1 }, { x: 5 }]"));
+                auto x = jsrt::property_id::create(L"x");
+                auto y = jsrt::property_id::create(L"y");
+
+                std::vector<std::vector<double>> columns = rows.columns({ x, y });
+                Assert::AreEqual(columns.size(), static_cast<size_t>(2));
+                Assert::AreEqual(columns[0].size(), static_cast<size_t>(3));
+                Assert::AreEqual(columns[0][2], 5.0);
+                Assert::AreEqual(columns[1][0], 2.5);
+                Assert::IsTrue(std::isnan(columns[1][2]));
+
+                std::vector<std::vector<int>> int_columns = rows.columns<int>({ y });
+                Assert::AreEqual(int_columns[0][0], 2);
+                Assert::AreEqual(int_columns[0][2], 0);
+
+                Assert::AreEqual(jsrt::array<jsrt::object>::create(0).columns({ x })[0].size(), static_cast<size_t>(0));
+
+                rows = static_cast<jsrt::array<jsrt::object>>(jsrt::context::evaluate(L"[{ x: 1 }, null]"));
+                TEST_FAILED_CALL(rows.columns({ x }), script_exception);
+            }
+            runtime.dispose();
+        }
     };
-}
\ No newline at end of file
+}
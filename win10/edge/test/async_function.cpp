@@ -0,0 +1,121 @@
+// Copyright 2015 Paul Vick
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace jsrtwrapperstest
+{
+    TEST_CLASS(async_function)
+    {
+    public:
+        MY_TEST_METHOD(resolve, "Test async functions that resolve.")
+        {
+            jsrt::runtime runtime = jsrt::runtime::create();
+            jsrt::context context = runtime.create_context();
+            {
+                jsrt::context::scope scope(context);
+                jsrt::thread_pool pool(2);
+                jsrt::event_loop loop;
+                loop.install();
+
+                std::thread::id runtime_thread = std::this_thread::get_id();
+                std::thread::id body_thread = runtime_thread;
+                jsrt::context::global().set_property(jsrt::property_id::create(L"repeat"), jsrt::async_function<std::wstring, std::wstring, int>::create(L"repeat",
+                    [&body_thread](const std::wstring &text, int count)
+                    {
+                        body_thread = std::this_thread::get_id();
+                        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                        std::wstring result;
+                        for (int index = 0; index < count; index++)
+                        {
+                            result += text;
+                        }
+                        return result;
+                    }, pool, loop));
+                jsrt::context::global().set_property(jsrt::property_id::create(L"ping"), jsrt::async_function<void>::create([]() {}, pool, loop));
+
+                jsrt::context::run(
+                    L"var log = [];"
+                    L"var pending = repeat('ab', 3);"
+                    L"log.push(pending instanceof Promise);"
+                    L"pending.then(function (value) { log.push(value); });"
+                    L"ping().then(function (value) { log.push(value === undefined); });");
+                Assert::AreEqual(loop.completions().outstanding(), static_cast<size_t>(2));
+
+                loop.run();
+                Assert::AreEqual(loop.completions().outstanding(), static_cast<size_t>(0));
+                Assert::IsTrue(body_thread != runtime_thread);
+                Assert::IsTrue(static_cast<jsrt::boolean>(jsrt::context::evaluate(
+                    L"log.length == 3 && log[0] && log.indexOf('ababab') > 0 && log.indexOf(true, 1) > 0")).data());
+            }
+            runtime.dispose();
+        }
+
+        MY_TEST_METHOD(reject, "Test async functions that fail.")
+        {
+            jsrt::runtime runtime = jsrt::runtime::create();
+            jsrt::context context = runtime.create_context();
+            {
+                jsrt::context::scope scope(context);
+                jsrt::thread_pool pool(1);
+                jsrt::event_loop loop;
+                loop.install();
+
+                jsrt::context::global().set_property(jsrt::property_id::create(L"fail"), jsrt::async_function<int, int>::create([](int value) -> int { throw value; }, pool, loop));
+                jsrt::context::run(
+                    L"var message;"
+                    L"fail(1).catch(function (e) { message = e.message; });"
+                    L"try { fail({}); } catch (e) { message = e instanceof TypeError; }");
+                Assert::IsTrue(static_cast<jsrt::boolean>(jsrt::context::evaluate(L"message")).data());
+
+                loop.run();
+                Assert::AreEqual(static_cast<jsrt::string>(jsrt::context::evaluate(L"message")).data(), std::wstring(L"Fatal error."));
+
+                TEST_INVALID_ARG_CALL(jsrt::async_function<int>::create(nullptr, pool, loop));
+            }
+            runtime.dispose();
+        }
+
+        MY_TEST_METHOD(completions, "Test posting completions from other threads.")
+        {
+            jsrt::runtime runtime = jsrt::runtime::create();
+            jsrt::context context = runtime.create_context();
+            {
+                jsrt::context::scope scope(context);
+                jsrt::thread_pool pool(4);
+                jsrt::event_loop loop;
+                loop.install();
+
+                int completed = 0;
+                for (int index = 0; index < 1000; index++)
+                {
+                    loop.completions().expect();
+                    pool.submit([&loop, &completed]()
+                    {
+                        loop.completions().post([&completed]() { completed++; });
+                    });
+                }
+
+                jsrt::context::run(L"var fired = false; setTimeout(function () { fired = true; }, 5);");
+                loop.run();
+                Assert::AreEqual(completed, 1000);
+                Assert::IsTrue(static_cast<jsrt::boolean>(jsrt::context::evaluate(L"fired")).data());
+            }
+            runtime.dispose();
+        }
+    };
+}
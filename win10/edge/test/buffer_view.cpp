@@ -0,0 +1,81 @@
+// Copyright 2015 Paul Vick
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace jsrtwrapperstest
+{
+    TEST_CLASS(buffer_view)
+    {
+    public:
+        MY_TEST_METHOD(empty_view, "Test an empty buffer_view.")
+        {
+            jsrt::buffer_view<int> view;
+            Assert::IsTrue(view.empty());
+            Assert::IsTrue(view.data() == nullptr);
+            Assert::IsFalse(view.source().is_valid());
+        }
+
+        static double sum(const jsrt::call_info &info, jsrt::buffer_view<const double> values)
+        {
+            double total = 0;
+            for (double element : values)
+            {
+                total += element;
+            }
+            return total;
+        }
+
+        static jsrt::buffer_view<int> fill(const jsrt::call_info &info, jsrt::buffer_view<int> values, int fill_value)
+        {
+            for (int &element : values)
+            {
+                element = fill_value;
+            }
+            return values;
+        }
+
+        static int length(const jsrt::call_info &info, jsrt::typed_array<int> values)
+        {
+            return values.length();
+        }
+
+        MY_TEST_METHOD(parameters, "Test buffer_view and typed_array parameters.")
+        {
+            jsrt::runtime runtime = jsrt::runtime::create();
+            jsrt::context context = runtime.create_context();
+            {
+                jsrt::context::scope scope(context);
+                jsrt::context::global().set_property(jsrt::property_id::create(L"sum"), jsrt::function<double, jsrt::buffer_view<const double>>::create(sum));
+                jsrt::context::global().set_property(jsrt::property_id::create(L"fill"), jsrt::function<jsrt::buffer_view<int>, jsrt::buffer_view<int>, int>::create(fill));
+                jsrt::context::global().set_property(jsrt::property_id::create(L"length"), jsrt::function<int, jsrt::typed_array<int>>::create(length));
+
+                Assert::AreEqual(static_cast<jsrt::number>(jsrt::context::evaluate(L"sum(new Float64Array([1, 2, 3.5]))")).as_double(), 6.5);
+                Assert::AreEqual(static_cast<jsrt::number>(jsrt::context::evaluate(L"sum(new Float64Array(new ArrayBuffer(24)))")).as_double(), 0.0);
+                Assert::AreEqual(static_cast<jsrt::number>(jsrt::context::evaluate(L"var b = new ArrayBuffer(8); fill(new DataView(b), 7); new Int32Array(b)[1]")).as_int(), 7);
+                Assert::IsTrue(static_cast<jsrt::boolean>(jsrt::context::evaluate(L"var a = new Int32Array(2); fill(a, 1) === a")).data());
+                Assert::AreEqual(static_cast<jsrt::number>(jsrt::context::evaluate(L"length(new Int32Array(3))")).as_int(), 3);
+
+                Assert::IsTrue(static_cast<jsrt::boolean>(jsrt::context::evaluate(L"try { sum(new Float32Array(2)); false; } catch (e) { e instanceof TypeError; }")).data());
+                Assert::IsTrue(static_cast<jsrt::boolean>(jsrt::context::evaluate(L"try { sum([1, 2]); false; } catch (e) { e instanceof TypeError; }")).data());
+                Assert::IsTrue(static_cast<jsrt::boolean>(jsrt::context::evaluate(L"try { fill(new ArrayBuffer(6), 0); false; } catch (e) { e instanceof TypeError; }")).data());
+                Assert::IsTrue(static_cast<jsrt::boolean>(jsrt::context::evaluate(L"try { length(new Uint32Array(3)); false; } catch (e) { e instanceof TypeError; }")).data());
+            }
+            runtime.dispose();
+        }
+    };
+}
@@ -238,6 +238,41 @@ namespace jsrtwrapperstest
             runtime.dispose();
         }
 
+        MY_TEST_METHOD(microtask_queue, "Test the microtask queue.")
+        {
+            jsrt::runtime runtime = jsrt::runtime::create();
+            jsrt::context context = runtime.create_context();
+            {
+                jsrt::context::scope scope(context);
+                jsrt::microtask_queue queue(2);
+                queue.install();
+
+                queue.run(L"var order = []; Promise.resolve().then(function () { order.push(1); }).then(function () { order.push(3); }); Promise.resolve().then(function () { order.push(2); });");
+                Assert::AreEqual(queue.depth(), static_cast<size_t>(0));
+                Assert::IsTrue(static_cast<jsrt::boolean>(jsrt::context::evaluate(L"order.join() == '1,2,3'")).data());
+                Assert::AreEqual(queue.stats().tasks_run, 3ULL);
+
+                // A budget leaves the rest of the tasks for the next drain.
+                queue.set_task_budget(10);
+                jsrt::context::run(L"var count = 0; for (var i = 0; i < 25; i++) { Promise.resolve().then(function () { count++; }); }");
+                Assert::AreEqual(queue.depth(), static_cast<size_t>(25));
+                Assert::AreEqual(queue.drain(), static_cast<size_t>(10));
+                Assert::AreEqual(queue.depth(), static_cast<size_t>(15));
+                Assert::AreEqual(queue.stats().max_depth, static_cast<size_t>(25));
+                queue.set_task_budget(0);
+                Assert::AreEqual(queue.drain(), static_cast<size_t>(15));
+                Assert::AreEqual(static_cast<jsrt::number>(jsrt::context::evaluate(L"count")).as_int(), 25);
+
+                // An endless chain of tasks is cut off by the time budget.
+                queue.set_time_budget(std::chrono::milliseconds(10));
+                jsrt::context::run(L"var spins = 0; (function spin() { spins++; Promise.resolve().then(spin); })();");
+                Assert::IsTrue(queue.drain() > 0);
+                Assert::AreEqual(queue.depth(), static_cast<size_t>(1));
+                Assert::IsTrue(queue.stats().last_drain_time >= std::chrono::milliseconds(10));
+            }
+            runtime.dispose();
+        }
+
         MY_TEST_METHOD(uwp, "Test UWP projection.")
         {
             jsrt::runtime runtime = jsrt::runtime::create();
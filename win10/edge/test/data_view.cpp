@@ -17,6 +17,27 @@
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 
+namespace jsrtwrapperstest
+{
+    struct packet
+    {
+        unsigned int id;
+        short flags;
+        double value;
+    };
+}
+
+namespace jsrt
+{
+    template<>
+    struct record_type<jsrtwrapperstest::packet> : record_layout<jsrtwrapperstest::packet,
+        record_field<jsrtwrapperstest::packet, unsigned int, &jsrtwrapperstest::packet::id, 0, endedness::big_endian>,
+        record_field<jsrtwrapperstest::packet, short, &jsrtwrapperstest::packet::flags, 4>,
+        record_field<jsrtwrapperstest::packet, double, &jsrtwrapperstest::packet::value, 6, endedness::big_endian>>
+    {
+    };
+}
+
 namespace jsrtwrapperstest
 {
     TEST_CLASS(data_view)
@@ -108,5 +129,85 @@ namespace jsrtwrapperstest
             }
             runtime.dispose();
         }
+
+        MY_TEST_METHOD(bulk_accessors, "Test read_array and write_array methods.")
+        {
+            jsrt::runtime runtime = jsrt::runtime::create();
+            jsrt::context context = runtime.create_context();
+            {
+                jsrt::context::scope scope(context);
+                jsrt::array_buffer buffer = jsrt::array_buffer::create(80);
+                jsrt::data_view<jsrt::endedness::big_endian> big_view = jsrt::data_view<jsrt::endedness::big_endian>::create(buffer);
+                jsrt::data_view<> little_view = jsrt::data_view<>::create(buffer);
+
+                std::vector<int> values;
+                for (int index = 0; index < 10; index++)
+                {
+                    values.push_back(0x01020304 * (index + 1));
+                }
+
+                big_view.write_array<int>(0, values);
+                Assert::AreEqual(big_view.get<int>(4), values[1]);
+                Assert::AreEqual(big_view.get<int>(36), values[9]);
+                Assert::IsTrue(big_view.read_array<int>(0, 10) == values);
+                Assert::AreEqual(buffer.data()[3], static_cast<unsigned char>(0x04));
+
+                little_view.write_array<int>(40, values);
+                Assert::AreEqual(little_view.get<int>(76), values[9]);
+                Assert::IsTrue(little_view.read_array<int>(40, 10) == values);
+
+                double doubles[3] = { 1.5, -2.25, 1e100 };
+                big_view.write_array<double>(8, 3, doubles);
+                Assert::AreEqual(big_view.get<double>(16), -2.25);
+                double result[3];
+                big_view.read_array<double>(8, 3, result);
+                Assert::AreEqual(result[2], 1e100);
+
+                TEST_INVALID_ARG_CALL(big_view.read_array<int>(4, 20));
+                TEST_INVALID_ARG_CALL(little_view.write_array<double>(80, 1, doubles));
+            }
+            runtime.dispose();
+        }
+
+        MY_TEST_METHOD(records, "Test read, write and records methods.")
+        {
+            jsrt::runtime runtime = jsrt::runtime::create();
+            jsrt::context context = runtime.create_context();
+            {
+                jsrt::context::scope scope(context);
+                Assert::AreEqual(jsrt::record_type<packet>::size, 14u);
+
+                jsrt::array_buffer buffer = jsrt::array_buffer::create(42);
+                jsrt::data_view<> view = jsrt::data_view<>::create(buffer);
+                jsrt::data_view<jsrt::endedness::big_endian> big_view = jsrt::data_view<jsrt::endedness::big_endian>::create(buffer);
+
+                for (unsigned int index = 0; index < 3; index++)
+                {
+                    packet record = { index + 1, static_cast<short>(-1 - static_cast<int>(index)), index * 1.5 };
+                    view.write(index * 14, record);
+                }
+
+                Assert::AreEqual(big_view.get<unsigned int>(14), 2u);
+                Assert::AreEqual(view.get<short>(18), static_cast<short>(-2));
+                Assert::AreEqual(big_view.get<double>(20), 1.5);
+
+                packet second = view.read<packet>(14);
+                Assert::AreEqual(second.id, 2u);
+                Assert::AreEqual(second.flags, static_cast<short>(-2));
+                Assert::AreEqual(second.value, 1.5);
+
+                unsigned int count = 0;
+                for (packet record : view.records<packet>(0, 3))
+                {
+                    Assert::AreEqual(record.id, count + 1);
+                    count++;
+                }
+                Assert::AreEqual(count, 3u);
+
+                TEST_INVALID_ARG_CALL(view.read<packet>(30));
+                TEST_INVALID_ARG_CALL(view.records<packet>(14, 3));
+            }
+            runtime.dispose();
+        }
     };
 }
\ No newline at end of file
@@ -0,0 +1,98 @@
+// Copyright 2015 Paul Vick
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace jsrtwrapperstest
+{
+    TEST_CLASS(event_loop)
+    {
+    public:
+        MY_TEST_METHOD(timers, "Test timers.")
+        {
+            jsrt::runtime runtime = jsrt::runtime::create();
+            jsrt::context context = runtime.create_context();
+            {
+                jsrt::context::scope scope(context);
+                jsrt::event_loop loop;
+                loop.install();
+
+                auto start = std::chrono::steady_clock::now();
+                jsrt::context::run(
+                    L"var log = [];"
+                    L"setTimeout(function (a, b) { log.push('late' + a + b); }, 30, 1, 2);"
+                    L"setTimeout(function () { log.push('first'); Promise.resolve().then(function () { log.push('task'); }); }, 10);"
+                    L"setTimeout(function () { log.push('second'); }, 10);"
+                    L"var cleared = setTimeout(function () { log.push('cleared'); }, 5);"
+                    L"clearTimeout(cleared);"
+                    L"var ticks = 0, interval = setInterval(function () { if (++ticks == 3) { clearInterval(interval); } }, 5);");
+                Assert::AreEqual(loop.pending(), static_cast<size_t>(4));
+
+                loop.run();
+                Assert::IsTrue(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(30));
+                Assert::AreEqual(loop.pending(), static_cast<size_t>(0));
+                Assert::IsTrue(static_cast<jsrt::boolean>(jsrt::context::evaluate(L"log.join() == 'first,task,second,late12' && ticks == 3")).data());
+
+                Assert::IsTrue(static_cast<jsrt::boolean>(jsrt::context::evaluate(
+                    L"try { setTimeout('code', 1); false; } catch (e) { e instanceof TypeError; }")).data());
+            }
+            runtime.dispose();
+        }
+
+        MY_TEST_METHOD(exceptions, "Test timers that throw.")
+        {
+            jsrt::runtime runtime = jsrt::runtime::create();
+            jsrt::context context = runtime.create_context();
+            {
+                jsrt::context::scope scope(context);
+                jsrt::event_loop loop;
+                loop.install();
+
+                jsrt::context::run(
+                    L"var done = false;"
+                    L"setTimeout(function () { throw new Error('timer'); }, 1);"
+                    L"setTimeout(function () { done = true; }, 1);");
+
+                TEST_FAILED_CALL(loop.run(), script_exception);
+                loop.run();
+                Assert::IsTrue(static_cast<jsrt::boolean>(jsrt::context::evaluate(L"done")).data());
+            }
+            runtime.dispose();
+        }
+
+        MY_TEST_METHOD(many_timers, "Test many pending timers.")
+        {
+            jsrt::runtime runtime = jsrt::runtime::create();
+            jsrt::context context = runtime.create_context();
+            {
+                jsrt::context::scope scope(context);
+                jsrt::event_loop loop;
+                loop.install();
+
+                jsrt::context::run(
+                    L"var fired = 0, ids = [];"
+                    L"for (var i = 0; i < 100000; i++) { ids.push(setTimeout(function () { fired++; }, i % 50)); }"
+                    L"for (var i = 0; i < ids.length; i += 2) { clearTimeout(ids[i]); }");
+                Assert::AreEqual(loop.pending(), static_cast<size_t>(50000));
+
+                loop.run();
+                Assert::AreEqual(static_cast<jsrt::number>(jsrt::context::evaluate(L"fired")).as_int(), 50000);
+            }
+            runtime.dispose();
+        }
+    };
+}
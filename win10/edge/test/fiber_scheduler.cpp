@@ -0,0 +1,175 @@
+// Copyright 2015 Paul Vick
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace jsrtwrapperstest
+{
+    TEST_CLASS(fiber_scheduler)
+    {
+    public:
+        MY_TEST_METHOD(spawn, "Test running many runtimes on one thread.")
+        {
+            jsrt::fiber_scheduler scheduler;
+            std::thread::id thread = std::this_thread::get_id();
+            std::vector<double> results(100);
+            bool same_thread = true;
+
+            for (int index = 0; index < 100; index++)
+            {
+                scheduler.spawn([index, thread, &results, &same_thread]()
+                {
+                    jsrt::context::run(L"var total = " + std::to_wstring(index) + L";");
+                    for (int round = 0; round < 3; round++)
+                    {
+                        jsrt::fiber_scheduler::yield();
+                        same_thread = same_thread && std::this_thread::get_id() == thread;
+                        jsrt::context::run(L"total += 1000;");
+                    }
+                    results[index] = static_cast<jsrt::number>(jsrt::context::evaluate(L"total")).data();
+                });
+            }
+            Assert::AreEqual(scheduler.size(), static_cast<size_t>(100));
+
+            scheduler.run();
+            Assert::AreEqual(scheduler.size(), static_cast<size_t>(0));
+            Assert::IsTrue(same_thread);
+            for (int index = 0; index < 100; index++)
+            {
+                Assert::AreEqual(results[index], index + 3000.0);
+            }
+
+            TEST_NULL_ARG_CALL(scheduler.spawn(nullptr));
+            TEST_FAILED_CALL(jsrt::fiber_scheduler::yield(), wrong_thread_exception);
+            TEST_FAILED_CALL(jsrt::fiber_scheduler::current(), wrong_thread_exception);
+        }
+
+        MY_TEST_METHOD(post, "Test waking fibers from other threads.")
+        {
+            jsrt::fiber_scheduler scheduler;
+            std::vector<unsigned int> ids;
+            std::vector<std::wstring> logs(3);
+
+            for (int index = 0; index < 3; index++)
+            {
+                ids.push_back(scheduler.spawn([index, &logs]()
+                {
+                    jsrt::context::run(L"var log = []; var done = false;");
+                    jsrt::context::run(L"Promise.resolve().then(function () { log.push('task'); });");
+                    while (!static_cast<jsrt::boolean>(jsrt::context::evaluate(L"done")).data())
+                    {
+                        jsrt::fiber_scheduler::suspend();
+                    }
+                    logs[index] = static_cast<jsrt::string>(jsrt::context::evaluate(L"log.sort().join()")).data();
+                }));
+            }
+
+            // The sender starts once the other fibers are waiting for it.
+            std::thread sender;
+            scheduler.spawn([&scheduler, &ids, &sender]()
+            {
+                sender = std::thread([&scheduler, &ids]()
+                {
+                    for (unsigned int id : ids)
+                    {
+                        scheduler.post(id, []() { jsrt::context::run(L"log.push('first');"); });
+                        scheduler.post(id, []() { jsrt::context::run(L"log.push('second'); done = true;"); });
+                    }
+                });
+            });
+
+            scheduler.run();
+            sender.join();
+            for (const std::wstring &log : logs)
+            {
+                Assert::AreEqual(log, std::wstring(L"first,second,task"));
+            }
+
+            TEST_INVALID_ARG_CALL(scheduler.post(ids[0], []() {}));
+            TEST_NULL_ARG_CALL(scheduler.post(ids[0], nullptr));
+        }
+
+        MY_TEST_METHOD(blocking, "Test fibers waiting for blocking calls and promises.")
+        {
+            jsrt::fiber_scheduler scheduler;
+            jsrt::thread_pool pool(2);
+            int slow_result = 0;
+            int ticks = 0;
+            std::wstring settled;
+
+            scheduler.spawn([&pool, &slow_result]()
+            {
+                slow_result = jsrt::fiber_scheduler::run_blocking(pool, []()
+                {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+                    return 42;
+                });
+            });
+
+            // Keeps running while the first fiber waits for the pool.
+            scheduler.spawn([&slow_result, &ticks]()
+            {
+                while (slow_result == 0)
+                {
+                    ticks++;
+                    jsrt::fiber_scheduler::yield();
+                }
+            });
+
+            scheduler.spawn([&settled]()
+            {
+                jsrt::promise<std::wstring> fulfilled(jsrt::context::evaluate(L"Promise.resolve('done')"));
+                settled = jsrt::fiber_scheduler::wait(fulfilled);
+
+                jsrt::promise<std::wstring> rejected(jsrt::context::evaluate(L"Promise.reject(new Error('failed'))"));
+                TEST_SCRIPT_EXCEPTION_CALL(jsrt::fiber_scheduler::wait(rejected));
+            });
+
+            scheduler.run();
+            Assert::AreEqual(slow_result, 42);
+            Assert::IsTrue(ticks > 0);
+            Assert::AreEqual(settled, std::wstring(L"done"));
+        }
+
+        MY_TEST_METHOD(failures, "Test fibers that throw.")
+        {
+            jsrt::fiber_scheduler scheduler;
+            bool finished = false;
+
+            scheduler.spawn([]()
+            {
+                jsrt::context::global().set_property(jsrt::property_id::create(L"yieldNow"), jsrt::function<void>::create([](const jsrt::call_info &)
+                {
+                    jsrt::fiber_scheduler::yield();
+                }));
+
+                // A fiber can't give up the thread while script is running on it.
+                TEST_SCRIPT_EXCEPTION_CALL(jsrt::context::run(L"yieldNow();"));
+                jsrt::context::run(L"throw new Error('failed');");
+            });
+
+            scheduler.spawn([&finished]()
+            {
+                jsrt::fiber_scheduler::yield();
+                finished = true;
+            });
+
+            TEST_SCRIPT_EXCEPTION_CALL(scheduler.run());
+            Assert::IsTrue(finished);
+        }
+    };
+}
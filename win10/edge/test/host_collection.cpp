@@ -0,0 +1,80 @@
+// Copyright 2015 Paul Vick
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "stdafx.h"
+#include <map>
+#include <unordered_map>
+#include "CppUnitTest.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace jsrtwrapperstest
+{
+    TEST_CLASS(host_collection)
+    {
+    public:
+        MY_TEST_METHOD(methods, "Test host collections with methods.")
+        {
+            jsrt::runtime runtime = jsrt::runtime::create();
+            jsrt::context context = runtime.create_context();
+            {
+                jsrt::context::scope scope(context);
+                std::unordered_map<std::wstring, double> values;
+                values[L"a"] = 1;
+                values[L"b"] = 2;
+                auto collection = jsrt::host_collection<std::unordered_map<std::wstring, double>>::create(values);
+                jsrt::context::global().set_property(jsrt::property_id::create(L"c"), collection.target());
+
+                Assert::IsTrue(static_cast<jsrt::boolean>(jsrt::context::evaluate(
+                    L"c.size == 2 && c.get('a') == 1 && c.get('z') === undefined && c.get(1) === undefined && c.has('b') && !c.has('z') && c.keys().sort().join() == 'a,b'")).data());
+                Assert::AreEqual(static_cast<jsrt::number>(jsrt::context::evaluate(
+                    L"var total = 0; c.forEach(function (value, key, collection) { total += value; }); total")).as_double(), 3.0);
+                Assert::IsTrue(static_cast<jsrt::boolean>(jsrt::context::evaluate(
+                    L"try { c.forEach(function () { throw new RangeError('stop'); }); false; } catch (e) { e instanceof RangeError; }")).data());
+                Assert::IsTrue(static_cast<jsrt::boolean>(jsrt::context::evaluate(
+                    L"try { c.get.call({}, 'a'); false; } catch (e) { e instanceof TypeError; }")).data());
+
+                collection.data()[L"c"] = 3;
+                Assert::AreEqual(static_cast<jsrt::number>(jsrt::context::evaluate(L"c.get('c') + c.size")).as_double(), 6.0);
+            }
+            runtime.dispose();
+        }
+
+        MY_TEST_METHOD(proxies, "Test host collections as proxies.")
+        {
+            jsrt::runtime runtime = jsrt::runtime::create();
+            jsrt::context context = runtime.create_context();
+            {
+                jsrt::context::scope scope(context);
+                std::map<std::wstring, std::vector<int>> named;
+                named[L"first"] = { 1, 2 };
+                named[L"second"] = { 3 };
+                jsrt::context::global().set_property(jsrt::property_id::create(L"named"),
+                    jsrt::host_collection<std::map<std::wstring, std::vector<int>>>::create_proxy(named).target());
+                jsrt::context::global().set_property(jsrt::property_id::create(L"list"),
+                    jsrt::host_collection<std::vector<std::wstring>>::create_proxy({ L"x", L"y", L"z" }).target());
+
+                Assert::IsTrue(static_cast<jsrt::boolean>(jsrt::context::evaluate(
+                    L"named.first[1] == 2 && named.second.length == 1 && named.third === undefined && 'first' in named && !('third' in named) && "
+                    L"Object.keys(named).join() == 'first,second' && JSON.stringify(named) == '{\"first\":[1,2],\"second\":[3]}'")).data());
+                Assert::IsTrue(static_cast<jsrt::boolean>(jsrt::context::evaluate(
+                    L"list[1] == 'y' && list['2'] == 'z' && list[3] === undefined && list['01'] === undefined && list[-1] === undefined && "
+                    L"'0' in list && Object.keys(list).join() == '0,1,2'")).data());
+                Assert::IsTrue(static_cast<jsrt::boolean>(jsrt::context::evaluate(
+                    L"(function () { 'use strict'; try { list[0] = 'w'; return false; } catch (e) { return e instanceof TypeError && list[0] == 'x'; } })()")).data());
+            }
+            runtime.dispose();
+        }
+    };
+}
@@ -0,0 +1,79 @@
+// Copyright 2015 Paul Vick
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace jsrtwrapperstest
+{
+    TEST_CLASS(host_iterator)
+    {
+    public:
+        MY_TEST_METHOD(ranges, "Test iterating native ranges from script.")
+        {
+            jsrt::runtime runtime = jsrt::runtime::create();
+            jsrt::context context = runtime.create_context();
+            {
+                jsrt::context::scope scope(context);
+                std::vector<std::wstring> names = { L"a", L"b", L"c" };
+                jsrt::context::global().set_property(jsrt::property_id::create(L"names"), jsrt::host_iterator<std::wstring>::from_range(names));
+                jsrt::context::global().set_property(jsrt::property_id::create(L"chunked"), jsrt::host_iterator<std::wstring>::from_range(names, 2));
+
+                Assert::IsTrue(static_cast<jsrt::boolean>(jsrt::context::evaluate(
+                    L"var result = ''; for (var name of names) { result += name; } result == 'abc' && names.next().done")).data());
+                Assert::IsTrue(static_cast<jsrt::boolean>(jsrt::context::evaluate(
+                    L"var result = ''; for (var name of chunked) { result += name; } result == 'abc' && chunked.next().done")).data());
+            }
+            runtime.dispose();
+        }
+
+        MY_TEST_METHOD(generators, "Test iterating native generators from script.")
+        {
+            jsrt::runtime runtime = jsrt::runtime::create();
+            jsrt::context context = runtime.create_context();
+            {
+                jsrt::context::scope scope(context);
+                std::shared_ptr<int> owner = std::make_shared<int>(0);
+
+                // An unbounded sequence that releases its state when script stops early.
+                jsrt::context::global().set_property(jsrt::property_id::create(L"squares"), jsrt::host_iterator<double>::create([owner](double &element)
+                {
+                    element = static_cast<double>(*owner) * *owner;
+                    (*owner)++;
+                    return true;
+                }, 16));
+                Assert::AreEqual(owner.use_count(), 2L);
+
+                Assert::AreEqual(static_cast<jsrt::number>(jsrt::context::evaluate(
+                    L"var total = 0; for (var square of squares) { if (square > 100) { break; } total += square; } total")).as_double(), 385.0);
+                Assert::AreEqual(owner.use_count(), 1L);
+                Assert::IsTrue(static_cast<jsrt::boolean>(jsrt::context::evaluate(L"squares.next().done")).data());
+
+                int count = 0;
+                jsrt::context::global().set_property(jsrt::property_id::create(L"counter"), jsrt::host_iterator<int>::create([count](int &element) mutable
+                {
+                    element = count++;
+                    return count <= 5;
+                }));
+                Assert::IsTrue(static_cast<jsrt::boolean>(jsrt::context::evaluate(
+                    L"Array.from(counter).join() == '0,1,2,3,4'")).data());
+                Assert::IsTrue(static_cast<jsrt::boolean>(jsrt::context::evaluate(
+                    L"try { counter.next.call({}); false; } catch (e) { e instanceof TypeError; }")).data());
+            }
+            runtime.dispose();
+        }
+    };
+}
@@ -0,0 +1,107 @@
+// Copyright 2015 Paul Vick
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace jsrtwrapperstest
+{
+    TEST_CLASS(iterable)
+    {
+    public:
+        static double sum(const jsrt::call_info &info, jsrt::iterable<double> values)
+        {
+            double total = 0;
+            for (double value : values.batched(3))
+            {
+                total += value;
+            }
+            return total;
+        }
+
+        MY_TEST_METHOD(iteration, "Test iterating JavaScript iterables.")
+        {
+            jsrt::runtime runtime = jsrt::runtime::create();
+            jsrt::context context = runtime.create_context();
+            {
+                jsrt::context::scope scope(context);
+
+                std::vector<int> numbers;
+                for (int value : jsrt::iterable<int>(jsrt::context::evaluate(L"[1, 2, 3]")))
+                {
+                    numbers.push_back(value);
+                }
+                Assert::AreEqual(numbers.size(), static_cast<size_t>(3));
+                Assert::AreEqual(numbers[2], 3);
+
+                std::wstring characters;
+                for (const std::wstring &character : jsrt::iterable<std::wstring>(jsrt::context::evaluate(L"'abc'")))
+                {
+                    characters += character;
+                }
+                Assert::AreEqual(characters, static_cast<std::wstring>(L"abc"));
+
+                std::vector<std::wstring> keys;
+                for (const std::wstring &key : jsrt::iterable<std::wstring>(jsrt::context::evaluate(L"new Map([['x', 1], ['y', 2]]).keys()")))
+                {
+                    keys.push_back(key);
+                }
+                Assert::AreEqual(keys.size(), static_cast<size_t>(2));
+                Assert::AreEqual(keys[1], static_cast<std::wstring>(L"y"));
+
+                int count = 0;
+                for (int value : jsrt::iterable<int>(jsrt::context::evaluate(L"new Set([5, 5, 6])")).batched(10))
+                {
+                    count += value;
+                }
+                Assert::AreEqual(count, 11);
+
+                TEST_INVALID_ARG_CALL(jsrt::iterable<int>(jsrt::context::evaluate(L"({})")).begin());
+                TEST_INVALID_ARG_CALL(jsrt::iterable<int>(jsrt::context::evaluate(L"['a']")).begin());
+            }
+            runtime.dispose();
+        }
+
+        MY_TEST_METHOD(generators, "Test iterating generators.")
+        {
+            jsrt::runtime runtime = jsrt::runtime::create();
+            jsrt::context context = runtime.create_context();
+            {
+                jsrt::context::scope scope(context);
+                jsrt::context::evaluate(
+                    L"var closed = false;"
+                    L"function* range(count) { try { for (var i = 0; i < count; i++) { yield i; } } finally { closed = true; } }");
+
+                // Batches that divide the elements evenly and unevenly.
+                jsrt::context::global().set_property(jsrt::property_id::create(L"sum"), jsrt::function<double, jsrt::iterable<double>>::create(sum));
+                Assert::AreEqual(static_cast<jsrt::number>(jsrt::context::evaluate(L"sum(range(6)) + sum(range(7))")).as_double(), 36.0);
+
+                int last = 0;
+                for (int value : jsrt::iterable<int>(jsrt::context::evaluate(L"closed = false; range(100)")))
+                {
+                    last = value;
+                    if (value == 4)
+                    {
+                        break;
+                    }
+                }
+                Assert::AreEqual(last, 4);
+                Assert::IsTrue(static_cast<jsrt::boolean>(jsrt::context::evaluate(L"closed")).data());
+            }
+            runtime.dispose();
+        }
+    };
+}
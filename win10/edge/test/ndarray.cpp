@@ -0,0 +1,104 @@
+// Copyright 2015 Paul Vick
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace jsrtwrapperstest
+{
+    TEST_CLASS(ndarray)
+    {
+    public:
+        MY_TEST_METHOD(empty_handle, "Test an empty ndarray.")
+        {
+            jsrt::ndarray<int, 2> view;
+            Assert::IsFalse(view.is_valid());
+        }
+
+        MY_TEST_METHOD(views, "Test indexing, slicing and transposing.")
+        {
+            jsrt::runtime runtime = jsrt::runtime::create();
+            jsrt::context context = runtime.create_context();
+            {
+                jsrt::context::scope scope(context);
+                jsrt::typed_array<int> array = jsrt::typed_array<int>::create({ 0, 1, 2, 3, 4, 5 });
+                jsrt::ndarray<int, 2> matrix(array, { { 2, 3 } });
+                Assert::AreEqual(matrix.size(), static_cast<size_t>(6));
+                Assert::IsTrue(matrix.is_contiguous());
+                Assert::AreEqual(matrix(1, 2), 5);
+                Assert::AreEqual(matrix.at({ { 0, 1 } }), 1);
+                matrix(1, 0) = 30;
+                Assert::AreEqual(static_cast<int>(array[3]), 30);
+
+                jsrt::ndarray<int, 2> transposed = matrix.transpose();
+                Assert::AreEqual(transposed.shape()[0], 3u);
+                Assert::AreEqual(transposed(2, 1), 5);
+                Assert::IsFalse(transposed.is_contiguous());
+
+                jsrt::ndarray<int, 2> columns = matrix.slice(1, 0, 3, 2);
+                Assert::AreEqual(columns.shape()[1], 2u);
+                Assert::AreEqual(columns(1, 1), 5);
+
+                jsrt::ndarray<int, 1> row = matrix.index(0, 1);
+                Assert::AreEqual(row(1), 4);
+                Assert::IsTrue(row.data() == array.data() + 3);
+
+                TEST_INVALID_ARG_CALL((jsrt::ndarray<int, 2>(array, { { 2, 2 } })));
+                TEST_INVALID_ARG_CALL(matrix.at({ { 2, 0 } }));
+                TEST_INVALID_ARG_CALL(matrix.slice(0, 1, 3));
+                TEST_INVALID_ARG_CALL(matrix.index(2, 0));
+            }
+            runtime.dispose();
+        }
+
+        static int sum(const jsrt::call_info &info, jsrt::ndarray<int, 2> view)
+        {
+            int total = 0;
+            for (unsigned int row = 0; row < view.shape()[0]; row++)
+            {
+                for (unsigned int column = 0; column < view.shape()[1]; column++)
+                {
+                    total += view(row, column);
+                }
+            }
+            return total;
+        }
+
+        static jsrt::ndarray<int, 2> transpose(const jsrt::call_info &info, jsrt::ndarray<int, 2> view)
+        {
+            return view.transpose();
+        }
+
+        MY_TEST_METHOD(marshal, "Test marshalling ndarray values.")
+        {
+            jsrt::runtime runtime = jsrt::runtime::create();
+            jsrt::context context = runtime.create_context();
+            {
+                jsrt::context::scope scope(context);
+                jsrt::context::global().set_property(jsrt::property_id::create(L"sum"), jsrt::function<int, jsrt::ndarray<int, 2>>::create(sum));
+                jsrt::context::global().set_property(jsrt::property_id::create(L"transpose"), jsrt::function<jsrt::ndarray<int, 2>, jsrt::ndarray<int, 2>>::create(transpose));
+
+                Assert::AreEqual(static_cast<jsrt::number>(jsrt::context::evaluate(L"sum({ data: new Int32Array([1, 2, 3, 4]), shape: [2, 2] })")).as_int(), 10);
+                Assert::AreEqual(static_cast<jsrt::number>(jsrt::context::evaluate(L"sum({ data: new Int32Array([1, 2, 3, 4]), shape: [1, 2], strides: [2, -1], offset: 1 })")).as_int(), 3);
+                Assert::AreEqual(static_cast<jsrt::number>(jsrt::context::evaluate(L"var t = transpose({ data: new Int32Array([1, 2, 3, 4, 5, 6]), shape: [2, 3] }); t.shape[0] * 10 + t.strides[0]")).as_int(), 31);
+
+                jsrt::context::run(L"try { sum({ data: new Int32Array(4), shape: [3, 2] }); } catch (e) { failed = e instanceof TypeError; }");
+                Assert::IsTrue(jsrt::context::global().get_property<bool>(jsrt::property_id::create(L"failed")));
+            }
+            runtime.dispose();
+        }
+    };
+}
@@ -0,0 +1,120 @@
+// Copyright 2015 Paul Vick
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include <chrono>
+#include <cmath>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace jsrtwrapperstest
+{
+    TEST_CLASS(numeric)
+    {
+        static double time_script(const wchar_t *script)
+        {
+            auto start = std::chrono::high_resolution_clock::now();
+            jsrt::context::run(script);
+            auto finish = std::chrono::high_resolution_clock::now();
+            return std::chrono::duration<double, std::milli>(finish - start).count();
+        }
+
+    public:
+        MY_TEST_METHOD(kernels, "Test the native kernels.")
+        {
+            double doubles[] = { 1.5, -2, 3, 4.25, -5, 6 };
+            int ints[] = { 3, -1, 4, -1, 5, -9, 2 };
+            double double_sums[6];
+            int int_sums[7];
+
+            Assert::AreEqual(jsrt::numeric::dot(doubles, doubles, 6), 2.25 + 4 + 9 + 18.0625 + 25 + 36);
+            Assert::AreEqual(jsrt::numeric::dot(ints, ints, 7), 137.0);
+
+            jsrt::numeric::prefix_sum(doubles, double_sums, 6);
+            Assert::AreEqual(double_sums[5], 7.75);
+            jsrt::numeric::prefix_sum(ints, int_sums, 7);
+            Assert::AreEqual(int_sums[4], 10);
+            Assert::AreEqual(int_sums[6], 3);
+
+            Assert::AreEqual(jsrt::numeric::min(doubles, 6), -5.0);
+            Assert::AreEqual(jsrt::numeric::max(doubles, 6), 6.0);
+            Assert::AreEqual(jsrt::numeric::min(ints, 7), -9.0);
+            Assert::AreEqual(jsrt::numeric::max(ints, 7), 5.0);
+            Assert::IsTrue(std::isinf(jsrt::numeric::min(ints, 0)));
+
+            doubles[3] = std::nan("");
+            Assert::IsTrue(std::isnan(jsrt::numeric::min(doubles, 6)));
+
+            unsigned int bins[3];
+            jsrt::numeric::histogram(ints, 7, -3, 6, bins, 3);
+            Assert::AreEqual(bins[0], 2u);
+            Assert::AreEqual(bins[1], 1u);
+            Assert::AreEqual(bins[2], 3u);
+        }
+
+        MY_TEST_METHOD(install, "Test calling the kernels from script.")
+        {
+            jsrt::runtime runtime = jsrt::runtime::create();
+            jsrt::context context = runtime.create_context();
+            {
+                jsrt::context::scope scope(context);
+                jsrt::object kernels = jsrt::object::create();
+                jsrt::numeric::install(kernels);
+                jsrt::context::global().set_property(jsrt::property_id::create(L"kernels"), kernels);
+
+                Assert::AreEqual(static_cast<jsrt::number>(jsrt::context::evaluate(L"kernels.dot(new Float64Array([1, 2, 3]), new Float64Array([4, 5, 6]))")).as_double(), 32.0);
+                Assert::AreEqual(static_cast<jsrt::number>(jsrt::context::evaluate(L"var sums = new Int32Array(5); kernels.prefixSum(new Int32Array([1, 2, 3, 4, 5]), sums); sums[4]")).as_int(), 15);
+                Assert::AreEqual(static_cast<jsrt::number>(jsrt::context::evaluate(L"kernels.min(new Int32Array([4, -2, 7]))")).as_int(), -2);
+                Assert::AreEqual(static_cast<jsrt::number>(jsrt::context::evaluate(L"kernels.max(new Float64Array([4, -2, 7.5]))")).as_double(), 7.5);
+                Assert::AreEqual(static_cast<jsrt::number>(jsrt::context::evaluate(L"var bins = new Uint32Array(2); kernels.histogram(new Float64Array([0, 1, 2, 3]), bins, 0, 4); bins[1]")).as_int(), 2);
+
+                Assert::IsTrue(static_cast<jsrt::boolean>(jsrt::context::evaluate(L"try { kernels.dot(new Float64Array(2), new Int32Array(2)); false; } catch (e) { e instanceof TypeError; }")).data());
+                Assert::IsTrue(static_cast<jsrt::boolean>(jsrt::context::evaluate(L"try { kernels.min([1, 2]); false; } catch (e) { e instanceof TypeError; }")).data());
+            }
+            runtime.dispose();
+        }
+
+        MY_TEST_METHOD(benchmark, "Compare the native kernels with equivalent script loops.")
+        {
+            jsrt::runtime runtime = jsrt::runtime::create();
+            jsrt::context context = runtime.create_context();
+            {
+                jsrt::context::scope scope(context);
+                jsrt::object kernels = jsrt::object::create();
+                jsrt::numeric::install(kernels);
+                jsrt::context::global().set_property(jsrt::property_id::create(L"kernels"), kernels);
+                jsrt::context::run(
+                    L"var a = new Float64Array(1000000), b = new Float64Array(1000000), out = new Float64Array(1000000);"
+                    L"for (var i = 0; i < a.length; i++) { a[i] = Math.random(); b[i] = Math.random(); }");
+
+                const wchar_t *benchmarks[][3] =
+                {
+                    { L"dot", L"for (var r = 0; r < 20; r++) { var s = 0; for (var i = 0; i < a.length; i++) { s += a[i] * b[i]; } }", L"for (var r = 0; r < 20; r++) { kernels.dot(a, b); }" },
+                    { L"prefixSum", L"for (var r = 0; r < 20; r++) { var s = 0; for (var i = 0; i < a.length; i++) { out[i] = s += a[i]; } }", L"for (var r = 0; r < 20; r++) { kernels.prefixSum(a, out); }" },
+                    { L"min", L"for (var r = 0; r < 20; r++) { var m = Infinity; for (var i = 0; i < a.length; i++) { if (a[i] < m) { m = a[i]; } } }", L"for (var r = 0; r < 20; r++) { kernels.min(a); }" },
+                };
+
+                for (auto &benchmark : benchmarks)
+                {
+                    double script = time_script(benchmark[1]);
+                    double native = time_script(benchmark[2]);
+                    Logger::WriteMessage((std::wstring(benchmark[0]) + L": script " + std::to_wstring(script) + L"ms, native " + std::to_wstring(native) + L"ms").c_str());
+                }
+            }
+            runtime.dispose();
+        }
+    };
+}
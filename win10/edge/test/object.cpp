@@ -382,6 +382,41 @@ namespace jsrtwrapperstest
             runtime.dispose();
         }
 
+        MY_TEST_METHOD(managed_external_indexes, "Test managed external indexed storage.")
+        {
+            jsrt::runtime runtime = jsrt::runtime::create();
+            jsrt::context context = runtime.create_context();
+            {
+                jsrt::context::scope scope(context);
+                jsrt::object object = jsrt::object::create();
+                auto storage = jsrt::external_indexes<double>::create(object, { 1.5, 2.5 });
+                Assert::IsTrue(object.has_external_indexes());
+                Assert::AreEqual(object.external_indexes_type(), JsArrayTypeFloat64);
+                Assert::AreEqual(object.get_index<double>(1), 2.5);
+
+                object.set_index(0, 10.0);
+                Assert::AreEqual(storage[0], 10.0);
+
+                storage.resize(100, 7.0);
+                Assert::AreEqual(object.external_indexes_size(), 100u);
+                Assert::AreEqual(object.get_index<double>(99), 7.0);
+                Assert::AreEqual(object.get_index<double>(0), 10.0);
+
+                storage.push_back(3.0);
+                Assert::AreEqual(object.external_indexes_size(), 101u);
+                Assert::IsTrue(object.external_indexes_data() == storage.data());
+
+                storage.assign({ 4.0 });
+                Assert::AreEqual(object.external_indexes_size(), 1u);
+                Assert::AreEqual(object.get_index<double>(0), 4.0);
+
+                object = jsrt::object();
+                storage = jsrt::external_indexes<double>();
+            }
+            runtime.collect_garbage();
+            runtime.dispose();
+        }
+
         static void CALLBACK finalize(void *data)
         {
             Assert::AreEqual(data, reinterpret_cast<void *>(0xdeadbeef));
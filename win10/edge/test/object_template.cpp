@@ -0,0 +1,67 @@
+// Copyright 2015 Paul Vick
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace jsrtwrapperstest
+{
+    TEST_CLASS(object_template)
+    {
+    public:
+        MY_TEST_METHOD(empty_template, "Test an empty object_template.")
+        {
+            jsrt::object_template<double> empty;
+            Assert::IsFalse(empty.is_valid());
+        }
+
+        MY_TEST_METHOD(instantiate, "Test creating objects from a template.")
+        {
+            jsrt::runtime runtime = jsrt::runtime::create();
+            jsrt::context context = runtime.create_context();
+            {
+                jsrt::context::scope scope(context);
+                auto x = jsrt::property_id::create(L"x");
+                auto name = jsrt::property_id::create(L"name");
+                auto count = jsrt::property_id::create(L"count");
+                jsrt::object_template<double, std::wstring, int> point({ x, name, count });
+                Assert::IsTrue(point.is_valid());
+
+                jsrt::object single = point.instantiate(1.5, L"first", 3);
+                Assert::AreEqual(single.get_property<double>(x), 1.5);
+                Assert::AreEqual(single.get_property<std::wstring>(name), static_cast<std::wstring>(L"first"));
+                Assert::AreEqual(single.get_property<int>(count), 3);
+                Assert::AreEqual(single.get_own_property_names()[1], static_cast<std::wstring>(L"name"));
+
+                std::vector<std::tuple<double, std::wstring, int>> rows;
+                rows.push_back(std::make_tuple(2.5, L"second", 4));
+                rows.push_back(std::make_tuple(-1.0, L"third", 5));
+                jsrt::array<jsrt::object> objects = point.instantiate_many(rows);
+                Assert::AreEqual(objects.size(), 2);
+
+                jsrt::object second = objects[1];
+                Assert::AreEqual(second.get_property<double>(x), -1.0);
+                Assert::AreEqual(second.get_property<std::wstring>(name), static_cast<std::wstring>(L"third"));
+                Assert::AreEqual(second.get_property<int>(count), 5);
+                Assert::AreEqual(second.get_own_property_names()[2], static_cast<std::wstring>(L"count"));
+
+                Assert::AreEqual(point.instantiate_many(std::vector<std::tuple<double, std::wstring, int>>()).size(), 0);
+                TEST_INVALID_ARG_CALL((jsrt::object_template<double, int>({ x })));
+            }
+            runtime.dispose();
+        }
+    };
+}
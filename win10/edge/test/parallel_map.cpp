@@ -0,0 +1,103 @@
+// Copyright 2015 Paul Vick
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace jsrtwrapperstest
+{
+    TEST_CLASS(parallel_map)
+    {
+    public:
+        MY_TEST_METHOD(run, "Test mapping buffers.")
+        {
+            jsrt::script_executor executor(4);
+            jsrt::parallel_map<float> square(executor, L"(function (x) { return x * x; })");
+            jsrt::parallel_map<double> indexed(executor, L"(function (x, i) { return x + i; })");
+
+            std::vector<float> input(100000);
+            for (size_t index = 0; index < input.size(); index++)
+            {
+                input[index] = static_cast<float>(index % 100);
+            }
+
+            std::vector<float> output;
+            square.run(input, output);
+            Assert::AreEqual(output.size(), input.size());
+            for (size_t index = 0; index < input.size(); index++)
+            {
+                Assert::AreEqual(output[index], input[index] * input[index]);
+            }
+
+            // Odd chunk sizes are rounded up to whole cache lines.
+            std::vector<double> values(1001, 1.0);
+            indexed.run(values.data(), values.data(), values.size(), 7);
+            for (size_t index = 0; index < values.size(); index++)
+            {
+                Assert::AreEqual(values[index], index + 1.0);
+            }
+
+            square.run(nullptr, nullptr, 0);
+            TEST_NULL_ARG_CALL(square.run(nullptr, output.data(), 1));
+        }
+
+        MY_TEST_METHOD(errors, "Test kernels that fail.")
+        {
+            jsrt::script_executor executor(2);
+            jsrt::parallel_map<double> failing(executor, L"(function (x) { if (x > 5) { throw new Error('too big'); } return x; })");
+
+            std::vector<double> input(10000, 1.0);
+            std::vector<double> output;
+            failing.run(input, output);
+
+            input[9000] = 10;
+            TEST_FAILED_CALL(failing.run(input, output), script_exception);
+        }
+
+        MY_TEST_METHOD(benchmark, "Compare mapping on one runtime with mapping on every core.")
+        {
+            const wchar_t *kernel = L"(function (x, i) { return Math.sqrt(x * x + i) * Math.sin(x); })";
+            std::vector<float> input(1 << 22);
+            for (size_t index = 0; index < input.size(); index++)
+            {
+                input[index] = static_cast<float>(index % 1000) / 1000;
+            }
+
+            std::vector<float> output(input.size());
+            double single = 0;
+            unsigned int cores = (std::max)(std::thread::hardware_concurrency(), 1u);
+
+            for (unsigned int workers : { 1u, cores })
+            {
+                jsrt::script_executor executor(workers);
+                jsrt::parallel_map<float> map(executor, kernel);
+
+                // Load the kernel in every worker before timing.
+                map.run(input.data(), output.data(), workers * 1024);
+
+                auto start = std::chrono::steady_clock::now();
+                map.run(input, output);
+                double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+                if (workers == 1)
+                {
+                    single = milliseconds;
+                }
+
+                Logger::WriteMessage((std::to_wstring(workers) + L" runtimes: " + std::to_wstring(milliseconds) + L"ms, speedup " + std::to_wstring(single / milliseconds)).c_str());
+            }
+        }
+    };
+}
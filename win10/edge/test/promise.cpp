@@ -0,0 +1,147 @@
+// Copyright 2015 Paul Vick
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace jsrtwrapperstest
+{
+    TEST_CLASS(promise)
+    {
+    public:
+        struct resume_handle
+        {
+            int *resumed;
+
+            void operator()() const
+            {
+                (*resumed)++;
+            }
+        };
+
+        static jsrt::task<double> pending_task;
+
+        static jsrt::task<double> start(const jsrt::call_info &info, double value)
+        {
+            pending_task = jsrt::task<double>::create();
+            return pending_task;
+        }
+
+        MY_TEST_METHOD(then, "Test native continuations.")
+        {
+            jsrt::runtime runtime = jsrt::runtime::create();
+            jsrt::context context = runtime.create_context();
+            {
+                jsrt::context::scope scope(context);
+                jsrt::microtask_queue queue;
+                queue.install();
+
+                double fulfilled = 0;
+                std::wstring rejected;
+                jsrt::promise<double>(jsrt::context::evaluate(L"Promise.resolve(42)")).then(
+                    [&fulfilled](const double &result) { fulfilled = result; },
+                    [](jsrt::value reason) { Assert::Fail(); });
+                jsrt::promise<double>(jsrt::context::evaluate(L"Promise.reject(new Error('failed'))")).then(
+                    [](const double &result) { Assert::Fail(); },
+                    [&rejected](jsrt::value reason) { rejected = jsrt::error(reason).message(); });
+                Assert::AreEqual(fulfilled, 0.0);
+
+                queue.drain();
+                Assert::AreEqual(fulfilled, 42.0);
+                Assert::AreEqual(rejected, std::wstring(L"failed"));
+
+                bool converted = true;
+                jsrt::promise<std::vector<int>>(jsrt::context::evaluate(L"Promise.resolve(1)")).then(
+                    [](const std::vector<int> &result) { Assert::Fail(); },
+                    [&converted](jsrt::value reason) { converted = false; });
+                queue.drain();
+                Assert::IsFalse(converted);
+
+                TEST_INVALID_ARG_CALL(jsrt::promise<>(jsrt::context::evaluate(L"({})")).then([](const jsrt::value &) {}, [](jsrt::value) {}));
+                TEST_INVALID_ARG_CALL(jsrt::promise<>(jsrt::context::evaluate(L"Promise.resolve()")).then(nullptr, [](jsrt::value) {}));
+            }
+            runtime.dispose();
+        }
+
+        MY_TEST_METHOD(await, "Test the awaitable protocol.")
+        {
+            jsrt::runtime runtime = jsrt::runtime::create();
+            jsrt::context context = runtime.create_context();
+            {
+                jsrt::context::scope scope(context);
+                jsrt::microtask_queue queue;
+                queue.install();
+
+                int resumed = 0;
+                jsrt::promise<std::wstring> fulfilled(jsrt::context::evaluate(L"Promise.resolve('done')"));
+                Assert::IsFalse(fulfilled.await_ready());
+                fulfilled.await_suspend(resume_handle { &resumed });
+                Assert::AreEqual(resumed, 0);
+                queue.drain();
+                Assert::AreEqual(resumed, 1);
+                Assert::AreEqual(fulfilled.await_resume(), std::wstring(L"done"));
+
+                jsrt::promise<std::wstring> rejected(jsrt::context::evaluate(L"Promise.reject(new TypeError('bad'))"));
+                rejected.await_suspend(resume_handle { &resumed });
+                queue.drain();
+                Assert::AreEqual(resumed, 2);
+                TEST_FAILED_CALL(rejected.await_resume(), script_exception);
+
+                TEST_INVALID_ARG_CALL(jsrt::promise<>(jsrt::context::evaluate(L"Promise.resolve()")).await_resume());
+            }
+            runtime.dispose();
+        }
+
+        MY_TEST_METHOD(task, "Test tasks.")
+        {
+            jsrt::runtime runtime = jsrt::runtime::create();
+            jsrt::context context = runtime.create_context();
+            {
+                jsrt::context::scope scope(context);
+                jsrt::microtask_queue queue;
+                queue.install();
+
+                jsrt::context::global().set_property(jsrt::property_id::create(L"start"), jsrt::function<jsrt::task<double>, double>::create(start));
+                jsrt::context::run(L"var result; start(1).then(function (value) { result = value; });");
+                Assert::IsFalse(pending_task.is_settled());
+                queue.drain();
+                Assert::IsTrue(static_cast<jsrt::boolean>(jsrt::context::evaluate(L"result === undefined")).data());
+
+                pending_task.resolve(3);
+                pending_task.resolve(4);
+                Assert::IsTrue(pending_task.is_settled());
+                queue.drain();
+                Assert::AreEqual(static_cast<jsrt::number>(jsrt::context::evaluate(L"result")).data(), 3.0);
+
+                jsrt::task<double> failed = jsrt::task<double>::create();
+                std::wstring reason;
+                failed.promise().then(
+                    [](const double &) { Assert::Fail(); },
+                    [&reason](jsrt::value value) { reason = jsrt::error(value).message(); });
+                failed.reject(jsrt::error::create(L"failed"));
+                queue.drain();
+                Assert::AreEqual(reason, std::wstring(L"failed"));
+
+                pending_task = jsrt::task<double>();
+                Assert::IsFalse(pending_task.is_valid());
+                TEST_INVALID_ARG_CALL(pending_task.resolve(1));
+            }
+            runtime.dispose();
+        }
+    };
+
+    jsrt::task<double> promise::pending_task;
+}
@@ -0,0 +1,106 @@
+// Copyright 2015 Paul Vick
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace jsrtwrapperstest
+{
+    TEST_CLASS(runtime_dispatcher)
+    {
+    public:
+        MY_TEST_METHOD(post, "Test posting work from other threads.")
+        {
+            jsrt::runtime_dispatcher dispatcher;
+            Assert::IsTrue(dispatcher.thread_id() != std::this_thread::get_id());
+
+            std::thread::id thread = dispatcher.post([]() { return std::this_thread::get_id(); }).get();
+            Assert::IsTrue(thread == dispatcher.thread_id());
+
+            dispatcher.post([]() { jsrt::context::run(L"var total = 0;"); }).get();
+
+            std::vector<std::thread> threads;
+            for (int index = 0; index < 4; index++)
+            {
+                threads.push_back(std::thread([&dispatcher]()
+                {
+                    std::vector<std::future<void>> results;
+                    for (int call = 0; call < 250; call++)
+                    {
+                        results.push_back(dispatcher.post([]() { jsrt::context::run(L"total++;"); }));
+                    }
+
+                    for (std::future<void> &result : results)
+                    {
+                        result.get();
+                    }
+                }));
+            }
+
+            for (std::thread &thread : threads)
+            {
+                thread.join();
+            }
+
+            double total = dispatcher.post([]() { return static_cast<jsrt::number>(jsrt::context::evaluate(L"total")).data(); }).get();
+            Assert::AreEqual(total, 1000.0);
+
+            jsrt::runtime_dispatcher::statistics stats = dispatcher.stats();
+            Assert::AreEqual(stats.calls, 1003ull);
+            Assert::IsTrue(stats.batches <= stats.calls);
+            Assert::IsTrue(stats.largest_batch >= 1);
+        }
+
+        MY_TEST_METHOD(call, "Test calling script functions.")
+        {
+            jsrt::runtime_dispatcher dispatcher;
+            dispatcher.post([]()
+            {
+                jsrt::context::run(
+                    L"var log = [];"
+                    L"function join(separator) { return Array.prototype.slice.call(arguments, 1).join(separator); }"
+                    L"function record(value) { log.push(value); }"
+                    L"function later(value) { setTimeout(function () { log.push(value); }, 5); }"
+                    L"function fail() { throw new Error('failed'); }");
+            }).get();
+
+            std::vector<std::wstring> parts = { L"a", L"b", L"c" };
+            Assert::AreEqual(dispatcher.call<std::wstring>(L"join", std::wstring(L"-"), parts).get(), std::wstring(L"a-b-c"));
+
+            dispatcher.call<void>(L"later", 1).get();
+            dispatcher.call<void>(L"record", 2).get();
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            Assert::AreEqual(dispatcher.post([]() { return static_cast<jsrt::string>(jsrt::context::evaluate(L"log.join()")).data(); }).get(), std::wstring(L"2,1"));
+
+            std::future<void> failed = dispatcher.call<void>(L"fail");
+            TEST_FAILED_CALL(failed.get(), script_exception);
+
+            std::future<int> missing = dispatcher.call<int>(L"missing");
+            TEST_INVALID_ARG_CALL(missing.get());
+        }
+
+        MY_TEST_METHOD(shutdown, "Test calls queued before the dispatcher is destroyed.")
+        {
+            std::future<int> result;
+            {
+                jsrt::runtime_dispatcher dispatcher;
+                dispatcher.post([]() { std::this_thread::sleep_for(std::chrono::milliseconds(10)); });
+                result = dispatcher.post([]() { return 1; });
+            }
+            Assert::AreEqual(result.get(), 1);
+        }
+    };
+}
@@ -0,0 +1,152 @@
+// Copyright 2015 Paul Vick
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace jsrtwrapperstest
+{
+    TEST_CLASS(runtime_handle)
+    {
+    public:
+        MY_TEST_METHOD(lease, "Test moving a runtime between threads.")
+        {
+            jsrt::runtime_handle handle = jsrt::runtime_handle::create();
+            Assert::IsTrue(handle.is_valid());
+            Assert::IsFalse(handle.is_attached());
+
+            {
+                jsrt::runtime_handle::lease lease = handle.attach();
+                Assert::IsTrue(handle.is_attached());
+                Assert::IsTrue(jsrt::context::current() == handle.script_context());
+                jsrt::context::run(L"var count = 1;");
+                lease.detach();
+                Assert::IsFalse(lease.is_valid());
+            }
+            Assert::IsFalse(jsrt::context::current().is_valid());
+            Assert::IsFalse(handle.is_attached());
+
+            double count = 0;
+            std::thread::id otherId;
+            std::thread other([&handle, &count, &otherId]()
+            {
+                otherId = std::this_thread::get_id();
+                jsrt::runtime_handle::lease lease = handle.attach();
+                count = static_cast<jsrt::number>(jsrt::context::evaluate(L"++count")).data();
+                lease.detach();
+            });
+            other.join();
+            Assert::AreEqual(count, 2.0);
+            Assert::IsTrue(handle.thread_id() == otherId);
+            Assert::AreEqual(handle.migrations(), 1ull);
+
+            {
+                jsrt::runtime_handle::lease lease = handle.attach();
+                std::thread contender([&handle]()
+                {
+                    TEST_FAILED_CALL(handle.attach(), runtime_in_use_exception);
+                });
+                contender.join();
+                TEST_FAILED_CALL(handle.dispose(), runtime_in_use_exception);
+                TEST_FAILED_CALL(handle.attach(), runtime_in_use_exception);
+            }
+            Assert::IsFalse(handle.is_attached());
+            Assert::AreEqual(handle.migrations(), 2ull);
+
+            handle.dispose();
+            Assert::IsFalse(handle.is_valid());
+            TEST_INVALID_ARG_CALL(handle.attach());
+        }
+
+        MY_TEST_METHOD(live_scopes, "Test detaching with a scope still alive.")
+        {
+            jsrt::runtime_handle handle = jsrt::runtime_handle::create();
+            {
+                jsrt::runtime_handle::lease lease = handle.attach();
+
+                {
+                    jsrt::context::scope scope(handle.script_runtime().create_context());
+                    TEST_FAILED_CALL(lease.detach(), runtime_in_use_exception);
+                }
+
+                {
+                    jsrt::context::scope scope(handle.script_context());
+                    TEST_FAILED_CALL(lease.detach(), runtime_in_use_exception);
+                }
+
+                Assert::IsTrue(lease.is_valid());
+                lease.detach();
+
+                std::thread other([&lease]()
+                {
+                    TEST_INVALID_ARG_CALL(lease.detach());
+                });
+                other.join();
+            }
+            handle.dispose();
+        }
+
+        MY_TEST_METHOD(balancer, "Test moving tenants from busy threads.")
+        {
+            jsrt::runtime_balancer balancer(2);
+            std::vector<unsigned int> tenants;
+            for (int index = 0; index < 4; index++)
+            {
+                tenants.push_back(balancer.add_tenant());
+            }
+            Assert::AreEqual(balancer.worker_of(tenants[0]), balancer.worker_of(tenants[2]));
+            Assert::AreNotEqual(balancer.worker_of(tenants[0]), balancer.worker_of(tenants[1]));
+
+            for (unsigned int tenant : tenants)
+            {
+                balancer.post(tenant, [tenant]() { jsrt::context::run(L"var id = " + std::to_wstring(tenant) + L";"); }).get();
+            }
+
+            // Make the first worker busy.
+            std::thread::id before = balancer.post(tenants[0], []()
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+                return std::this_thread::get_id();
+            }).get();
+            balancer.post(tenants[2], []() { std::this_thread::sleep_for(std::chrono::milliseconds(20)); }).get();
+
+            size_t hot = balancer.worker_of(tenants[0]);
+            Assert::AreEqual(balancer.rebalance(), static_cast<size_t>(1));
+            Assert::AreNotEqual(balancer.worker_of(tenants[0]), hot);
+            Assert::AreEqual(balancer.worker_of(tenants[2]), hot);
+            Assert::AreEqual(balancer.rebalance(), static_cast<size_t>(0));
+
+            std::thread::id after;
+            double id = balancer.post(tenants[0], [&after]()
+            {
+                after = std::this_thread::get_id();
+                jsrt::context::run(L"Promise.resolve().then(function () { id += 10; });");
+                return static_cast<jsrt::number>(jsrt::context::evaluate(L"id")).data();
+            }).get();
+            Assert::IsTrue(after != before);
+            Assert::AreEqual(id, static_cast<double>(tenants[0]));
+            Assert::AreEqual(balancer.post(tenants[0], []() { return static_cast<jsrt::number>(jsrt::context::evaluate(L"id")).data(); }).get(), tenants[0] + 10.0);
+
+            std::future<void> failed = balancer.post(tenants[1], []() { jsrt::context::run(L"throw new Error('failed');"); });
+            TEST_SCRIPT_EXCEPTION_CALL(failed.get());
+            TEST_INVALID_ARG_CALL(balancer.post(100, []() {}));
+
+            jsrt::runtime_balancer::statistics stats = balancer.stats();
+            Assert::AreEqual(stats.migrations, 1ull);
+            Assert::AreEqual(stats.tasks, 9ull);
+        }
+    };
+}
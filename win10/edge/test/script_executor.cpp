@@ -0,0 +1,114 @@
+// Copyright 2015 Paul Vick
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace jsrtwrapperstest
+{
+    TEST_CLASS(script_executor)
+    {
+    public:
+        MY_TEST_METHOD(submit, "Test running scripts on workers.")
+        {
+            jsrt::script_executor executor(4);
+            Assert::AreEqual(executor.size(), static_cast<size_t>(4));
+
+            unsigned int add = executor.add_script(L"(function (a, b) { return a + b; })");
+            unsigned int join = executor.add_script(L"(function () { return Array.prototype.join.call(arguments, '-'); })");
+
+            std::vector<std::future<double>> sums;
+            for (int index = 0; index < 1000; index++)
+            {
+                sums.push_back(executor.submit<double>(add, static_cast<double>(index), 1.0));
+            }
+
+            for (int index = 0; index < 1000; index++)
+            {
+                Assert::AreEqual(sums[index].get(), index + 1.0);
+            }
+
+            std::vector<std::wstring> parts = { L"a", L"b" };
+            Assert::AreEqual(executor.submit<std::wstring>(join, parts).get(), std::wstring(L"a-b"));
+            Assert::AreEqual(executor.stats().tasks, 1001ull);
+        }
+
+        MY_TEST_METHOD(errors, "Test scripts that fail.")
+        {
+            jsrt::script_executor executor(2);
+            unsigned int thrower = executor.add_script(L"(function () { throw new Error('failed'); })");
+            unsigned int broken = executor.add_script(L"(function () {");
+            unsigned int number = executor.add_script(L"42");
+
+            std::future<void> thrown = executor.submit<void>(thrower);
+            TEST_FAILED_CALL(thrown.get(), script_exception);
+
+            std::future<void> compiled = executor.submit<void>(broken);
+            TEST_FAILED_CALL(compiled.get(), script_compile_exception);
+
+            std::future<void> called = executor.submit<void>(number);
+            TEST_INVALID_ARG_CALL(called.get());
+
+            std::future<void> missing = executor.submit<void>(100);
+            TEST_INVALID_ARG_CALL(missing.get());
+
+            unsigned int working = executor.add_script(L"(function () { return 1; })");
+            Assert::AreEqual(executor.submit<int>(working).get(), 1);
+        }
+
+        MY_TEST_METHOD(benchmark, "Measure throughput against the number of workers.")
+        {
+            const int task_count = 20000;
+            double single = 0;
+
+            for (unsigned int workers = 1; workers <= (std::max)(std::thread::hardware_concurrency(), 1u); workers *= 2)
+            {
+                jsrt::script_executor executor(workers);
+                unsigned int kernel = executor.add_script(L"(function (n) { var s = 0; for (var i = 0; i < n; i++) { s += Math.sqrt(i); } return s; })");
+
+                // Load the script in every worker before timing.
+                std::vector<std::future<double>> results;
+                for (unsigned int index = 0; index < workers * 4; index++)
+                {
+                    results.push_back(executor.submit<double>(kernel, 1));
+                }
+                for (std::future<double> &result : results)
+                {
+                    result.get();
+                }
+                results.clear();
+
+                auto start = std::chrono::steady_clock::now();
+                for (int index = 0; index < task_count; index++)
+                {
+                    results.push_back(executor.submit<double>(kernel, 1000));
+                }
+                for (std::future<double> &result : results)
+                {
+                    result.get();
+                }
+                double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                double throughput = task_count / seconds;
+                if (workers == 1)
+                {
+                    single = throughput;
+                }
+
+                Logger::WriteMessage((std::to_wstring(workers) + L" workers: " + std::to_wstring(throughput) + L" tasks/s, speedup " + std::to_wstring(throughput / single) + L", steals " + std::to_wstring(executor.stats().steals)).c_str());
+            }
+        }
+    };
+}
@@ -0,0 +1,124 @@
+// Copyright 2015 Paul Vick
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace jsrtwrapperstest
+{
+    struct point
+    {
+        double x;
+        double y;
+        jsrt::optional<std::wstring> label;
+    };
+
+    struct shape
+    {
+        std::wstring name;
+        point origin;
+        std::vector<point> points;
+    };
+}
+
+namespace jsrt
+{
+    template<>
+    struct struct_type<jsrtwrapperstest::point> : struct_mapping
+    {
+        static auto fields()
+        {
+            return std::make_tuple(
+                field(L"x", &jsrtwrapperstest::point::x),
+                field(L"y", &jsrtwrapperstest::point::y),
+                field(L"label", &jsrtwrapperstest::point::label));
+        }
+    };
+
+    template<>
+    struct struct_type<jsrtwrapperstest::shape> : struct_mapping
+    {
+        static auto fields()
+        {
+            return std::make_tuple(
+                field(L"name", &jsrtwrapperstest::shape::name),
+                field(L"origin", &jsrtwrapperstest::shape::origin),
+                field(L"points", &jsrtwrapperstest::shape::points));
+        }
+    };
+}
+
+namespace jsrtwrapperstest
+{
+    TEST_CLASS(struct_type)
+    {
+    public:
+        static shape translate(const jsrt::call_info &info, shape value, point offset)
+        {
+            value.origin.x += offset.x;
+            value.origin.y += offset.y;
+            for (auto &element : value.points)
+            {
+                element.x += offset.x;
+                element.y += offset.y;
+            }
+            return value;
+        }
+
+        MY_TEST_METHOD(properties, "Test mapped structures as properties.")
+        {
+            jsrt::runtime runtime = jsrt::runtime::create();
+            jsrt::context context = runtime.create_context();
+            {
+                jsrt::context::scope scope(context);
+                jsrt::object object = jsrt::object::create();
+                auto p = jsrt::property_id::create(L"p");
+
+                point value = { 1, 2, jsrt::missing() };
+                object.set_property(p, value);
+                jsrt::object stored = object.get_property<jsrt::object>(p);
+                Assert::AreEqual(stored.get_property<double>(jsrt::property_id::create(L"y")), 2.0);
+                Assert::IsFalse(stored.has_property(jsrt::property_id::create(L"label")));
+
+                value.label = std::wstring(L"first");
+                object.set_property(p, value);
+                point result = object.get_property<point>(p);
+                Assert::AreEqual(result.x, 1.0);
+                Assert::IsTrue(result.label.has_value());
+                Assert::AreEqual(result.label.value(), static_cast<std::wstring>(L"first"));
+            }
+            runtime.dispose();
+        }
+
+        MY_TEST_METHOD(functions, "Test mapped structures as parameters and results.")
+        {
+            jsrt::runtime runtime = jsrt::runtime::create();
+            jsrt::context context = runtime.create_context();
+            {
+                jsrt::context::scope scope(context);
+                jsrt::context::global().set_property(jsrt::property_id::create(L"translate"), jsrt::function<shape, shape, point>::create(translate));
+
+                Assert::IsTrue(static_cast<jsrt::boolean>(jsrt::context::evaluate(
+                    L"var s = translate({ name: 'tri', origin: { x: 0, y: 0 }, points: [{ x: 1, y: 1, label: 'a' }, { x: 2, y: 0 }] }, { x: 10, y: 20 });"
+                    L"s.name == 'tri' && s.origin.x == 10 && s.points.length == 2 && s.points[0].y == 21 && s.points[0].label == 'a' && !('label' in s.points[1])")).data());
+
+                Assert::IsTrue(static_cast<jsrt::boolean>(jsrt::context::evaluate(
+                    L"try { translate({ name: 'bad', origin: null, points: [] }, { x: 0, y: 0 }); false; } catch (e) { e instanceof TypeError; }")).data());
+            }
+            runtime.dispose();
+        }
+    };
+}
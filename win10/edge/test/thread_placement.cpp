@@ -0,0 +1,137 @@
+// Copyright 2015 Paul Vick
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace jsrtwrapperstest
+{
+    TEST_CLASS(thread_placement)
+    {
+    public:
+        MY_TEST_METHOD(policies, "Test finding places for threads.")
+        {
+            jsrt::thread_placement none;
+            Assert::IsTrue(none.policy() == jsrt::placement_policy::none);
+            Assert::AreEqual(none.size(), static_cast<size_t>(0));
+            Assert::AreEqual(none.node_count(), static_cast<size_t>(1));
+            Assert::AreEqual(none.node_of(3), 0u);
+            Assert::IsFalse(none.apply(0));
+
+            jsrt::thread_placement cores(jsrt::placement_policy::cores);
+            Assert::IsTrue(cores.size() >= cores.node_count());
+            Assert::IsTrue(cores.size() <= std::thread::hardware_concurrency());
+            for (size_t index = 1; index < cores.node_count(); index++)
+            {
+                Assert::AreNotEqual(cores.node_of(index), cores.node_of(index - 1));
+            }
+
+            jsrt::thread_placement nodes(jsrt::placement_policy::nodes);
+            Assert::AreEqual(nodes.size(), nodes.node_count());
+            Assert::AreEqual(nodes.node_of(nodes.size()), nodes.node_of(0));
+
+            std::thread pinned([&cores]()
+            {
+                Assert::IsTrue(cores.apply(0));
+            });
+            pinned.join();
+        }
+
+        MY_TEST_METHOD(workers, "Test placing the threads of pools.")
+        {
+            jsrt::thread_placement placement(jsrt::placement_policy::cores);
+
+            {
+                jsrt::thread_pool pool(2, placement);
+                std::promise<int> done;
+                pool.submit([&done]() { done.set_value(1); });
+                Assert::AreEqual(done.get_future().get(), 1);
+            }
+
+            jsrt::script_executor executor(2, JsRuntimeAttributeNone, placement);
+            Assert::IsTrue(executor.placement().policy() == jsrt::placement_policy::cores);
+            unsigned int add = executor.add_script(L"(function (a, b) { return a + b; })");
+            Assert::AreEqual(executor.submit<int>(add, 1, 2).get(), 3);
+
+            // Tenants alternate between the workers, and so between the nodes.
+            jsrt::runtime_balancer balancer(static_cast<unsigned int>((std::max)(placement.node_count(), static_cast<size_t>(2))), JsRuntimeAttributeNone, placement);
+            unsigned int first = balancer.add_tenant();
+            unsigned int second = balancer.add_tenant();
+            Assert::AreNotEqual(balancer.worker_of(first), balancer.worker_of(second));
+            Assert::AreEqual(balancer.post(second, []() { return static_cast<jsrt::number>(jsrt::context::evaluate(L"6 * 7")).data(); }).get(), 42.0);
+
+            // Only the busiest worker's node is considered, so a tenant never leaves its node.
+            balancer.post(first, []() { std::this_thread::sleep_for(std::chrono::milliseconds(20)); }).get();
+            size_t before = balancer.worker_of(first);
+            balancer.rebalance();
+            Assert::AreEqual(placement.node_of(balancer.worker_of(first)), placement.node_of(before));
+        }
+
+        MY_TEST_METHOD(benchmark, "Measure the cost of running a runtime on a remote NUMA node.")
+        {
+            jsrt::thread_placement nodes(jsrt::placement_policy::nodes);
+            if (nodes.node_count() < 2)
+            {
+                Logger::WriteMessage(L"Only one NUMA node, so every run is local.");
+            }
+
+            // The heap is created on the first node and then used from each node in turn.
+            jsrt::runtime_handle handle = jsrt::runtime_handle::create();
+            std::thread creator([&nodes, &handle]()
+            {
+                nodes.apply(0);
+                jsrt::runtime_handle::lease lease = handle.attach();
+                jsrt::context::run(
+                    L"var heap = [];"
+                    L"for (var i = 0; i < 1000000; i++) { heap.push({ value: i, items: [i, i + 1] }); }");
+                lease.detach();
+            });
+            creator.join();
+
+            for (size_t slot = 0; slot < (std::min)(nodes.node_count(), static_cast<size_t>(2)); slot++)
+            {
+                double collect_ms = 0;
+                double execute_ms = 0;
+                std::thread runner([&nodes, &handle, slot, &collect_ms, &execute_ms]()
+                {
+                    nodes.apply(slot);
+                    jsrt::runtime_handle::lease lease = handle.attach();
+
+                    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+                    for (int collection = 0; collection < 5; collection++)
+                    {
+                        handle.script_runtime().collect_garbage();
+                    }
+                    collect_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / 5;
+
+                    start = std::chrono::steady_clock::now();
+                    jsrt::context::run(
+                        L"var sum = 0;"
+                        L"for (var pass = 0; pass < 10; pass++) { for (var i = 0; i < heap.length; i++) { sum += heap[i].value + heap[i].items[1]; } }");
+                    execute_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+                    lease.detach();
+                });
+                runner.join();
+
+                Logger::WriteMessage((std::wstring(slot == 0 ? L"local" : L"remote") + L" node " + std::to_wstring(nodes.node_of(slot)) + 
+                    L": collection " + std::to_wstring(collect_ms) + L" ms, execution " + std::to_wstring(execute_ms) + L" ms").c_str());
+            }
+
+            handle.dispose();
+        }
+    };
+}
@@ -140,5 +140,72 @@ namespace jsrtwrapperstest
             }
             runtime.dispose();
         }
+
+        MY_TEST_METHOD(views, "Test subarray and reinterpret.")
+        {
+            jsrt::runtime runtime = jsrt::runtime::create();
+            jsrt::context context = runtime.create_context();
+            {
+                jsrt::context::scope scope(context);
+                jsrt::typed_array<int> array = jsrt::typed_array<int>::create({ 1, 2, 3, 4 });
+                Assert::AreEqual(array.length(), 4u);
+                Assert::AreEqual(array.byte_offset(), 0u);
+
+                jsrt::typed_array<int> sub = array.subarray(1, 3);
+                Assert::AreEqual(sub.length(), 2u);
+                Assert::AreEqual(sub.byte_offset(), 4u);
+                Assert::IsTrue(sub.buffer() == array.buffer());
+                Assert::AreEqual(static_cast<int>(sub[0]), 2);
+                sub[1] = 30;
+                Assert::AreEqual(static_cast<int>(array[2]), 30);
+
+                jsrt::typed_array<short> shorts = sub.reinterpret<short>();
+                Assert::AreEqual(shorts.length(), 4u);
+                Assert::AreEqual(shorts.byte_offset(), 4u);
+                Assert::IsTrue(shorts.data() == sub.data());
+
+                Assert::AreEqual(array.subarray(4, 4).length(), 0u);
+                TEST_INVALID_ARG_CALL(array.subarray(3, 2));
+                TEST_INVALID_ARG_CALL(array.subarray(0, 5));
+                TEST_INVALID_ARG_CALL(array.subarray(1, 2).reinterpret<double>());
+            }
+            runtime.dispose();
+        }
+
+        static std::vector<double> squares(const jsrt::call_info &info, int count)
+        {
+            std::vector<double> result(count);
+            for (int index = 0; index < count; index++)
+            {
+                result[index] = static_cast<double>(index) * index;
+            }
+            return result;
+        }
+
+        static jsrt::typed_result<unsigned char, true> pixels(const jsrt::call_info &info)
+        {
+            return std::vector<unsigned char>{ 0, 128, 255 };
+        }
+
+        MY_TEST_METHOD(typed_results, "Test returning vectors as typed arrays.")
+        {
+            jsrt::runtime runtime = jsrt::runtime::create();
+            jsrt::context context = runtime.create_context();
+            {
+                jsrt::context::scope scope(context);
+                auto squares_function = jsrt::function<std::vector<double>, int>::create(squares);
+                jsrt::context::global().set_property(jsrt::property_id::create(L"squares"), squares_function);
+                jsrt::context::global().set_property(jsrt::property_id::create(L"pixels"), jsrt::function<jsrt::typed_result<unsigned char, true>>::create(pixels));
+
+                Assert::IsTrue(static_cast<jsrt::boolean>(jsrt::context::evaluate(L"var s = squares(4); s instanceof Float64Array && s.length == 4 && s[3] == 9")).data());
+                Assert::IsTrue(static_cast<jsrt::boolean>(jsrt::context::evaluate(L"squares(0).length == 0")).data());
+                Assert::IsTrue(static_cast<jsrt::boolean>(jsrt::context::evaluate(L"var p = pixels(); p instanceof Uint8ClampedArray && p[2] == 255")).data());
+
+                std::vector<double> result = squares_function(jsrt::context::undefined(), 3);
+                Assert::AreEqual(result.size(), static_cast<size_t>(3));
+                Assert::AreEqual(result[2], 4.0);
+            }
+            runtime.dispose();
+        }
     };
-}
\ No newline at end of file
+}
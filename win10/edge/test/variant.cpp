@@ -0,0 +1,120 @@
+// Copyright 2015 Paul Vick
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "stdafx.h"
+#include <map>
+#include <unordered_map>
+#include "CppUnitTest.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace jsrtwrapperstest
+{
+    typedef jsrt::variant<double, std::wstring, std::vector<double>, std::map<std::wstring, double>> any_value;
+
+    TEST_CLASS(variant)
+    {
+    public:
+        static std::wstring describe(const jsrt::call_info &info, any_value value)
+        {
+            switch (value.index())
+            {
+            case 0:
+                return L"number";
+            case 1:
+                return L"string:" + value.get<std::wstring>();
+            case 2:
+                return L"vector:" + std::to_wstring(value.get<std::vector<double>>().size());
+            default:
+                return L"map:" + std::to_wstring(value.get<std::map<std::wstring, double>>().size());
+            }
+        }
+
+        static std::tuple<std::wstring, int, bool> split(const jsrt::call_info &info, std::pair<std::wstring, std::array<int, 2>> value, std::unordered_map<std::wstring, std::vector<std::wstring>> groups)
+        {
+            return std::make_tuple(value.first, value.second[0] + value.second[1], groups[L"a"].size() == 2);
+        }
+
+        static jsrt::optional<std::vector<any_value>> values(const jsrt::call_info &info, bool present)
+        {
+            if (!present)
+            {
+                return jsrt::missing();
+            }
+
+            std::map<std::wstring, double> map;
+            map[L"x"] = 1;
+            return std::vector<any_value> { 1.0, std::wstring(L"two"), map };
+        }
+
+        MY_TEST_METHOD(variant_values, "Test variant values.")
+        {
+            any_value value;
+            Assert::AreEqual(value.index(), 0);
+            Assert::AreEqual(value.get<double>(), 0.0);
+            value = std::wstring(L"text");
+            Assert::IsTrue(value.is<std::wstring>());
+            any_value copy = value;
+            Assert::AreEqual(copy.get<std::wstring>(), static_cast<std::wstring>(L"text"));
+            TEST_INVALID_ARG_CALL(copy.get<double>());
+        }
+
+        MY_TEST_METHOD(containers, "Test marshalling standard containers.")
+        {
+            jsrt::runtime runtime = jsrt::runtime::create();
+            jsrt::context context = runtime.create_context();
+            {
+                jsrt::context::scope scope(context);
+                jsrt::context::global().set_property(jsrt::property_id::create(L"split"),
+                    jsrt::function<std::tuple<std::wstring, int, bool>, std::pair<std::wstring, std::array<int, 2>>, std::unordered_map<std::wstring, std::vector<std::wstring>>>::create(split));
+
+                Assert::IsTrue(static_cast<jsrt::boolean>(jsrt::context::evaluate(
+                    L"var r = split(['name', [1, 2]], { a: ['x', 'y'], b: [] });"
+                    L"Array.isArray(r) && r.length == 3 && r[0] == 'name' && r[1] == 3 && r[2] === true")).data());
+                Assert::IsTrue(static_cast<jsrt::boolean>(jsrt::context::evaluate(
+                    L"try { split(['name', [1, 2, 3]], {}); false; } catch (e) { e instanceof TypeError; }")).data());
+
+                jsrt::object object = jsrt::object::create();
+                auto p = jsrt::property_id::create(L"p");
+                std::map<std::wstring, std::vector<int>> map;
+                map[L"first"] = { 1, 2, 3 };
+                object.set_property(p, map);
+                auto result = object.get_property<std::map<std::wstring, std::vector<int>>>(p);
+                Assert::AreEqual(result.size(), static_cast<size_t>(1));
+                Assert::AreEqual(result[L"first"][2], 3);
+            }
+            runtime.dispose();
+        }
+
+        MY_TEST_METHOD(dispatch, "Test marshalling variants.")
+        {
+            jsrt::runtime runtime = jsrt::runtime::create();
+            jsrt::context context = runtime.create_context();
+            {
+                jsrt::context::scope scope(context);
+                jsrt::context::global().set_property(jsrt::property_id::create(L"describe"), jsrt::function<std::wstring, any_value>::create(describe));
+                jsrt::context::global().set_property(jsrt::property_id::create(L"values"), jsrt::function<jsrt::optional<std::vector<any_value>>, bool>::create(values));
+
+                Assert::IsTrue(static_cast<jsrt::boolean>(jsrt::context::evaluate(
+                    L"describe(1) == 'number' && describe('a') == 'string:a' && describe([1, 2]) == 'vector:2' && "
+                    L"describe(new Float64Array(3)) == 'vector:3' && describe({ x: 1, y: 2 }) == 'map:2'")).data());
+                Assert::IsTrue(static_cast<jsrt::boolean>(jsrt::context::evaluate(
+                    L"try { describe(true); false; } catch (e) { e instanceof TypeError; }")).data());
+                Assert::IsTrue(static_cast<jsrt::boolean>(jsrt::context::evaluate(
+                    L"var v = values(true); values(false) === undefined && v[0] === 1 && v[1] == 'two' && v[2].x == 1")).data());
+            }
+            runtime.dispose();
+        }
+    };
+}